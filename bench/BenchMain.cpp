@@ -0,0 +1,692 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+
+#include "OpenSvsVersion.hpp"
+#include "SyntheticReport.hpp"
+#include "exporters/DiffExporter.hpp"
+#include "models/CircuitTreeModel.hpp"
+#include "models/DiffClusters.hpp"
+#include "models/DiffDelta.hpp"
+#include "models/DiffEntryCommon.hpp"
+#include "models/DiffEntryModel.hpp"
+#include "models/DiffFilterProxyModel.hpp"
+#include "models/WaiverSet.hpp"
+#include "parsers/DeviceHistogram.hpp"
+#include "parsers/NetConnectivity.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+#include "parsers/NetgenJsonStreamParser.hpp"
+#include "parsers/NetlistComparator.hpp"
+#include "parsers/PropertyTolerances.hpp"
+#include "parsers/SpiceIndex.hpp"
+
+#ifndef OPENSVS_BENCH_BUILD_TYPE
+#define OPENSVS_BENCH_BUILD_TYPE ""
+#endif
+
+namespace {
+using Report = NetgenJsonParser::Report;
+
+const qint64 streamChunk = 4 * 1024 * 1024;
+const char *const defaultSizes = "1M,16M,128M";
+const char *const fullSizes = "1M,16M,128M,1G,5G";
+
+// Swallows exporter output so only formatting is measured.
+class NullDevice : public QIODevice {
+  public:
+    NullDevice() { open(QIODevice::WriteOnly); }
+
+  protected:
+    auto readData(char * /*data*/, qint64 /*maxSize*/) -> qint64 override {
+        return -1;
+    }
+    auto writeData(const char * /*data*/, qint64 size) -> qint64 override {
+        return size;
+    }
+};
+
+struct Result {
+    QString benchmark;
+    QString size;
+    qint64 bytes = 0;
+    long long circuits = 0;
+    long long diffs = 0;
+    QVector<double> ms;
+    QString error;
+};
+
+auto parseSize(const QString &text, bool *ok) -> qint64 {
+    static const QRegularExpression re(
+        QStringLiteral("^(\\d+)([KMG]?)B?$"),
+        QRegularExpression::CaseInsensitiveOption);
+    const QRegularExpressionMatch match = re.match(text.trimmed());
+    *ok = match.hasMatch();
+    if (!*ok) {
+        return 0;
+    }
+    const QString unit = match.captured(2).toUpper();
+    const int power =
+        unit.isEmpty() ? 0 : int(QStringLiteral("KMG").indexOf(unit)) + 1;
+    qint64 bytes = match.captured(1).toLongLong();
+    for (int i = 0; i < power; ++i) {
+        bytes *= 1024;
+    }
+    return bytes;
+}
+
+auto toJson(const Result &result) -> QJsonObject {
+    QVector<double> sorted = result.ms;
+    std::sort(sorted.begin(), sorted.end());
+    QJsonObject obj{
+        {QStringLiteral("benchmark"), result.benchmark},
+        {QStringLiteral("size"), result.size},
+        {QStringLiteral("bytes"), result.bytes},
+        {QStringLiteral("circuits"), result.circuits},
+        {QStringLiteral("diffs"), result.diffs},
+        {QStringLiteral("repeat"), static_cast<int>(sorted.size())},
+        {QStringLiteral("ok"), result.error.isEmpty()},
+    };
+    if (!sorted.isEmpty()) {
+        const double best = sorted.first();
+        obj.insert(QStringLiteral("min_ms"), best);
+        obj.insert(QStringLiteral("median_ms"), sorted.at(sorted.size() / 2));
+        obj.insert(QStringLiteral("max_ms"), sorted.last());
+        if (best > 0) {
+            obj.insert(QStringLiteral("mb_per_s"),
+                       result.bytes / 1e6 / (best / 1e3));
+        }
+    }
+    if (!result.error.isEmpty()) {
+        obj.insert(QStringLiteral("error"), result.error);
+    }
+    return obj;
+}
+
+class Bench {
+  public:
+    Bench(QTextStream &log, const QRegularExpression &only, int repeat)
+        : log_(log), only_(only), repeat_(repeat) {}
+
+    void run(const QString &label, const QString &path) {
+        label_ = label;
+        bytes_ = QFileInfo(path).size();
+
+        Report report;
+        measure(QStringLiteral("parse_file"), [&] {
+            report = NetgenJsonParser::parseFile(path);
+            return report.ok ? QString() : report.error;
+        });
+        // parseFile is bound by QJsonDocument's document size limit; the
+        // stream parser yields the same report for any size, so the model
+        // benchmarks still run on the largest inputs.
+        measure(QStringLiteral("parse_stream"), [&] {
+            Report streamed = parseStream(path);
+            const QString error = streamed.ok ? QString() : streamed.error;
+            if (!report.ok) {
+                report = std::move(streamed);
+            }
+            return error;
+        });
+        measure(QStringLiteral("parse_on_demand"), [&] {
+            const Report compact = NetgenJsonParser::parseFile(
+                path, NetgenJsonParser::Details::OnDemand);
+            return compact.ok ? QString() : compact.error;
+        });
+        if (!report.ok) {
+            report = parseStream(path);
+        }
+        if (!report.ok) {
+            log_ << "  skipping model benchmarks: " << report.error << '\n';
+            commit(0, 0);
+            return;
+        }
+        QVector<NetgenJsonParser::DiffEntry> allDiffs;
+        for (const auto &cir : report.circuits) {
+            allDiffs += cir.diffs;
+        }
+
+        CircuitTreeModel tree;
+        measure(QStringLiteral("tree_set_circuits"), [&] {
+            tree.setCircuits(&report.circuits);
+            return QString();
+        });
+        tree.setCircuits(nullptr);
+
+        DiffEntryModel model;
+        measure(QStringLiteral("diff_model_set_diffs"), [&] {
+            model.setDiffs(allDiffs);
+            return QString();
+        });
+        model.setDiffs(allDiffs);
+        DiffFilterProxyModel proxy;
+        proxy.setSourceModel(&model);
+        const QString netType = NetgenJsonParser::toTypeString(
+            NetgenJsonParser::DiffType::NetMismatch);
+        const auto clearSearch = [&] { proxy.setSearchTerm(QString()); };
+        measure(QStringLiteral("proxy_type_filter"), [&] {
+            proxy.setTypeFilter(netType);
+            proxy.rowCount();
+            return QString();
+        }, [&] { proxy.setTypeFilter(QString()); });
+        measure(QStringLiteral("proxy_search_substring"), [&] {
+            proxy.setSearchTerm(QStringLiteral("net1"));
+            proxy.rowCount();
+            return QString();
+        }, clearSearch);
+        measure(QStringLiteral("proxy_search_regex"), [&] {
+            proxy.setSearchTerm(QStringLiteral("^net\\d*7_|w: \\d+e-7"));
+            proxy.rowCount();
+            return QString();
+        }, clearSearch);
+        measure(QStringLiteral("proxy_sort"), [&] {
+            proxy.sort(DiffEntryColumns::OBJECT, Qt::AscendingOrder);
+            proxy.rowCount();
+            return QString();
+        }, [&] { proxy.sort(-1); });
+        proxy.setSourceModel(nullptr);
+
+        DiffExporter::DiffList rows;
+        rows.reserve(allDiffs.size());
+        for (const auto &cir : report.circuits) {
+            for (const auto &entry : cir.diffs) {
+                rows.push_back(&entry);
+            }
+        }
+        const auto exportAs = [&](DiffExporter::Format format) {
+            NullDevice sink;
+            QTextStream out(&sink);
+            if (format == DiffExporter::Format::Json) {
+                DiffExporter::writeJson(out, report, QString(), rows, true,
+                                        true);
+            } else {
+                DiffExporter::writeDiffs(out, format, report, rows);
+            }
+            out.flush();
+            return QString();
+        };
+        measure(QStringLiteral("export_text"),
+                [&] { return exportAs(DiffExporter::Format::Text); });
+        measure(QStringLiteral("export_csv"),
+                [&] { return exportAs(DiffExporter::Format::Csv); });
+        measure(QStringLiteral("export_json"),
+                [&] { return exportAs(DiffExporter::Format::Json); });
+        // Against itself every diff is probed and matched: the worst case
+        // for the join, which builds and probes the whole report.
+        measure(QStringLiteral("delta_self"), [&] {
+            const DiffDelta::Result delta =
+                DiffDelta::compare(report.circuits, report.circuits);
+            return delta.unchangedCount == allDiffs.size()
+                       ? QString()
+                       : QStringLiteral("self-compare found changes");
+        });
+        // Ten thousand rules of the three kinds WaiverSet compiles: object
+        // globs for the automaton, object regexes for the grouped
+        // fallback and cell-only rules listed per cell.
+        QString rules;
+        for (int i = 0; i < 10000; ++i) {
+            switch (i % 10) {
+            case 0:
+                rules += QStringLiteral("object=re:^net%1_[a-z]+$\n").arg(i);
+                break;
+            case 1:
+                rules += QStringLiteral(
+                             "type=property_mismatch cell=cell%1_*\n")
+                             .arg(i);
+                break;
+            default:
+                rules += QStringLiteral("object=net%1_*\n").arg(i);
+                break;
+            }
+        }
+        WaiverSet waivers;
+        waivers.parse(rules);
+        measure(QStringLiteral("waivers_apply"), [&] {
+            const QVector<int> waived = waivers.apply(allDiffs);
+            return waived.size() == allDiffs.size()
+                       ? QString()
+                       : QStringLiteral("waiver rows do not match diffs");
+        });
+        // The synthetic names are indexed, so the groups are few and large.
+        measure(QStringLiteral("cluster"), [&] {
+            const auto clusters = DiffClusters::cluster(rows);
+            return clusters.isEmpty() == allDiffs.isEmpty()
+                       ? QString()
+                       : QStringLiteral("no clusters");
+        });
+        // One badnets group per diff's worth of nets: every schematic net
+        // split over two layout nets, so each is an open.
+        QVector<NetConnectivity::Net> layoutNets;
+        QVector<NetConnectivity::Net> schematicNets;
+        for (qsizetype i = 0; i < allDiffs.size(); ++i) {
+            const QString a = QStringLiteral("x%1:a").arg(i);
+            const QString b = QStringLiteral("x%1:b").arg(i);
+            layoutNets.append({QStringLiteral("l%1a").arg(i), {{a, 1}}});
+            layoutNets.append({QStringLiteral("l%1b").arg(i), {{b, 1}}});
+            schematicNets.append(
+                {QStringLiteral("s%1").arg(i), {{a, 1}, {b, 1}}});
+        }
+        measure(QStringLiteral("net_connectivity"), [&] {
+            const auto findings =
+                NetConnectivity::classify(layoutNets, schematicNets);
+            return findings.size() == schematicNets.size()
+                       ? QString()
+                       : QStringLiteral("opens not found");
+        });
+        measure(QStringLiteral("device_histogram"), [&] {
+            const auto rolled = DeviceHistogram::rolledUp(report.circuits);
+            return rolled.size() == report.circuits.size()
+                       ? QString()
+                       : QStringLiteral("histogram rows do not match");
+        });
+        // One property pair per diff, equal in value but spelled apart, so
+        // every pair goes through both number parses.
+        QStringList layoutValues;
+        QStringList schematicValues;
+        for (qsizetype i = 0; i < allDiffs.size(); ++i) {
+            layoutValues.append(QStringLiteral("%1.5u").arg(i));
+            schematicValues.append(QStringLiteral("%1500n").arg(i));
+        }
+        measure(QStringLiteral("property_tolerances"), [&] {
+            const PropertyTolerances tolerances;
+            const QString parameter = QStringLiteral("w");
+            for (qsizetype i = 0; i < layoutValues.size(); ++i) {
+                if (!tolerances.matches(parameter, layoutValues.at(i),
+                                        schematicValues.at(i))) {
+                    return QStringLiteral("values do not match");
+                }
+            }
+            return QString();
+        });
+        // A flattened netlist with one subcircuit call per diff, split over
+        // a continuation line, written once outside the measured scan.
+        QTemporaryDir netlistDir;
+        const QString netlist = netlistDir.filePath(QStringLiteral("flat.sp"));
+        {
+            QFile file(netlist);
+            if (file.open(QIODevice::WriteOnly)) {
+                QTextStream out(&file);
+                out << ".subckt inv a y vdd gnd\n"
+                       "M1 y a vdd vdd pfet w=2u\n"
+                       "M2 y a gnd gnd nfet w=1u\n"
+                       ".ends\n";
+                for (qsizetype i = 0; i < allDiffs.size(); ++i) {
+                    out << 'x' << i << " n" << i << " n" << i + 1
+                        << "\n+ vdd gnd inv w=1u\n";
+                }
+            }
+        }
+        measure(QStringLiteral("spice_index"), [&] {
+            SpiceIndex index;
+            QString error;
+            if (!index.build(netlist, &error)) {
+                return error;
+            }
+            return index.count(SpiceIndex::Kind::Instance) ==
+                           allDiffs.size() + 2
+                       ? QString()
+                       : QStringLiteral("instances missing");
+        });
+        // The same number of inverters in chains of 16, compared with
+        // itself: refinement takes rounds in proportion to chain length.
+        const QString chains = netlistDir.filePath(QStringLiteral("chains.sp"));
+        {
+            QFile file(chains);
+            if (file.open(QIODevice::WriteOnly)) {
+                QTextStream out(&file);
+                out << ".subckt inv a y vdd gnd\n"
+                       "M1 y a vdd vdd pfet w=2u\n"
+                       "M2 y a gnd gnd nfet w=1u\n"
+                       ".ends\n";
+                for (qsizetype i = 0; i < allDiffs.size(); ++i) {
+                    out << 'x' << i << " c" << i / 16 << '_' << i % 16
+                        << " c" << i / 16 << '_' << i % 16 + 1
+                        << " vdd gnd inv\n";
+                }
+                out << ".global vdd gnd\n";
+            }
+        }
+        measure(QStringLiteral("netlist_compare"), [&] {
+            QString error;
+            const QJsonArray circuits =
+                NetlistComparator::compareFiles(chains, chains, {}, &error);
+            if (circuits.isEmpty()) {
+                return error;
+            }
+            const QJsonObject top = circuits.last().toObject();
+            return top.value(QStringLiteral("badnets")).toArray().isEmpty()
+                       ? QString()
+                       : QStringLiteral("netlist compared unequal");
+        });
+        // The chains again, one subcircuit each, and a copy with one chain
+        // changed: against the records of a full run, only that chain and
+        // the top are compared.
+        auto writeBlocks = [&](const QString &path, bool changed) {
+            QFile file(path);
+            if (!file.open(QIODevice::WriteOnly)) {
+                return;
+            }
+            QTextStream out(&file);
+            out << ".subckt inv a y vdd gnd\n"
+                   "M1 y a vdd vdd pfet w=2u\n"
+                   "M2 y a gnd gnd nfet w=1u\n"
+                   ".ends\n";
+            const qsizetype blocks = (allDiffs.size() + 15) / 16;
+            for (qsizetype b = 0; b < blocks; ++b) {
+                out << ".subckt chain" << b << " a y vdd gnd\n";
+                for (int i = 0; i < 16; ++i) {
+                    out << 'x' << i << " n" << i << " n" << i + 1
+                        << " vdd gnd inv\n";
+                }
+                out << "R1 a n0 1\nR2 n16 y 1\n";
+                if (changed && b == blocks / 2) {
+                    out << "C1 n8 gnd 1f\n";
+                }
+                out << ".ends\n";
+                out << 'x' << b << " c" << b << " c" << b + 1
+                    << " vdd gnd chain" << b << '\n';
+            }
+            out << ".global vdd gnd\n";
+        };
+        const QString blocks = netlistDir.filePath(QStringLiteral("blocks.sp"));
+        const QString edited = netlistDir.filePath(QStringLiteral("edit.sp"));
+        writeBlocks(blocks, false);
+        writeBlocks(edited, true);
+        NetlistComparator::Records previous;
+        NetlistComparator::Options full;
+        full.records = &previous;
+        NetlistComparator::compareFiles(blocks, blocks, full);
+        measure(QStringLiteral("netlist_compare_incremental"), [&] {
+            NetlistComparator::Records records;
+            NetlistComparator::Options options;
+            options.previous = &previous;
+            options.records = &records;
+            QString error;
+            if (NetlistComparator::compareFiles(edited, blocks, options,
+                                                &error)
+                    .isEmpty()) {
+                return error;
+            }
+            return records.reusedCount() == records.cells.size() - 2
+                       ? QString()
+                       : QStringLiteral("unchanged chains compared again");
+        });
+        commit(report.circuits.size(), allDiffs.size());
+    }
+
+    void add(const Result &result) { results_.append(toJson(result)); }
+
+    auto results() const -> const QJsonArray & { return results_; }
+
+  private:
+    static auto parseStream(const QString &path) -> Report {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            Report report;
+            report.error = QStringLiteral("Failed to open file: %1").arg(path);
+            return report;
+        }
+        NetgenJsonStreamParser stream;
+        while (!stream.hasError()) {
+            const QByteArray chunk = file.read(streamChunk);
+            if (chunk.isEmpty()) {
+                break;
+            }
+            stream.feed(chunk);
+        }
+        return stream.finish();
+    }
+
+    // fn returns an error message, empty on success; a failing benchmark
+    // is recorded once and not repeated. reset runs untimed after each run.
+    void measure(const QString &name, const std::function<QString()> &fn,
+                 const std::function<void()> &reset = {}) {
+        if (!only_.match(name).hasMatch()) {
+            return;
+        }
+        Result result{name, label_, bytes_, 0, 0, {}, {}};
+        QElapsedTimer timer;
+        for (int i = 0; i < repeat_ && result.error.isEmpty(); ++i) {
+            timer.start();
+            result.error = fn();
+            result.ms.push_back(timer.nsecsElapsed() / 1e6);
+            if (reset) {
+                reset();
+            }
+        }
+        const double best = *std::min_element(result.ms.cbegin(),
+                                               result.ms.cend());
+        log_ << "  " << name.leftJustified(24) << ' '
+             << QString::number(best, 'f', 2) << " ms";
+        if (!result.error.isEmpty()) {
+            log_ << " (" << result.error << ')';
+        }
+        log_ << '\n';
+        log_.flush();
+        pending_.push_back(std::move(result));
+    }
+
+    // Circuit and diff counts are only known once a parse succeeded.
+    void commit(long long circuits, long long diffs) {
+        for (Result &result : pending_) {
+            result.circuits = circuits;
+            result.diffs = diffs;
+            add(result);
+        }
+        pending_.clear();
+    }
+
+    QTextStream &log_;
+    QRegularExpression only_;
+    int repeat_;
+    QString label_;
+    qint64 bytes_{0};
+    QVector<Result> pending_; // results of the current size
+    QJsonArray results_;
+};
+} // namespace
+
+auto main(int argc, char *argv[]) -> int {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("opensvs_bench"));
+    QCoreApplication::setApplicationVersion(
+        QStringLiteral(OPENSVS_VERSION_STRING));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+        "OpenSVS benchmarks on synthetic netgen JSON reports. Results are "
+        "written as JSON; progress goes to standard error."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const SyntheticReport::Knobs defaults;
+    const auto knob = [](const char *name, const char *help, int value) {
+        return QCommandLineOption(QString::fromLatin1(name),
+                                  QStringLiteral("%1 (default %2).")
+                                      .arg(QString::fromLatin1(help))
+                                      .arg(value),
+                                  QStringLiteral("n"), QString::number(value));
+    };
+    const QCommandLineOption sizesOption(
+        QStringLiteral("sizes"),
+        QStringLiteral("Comma-separated report sizes such as 1M,64M,1G, or "
+                       "\"full\" for %1 (default %2).")
+            .arg(QString::fromLatin1(fullSizes),
+                 QString::fromLatin1(defaultSizes)),
+        QStringLiteral("list"), QString::fromLatin1(defaultSizes));
+    const QCommandLineOption repeatOption(
+        QStringLiteral("repeat"),
+        QStringLiteral("Runs per benchmark; min and median are reported "
+                       "(default 3)."),
+        QStringLiteral("n"), QStringLiteral("3"));
+    const QCommandLineOption onlyOption(
+        QStringLiteral("only"),
+        QStringLiteral("Only benchmarks whose name matches this regex."),
+        QStringLiteral("pattern"));
+    const QCommandLineOption outputOption(
+        QStringLiteral("output"),
+        QStringLiteral("Write the JSON results here instead of stdout."),
+        QStringLiteral("file"));
+    const QCommandLineOption workDirOption(
+        QStringLiteral("work-dir"),
+        QStringLiteral("Where generated reports are kept and reused "
+                       "(default: <temp>/opensvs-bench)."),
+        QStringLiteral("dir"));
+    const QCommandLineOption generateOption(
+        QStringLiteral("generate"),
+        QStringLiteral("Only write one report of the first size to file."),
+        QStringLiteral("file"));
+    const QCommandLineOption circuitsOption = knob(
+        "circuits", "Leaf cells when no size is given", defaults.circuits);
+    const QCommandLineOption depthOption =
+        knob("depth", "Hierarchy levels", defaults.depth);
+    const QCommandLineOption fanoutOption =
+        knob("fanout", "Child cells per parent", defaults.fanout);
+    const QCommandLineOption badnetsOption =
+        knob("badnets", "Bad nets per circuit", defaults.badnets);
+    const QCommandLineOption pinsOption =
+        knob("pins", "Pins per net", defaults.pinsPerNet);
+    const QCommandLineOption propertiesOption =
+        knob("properties", "Property mismatches per circuit",
+             defaults.propertyMismatches);
+    const QCommandLineOption nameLengthOption =
+        knob("name-length", "Minimum name length", defaults.nameLength);
+    const QCommandLineOption seedOption =
+        knob("seed", "Generator seed", static_cast<int>(defaults.seed));
+    parser.addOptions({sizesOption, repeatOption, onlyOption, outputOption,
+                       workDirOption, generateOption, circuitsOption,
+                       depthOption, fanoutOption, badnetsOption, pinsOption,
+                       propertiesOption, nameLengthOption, seedOption});
+    parser.process(app);
+
+    QTextStream log(stderr);
+    SyntheticReport::Knobs knobs;
+    knobs.circuits = parser.value(circuitsOption).toInt();
+    knobs.depth = parser.value(depthOption).toInt();
+    knobs.fanout = parser.value(fanoutOption).toInt();
+    knobs.badnets = parser.value(badnetsOption).toInt();
+    knobs.pinsPerNet = parser.value(pinsOption).toInt();
+    knobs.propertyMismatches = parser.value(propertiesOption).toInt();
+    knobs.nameLength = parser.value(nameLengthOption).toInt();
+    knobs.seed = parser.value(seedOption).toUInt();
+
+    QString sizeList = parser.value(sizesOption);
+    if (sizeList == QStringLiteral("full")) {
+        sizeList = QString::fromLatin1(fullSizes);
+    }
+    QVector<QPair<QString, qint64>> sizes;
+    for (const QString &label :
+         sizeList.split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+        bool ok = false;
+        const qint64 bytes = parseSize(label, &ok);
+        if (!ok) {
+            log << "Invalid size: " << label << '\n';
+            return 2;
+        }
+        sizes.push_back({label.trimmed(), bytes});
+    }
+
+    if (parser.isSet(generateOption)) {
+        // Without --sizes the report is sized by --circuits alone.
+        if (parser.isSet(sizesOption) && !sizes.isEmpty()) {
+            knobs.targetBytes = sizes.first().second;
+        }
+        QString error;
+        const auto stats = SyntheticReport::writeFile(
+            parser.value(generateOption), knobs, &error);
+        if (stats.bytes < 0) {
+            log << "Failed to write " << parser.value(generateOption) << ": "
+                << error << '\n';
+            return 2;
+        }
+        log << "Wrote " << stats.bytes << " bytes, " << stats.circuits
+            << " circuits, " << stats.diffs << " diffs\n";
+        return 0;
+    }
+
+    const QString workDir =
+        parser.isSet(workDirOption)
+            ? parser.value(workDirOption)
+            : QDir::temp().filePath(QStringLiteral("opensvs-bench"));
+    if (!QDir().mkpath(workDir)) {
+        log << "Cannot create " << workDir << '\n';
+        return 2;
+    }
+    const QRegularExpression only(parser.value(onlyOption));
+    if (!only.isValid()) {
+        log << "Invalid --only pattern: " << only.errorString() << '\n';
+        return 2;
+    }
+
+    Bench bench(log, only,
+                std::max(1, parser.value(repeatOption).toInt()));
+    for (const auto &[label, bytes] : sizes) {
+        knobs.targetBytes = bytes;
+        const QString path = QDir(workDir).filePath(
+            QStringLiteral("synthetic-%1.json")
+                .arg(SyntheticReport::cacheKey(knobs)));
+        log << label << ": " << QDir::toNativeSeparators(path) << '\n';
+        if (!QFileInfo::exists(path)) {
+            QElapsedTimer timer;
+            timer.start();
+            QString error;
+            const auto stats = SyntheticReport::writeFile(path, knobs, &error);
+            Result generated{QStringLiteral("generate"), label, stats.bytes,
+                             stats.circuits, stats.diffs,
+                             {timer.nsecsElapsed() / 1e6}, error};
+            bench.add(generated);
+            if (stats.bytes < 0) {
+                log << "  failed to generate: " << error << '\n';
+                continue;
+            }
+        }
+        bench.run(label, path);
+    }
+
+    const QJsonObject knobsJson{
+        {QStringLiteral("depth"), knobs.depth},
+        {QStringLiteral("fanout"), knobs.fanout},
+        {QStringLiteral("badnets"), knobs.badnets},
+        {QStringLiteral("pins_per_net"), knobs.pinsPerNet},
+        {QStringLiteral("property_mismatches"), knobs.propertyMismatches},
+        {QStringLiteral("name_length"), knobs.nameLength},
+        {QStringLiteral("seed"), static_cast<qint64>(knobs.seed)},
+        {QStringLiteral("generator_version"),
+         SyntheticReport::generatorVersion},
+    };
+    const QJsonObject doc{
+        {QStringLiteral("schema"), 1},
+        {QStringLiteral("opensvs_version"),
+         QCoreApplication::applicationVersion()},
+        {QStringLiteral("qt_version"), QString::fromLatin1(qVersion())},
+        {QStringLiteral("build_type"),
+         QStringLiteral(OPENSVS_BENCH_BUILD_TYPE)},
+        {QStringLiteral("date"),
+         QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {QStringLiteral("knobs"), knobsJson},
+        {QStringLiteral("results"), bench.results()},
+    };
+    const QByteArray json = QJsonDocument(doc).toJson();
+    if (parser.isSet(outputOption)) {
+        QFile out(parser.value(outputOption));
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+            out.write(json) != json.size()) {
+            log << "Failed to write " << parser.value(outputOption) << '\n';
+            return 2;
+        }
+    } else {
+        QTextStream(stdout) << json;
+    }
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include "SyntheticReport.hpp"
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QVector>
+#include <algorithm>
+
+namespace {
+const qsizetype flushBytes = 1024 * 1024;
+const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+const char *const pinNames[] = {"d", "g", "s", "b"};
+
+class Writer {
+  public:
+    Writer(QIODevice &out, const SyntheticReport::Knobs &knobs)
+        : out_(out), knobs_(knobs), rng_(knobs.seed) {
+        knobs_.depth = std::max(knobs_.depth, 1);
+        knobs_.fanout = std::max(knobs_.fanout, 2);
+        knobs_.badnets = std::max(knobs_.badnets, 0);
+        knobs_.pinsPerNet = std::max(knobs_.pinsPerNet, 1);
+        knobs_.propertyMismatches = std::max(knobs_.propertyMismatches, 0);
+    }
+
+    auto run() -> SyntheticReport::Stats {
+        buf_ += '[';
+        // netgen lists cells bottom-up: leaves first, the top cell last.
+        QVector<QByteArray> level;
+        while (knobs_.targetBytes > 0
+                   ? !reachesTarget(level.size())
+                   : level.size() < knobs_.circuits) {
+            level.push_back(name("cell", level.size()));
+            circuit(level.constLast(), {});
+        }
+        for (int d = 1; d < knobs_.depth && level.size() > 1; ++d) {
+            const QByteArray prefix = "blk" + QByteArray::number(d) + '_';
+            QVector<QByteArray> parents;
+            for (qsizetype i = 0; i < level.size(); i += knobs_.fanout) {
+                parents.push_back(name(prefix, parents.size()));
+                circuit(parents.constLast(), level.mid(i, knobs_.fanout));
+            }
+            level = std::move(parents);
+        }
+        buf_ += "\n]\n";
+        flush(true);
+        return stats_;
+    }
+
+    auto failed() const -> bool { return failed_; }
+
+  private:
+    // Unique prefix+index, padded with seeded noise up to nameLength.
+    auto name(const QByteArray &prefix, qsizetype index) -> QByteArray {
+        QByteArray n = prefix + QByteArray::number(index);
+        if (n.size() < knobs_.nameLength) {
+            n += '_';
+        }
+        while (n.size() < knobs_.nameLength) {
+            n += alphabet[rng_.bounded(int(sizeof(alphabet) - 1))];
+        }
+        return n;
+    }
+
+    // Leaves are added until the written bytes plus the estimated size of
+    // the parent levels above them reach the target.
+    auto reachesTarget(qsizetype leaves) const -> bool {
+        if (leaves == 0) {
+            return false;
+        }
+        const qint64 written = stats_.bytes + buf_.size();
+        qint64 parents = 0;
+        qint64 n = leaves;
+        for (int d = 1; d < knobs_.depth && n > 1; ++d) {
+            n = (n + knobs_.fanout - 1) / knobs_.fanout;
+            parents += n;
+        }
+        return written + written / leaves * parents >= knobs_.targetBytes;
+    }
+
+    void circuit(const QByteArray &cell, const QVector<QByteArray> &children) {
+        if (stats_.circuits > 0) {
+            buf_ += ',';
+        }
+        buf_ += "\n{\"name\": [\"" + cell + "\", \"" + cell + "\"]";
+
+        QByteArray devices = "[[\"nfet\", " +
+                             QByteArray::number(1 + rng_.bounded(64)) +
+                             "], [\"pfet\", " +
+                             QByteArray::number(1 + rng_.bounded(64)) + ']';
+        for (const QByteArray &child : children) {
+            devices += ", [\"" + child + "\", 1]";
+        }
+        devices += ']';
+        buf_ += ", \"devices\": [" + devices + ", " + devices + ']';
+
+        const QByteArray nets =
+            QByteArray::number(knobs_.badnets + 16 + rng_.bounded(256));
+        buf_ += ", \"nets\": [" + nets + ", " + nets + ']';
+
+        // One [[layout nets], [schematic nets]] group per bad net. Every
+        // fourth net is missing on the schematic side; the others differ
+        // in the count of their last pin.
+        buf_ += ", \"badnets\": [";
+        for (int j = 0; j < knobs_.badnets; ++j) {
+            const QByteArray net = name("net", j);
+            QByteArray pinsA;
+            QByteArray pinsB;
+            for (int k = 0; k < knobs_.pinsPerNet; ++k) {
+                QByteArray dev = k % 2 == 0 ? "nfet" : "pfet";
+                if (k >= 8) {
+                    dev += QByteArray::number(k / 8);
+                }
+                const int count = 1 + rng_.bounded(8);
+                const bool last = k == knobs_.pinsPerNet - 1;
+                const QByteArray pin =
+                    "[\"" + dev + "\", \"" + pinNames[(k / 2) % 4] + "\", ";
+                const QByteArray sep = k > 0 ? ", " : "";
+                pinsA += sep + pin + QByteArray::number(count) + ']';
+                pinsB += sep + pin + QByteArray::number(count + int(last)) +
+                         ']';
+            }
+            buf_ += j > 0 ? ", " : "";
+            buf_ += "[[[\"" + net + "\", [" + pinsA + "]]], ";
+            if (j % 4 == 3) {
+                buf_ += "[[\"(no matching net)\", []]]]";
+            } else {
+                buf_ += "[[\"" + net + "\", [" + pinsB + "]]]]";
+            }
+        }
+        buf_ += ']';
+
+        buf_ += ", \"properties\": [";
+        for (int m = 0; m < knobs_.propertyMismatches; ++m) {
+            const QByteArray dev = cell + "/nfet:" + QByteArray::number(m);
+            const int width = 10 + rng_.bounded(90);
+            const QByteArray length =
+                "[\"l\", \"" + QByteArray::number(1 + rng_.bounded(9)) +
+                "e-7\"]";
+            buf_ += m > 0 ? ", " : "";
+            buf_ += "[[\"" + dev + "\", [[\"w\", \"" +
+                    QByteArray::number(width) + "e-7\"], " + length +
+                    "]], [\"" + dev + "\", [[\"w\", \"" +
+                    QByteArray::number(width + 1) + "e-7\"], " + length +
+                    "]]]";
+        }
+        buf_ += "]}";
+
+        ++stats_.circuits;
+        stats_.diffs += knobs_.badnets + knobs_.propertyMismatches;
+        flush(false);
+    }
+
+    void flush(bool force) {
+        if (failed_ || (!force && buf_.size() < flushBytes)) {
+            return;
+        }
+        if (out_.write(buf_) != buf_.size()) {
+            failed_ = true;
+        }
+        stats_.bytes += buf_.size();
+        buf_.clear();
+    }
+
+    QIODevice &out_;
+    SyntheticReport::Knobs knobs_;
+    QRandomGenerator rng_;
+    QByteArray buf_;
+    SyntheticReport::Stats stats_;
+    bool failed_{false};
+};
+} // namespace
+
+auto SyntheticReport::write(QIODevice &out, const Knobs &knobs) -> Stats {
+    Writer writer(out, knobs);
+    Stats stats = writer.run();
+    if (writer.failed()) {
+        stats.bytes = -1;
+    }
+    return stats;
+}
+
+auto SyntheticReport::writeFile(const QString &path, const Knobs &knobs,
+                                QString *error) -> Stats {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error != nullptr) {
+            *error = file.errorString();
+        }
+        return Stats{-1, 0, 0};
+    }
+    Stats stats = write(file, knobs);
+    if (stats.bytes < 0 || !file.commit()) {
+        if (error != nullptr) {
+            *error = file.errorString();
+        }
+        stats.bytes = -1;
+    }
+    return stats;
+}
+
+auto SyntheticReport::cacheKey(const Knobs &knobs) -> QString {
+    return QStringLiteral("v%1-c%2-d%3-f%4-b%5-p%6-m%7-n%8-s%9-t%10")
+        .arg(generatorVersion)
+        .arg(knobs.circuits)
+        .arg(knobs.depth)
+        .arg(knobs.fanout)
+        .arg(knobs.badnets)
+        .arg(knobs.pinsPerNet)
+        .arg(knobs.propertyMismatches)
+        .arg(knobs.nameLength)
+        .arg(knobs.seed)
+        .arg(knobs.targetBytes);
+}
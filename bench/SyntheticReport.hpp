@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+class QIODevice;
+
+// Deterministic generator for netgen-shaped LVS JSON. The same knobs always
+// produce the same bytes, so a file can be regenerated instead of shipped
+// and benchmark numbers stay comparable between releases. Output is
+// streamed, which keeps multi-gigabyte reports out of memory.
+class SyntheticReport {
+  public:
+    struct Knobs {
+        int circuits = 64; // leaf cells; ignored when targetBytes is set
+        int depth = 3;     // hierarchy levels, leaves included
+        int fanout = 4;    // child cells instantiated per parent
+        int badnets = 8;   // mismatching nets per circuit
+        int pinsPerNet = 4;
+        int propertyMismatches = 2; // per circuit
+        int nameLength = 12;        // minimum length of cell and net names
+        quint32 seed = 1;
+        // Approximate report size; leaf cells are added until it is
+        // reached.
+        qint64 targetBytes = 0;
+    };
+
+    struct Stats {
+        qint64 bytes = 0;
+        long long circuits = 0;
+        long long diffs = 0; // what NetgenJsonParser reports for the file
+    };
+
+    static auto write(QIODevice &out, const Knobs &knobs) -> Stats;
+    static auto writeFile(const QString &path, const Knobs &knobs,
+                          QString *error = nullptr) -> Stats;
+    // Stable file-name-safe key of the knobs and the generator version.
+    static auto cacheKey(const Knobs &knobs) -> QString;
+
+    // Bumped whenever the output for the same knobs changes.
+    static constexpr int generatorVersion = 1;
+};
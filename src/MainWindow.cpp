@@ -2,39 +2,72 @@
 
 #include <QAbstractItemView>
 #include <QAction>
+#include <QCheckBox>
 #include <QComboBox>
 #include <QCoreApplication>
+#include <QCryptographicHash>
 #include <QDateTime>
 #include <QDialogButtonBox>
 #include <QDir>
 #include <QDockWidget>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileDialog>
+#include <QFileSystemWatcher>
+#include <QFontDatabase>
 #include <QFormLayout>
 #include <QGridLayout>
 #include <QHBoxLayout>
 #include <QHeaderView>
+#include <QInputDialog>
+#include <QJsonDocument>
 #include <QLabel>
 #include <QLineEdit>
+#include <QLocale>
 #include <QMenuBar>
 #include <QMessageBox>
 #include <QPlainTextEdit>
-#include <QProcess>
 #include <QPushButton>
+#include <QRegularExpression>
 #include <QSet>
+#include <QSpinBox>
 #include <QStackedWidget>
 #include <QStandardPaths>
 #include <QStatusBar>
+#include <QTabBar>
+#include <QTabWidget>
 #include <QTableView>
+#include <QTextBlock>
 #include <QTextStream>
+#include <QTimer>
 #include <QTreeView>
+#include <QTreeWidget>
 #include <QVBoxLayout>
-
+#include <algorithm>
+#include <utility>
+
+#include "diagnostics/MemoryBudget.hpp"
+#include "diagnostics/MemoryReport.hpp"
+#include "diagnostics/Tracer.hpp"
+#include "ipc/QueryServer.hpp"
+#include "lvs/DetachedThread.hpp"
+#include "lvs/LvsJobQueue.hpp"
+#include "lvs/LvsResultCache.hpp"
+#include "lvs/LvsRunner.hpp"
 #include "models/CircuitTreeModel.hpp"
+#include "models/DiffClusterModel.hpp"
+#include "models/DiffDelta.hpp"
 #include "models/DiffEntryCommon.hpp"
+#include "models/DiffEntryDelegate.hpp"
 #include "models/DiffEntryModel.hpp"
+#include "models/DiffFilter.hpp"
 #include "models/DiffFilterProxyModel.hpp"
+#include "models/LvsJobModel.hpp"
+#include "models/WaiverSet.hpp"
 #include "parsers/NetgenJsonParser.hpp"
+#include "parsers/NetgenJsonStreamParser.hpp"
+#include "parsers/NetlistComparator.hpp"
+#include "parsers/SpiceIndex.hpp"
 
 namespace QtConfig {
 const auto dockStyle =
@@ -50,17 +83,23 @@ const int verticalSpacing = 8;
 const int contentMargin = 8;
 const int contentSpacing = 8;
 const int timeout = 5000;
+const int lvsTickMs = 1000;
+const int lvsMaxConcurrency = 256;
+const int lvsStreamRefreshMs = 250;
+const int perfRefreshMs = 500;
+const int perfMaxRows = 20000;
+const int sourceContextLines = 40; // shown above and below a definition
+const qint64 mebibyte = 1024 * 1024;
+const int maxBudgetMiB = 1 << 24; // 16 TiB
 } // namespace QtConfig
 
-MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), diffModel_(new DiffEntryModel(this)),
-      proxyModel_(new DiffFilterProxyModel(this)),
-      circuitTreeModel_(new CircuitTreeModel(this)) {
+MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     setWindowTitle(tr("OpenSVS"));
     setMinimumSize(QtConfig::windowW, QtConfig::windowH);
     loadRecentFiles();
     buildUi();
     buildMenus();
+    activateTab(tabIndex(addTab()));
     ensureLvsDock();
     if (lvsDock_ != nullptr) {
         lvsDock_->show();
@@ -71,8 +110,32 @@ MainWindow::MainWindow(QWidget *parent)
 }
 
 auto MainWindow::loadFile(const QString &path, bool showError) -> bool {
-    NetgenJsonParser parser;
-    auto report = NetgenJsonParser::parseFile(path);
+    Tracer::Span span("MainWindow::loadFile", "ui");
+    span.setDetail(path);
+    const qint64 fileSize = QFileInfo(path).size();
+    MemoryBudget budget;
+    // Other tabs count against the budget; a reload frees its own tab.
+    qint64 inUse = memoryReport().total();
+    for (const auto &open : tabs_) {
+        if (open->source == path) {
+            inUse -= memoryReport(open.get()).total();
+        }
+    }
+    inUse = std::max<qint64>(0, inUse);
+    auto details = NetgenJsonParser::Details::Resident;
+    if (budget.exceeds(fileSize, inUse)) {
+        const QLocale locale;
+        logEvent(tr("Loading %1 is projected to need %2 of memory, above the "
+                    "budget of %3 with %4 held by open reports; details are "
+                    "read from the file on demand.")
+                     .arg(path,
+                          locale.formattedDataSize(budget.project(fileSize)),
+                          locale.formattedDataSize(budget.budgetBytes()),
+                          locale.formattedDataSize(inUse)));
+        details = NetgenJsonParser::Details::OnDemand;
+    }
+
+    auto report = NetgenJsonParser::parseFile(path, details, tolerances_);
     if (!report.ok) {
         if (showError) {
             QMessageBox::critical(this, tr("Failed to load"), report.error);
@@ -80,49 +143,433 @@ auto MainWindow::loadFile(const QString &path, bool showError) -> bool {
         return false;
     }
 
-    circuits_ = std::move(report.circuits);
-    circuitTreeModel_->setCircuits(&circuits_);
-    if ((circuitTree_ != nullptr) && circuitTreeModel_->rowCount() > 0) {
-        const QModelIndex rootIndex = circuitTreeModel_->index(0, 0);
-        circuitTree_->setCurrentIndex(rootIndex);
-        applyCircuitFilter(rootIndex);
+    ReportTab &tab = tabForLoad(path);
+    tab.fileSize = fileSize;
+    showReport(tab, std::move(report), path);
+    addRecentFile(path);
+
+    const qint64 resident = memoryReport(&tab).total();
+    // The ratio projects full loads; an on-demand load would skew it.
+    if (!tab.detailCache) {
+        budget.recordLoad(fileSize, resident);
+    }
+    logEvent(tr("Report memory: %1 for %2 of JSON")
+                 .arg(QLocale().formattedDataSize(resident),
+                      QLocale().formattedDataSize(fileSize)));
+    refreshMemoryView();
+    return true;
+}
+
+void MainWindow::showReport(ReportTab &tab,
+                            NetgenJsonParser::Report &&report,
+                            const QString &source) {
+    OPENSVS_TRACE_SCOPE("MainWindow::showReport", "ui");
+    stringPool_.intern(report.circuits);
+    tab.circuits = std::move(report.circuits);
+    tab.detailCache = std::move(report.detailCache);
+    tab.diffModel->setDetailSource(tab.detailCache);
+    tab.masters = DiffMasters::build(tab.circuits);
+    tab.diffModel->setMasters(&tab.masters);
+    applyUniqueMasters(tab);
+    tab.treeModel->setCircuits(&tab.circuits);
+    tab.treeCurrent = QPersistentModelIndex();
+    if (tab.treeModel->rowCount() > 0) {
+        const QModelIndex rootIndex = tab.treeModel->index(0, 0);
+        tab.treeCurrent = rootIndex;
+        tab.proxyModel->setAllowedCircuits(allowedCircuits(tab, rootIndex));
     } else {
-        proxyModel_->setAllowedCircuits({});
+        tab.proxyModel->setAllowedCircuits({});
     }
 
     QVector<NetgenJsonParser::DiffEntry> allDiffs;
-    for (const auto &cir : circuits_) {
+    for (const auto &cir : tab.circuits) {
         allDiffs += cir.diffs;
     }
 
-    diffModel_->setDiffs(allDiffs);
-    proxyModel_->invalidate();
-    setSummary(report.summary.deviceMismatches, report.summary.netMismatches,
-               report.summary.shorts, report.summary.opens,
-               report.summary.totalDevices, report.summary.totalNets,
-               report.summary.layoutCell, report.summary.schematicCell);
-    const QString msg =
-        tr("Loaded %1 diffs from %2").arg(allDiffs.size()).arg(path);
+    tab.diffModel->setDiffs(allDiffs);
+    // A reloaded report is no longer the one that was compared.
+    tab.baseline.clear();
+    tab.deltaText = tr("All");
+    tab.proxyModel->setDeltaFilter({});
+    {
+        OPENSVS_TRACE_SCOPE("DiffFilterProxyModel::invalidate", "filter");
+        tab.proxyModel->invalidate();
+    }
+    tab.summary = report.summary;
+    tab.source = source;
+    refreshTabTitle(tab);
+    activateTab(tabIndex(tab));
+    QString msg =
+        tr("Loaded %1 diffs from %2").arg(allDiffs.size()).arg(source);
+    if (tab.detailCache) {
+        msg += tr(" (details read on demand)");
+    }
+    if (tab.masters.occurrenceCount() != allDiffs.size()) {
+        msg += tr("; %1 unique in %2 masters, %3 across instances")
+                   .arg(tab.masters.uniqueDiffCount())
+                   .arg(tab.masters.masters().size())
+                   .arg(tab.masters.occurrenceCount());
+    }
     showStatus(msg);
     logEvent(msg);
+    // eventFilter closes this with the table's next paint.
+    firstPaintStartNs_ = Tracer::isEnabled() ? Tracer::now() : -1;
+}
+
+auto MainWindow::eventFilter(QObject *watched, QEvent *event) -> bool {
+    if (firstPaintStartNs_ < 0 || event->type() != QEvent::Paint ||
+        diffTable_ == nullptr || watched != diffTable_->viewport()) {
+        return QMainWindow::eventFilter(watched, event);
+    }
+    // Deliver the paint from here so that it can be timed; the nested
+    // call passes this filter because firstPaintStartNs_ is reset.
+    const qint64 paintStart = Tracer::now();
+    Tracer::record("wait for first table paint", "ui",
+                   std::exchange(firstPaintStartNs_, -1), paintStart);
+    QCoreApplication::sendEvent(watched, event);
+    Tracer::record("first table paint", "ui", paintStart, Tracer::now());
+    return true;
+}
+
+auto MainWindow::addTab() -> ReportTab & {
+    auto tab = std::make_unique<ReportTab>();
+    tab->diffModel = new DiffEntryModel(this);
+    tab->proxyModel = new DiffFilterProxyModel(this);
+    tab->proxyModel->setSourceModel(tab->diffModel);
+    tab->treeModel = new CircuitTreeModel(this);
+    tab->diffModel->setWaivers(waivers_);
+    tab->proxyModel->setHideWaived(hideWaived_->isChecked());
+    tab->diffModel->setMasters(&tab->masters);
+    tab->typeText = tr("All");
+    tab->deltaText = tr("All");
+    DiffFilterProxyModel *proxy = tab->proxyModel;
+    auto regroup = [this, proxy]() {
+        if (tab_ != nullptr && tab_->proxyModel == proxy &&
+            groupSimilar_->isChecked()) {
+            clusterTimer_->start();
+        }
+    };
+    connect(proxy, &QAbstractItemModel::modelReset, this, regroup);
+    connect(proxy, &QAbstractItemModel::layoutChanged, this, regroup);
+    connect(proxy, &QAbstractItemModel::rowsInserted, this, regroup);
+    connect(proxy, &QAbstractItemModel::rowsRemoved, this, regroup);
+    tabs_.push_back(std::move(tab));
+    {
+        const QSignalBlocker blocker(tabBar_);
+        tabBar_->addTab(tr("No report"));
+    }
+    return *tabs_.back();
+}
 
-    // Track recent files
+auto MainWindow::tabForLoad(const QString &path) -> ReportTab & {
     if (!path.isEmpty()) {
-        recentFiles_.removeAll(path);
-        recentFiles_.prepend(path);
-        const int maxRecent = 10;
-        while (recentFiles_.size() > maxRecent) {
-            recentFiles_.removeLast();
+        for (const auto &tab : tabs_) {
+            if (tab->source == path) {
+                return *tab;
+            }
         }
-        rebuildRecentFilesMenu();
-        saveRecentFiles();
     }
-    if ((stack_ != nullptr) && (contentPage_ != nullptr)) {
-        stack_->setCurrentWidget(contentPage_);
+    if (tab_ != nullptr && tab_->source.isEmpty()) {
+        return *tab_;
+    }
+    return addTab();
+}
+
+auto MainWindow::tabIndex(const ReportTab &tab) const -> int {
+    for (std::size_t i = 0; i < tabs_.size(); ++i) {
+        if (tabs_[i].get() == &tab) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void MainWindow::refreshTabTitle(const ReportTab &tab) {
+    // Corners usually differ in their directory, not in the file name.
+    const QFileInfo info(tab.source);
+    QString title = tab.source;
+    if (tab.source.isEmpty()) {
+        title = tr("No report");
+    } else if (info.exists()) {
+        title = info.dir().dirName() + QLatin1Char('/') + info.fileName();
+    }
+    const int index = tabIndex(tab);
+    tabBar_->setTabText(index, title);
+    tabBar_->setTabToolTip(index, tab.source);
+}
+
+void MainWindow::activateTab(int index) {
+    if (index < 0 || index >= static_cast<int>(tabs_.size())) {
+        return;
+    }
+    OPENSVS_TRACE_SCOPE("MainWindow::activateTab", "ui");
+    tab_ = tabs_[index].get();
+    {
+        const QSignalBlocker blocker(tabBar_);
+        tabBar_->setCurrentIndex(index);
+    }
+    // Each tab keeps its models, so this only rebinds the views. setModel
+    // leaves the previous selection models to be deleted here.
+    QItemSelectionModel *oldSelection = diffTable_->selectionModel();
+    diffTable_->setModel(tab_->proxyModel);
+    delete oldSelection;
+    diffTable_->setColumnWidth(DiffEntryColumns::SUBTYPE, QtConfig::columnW);
+    oldSelection = circuitTree_->selectionModel();
+    circuitTree_->setModel(tab_->treeModel);
+    delete oldSelection;
+    // The proxy already filters for this circuit; restore it before
+    // listening so that it is not filtered again.
+    circuitTree_->setCurrentIndex(tab_->treeCurrent);
+    connect(circuitTree_->selectionModel(),
+            &QItemSelectionModel::currentChanged, this,
+            &MainWindow::applyCircuitFilter);
+    connect(diffTable_->selectionModel(), &QItemSelectionModel::currentChanged,
+            this, &MainWindow::showDiffSource);
+    {
+        const QSignalBlocker typeBlocker(typeFilter_);
+        const QSignalBlocker searchBlocker(searchField_);
+        const QSignalBlocker deltaBlocker(deltaFilter_);
+        typeFilter_->setCurrentText(tab_->typeText);
+        searchField_->setText(tab_->searchText);
+        deltaFilter_->setCurrentText(tab_->deltaText);
+    }
+    deltaFilter_->setEnabled(!tab_->baseline.isEmpty());
+    deltaFilter_->setToolTip(
+        tab_->baseline.isEmpty()
+            ? tr("Use File -> Compare With Baseline to compare two runs")
+            : tr("Compared with %1").arg(tab_->baseline));
+
+    refreshClusters();
+
+    const auto &sum = tab_->summary;
+    setSummary(sum.deviceMismatches, sum.netMismatches, sum.shorts, sum.opens,
+               sum.totalDevices, sum.totalNets, sum.layoutCell,
+               sum.schematicCell);
+    stack_->setCurrentWidget(tab_->source.isEmpty() ? welcomePage_
+                                                    : contentPage_);
+    publishSnapshot();
+    refreshMemoryView();
+}
+
+void MainWindow::closeTab(int index) {
+    if (index < 0 || index >= static_cast<int>(tabs_.size())) {
+        return;
+    }
+    // The window always has a tab; the last one closes into an empty one.
+    if (tabs_.size() == 1) {
+        addTab();
+    }
+    std::unique_ptr<ReportTab> closing = std::move(tabs_[index]);
+    tabs_.erase(tabs_.begin() + index);
+    {
+        const QSignalBlocker blocker(tabBar_);
+        tabBar_->removeTab(index);
+    }
+    if (closing.get() == lvsStreamTab_) {
+        lvsStreamTab_ = nullptr;
+        lvsStreamHeld_ = std::move(closing->circuits);
+    }
+    if (closing.get() == tab_) {
+        tab_ = nullptr;
+        activateTab(tabBar_->currentIndex());
+    }
+    if (!closing->source.isEmpty()) {
+        logEvent(tr("Closed %1").arg(closing->source));
+    }
+    delete closing->proxyModel;
+    delete closing->diffModel;
+    delete closing->treeModel;
+    closing.reset();
+    stringPool_.prune();
+    refreshMemoryView();
+}
+
+void MainWindow::chooseBaseline() {
+    if (tab_ == nullptr || tab_->circuits.isEmpty()) {
+        showStatus(tr("Open a report before comparing it."));
+        return;
+    }
+    QStringList open;
+    for (const auto &tab : tabs_) {
+        if (tab.get() != tab_ && !tab->circuits.isEmpty()) {
+            open.append(tab->source);
+        }
+    }
+    const QString other = tr("Other file...");
+    QString path = other;
+    if (!open.isEmpty()) {
+        bool ok = false;
+        path = QInputDialog::getItem(this, tr("Compare With Baseline"),
+                                     tr("Baseline report:"),
+                                     open + QStringList{other}, 0, false,
+                                     &ok);
+        if (!ok) {
+            return;
+        }
+    }
+    if (path == other) {
+        path = QFileDialog::getOpenFileName(
+            this, tr("Open baseline netgen JSON report"),
+            QFileInfo(tab_->source).absolutePath(),
+            tr("JSON files (*.json);;All files (*)"));
+    }
+    if (!path.isEmpty()) {
+        compareWith(path);
+    }
+}
+
+auto MainWindow::compareWith(const QString &baselinePath) -> bool {
+    Tracer::Span span("MainWindow::compareWith", "ui");
+    span.setDetail(baselinePath);
+    ReportTab *current = tab_;
+    if (current == nullptr || current->circuits.isEmpty()) {
+        return false;
+    }
+    if (baselinePath == current->source) {
+        showStatus(tr("A report cannot be its own baseline."));
+        return false;
+    }
+    auto findTab = [this](const QString &path) -> ReportTab * {
+        for (const auto &tab : tabs_) {
+            if (tab->source == path) {
+                return tab.get();
+            }
+        }
+        return nullptr;
+    };
+    // The baseline stays open in its own tab, sharing strings with this one.
+    ReportTab *base = findTab(baselinePath);
+    if (base == nullptr) {
+        if (!loadFile(baselinePath, true)) {
+            return false;
+        }
+        base = findTab(baselinePath);
+        activateTab(tabIndex(*current));
+    }
+    if (base == nullptr) {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const DiffDelta::Result delta =
+        DiffDelta::compare(base->circuits, current->circuits,
+                           base->detailCache.get(),
+                           current->detailCache.get());
+    QVector<NetgenJsonParser::DiffEntry> rows;
+    rows.reserve(delta.current.size() + delta.fixed.size());
+    for (const auto &cir : current->circuits) {
+        rows += cir.diffs;
+    }
+    rows += delta.fixed;
+    QVector<DiffDelta::Status> statuses = delta.current;
+    statuses.insert(statuses.size(), delta.fixed.size(),
+                    DiffDelta::Status::Fixed);
+    current->diffModel->setDiffs(rows, statuses);
+    current->baseline = baselinePath;
+    current->proxyModel->invalidate();
+    activateTab(tabIndex(*current));
+
+    const QString msg =
+        tr("Compared with %1: %2 new, %3 fixed, %4 unchanged (%5 ms)")
+            .arg(baselinePath)
+            .arg(delta.newCount)
+            .arg(delta.fixed.size())
+            .arg(delta.unchangedCount)
+            .arg(timer.elapsed());
+    showStatus(msg);
+    logEvent(msg);
+    return true;
+}
+
+auto MainWindow::loadWaivers(const QString &path, bool showError)
+    -> bool {
+    Tracer::Span span("MainWindow::loadWaivers", "ui");
+    span.setDetail(path);
+    QElapsedTimer timer;
+    timer.start();
+    auto waivers = std::make_shared<WaiverSet>();
+    QString error;
+    if (!waivers->load(path, &error)) {
+        if (showError) {
+            QMessageBox::critical(this, tr("Failed to load waivers"), error);
+        }
+        logEvent(tr("Failed to load waivers: %1").arg(error));
+        return false;
+    }
+    waivers_ = std::move(waivers);
+    qsizetype rows = 0;
+    qsizetype waived = 0;
+    for (const auto &tab : tabs_) {
+        tab->diffModel->setWaivers(waivers_);
+        rows += tab->diffModel->rowCount();
+        waived += tab->diffModel->waivedCount();
+    }
+    hideWaived_->setEnabled(true);
+    hideWaived_->setToolTip(tr("Waivers from %1").arg(path));
+
+    const QString msg =
+        tr("Loaded %1 waiver rules from %2: %3 of %4 diffs waived (%5 ms)")
+            .arg(waivers_->rules().size())
+            .arg(path)
+            .arg(waived)
+            .arg(rows)
+            .arg(timer.elapsed());
+    showStatus(msg);
+    logEvent(msg);
+    return true;
+}
+
+auto MainWindow::loadTolerances(const QString &path, bool showError)
+    -> bool {
+    Tracer::Span span("MainWindow::loadTolerances", "ui");
+    span.setDetail(path);
+    PropertyTolerances tolerances;
+    QString error;
+    if (!tolerances.load(path, &error)) {
+        if (showError) {
+            QMessageBox::critical(this, tr("Failed to load tolerances"),
+                                  error);
+        }
+        logEvent(tr("Failed to load tolerances: %1").arg(error));
+        return false;
     }
+    tolerances_ = tolerances;
+    // Tolerances apply while parsing, so open reports are read again.
+    QStringList sources;
+    for (const auto &tab : tabs_) {
+        if (!tab->source.isEmpty() && QFileInfo::exists(tab->source)) {
+            sources.append(tab->source);
+        }
+    }
+    for (const QString &source : std::as_const(sources)) {
+        loadFile(source, showError);
+    }
+
+    const QString msg = tr("Loaded %1 tolerance rules from %2; %3 reports "
+                           "reloaded")
+                            .arg(tolerances_.ruleCount())
+                            .arg(path)
+                            .arg(sources.size());
+    showStatus(msg);
+    logEvent(msg);
     return true;
 }
 
+void MainWindow::addRecentFile(const QString &path) {
+    if (path.isEmpty()) {
+        return;
+    }
+    recentFiles_.removeAll(path);
+    recentFiles_.prepend(path);
+    const int maxRecent = 10;
+    while (recentFiles_.size() > maxRecent) {
+        recentFiles_.removeLast();
+    }
+    rebuildRecentFilesMenu();
+    saveRecentFiles();
+}
+
 void MainWindow::buildUi() {
     stack_ = new QStackedWidget(this);
 
@@ -151,6 +598,15 @@ void MainWindow::buildUi() {
                                QtConfig::contentMargin);
     layout->setSpacing(QtConfig::contentSpacing);
 
+    // Hidden while a single report is open.
+    tabBar_ = new QTabBar(contentPage_);
+    tabBar_->setObjectName(QStringLiteral("reportTabs"));
+    tabBar_->setTabsClosable(true);
+    tabBar_->setDocumentMode(true);
+    tabBar_->setExpanding(false);
+    tabBar_->setAutoHide(true);
+    layout->addWidget(tabBar_);
+
     auto *filterRow = new QHBoxLayout();
     filterRow->setSpacing(QtConfig::contentSpacing);
 
@@ -188,42 +644,75 @@ void MainWindow::buildUi() {
     typeFilter_->setObjectName(QStringLiteral("typeFilter"));
     typeFilter_->addItems({tr("All"), tr("net_mismatch"),
                            tr("instance_mismatch"), tr("device_mismatch"),
-                           tr("property_mismatch")});
+                           tr("property_mismatch"), tr("short"),
+                           tr("open"), tr("pin_mismatch")});
     searchField_ = new QLineEdit(contentPage_);
     searchField_->setObjectName(QStringLiteral("searchField"));
     searchField_->setPlaceholderText(tr("Search object/details"));
     filterRow->addWidget(new QLabel(tr("Type:"), contentPage_));
     filterRow->addWidget(typeFilter_);
+    deltaFilter_ = new QComboBox(contentPage_);
+    deltaFilter_->setObjectName(QStringLiteral("deltaFilter"));
+    deltaFilter_->addItems(
+        {tr("All"), tr("new"), tr("fixed"), tr("unchanged")});
+    deltaFilter_->setEnabled(false);
     filterRow->addWidget(new QLabel(tr("Search:"), contentPage_));
     filterRow->addWidget(searchField_, 1);
+    filterRow->addWidget(new QLabel(tr("Delta:"), contentPage_));
+    filterRow->addWidget(deltaFilter_);
+    hideWaived_ = new QCheckBox(tr("Hide waived"), contentPage_);
+    hideWaived_->setObjectName(QStringLiteral("hideWaived"));
+    hideWaived_->setChecked(true);
+    hideWaived_->setEnabled(false);
+    hideWaived_->setToolTip(tr("Use File -> Load Waivers to load rules"));
+    filterRow->addWidget(hideWaived_);
+    groupSimilar_ = new QCheckBox(tr("Group similar"), contentPage_);
+    groupSimilar_->setObjectName(QStringLiteral("groupSimilar"));
+    groupSimilar_->setToolTip(
+        tr("Group diffs that differ only in indices and number magnitudes"));
+    filterRow->addWidget(groupSimilar_);
+    uniqueMasters_ = new QCheckBox(tr("Unique per master"), contentPage_);
+    uniqueMasters_->setObjectName(QStringLiteral("uniqueMasters"));
+    uniqueMasters_->setToolTip(
+        tr("Show the diffs of a cell reported more than once only once; "
+           "the row header counts its instances"));
+    filterRow->addWidget(uniqueMasters_);
     layout->addLayout(filterRow);
 
-    proxyModel_->setSourceModel(diffModel_);
-
+    // activateTab() sets the models of both views.
     diffTable_ = new QTableView(contentPage_);
     diffTable_->setObjectName(QStringLiteral("diffTableView"));
-    diffTable_->setModel(proxyModel_);
     diffTable_->horizontalHeader()->setStretchLastSection(true);
     diffTable_->setSelectionBehavior(QAbstractItemView::SelectRows);
     diffTable_->setSelectionMode(QAbstractItemView::SingleSelection);
-    diffTable_->setColumnWidth(DiffEntryColumns::SUBTYPE, QtConfig::columnW);
+    diffTable_->setItemDelegate(new DiffEntryDelegate(diffTable_));
+    diffTable_->viewport()->installEventFilter(this);
+
+    clusterModel_ = new DiffClusterModel(this);
+    clusterView_ = new QTreeView(contentPage_);
+    clusterView_->setObjectName(QStringLiteral("clusterView"));
+    clusterView_->setModel(clusterModel_);
+    clusterView_->setItemDelegate(new DiffEntryDelegate(clusterView_));
+    clusterView_->setUniformRowHeights(true);
+    clusterView_->header()->setStretchLastSection(true);
+    clusterView_->setSelectionBehavior(QAbstractItemView::SelectRows);
+    clusterView_->setVisible(false);
+    clusterTimer_ = new QTimer(this);
+    clusterTimer_->setSingleShot(true);
+    clusterTimer_->setInterval(0);
 
     circuitTree_ = new QTreeView(contentPage_);
     circuitTree_->setObjectName(QStringLiteral("circuitTree"));
     circuitTree_->setHeaderHidden(true);
     circuitTree_->setMinimumWidth(QtConfig::circuitTreeW);
-    circuitTree_->setModel(circuitTreeModel_);
     circuitTree_->setExpandsOnDoubleClick(true);
-    circuitTree_->collapseAll();
-    connect(circuitTree_->selectionModel(),
-            &QItemSelectionModel::currentChanged, this,
-            &MainWindow::applyCircuitFilter);
 
     auto *tableRow = new QHBoxLayout();
     tableRow->setContentsMargins(0, 0, 0, 0);
     tableRow->setSpacing(QtConfig::contentSpacing);
     tableRow->addWidget(circuitTree_, 0);
     tableRow->addWidget(diffTable_, 1);
+    tableRow->addWidget(clusterView_, 1);
 
     layout->addLayout(tableRow);
 
@@ -232,9 +721,43 @@ void MainWindow::buildUi() {
     setCentralWidget(stack_);
 
     connect(typeFilter_, &QComboBox::currentTextChanged, this,
-            [this](const QString &text) { proxyModel_->setTypeFilter(text); });
+            [this](const QString &text) {
+                tab_->typeText = text;
+                tab_->proxyModel->setTypeFilter(text);
+            });
     connect(searchField_, &QLineEdit::textChanged, this,
-            [this](const QString &text) { proxyModel_->setSearchTerm(text); });
+            [this](const QString &text) {
+                tab_->searchText = text;
+                tab_->proxyModel->setSearchTerm(text);
+            });
+    connect(hideWaived_, &QCheckBox::toggled, this, [this](bool hide) {
+        for (const auto &tab : tabs_) {
+            tab->proxyModel->setHideWaived(hide);
+        }
+    });
+    connect(deltaFilter_, &QComboBox::currentTextChanged, this,
+            [this](const QString &text) {
+                tab_->deltaText = text;
+                tab_->proxyModel->setDeltaFilter(text);
+            });
+    connect(uniqueMasters_, &QCheckBox::toggled, this, [this]() {
+        for (const auto &tab : tabs_) {
+            applyUniqueMasters(*tab);
+        }
+    });
+    connect(groupSimilar_, &QCheckBox::toggled, this, [this](bool group) {
+        diffTable_->setVisible(!group);
+        clusterView_->setVisible(group);
+        refreshClusters();
+    });
+    connect(clusterTimer_, &QTimer::timeout, this,
+            &MainWindow::refreshClusters);
+    connect(clusterView_, &QTreeView::activated, this,
+            &MainWindow::showClusterMember);
+    connect(tabBar_, &QTabBar::currentChanged, this,
+            &MainWindow::activateTab);
+    connect(tabBar_, &QTabBar::tabCloseRequested, this,
+            &MainWindow::closeTab);
 
     connect(loadButton_, &QPushButton::clicked, this, [this]() {
         const QString startDir =
@@ -271,6 +794,44 @@ void MainWindow::buildMenus() {
         }
     });
     fileMenu->addAction(openAction);
+    auto *closeAction = new QAction(tr("&Close Report"), this);
+    closeAction->setShortcut(QKeySequence::Close);
+    connect(closeAction, &QAction::triggered, this,
+            [this]() { closeTab(tabIndex(*tab_)); });
+    fileMenu->addAction(closeAction);
+    auto *compareAction = new QAction(tr("Compare With &Baseline..."), this);
+    compareAction->setToolTip(
+        tr("Mark diffs new, fixed or unchanged against an earlier run"));
+    connect(compareAction, &QAction::triggered, this,
+            &MainWindow::chooseBaseline);
+    fileMenu->addAction(compareAction);
+    auto *waiversAction = new QAction(tr("Load &Waivers..."), this);
+    waiversAction->setToolTip(tr("Mark or hide accepted mismatches"));
+    connect(waiversAction, &QAction::triggered, this, [this]() {
+        const QString path = QFileDialog::getOpenFileName(
+            this, tr("Open waiver file"),
+            tab_->source.isEmpty() ? QDir::currentPath()
+                                   : QFileInfo(tab_->source).absolutePath(),
+            tr("Waiver files (*.waivers *.txt);;All files (*)"));
+        if (!path.isEmpty()) {
+            loadWaivers(path, true);
+        }
+    });
+    fileMenu->addAction(waiversAction);
+    auto *tolerancesAction = new QAction(tr("Load &Tolerances..."), this);
+    tolerancesAction->setToolTip(
+        tr("Compare property values as numbers within tolerances"));
+    connect(tolerancesAction, &QAction::triggered, this, [this]() {
+        const QString path = QFileDialog::getOpenFileName(
+            this, tr("Open tolerance file"),
+            tab_->source.isEmpty() ? QDir::currentPath()
+                                   : QFileInfo(tab_->source).absolutePath(),
+            tr("Tolerance files (*.tolerances *.txt);;All files (*)"));
+        if (!path.isEmpty()) {
+            loadTolerances(path, true);
+        }
+    });
+    fileMenu->addAction(tolerancesAction);
 
     recentMenu_ = fileMenu->addMenu(tr("Recent Files"));
     rebuildRecentFilesMenu();
@@ -284,6 +845,19 @@ void MainWindow::buildMenus() {
     ensureLogDock();
     auto *viewMenu = menuBar()->addMenu(tr("&View"));
     viewMenu->addAction(logDock_->toggleViewAction());
+    ensurePerfDock();
+    viewMenu->addAction(perfDock_->toggleViewAction());
+    ensureSourceDock();
+    viewMenu->addAction(sourceDock_->toggleViewAction());
+    viewMenu->addSeparator();
+    queryServerAction_ = new QAction(tr("Query Server"), this);
+    queryServerAction_->setCheckable(true);
+    queryServerAction_->setToolTip(
+        tr("Answer summary, diff, net and hierarchy queries about the "
+           "loaded report on a local socket"));
+    connect(queryServerAction_, &QAction::toggled, this,
+            &MainWindow::setQueryServerEnabled);
+    viewMenu->addAction(queryServerAction_);
 
     auto *helpMenu = menuBar()->addMenu(tr("&Help"));
     auto *aboutAction = new QAction(tr("About OpenSVS"), this);
@@ -293,7 +867,17 @@ void MainWindow::buildMenus() {
                "viewing netgen JSON reports.")
                 .arg(QCoreApplication::applicationVersion())
                 .arg(QLatin1String(qVersion()));
-        QMessageBox::about(this, tr("About OpenSVS"), text);
+        const bool loaded =
+            std::any_of(tabs_.cbegin(), tabs_.cend(), [](const auto &tab) {
+                return !tab->circuits.isEmpty();
+            });
+        const QString memory =
+            !loaded ? QString()
+                    : tr("<br>Loaded reports: %1 in memory (details under "
+                         "View -> Performance)")
+                          .arg(QLocale().formattedDataSize(
+                              memoryReport().total()));
+        QMessageBox::about(this, tr("About OpenSVS"), text + memory);
     });
     helpMenu->addAction(aboutAction);
 }
@@ -467,6 +1051,494 @@ void MainWindow::ensureLogDock() {
     logDock_->hide();
 }
 
+void MainWindow::ensureSourceDock() {
+    if (sourceDock_ != nullptr) {
+        return;
+    }
+    sourceDock_ = new QDockWidget(tr("Source"), this);
+    sourceDock_->setObjectName(QStringLiteral("sourceDock"));
+    sourceDock_->setFeatures(QDockWidget::DockWidgetClosable |
+                             QDockWidget::DockWidgetMovable |
+                             QDockWidget::DockWidgetFloatable);
+    sourceDock_->setAllowedAreas(Qt::AllDockWidgetAreas);
+    sourceDock_->setStyleSheet(QtConfig::dockStyle);
+
+    auto *tabs = new QTabWidget(sourceDock_);
+    const std::array<QString, 2> names{QStringLiteral("Layout"),
+                                       QStringLiteral("Schematic")};
+    for (size_t side = 0; side < sourcePanes_.size(); ++side) {
+        SourcePane &pane = sourcePanes_[side];
+        auto *page = new QWidget(tabs);
+        auto *layout = new QVBoxLayout(page);
+        pane.label = new QLabel(tr("No netlist indexed"), page);
+        pane.label->setObjectName(QStringLiteral("source%1Label")
+                                      .arg(names[side]));
+        pane.label->setTextInteractionFlags(Qt::TextSelectableByMouse);
+        pane.view = new QPlainTextEdit(page);
+        pane.view->setObjectName(QStringLiteral("source%1View")
+                                     .arg(names[side]));
+        pane.view->setReadOnly(true);
+        pane.view->setLineWrapMode(QPlainTextEdit::NoWrap);
+        pane.view->setFont(
+            QFontDatabase::systemFont(QFontDatabase::FixedFont));
+        layout->addWidget(pane.label);
+        layout->addWidget(pane.view, 1);
+        tabs->addTab(page, side == 0 ? tr("Layout") : tr("Schematic"));
+        pane.watcher = new QFileSystemWatcher(this);
+        connect(pane.watcher, &QFileSystemWatcher::fileChanged, this,
+                [this, side]() { sourceFileChanged(static_cast<int>(side)); });
+    }
+    sourceDock_->setWidget(tabs);
+    addDockWidget(Qt::RightDockWidgetArea, sourceDock_);
+    sourceDock_->hide();
+
+    // Netlists are only mapped and scanned once somebody looks.
+    connect(sourceDock_, &QDockWidget::visibilityChanged, this,
+            [this](bool visible) {
+                if (!visible) {
+                    return;
+                }
+                for (int side = 0; side < 2; ++side) {
+                    indexNetlist(side);
+                }
+                showDiffSource(diffTable_->currentIndex());
+            });
+}
+
+void MainWindow::setSourceNetlists(const QString &layout,
+                                   const QString &schematic) {
+    ensureSourceDock();
+    sourcePanes_[0].netlist = layout;
+    sourcePanes_[1].netlist = schematic;
+    if (sourceDock_->isVisible()) {
+        for (int side = 0; side < 2; ++side) {
+            indexNetlist(side);
+        }
+    }
+}
+
+void MainWindow::indexNetlist(int side) {
+    SourcePane &pane = sourcePanes_[side];
+    if (pane.indexing || pane.netlist.isEmpty() ||
+        (pane.indexed == pane.netlist && pane.index &&
+         pane.index->isCurrent())) {
+        return;
+    }
+    pane.indexing = true;
+    pane.label->setText(tr("Indexing %1...").arg(pane.netlist));
+    const QString path = pane.netlist;
+    auto index = std::make_shared<SpiceIndex>();
+    auto error = std::make_shared<QString>();
+    auto ok = std::make_shared<bool>(false);
+    const auto build = [index, path, error, ok]() {
+        *ok = index->build(path, error.get());
+    };
+    DetachedThread::start(build, this, [this, side, path, index, error, ok]() {
+        SourcePane &done = sourcePanes_[side];
+        done.indexing = false;
+        done.indexed = path;
+        if (!done.watcher->files().isEmpty()) {
+            done.watcher->removePaths(done.watcher->files());
+        }
+        if (*ok) {
+            done.index = index;
+            done.watcher->addPaths(index->files());
+            logEvent(tr("Indexed %1: %2 lines, %3 subcircuits, %4 "
+                        "instances, %5 nets")
+                         .arg(path)
+                         .arg(index->lineCount())
+                         .arg(index->count(SpiceIndex::Kind::Subckt))
+                         .arg(index->count(SpiceIndex::Kind::Instance))
+                         .arg(index->count(SpiceIndex::Kind::Net)));
+            for (const QString &missing : index->missingFiles()) {
+                logEvent(tr("Included netlist not found: %1").arg(missing));
+            }
+        } else {
+            done.index.reset();
+            logEvent(tr("Could not index netlist: %1").arg(*error));
+        }
+        // The netlist was switched, or edited, while indexing.
+        if (done.netlist != path || (done.index && !done.index->isCurrent())) {
+            done.index.reset();
+            indexNetlist(side);
+            return;
+        }
+        showDiffSource(diffTable_->currentIndex());
+    });
+}
+
+void MainWindow::sourceFileChanged(int side) {
+    SourcePane &pane = sourcePanes_[side];
+    if (!pane.index) {
+        return;
+    }
+    // A file rewritten in place may now be shorter than its mapping.
+    pane.index.reset();
+    pane.view->clear();
+    pane.label->setText(tr("No netlist indexed"));
+    if (sourceDock_->isVisible()) {
+        indexNetlist(side);
+    }
+}
+
+void MainWindow::showDiffSource(const QModelIndex &current) {
+    if (sourceDock_ == nullptr || !sourceDock_->isVisible() ||
+        tab_ == nullptr || !current.isValid()) {
+        return;
+    }
+    const QModelIndex source = tab_->proxyModel->mapToSource(current);
+    const auto &diffs = tab_->diffModel->diffs();
+    if (!source.isValid() || source.row() >= diffs.size()) {
+        return;
+    }
+    const NetgenJsonParser::DiffEntry &entry = diffs.at(source.row());
+    for (int side = 0; side < 2; ++side) {
+        SourcePane &pane = sourcePanes_[side];
+        if (!pane.index) {
+            if (!pane.indexing) {
+                pane.label->setText(pane.netlist.isEmpty()
+                                        ? tr("No netlist indexed")
+                                        : tr("Could not index %1")
+                                              .arg(pane.netlist));
+            }
+            pane.view->clear();
+            continue;
+        }
+        const QString &cell = side == 0 ? entry.layoutCell
+                                        : entry.schematicCell;
+        const SpiceIndex::Location at = pane.index->locate(entry, cell);
+        if (!at.isValid()) {
+            pane.label->setText(tr("%1 not found in %2")
+                                    .arg(entry.name, pane.indexed));
+            pane.view->clear();
+            continue;
+        }
+        qint64 first = 1;
+        pane.view->setPlainText(pane.index->excerpt(
+            at, QtConfig::sourceContextLines, QtConfig::sourceContextLines,
+            &first));
+        pane.label->setText(QStringLiteral("%1:%2")
+                                .arg(QDir::toNativeSeparators(at.path))
+                                .arg(at.line));
+        QTextCursor cursor(pane.view->document()->findBlockByNumber(
+            static_cast<int>(at.line - first)));
+        QTextEdit::ExtraSelection line;
+        line.format.setBackground(
+            pane.view->palette().color(QPalette::Highlight));
+        line.format.setForeground(
+            pane.view->palette().color(QPalette::HighlightedText));
+        line.format.setProperty(QTextFormat::FullWidthSelection, true);
+        line.cursor = cursor;
+        pane.view->setExtraSelections({line});
+        pane.view->setTextCursor(cursor);
+        pane.view->centerCursor();
+    }
+}
+
+void MainWindow::ensurePerfDock() {
+    if (perfDock_ != nullptr) {
+        return;
+    }
+    perfDock_ = new QDockWidget(tr("Performance"), this);
+    perfDock_->setObjectName(QStringLiteral("perfDock"));
+    perfDock_->setFeatures(QDockWidget::DockWidgetClosable |
+                           QDockWidget::DockWidgetMovable |
+                           QDockWidget::DockWidgetFloatable);
+    perfDock_->setAllowedAreas(Qt::AllDockWidgetAreas);
+    perfDock_->setStyleSheet(QtConfig::dockStyle);
+
+    auto *container = new QWidget(perfDock_);
+    auto *layout = new QVBoxLayout(container);
+    auto *controls = new QHBoxLayout();
+    perfRecord_ = new QCheckBox(tr("Record spans"), container);
+    perfRecord_->setObjectName(QStringLiteral("perfRecordCheck"));
+    perfRecord_->setChecked(Tracer::isEnabled());
+    auto *clearButton = new QPushButton(tr("Clear"), container);
+    auto *exportButton = new QPushButton(tr("Export trace..."), container);
+    perfStatusLabel_ = new QLabel(container);
+    controls->addWidget(perfRecord_);
+    controls->addWidget(clearButton);
+    controls->addWidget(exportButton);
+    controls->addWidget(perfStatusLabel_, 1);
+    layout->addLayout(controls);
+
+    perfTree_ = new QTreeWidget(container);
+    perfTree_->setObjectName(QStringLiteral("perfTree"));
+    perfTree_->setColumnCount(6);
+    perfTree_->setHeaderLabels({tr("Span"), tr("Category"), tr("Start (ms)"),
+                                tr("Duration (ms)"), tr("Thread"),
+                                tr("Detail")});
+    perfTree_->setUniformRowHeights(true);
+    layout->addWidget(perfTree_, 1);
+
+    auto *memoryPage = new QWidget(perfDock_);
+    auto *memoryLayout = new QVBoxLayout(memoryPage);
+    auto *memoryControls = new QHBoxLayout();
+    MemoryBudget budget;
+    memoryBudget_ = new QSpinBox(memoryPage);
+    memoryBudget_->setObjectName(QStringLiteral("memoryBudget"));
+    memoryBudget_->setRange(0, QtConfig::maxBudgetMiB);
+    memoryBudget_->setSuffix(tr(" MiB"));
+    memoryBudget_->setSpecialValueText(tr("Auto (%1)").arg(
+        QLocale().formattedDataSize(MemoryBudget::autoBudgetBytes())));
+    memoryBudget_->setValue(static_cast<int>(budget.configuredBudgetBytes() /
+                                             QtConfig::mebibyte));
+    auto *measureButton = new QPushButton(tr("Measure"), memoryPage);
+    memoryStatusLabel_ = new QLabel(memoryPage);
+    memoryControls->addWidget(new QLabel(tr("Memory budget:"), memoryPage));
+    memoryControls->addWidget(memoryBudget_);
+    memoryControls->addWidget(measureButton);
+    memoryControls->addWidget(memoryStatusLabel_, 1);
+    memoryLayout->addLayout(memoryControls);
+    memoryTree_ = new QTreeWidget(memoryPage);
+    memoryTree_->setObjectName(QStringLiteral("memoryTree"));
+    memoryTree_->setRootIsDecorated(false);
+    memoryTree_->setHeaderLabels({tr("Item"), tr("Bytes"), tr("Count")});
+    memoryLayout->addWidget(memoryTree_, 1);
+
+    auto *tabs = new QTabWidget(perfDock_);
+    tabs->addTab(container, tr("Spans"));
+    tabs->addTab(memoryPage, tr("Memory"));
+    perfDock_->setWidget(tabs);
+    addDockWidget(Qt::BottomDockWidgetArea, perfDock_);
+    perfDock_->hide();
+
+    perfTimer_ = new QTimer(this);
+    perfTimer_->setInterval(QtConfig::perfRefreshMs);
+    connect(perfTimer_, &QTimer::timeout, this, &MainWindow::refreshPerfView);
+    connect(perfDock_, &QDockWidget::visibilityChanged, this,
+            [this](bool visible) {
+                if (visible) {
+                    refreshPerfView();
+                    perfTimer_->start();
+                } else {
+                    perfTimer_->stop();
+                }
+            });
+    connect(perfRecord_, &QCheckBox::toggled, this, [this](bool on) {
+        Tracer::setEnabled(on);
+        logEvent(on ? tr("Performance recording started")
+                    : tr("Performance recording stopped"));
+    });
+    connect(clearButton, &QPushButton::clicked, this, [this]() {
+        Tracer::clear();
+        refreshPerfView();
+    });
+    connect(exportButton, &QPushButton::clicked, this,
+            &MainWindow::exportTrace);
+    connect(measureButton, &QPushButton::clicked, this,
+            &MainWindow::refreshMemoryView);
+    connect(memoryBudget_, &QSpinBox::valueChanged, this, [](int mib) {
+        MemoryBudget().setBudgetBytes(mib * QtConfig::mebibyte);
+    });
+}
+
+void MainWindow::setQueryServerEnabled(bool enabled) {
+    if (queryServer_ == nullptr) {
+        queryServer_ = new QueryServer(this);
+    }
+    if (enabled && !queryServer_->isRunning()) {
+        if (queryServer_->start()) {
+            publishSnapshot();
+            logEvent(tr("Query server listening on %1")
+                         .arg(queryServer_->fullServerName()));
+        } else {
+            logEvent(tr("Query server could not listen on %1 (another "
+                        "OpenSVS may own it)")
+                         .arg(QueryServer::defaultServerName()));
+            showStatus(tr("Query server could not start"));
+        }
+    } else if (!enabled && queryServer_->isRunning()) {
+        queryServer_->stop();
+        logEvent(tr("Query server stopped"));
+    }
+    if (queryServerAction_ != nullptr) {
+        const QSignalBlocker blocker(queryServerAction_);
+        queryServerAction_->setChecked(queryServer_->isRunning());
+    }
+}
+
+void MainWindow::publishSnapshot() {
+    if (queryServer_ == nullptr || !queryServer_->isRunning()) {
+        return;
+    }
+    OPENSVS_TRACE_SCOPE("MainWindow::publishSnapshot", "ui");
+    queryServer_->setSnapshot(
+        (tab_ == nullptr || tab_->circuits.isEmpty())
+            ? nullptr
+            : QuerySnapshot::make(tab_->source, tab_->summary, tab_->circuits,
+                                  tab_->detailCache));
+}
+
+auto MainWindow::memoryReport(const ReportTab *only) const -> MemoryReport {
+    QVector<const ReportTab *> tabs;
+    for (const auto &tab : tabs_) {
+        if (only == nullptr || tab.get() == only) {
+            tabs.append(tab.get());
+        }
+    }
+    QVector<const QVector<NetgenJsonParser::Report::Circuit> *> reports;
+    MemoryReport::Item tree{tr("circuit tree nodes")};
+    MemoryReport::Item rows{tr("diff table rows")};
+    MemoryReport::Item mapping{tr("filter proxy mapping")};
+    MemoryReport::Item cache{tr("on-demand detail cache")};
+    for (const ReportTab *tab : tabs) {
+        reports.append(&tab->circuits);
+        tree.bytes += tab->treeModel->memoryBytes();
+        tree.count += tab->treeModel->nodeCount();
+        rows.bytes += tab->diffModel->memoryBytes();
+        rows.count += tab->diffModel->rowCount();
+        mapping.bytes += tab->proxyModel->mappingBytes();
+        mapping.count += tab->proxyModel->rowCount();
+        if (tab->detailCache) {
+            cache.bytes += tab->detailCache->cachedBytes();
+            cache.count += tab->detailCache->cachedEntries();
+        }
+    }
+    MemoryReport memory = MemoryReport::measure(reports);
+    for (const auto &item : {tree, rows, mapping}) {
+        memory.add(item.name, item.bytes, item.count);
+    }
+    if (cache.count > 0) {
+        memory.add(cache.name, cache.bytes, cache.count);
+    }
+    if (only == nullptr) {
+        memory.add(tr("string pool tables"), stringPool_.memoryBytes(),
+                   stringPool_.size());
+        MemoryReport::Item netlists{tr("netlist source index")};
+        for (const SourcePane &pane : sourcePanes_) {
+            if (pane.index) {
+                netlists.bytes += pane.index->memoryBytes();
+                for (auto kind : {SpiceIndex::Kind::Subckt,
+                                  SpiceIndex::Kind::Instance,
+                                  SpiceIndex::Kind::Net}) {
+                    netlists.count += pane.index->count(kind);
+                }
+            }
+        }
+        if (netlists.bytes > 0) {
+            memory.add(netlists.name, netlists.bytes, netlists.count);
+        }
+    }
+    return memory;
+}
+
+void MainWindow::refreshMemoryView() {
+    if (memoryTree_ == nullptr) {
+        return;
+    }
+    const MemoryReport memory = memoryReport();
+    const QLocale locale;
+    memoryTree_->clear();
+    for (const auto &item : memory.items()) {
+        auto *row = new QTreeWidgetItem(memoryTree_);
+        row->setText(0, item.name);
+        row->setText(1, locale.formattedDataSize(item.bytes));
+        row->setToolTip(1, QString::number(item.bytes));
+        row->setText(2, QString::number(item.count));
+        row->setTextAlignment(1, Qt::AlignRight);
+        row->setTextAlignment(2, Qt::AlignRight);
+    }
+    const MemoryBudget budget;
+    qint64 fileSize = 0;
+    for (const auto &tab : tabs_) {
+        fileSize += tab->fileSize;
+    }
+    QString status = tr("Total %1").arg(
+        locale.formattedDataSize(memory.total()));
+    if (fileSize > 0) {
+        status += tr(" for %1 of JSON in %n report(s) (%2x)", nullptr,
+                     static_cast<int>(tabs_.size()))
+                      .arg(locale.formattedDataSize(fileSize))
+                      .arg(static_cast<double>(memory.total()) /
+                               static_cast<double>(fileSize),
+                           0, 'f', 1);
+    }
+    status += tr("; projecting %1x from %n load(s)", nullptr,
+                 budget.loadsSeen())
+                  .arg(budget.bytesPerFileByte(), 0, 'f', 1);
+    memoryStatusLabel_->setText(status);
+}
+
+void MainWindow::refreshPerfView() {
+    if (perfTree_ == nullptr) {
+        return;
+    }
+    const qsizetype count = Tracer::eventCount();
+    if (count == perfShown_) {
+        return;
+    }
+    perfShown_ = count;
+    QVector<Tracer::Event> events =
+        Tracer::events(std::max<qsizetype>(0, count - QtConfig::perfMaxRows));
+    QString status = tr("%n span(s)", nullptr, static_cast<int>(count));
+    if (Tracer::droppedCount() > 0) {
+        status += tr(", %1 dropped").arg(Tracer::droppedCount());
+    }
+    perfStatusLabel_->setText(status);
+
+    // Spans are recorded when they end; nest them by time containment
+    // per thread, parents (longer spans) first on equal start.
+    std::sort(events.begin(), events.end(),
+              [](const Tracer::Event &a, const Tracer::Event &b) {
+                  if (a.threadId != b.threadId) {
+                      return a.threadId < b.threadId;
+                  }
+                  if (a.startNs != b.startNs) {
+                      return a.startNs < b.startNs;
+                  }
+                  return a.durationNs > b.durationNs;
+              });
+    perfTree_->setUpdatesEnabled(false);
+    perfTree_->clear();
+    QVector<QPair<qint64, QTreeWidgetItem *>> open; // end, item
+    int thread = -1;
+    const auto ms = [](qint64 ns) { return QString::number(ns / 1e6, 'f', 3); };
+    for (const Tracer::Event &event : events) {
+        if (event.threadId != thread) {
+            open.clear();
+            thread = event.threadId;
+        }
+        const qint64 end = event.startNs + event.durationNs;
+        while (!open.isEmpty() && open.constLast().first < end) {
+            open.removeLast();
+        }
+        auto *item = open.isEmpty()
+                         ? new QTreeWidgetItem(perfTree_)
+                         : new QTreeWidgetItem(open.constLast().second);
+        item->setText(0, QString::fromUtf8(event.name));
+        item->setText(1, QString::fromUtf8(event.category));
+        item->setText(2, ms(event.startNs));
+        item->setText(3, ms(event.durationNs));
+        item->setText(4, QString::number(event.threadId));
+        item->setText(5, event.detail);
+        item->setTextAlignment(2, Qt::AlignRight);
+        item->setTextAlignment(3, Qt::AlignRight);
+        open.push_back({end, item});
+    }
+    perfTree_->expandToDepth(1);
+    perfTree_->setUpdatesEnabled(true);
+}
+
+void MainWindow::exportTrace() {
+    const QString path = QFileDialog::getSaveFileName(
+        this, tr("Export Chrome trace"), lvsLastDir_,
+        tr("Trace files (*.json);;All files (*)"));
+    if (path.isEmpty()) {
+        return;
+    }
+    QString error;
+    if (!Tracer::saveChromeTrace(path, &error)) {
+        QMessageBox::critical(this, tr("Export failed"), error);
+        return;
+    }
+    const QString msg = tr("Wrote %n span(s) to %1", nullptr,
+                           static_cast<int>(Tracer::eventCount()))
+                            .arg(path);
+    showStatus(msg);
+    logEvent(msg);
+}
+
 void MainWindow::refreshLogView() {
     if (logView_ != nullptr) {
         logView_->setPlainText(logLines_.join('\n'));
@@ -474,33 +1546,67 @@ void MainWindow::refreshLogView() {
     }
 }
 
-void MainWindow::applyCircuitFilter(const QModelIndex &index) {
-    if ((circuitTreeModel_ == nullptr) || (proxyModel_ == nullptr)) {
+void MainWindow::refreshClusters() {
+    clusterTimer_->stop();
+    if (tab_ == nullptr || !groupSimilar_->isChecked()) {
+        clusterModel_->setRows(nullptr, {});
         return;
     }
+    Tracer::Span span("MainWindow::refreshClusters", "ui");
+    QElapsedTimer timer;
+    timer.start();
+    const DiffFilterProxyModel *proxy = tab_->proxyModel;
+    QVector<int> rows;
+    rows.reserve(proxy->rowCount());
+    for (int row = 0; row < proxy->rowCount(); ++row) {
+        rows.append(proxy->mapToSource(proxy->index(row, 0)).row());
+    }
+    clusterModel_->setRows(tab_->diffModel, rows);
+    span.setDetail(QString::number(rows.size()));
+    showStatus(tr("%1 diffs in %2 groups (%3 ms)")
+                   .arg(rows.size())
+                   .arg(clusterModel_->clusterCount())
+                   .arg(timer.elapsed()));
+}
 
-    QSet<int> allowed;
-    auto gather = [&](auto &&self,
-                      NetgenJsonParser::Report::Circuit *circuit) -> void {
-        if (!circuit) {
-            return;
-        }
-        if (circuit->index >= 0) {
-            allowed.insert(static_cast<int>(circuit->index));
-        }
-        for (auto *child : circuit->subcircuits) {
-            self(self, child);
-        }
-    };
+void MainWindow::showClusterMember(const QModelIndex &index) {
+    const int row = clusterModel_->sourceRow(index);
+    if (row < 0 || tab_ == nullptr) {
+        return;
+    }
+    // Back to the table, on the chosen row.
+    const QModelIndex proxyIndex =
+        tab_->proxyModel->mapFromSource(tab_->diffModel->index(row, 0));
+    groupSimilar_->setChecked(false);
+    diffTable_->setCurrentIndex(proxyIndex);
+    diffTable_->scrollTo(proxyIndex);
+}
 
-    NetgenJsonParser::Report::Circuit *cir =
+void MainWindow::applyCircuitFilter(const QModelIndex &index) {
+    if (tab_ == nullptr) {
+        return;
+    }
+    tab_->treeCurrent = index;
+    tab_->proxyModel->setAllowedCircuits(allowedCircuits(*tab_, index));
+}
+
+auto MainWindow::allowedCircuits(const ReportTab &tab,
+                                 const QModelIndex &index) -> QSet<int> {
+    const NetgenJsonParser::Report::Circuit *cir =
         CircuitTreeModel::circuitForIndex(index);
-    if (cir != nullptr) {
-        gather(gather, cir);
-    } else {
-        allowed.clear();
+    if (cir == nullptr) {
+        return {};
     }
-    proxyModel_->setAllowedCircuits(allowed);
+    const QString cell =
+        cir->layoutCell.isEmpty() ? cir->schematicCell : cir->layoutCell;
+    return tab.masters.sameMaster(
+        DiffFilter::circuitsUnder(tab.circuits, cell));
+}
+
+void MainWindow::applyUniqueMasters(ReportTab &tab) {
+    tab.proxyModel->setDuplicateCircuits(uniqueMasters_->isChecked()
+                                             ? tab.masters.duplicateCircuits()
+                                             : QSet<int>());
 }
 
 void MainWindow::openLvsDialog() {
@@ -525,6 +1631,54 @@ void MainWindow::ensureLvsDock() {
     lvsDock_->setAllowedAreas(Qt::AllDockWidgetAreas);
     lvsDock_->setStyleSheet(QtConfig::dockStyle);
 
+    lvsQueue_ = new LvsJobQueue(this);
+    lvsQueue_->setCache(std::make_shared<LvsResultCache>());
+    lvsJobModel_ = new LvsJobModel(lvsQueue_, this);
+    lvsTicker_ = new QTimer(this);
+    lvsTicker_->setInterval(QtConfig::lvsTickMs);
+    connect(lvsTicker_, &QTimer::timeout, this, &MainWindow::updateLvsStatus);
+    connect(lvsQueue_, &LvsJobQueue::jobChanged, this,
+            &MainWindow::updateLvsStatus);
+    connect(lvsQueue_, &LvsJobQueue::jobOutput, this,
+            [this](int row, const QStringList &lines, bool isError) {
+                const int id = lvsQueue_->jobs().at(row).id;
+                const QString prefix =
+                    isError ? QStringLiteral("netgen[%1]! ").arg(id)
+                            : QStringLiteral("netgen[%1]: ").arg(id);
+                for (const QString &line : lines) {
+                    if (!line.trimmed().isEmpty()) {
+                        logEvent(prefix + line);
+                    }
+                }
+            });
+    connect(lvsQueue_, &LvsJobQueue::jobCellFinished, this,
+            [this](int row, const QString &cell, bool match) {
+                if (!match) {
+                    logEvent(tr("LVS job %1: cell %2 does not match")
+                                 .arg(lvsQueue_->jobs().at(row).id)
+                                 .arg(cell));
+                }
+            });
+    connect(lvsQueue_, &LvsJobQueue::jobJsonChunk, this,
+            [this](int row, const QByteArray &chunk) {
+                if (!lvsStream_ ||
+                    lvsQueue_->jobs().at(row).id != lvsStreamJobId_) {
+                    return;
+                }
+                lvsStream_->feed(chunk);
+                if (!lvsStreamTimer_->isActive()) {
+                    lvsStreamTimer_->start();
+                }
+            });
+    connect(lvsQueue_, &LvsJobQueue::jobFinished, this,
+            &MainWindow::onLvsJobFinished);
+    // Throttle tree/table rebuilds while a report streams in.
+    lvsStreamTimer_ = new QTimer(this);
+    lvsStreamTimer_->setSingleShot(true);
+    lvsStreamTimer_->setInterval(QtConfig::lvsStreamRefreshMs);
+    connect(lvsStreamTimer_, &QTimer::timeout, this,
+            &MainWindow::showLvsStreamProgress);
+
     auto *container = new QWidget(lvsDock_);
     auto *vbox = new QVBoxLayout(container);
     auto *form = new QFormLayout();
@@ -559,94 +1713,482 @@ void MainWindow::ensureLvsDock() {
         makePicker(tr("Select schematic file"), &lvsSchematicEdit_);
     auto *rulesRow = makePicker(tr("Select rules file"), &lvsRulesEdit_);
 
+    for (QLineEdit *edit : {lvsLayoutEdit_, lvsSchematicEdit_}) {
+        connect(edit, &QLineEdit::editingFinished, this, [this]() {
+            setSourceNetlists(lvsLayoutEdit_->text().trimmed(),
+                              lvsSchematicEdit_->text().trimmed());
+        });
+    }
+
     form->addRow(tr("Layout file:"), layoutRow);
     form->addRow(tr("Schematic file:"), schematicRow);
     form->addRow(tr("Rules file:"), rulesRow);
 
     vbox->addLayout(form);
 
-    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Cancel, container);
-    auto *runButton =
-        buttons->addButton(tr("Run"), QDialogButtonBox::AcceptRole);
+    auto *concurrencyRow = new QHBoxLayout();
+    lvsConcurrency_ = new QSpinBox(container);
+    lvsConcurrency_->setObjectName(QStringLiteral("lvsConcurrency"));
+    lvsConcurrency_->setRange(1, QtConfig::lvsMaxConcurrency);
+    lvsConcurrency_->setValue(lvsQueue_->maxConcurrent());
+    connect(lvsConcurrency_, &QSpinBox::valueChanged, lvsQueue_,
+            &LvsJobQueue::setMaxConcurrent);
+    concurrencyRow->addWidget(new QLabel(tr("Max parallel jobs:"), container));
+    concurrencyRow->addWidget(lvsConcurrency_);
+    concurrencyRow->addStretch(1);
+    lvsStatusLabel_ = new QLabel(tr("Idle"), container);
+    lvsStatusLabel_->setObjectName(QStringLiteral("lvsStatusLabel"));
+    concurrencyRow->addWidget(lvsStatusLabel_);
+    vbox->addLayout(concurrencyRow);
+
+    lvsForceRerun_ = new QCheckBox(tr("Force rerun (ignore cached results)"),
+                                   container);
+    lvsForceRerun_->setObjectName(QStringLiteral("lvsForceRerun"));
+    lvsForceRerun_->setToolTip(
+        tr("Results are cached by a content hash of the input files, their "
+           "includes and the netgen binary"));
+    vbox->addWidget(lvsForceRerun_);
+
+    auto *streamRow = new QHBoxLayout();
+    lvsStreamJson_ =
+        new QCheckBox(tr("Stream report while netgen runs"), container);
+    lvsStreamJson_->setObjectName(QStringLiteral("lvsStreamJson"));
+    lvsStreamJson_->setToolTip(
+        tr("netgen writes its JSON into a pipe that is parsed as it arrives; "
+           "circuits appear as soon as netgen has compared them"));
+    lvsKeepJson_ = new QCheckBox(tr("Keep JSON on disk"), container);
+    lvsKeepJson_->setObjectName(QStringLiteral("lvsKeepJson"));
+    lvsKeepJson_->setToolTip(
+        tr("Also save the streamed report next to the .out file so it can be "
+           "reopened and cached"));
+    lvsKeepJson_->setChecked(true);
+    lvsKeepJson_->setEnabled(false);
+    connect(lvsStreamJson_, &QCheckBox::toggled, lvsKeepJson_,
+            &QCheckBox::setEnabled);
+    streamRow->addWidget(lvsStreamJson_);
+    streamRow->addWidget(lvsKeepJson_);
+    streamRow->addStretch(1);
+    vbox->addLayout(streamRow);
+
+    lvsJobTable_ = new QTableView(container);
+    lvsJobTable_->setObjectName(QStringLiteral("lvsJobTable"));
+    lvsJobTable_->setModel(lvsJobModel_);
+    lvsJobTable_->horizontalHeader()->setStretchLastSection(true);
+    lvsJobTable_->verticalHeader()->hide();
+    lvsJobTable_->setSelectionBehavior(QAbstractItemView::SelectRows);
+    lvsJobTable_->setSelectionMode(QAbstractItemView::SingleSelection);
+    connect(lvsJobTable_, &QTableView::doubleClicked, this,
+            [this](const QModelIndex &index) { loadLvsJob(index.row()); });
+    vbox->addWidget(lvsJobTable_, 1);
+
+    auto *buttons = new QDialogButtonBox(QDialogButtonBox::Close, container);
+    lvsRunButton_ = buttons->addButton(tr("Run"), QDialogButtonBox::AcceptRole);
+    lvsRunButton_->setObjectName(QStringLiteral("lvsRunButton"));
+    lvsRunButton_->setToolTip(tr("Add the selected files to the job queue"));
+    lvsQuickButton_ =
+        buttons->addButton(tr("Quick compare"), QDialogButtonBox::ActionRole);
+    lvsQuickButton_->setObjectName(QStringLiteral("lvsQuickButton"));
+    lvsQuickButton_->setToolTip(
+        tr("Compare the layout and schematic netlists without netgen"));
+    auto *importButton =
+        buttons->addButton(tr("Import list..."), QDialogButtonBox::ActionRole);
+    importButton->setToolTip(
+        tr("Queue one job per line of \"layout schematic rules\""));
+    auto *loadJobButton =
+        buttons->addButton(tr("Load report"), QDialogButtonBox::ActionRole);
+    lvsCancelButton_ =
+        buttons->addButton(tr("Cancel run"), QDialogButtonBox::ActionRole);
+    lvsCancelButton_->setObjectName(QStringLiteral("lvsCancelButton"));
+    lvsCancelButton_->setToolTip(
+        tr("Cancel the selected job, or all pending jobs if none is selected"));
+    lvsCancelButton_->setEnabled(false);
+    auto *clearButton =
+        buttons->addButton(tr("Clear finished"), QDialogButtonBox::ResetRole);
     connect(buttons, &QDialogButtonBox::rejected, lvsDock_, &QDockWidget::hide);
-    connect(runButton, &QPushButton::clicked, this, [this]() {
-        if ((lvsLayoutEdit_ == nullptr) || (lvsSchematicEdit_ == nullptr) ||
-            (lvsRulesEdit_ == nullptr)) {
-            return;
+    connect(lvsRunButton_, &QPushButton::clicked, this,
+            &MainWindow::startLvsRun);
+    connect(lvsQuickButton_, &QPushButton::clicked, this,
+            &MainWindow::startQuickCompare);
+    connect(importButton, &QPushButton::clicked, this,
+            &MainWindow::importLvsJobList);
+    connect(loadJobButton, &QPushButton::clicked, this, [this]() {
+        const QModelIndex current = lvsJobTable_->currentIndex();
+        if (current.isValid()) {
+            loadLvsJob(current.row());
         }
+    });
+    connect(lvsCancelButton_, &QPushButton::clicked, this, [this]() {
+        const QModelIndex current = lvsJobTable_->currentIndex();
+        logEvent(tr("Canceling netgen run..."));
+        if (current.isValid()) {
+            lvsQueue_->cancel(current.row());
+        } else {
+            lvsQueue_->cancelAll();
+        }
+    });
+    connect(clearButton, &QPushButton::clicked, lvsQueue_,
+            &LvsJobQueue::clearFinished);
+    vbox->addWidget(buttons);
 
-        const QString layout = lvsLayoutEdit_->text().trimmed();
-        const QString schematic = lvsSchematicEdit_->text().trimmed();
-        const QString rules = lvsRulesEdit_->text().trimmed();
+    container->setLayout(vbox);
+    lvsDock_->setWidget(container);
+    addDockWidget(Qt::BottomDockWidgetArea, lvsDock_);
+}
 
-        if (layout.isEmpty() || schematic.isEmpty() || rules.isEmpty()) {
-            QMessageBox::warning(
-                this, tr("Missing input"),
-                tr("Please provide layout, schematic, and rules files."));
+void MainWindow::startLvsRun() {
+    if ((lvsLayoutEdit_ == nullptr) || (lvsSchematicEdit_ == nullptr) ||
+        (lvsRulesEdit_ == nullptr) || (lvsQueue_ == nullptr)) {
+        return;
+    }
+
+    const QString layout = lvsLayoutEdit_->text().trimmed();
+    const QString schematic = lvsSchematicEdit_->text().trimmed();
+    const QString rules = lvsRulesEdit_->text().trimmed();
+
+    if (layout.isEmpty() || schematic.isEmpty() || rules.isEmpty()) {
+        QMessageBox::warning(
+            this, tr("Missing input"),
+            tr("Please provide layout, schematic, and rules files."));
+        return;
+    }
+
+    enqueueLvsJob(layout, schematic, rules);
+}
+
+void MainWindow::startQuickCompare() {
+    if ((lvsLayoutEdit_ == nullptr) || (lvsSchematicEdit_ == nullptr)) {
+        return;
+    }
+    const QString layout = lvsLayoutEdit_->text().trimmed();
+    const QString schematic = lvsSchematicEdit_->text().trimmed();
+    if (layout.isEmpty() || schematic.isEmpty()) {
+        QMessageBox::warning(this, tr("Missing input"),
+                             tr("Please provide layout and schematic files."));
+        return;
+    }
+
+    setSourceNetlists(layout, schematic);
+    const QString jsonPath = LvsRunner::jsonPathForOut(
+        LvsJobQueue::uniqueOutPath(QDir::current(), QStringLiteral("quick")));
+    // Per-cell results are kept next to the netgen cache, one file per
+    // netlist pair, so the next compare only redoes the changed cells.
+    const std::shared_ptr<LvsResultCache> cache =
+        lvsQueue_ != nullptr ? lvsQueue_->cache() : nullptr;
+    QString recordsPath;
+    if (cache) {
+        const QByteArray pair =
+            QFileInfo(layout).absoluteFilePath().toUtf8() + '\n' +
+            QFileInfo(schematic).absoluteFilePath().toUtf8();
+        const QByteArray name =
+            QCryptographicHash::hash(pair, QCryptographicHash::Sha1).toHex();
+        recordsPath = QDir(cache->directory())
+                          .filePath(QStringLiteral("quick_%1.json")
+                                        .arg(QString::fromLatin1(name)));
+    }
+    const bool reuse =
+        (lvsForceRerun_ == nullptr) || !lvsForceRerun_->isChecked();
+    auto error = std::make_shared<QString>();
+    auto ok = std::make_shared<bool>(false);
+    auto records = std::make_shared<NetlistComparator::Records>();
+    const auto compare = [layout, schematic, jsonPath, recordsPath, reuse,
+                          error, ok, records]() {
+        NetlistComparator::Options options;
+        if (!recordsPath.isEmpty()) {
+            if (reuse && QFileInfo::exists(recordsPath)) {
+                records->load(recordsPath);
+            }
+            options.previous = records.get();
+            options.records = records.get();
+        }
+        const QJsonArray circuits = NetlistComparator::compareFiles(
+            layout, schematic, options, error.get());
+        if (circuits.isEmpty()) {
             return;
         }
-
-        const QString timestamp = QDateTime::currentDateTime().toString(
-            QStringLiteral("yyyyMMdd_hhmmss"));
-        const QString baseName = QStringLiteral("comp_%1").arg(timestamp);
-        const QString outPath =
-            QDir::current().filePath(baseName + QStringLiteral(".out"));
-        const QString jsonPath =
-            QDir::current().filePath(baseName + QStringLiteral(".json"));
-
-        QProcess proc(this);
-        QStringList args;
-        const QString workingDir = QFileInfo(rules).absolutePath();
-        auto makeRelative = [&](const QString &path) {
-            QDir dir(workingDir);
-            const QString rel = dir.relativeFilePath(path);
-            return rel;
-        };
-
-        args << QStringLiteral("-batch") << QStringLiteral("lvs")
-             << makeRelative(layout) << makeRelative(schematic)
-             << makeRelative(rules) << makeRelative(outPath)
-             << QStringLiteral("-json");
-        const QString msg = tr("Running \"netgen %1\"...").arg(args.join(" "));
-        showStatus(tr("Running netgen..."));
-        logEvent(msg);
-        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-        if (!workingDir.isEmpty()) {
-            proc.setWorkingDirectory(workingDir);
-        }
-        proc.setProcessEnvironment(env);
-        qInfo() << "Starting netgen in" << proc.workingDirectory() << args;
-        proc.start(QStringLiteral("netgen"), args);
-        if (!proc.waitForStarted()) {
-            QMessageBox::critical(this, tr("LVS failed to start"),
-                                  tr("Could not start netgen process."));
+        QFile file(jsonPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            *error = QStringLiteral("Could not write %1").arg(jsonPath);
             return;
         }
-        proc.waitForFinished(-1);
-        if (proc.exitStatus() != QProcess::NormalExit || proc.exitCode() != 0) {
-            QMessageBox::critical(
-                this, tr("LVS failed"),
-                tr("netgen exited with code %1:\n%2")
-                    .arg(proc.exitCode())
-                    .arg(QString::fromLocal8Bit(proc.readAllStandardError())));
+        *ok = file.write(QJsonDocument(circuits).toJson()) >= 0;
+        if (!*ok) {
+            *error = QStringLiteral("Could not write %1").arg(jsonPath);
             return;
         }
-
-        if (!QFile::exists(jsonPath)) {
-            QMessageBox::critical(
-                this, tr("Output missing"),
-                tr("Expected JSON output not found at %1").arg(jsonPath));
+        // Losing the records only costs the next compare its reuse.
+        if (!recordsPath.isEmpty() &&
+            QDir().mkpath(QFileInfo(recordsPath).absolutePath())) {
+            records->save(recordsPath);
+        }
+    };
+    QElapsedTimer timer;
+    timer.start();
+    const auto finished = [this, layout, schematic, jsonPath, error, ok,
+                           records, timer]() {
+        lvsQuickButton_->setEnabled(true);
+        if (!*ok) {
+            logEvent(tr("Quick compare failed: %1").arg(*error));
+            QMessageBox::critical(this, tr("Quick compare failed"), *error);
             return;
         }
-
+        const QString elapsed = LvsRunner::formatElapsed(timer.elapsed());
+        logEvent(tr("Quick compare of %1 vs %2 finished in %3: %4")
+                     .arg(layout, schematic, elapsed, jsonPath));
+        if (records->reusedCount() > 0) {
+            logEvent(tr("Reused %1 of %2 cells unchanged since "
+                        "the last compare")
+                         .arg(records->reusedCount())
+                         .arg(records->cells.size()));
+        }
         if (loadFile(jsonPath, true) && (stack_ != nullptr) &&
             (contentPage_ != nullptr)) {
             stack_->setCurrentWidget(contentPage_);
         }
-    });
-    vbox->addWidget(buttons);
+    };
+    lvsQuickButton_->setEnabled(false);
+    showStatus(tr("Comparing netlists..."));
+    DetachedThread::start(compare, this, finished);
+}
 
-    container->setLayout(vbox);
-    lvsDock_->setWidget(container);
-    addDockWidget(Qt::BottomDockWidgetArea, lvsDock_);
+void MainWindow::enqueueLvsJob(const QString &layout, const QString &schematic,
+                               const QString &rules) {
+    LvsRunner::Request request;
+    request.layout = layout;
+    request.schematic = schematic;
+    request.rules = rules;
+    request.outPath = LvsJobQueue::uniqueOutPath(QDir::current());
+    setSourceNetlists(layout, schematic);
+    // Only a job that will be shown on its own is worth streaming: the first
+    // one queued while the queue is idle.
+    const bool stream = (lvsStreamJson_ != nullptr) &&
+                        lvsStreamJson_->isChecked() &&
+                        lvsQueue_->pendingCount() == 0;
+    request.streamJson = stream;
+    request.keepJsonCopy = !stream || lvsKeepJson_->isChecked();
+
+    ++lvsBatchSize_;
+    const bool useCache =
+        (lvsForceRerun_ == nullptr) || !lvsForceRerun_->isChecked();
+    const int row = lvsQueue_->enqueue(request, useCache);
+    const auto &job = lvsQueue_->jobs().at(row);
+    // A cache hit drops the parser unused in onLvsJobFinished().
+    if (stream) {
+        lvsStream_ = std::make_unique<NetgenJsonStreamParser>();
+        lvsStream_->setTolerances(tolerances_);
+        lvsStreamJobId_ = job.id;
+        lvsStreamShown_ = false;
+        lvsStreamHeld_.clear();
+    }
+    logEvent(tr("Queued LVS job %1: %2 vs %3 (%4)")
+                 .arg(job.id)
+                 .arg(layout, schematic, job.request.outPath));
+    showStatus(tr("Running netgen..."));
+    lvsCancelButton_->setEnabled(true);
+    lvsTicker_->start();
+    updateLvsStatus();
+}
+
+void MainWindow::importLvsJobList() {
+    const QString listPath = QFileDialog::getOpenFileName(
+        this, tr("Import LVS job list"), lvsLastDir_,
+        tr("Text files (*.txt *.lst);;All files (*)"));
+    if (listPath.isEmpty()) {
+        return;
+    }
+    QFile listFile(listPath);
+    if (!listFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QMessageBox::critical(this, tr("Import failed"),
+                              tr("Could not open %1").arg(listPath));
+        return;
+    }
+    // One job per line: "layout schematic rules", paths relative to the list.
+    const QDir baseDir = QFileInfo(listPath).absoluteDir();
+    QTextStream in(&listFile);
+    int queued = 0;
+    while (!in.atEnd()) {
+        const QString line = in.readLine().section(QLatin1Char('#'), 0, 0);
+        const QStringList fields = line.split(
+            QRegularExpression(QStringLiteral("\\s+")), Qt::SkipEmptyParts);
+        if (fields.size() != 3) {
+            continue;
+        }
+        enqueueLvsJob(baseDir.absoluteFilePath(fields.at(0)),
+                      baseDir.absoluteFilePath(fields.at(1)),
+                      baseDir.absoluteFilePath(fields.at(2)));
+        ++queued;
+    }
+    lvsLastDir_ = baseDir.absolutePath();
+    logEvent(tr("Imported %1 LVS jobs from %2").arg(queued).arg(listPath));
+}
+
+void MainWindow::loadLvsJob(int row) {
+    if (row < 0 || row >= lvsQueue_->jobs().size()) {
+        return;
+    }
+    const auto &job = lvsQueue_->jobs().at(row);
+    if (job.status != LvsJobQueue::Status::Succeeded) {
+        showStatus(tr("LVS job %1 has no report to load").arg(job.id));
+        return;
+    }
+    if (job.jsonPath.isEmpty()) {
+        showStatus(tr("LVS job %1 was streamed without keeping its JSON")
+                       .arg(job.id));
+        return;
+    }
+    setSourceNetlists(job.request.layout, job.request.schematic);
+    if (loadFile(job.jsonPath, true) && (stack_ != nullptr) &&
+        (contentPage_ != nullptr)) {
+        stack_->setCurrentWidget(contentPage_);
+    }
+}
+
+void MainWindow::onLvsJobFinished(int row, bool ok) {
+    const auto &job = lvsQueue_->jobs().at(row);
+    std::unique_ptr<NetgenJsonStreamParser> stream;
+    if (job.id == lvsStreamJobId_) {
+        stream = std::move(lvsStream_);
+        lvsStreamJobId_ = -1;
+        lvsStreamTimer_->stop();
+        // netgen never ran, or ran on a scoped copy without streaming, so
+        // nothing was streamed; the report is loaded like any other.
+        if (job.cached || job.cellsReused > 0) {
+            stream.reset();
+        }
+    }
+    const QString elapsed = LvsRunner::formatElapsed(job.durationMs);
+    const bool single = lvsBatchSize_ == 1;
+    const bool idle = lvsQueue_->pendingCount() == 0;
+    if (idle) {
+        lvsTicker_->stop();
+        lvsCancelButton_->setEnabled(false);
+        lvsBatchSize_ = 0;
+    }
+    updateLvsStatus();
+
+    if (job.status == LvsJobQueue::Status::Canceled) {
+        showStatus(tr("netgen run canceled"));
+        logEvent(tr("LVS job %1 canceled after %2").arg(job.id).arg(elapsed));
+        return;
+    }
+    if (!ok) {
+        logEvent(tr("LVS job %1 failed: %2").arg(job.id).arg(job.result));
+        if (single && idle) {
+            QMessageBox::critical(this, tr("LVS failed"), job.result);
+        }
+        return;
+    }
+
+    if (job.cached) {
+        logEvent(tr("LVS job %1 served from cache: %2")
+                     .arg(job.id)
+                     .arg(job.jsonPath));
+    } else {
+        logEvent(tr("LVS job %1 finished in %2: %3")
+                     .arg(job.id)
+                     .arg(elapsed, job.result));
+        if (job.cellsReused > 0) {
+            logEvent(tr("LVS job %1: %2 unchanged cells taken from the cache")
+                         .arg(job.id)
+                         .arg(job.cellsReused));
+        }
+    }
+    // A streamed report is already on screen and only needs its hierarchy.
+    if (stream) {
+        ReportTab *streamTab = std::exchange(lvsStreamTab_, nullptr);
+        QVector<NetgenJsonParser::Report::Circuit> taken =
+            streamTab != nullptr ? std::move(streamTab->circuits)
+                                 : std::exchange(lvsStreamHeld_, {});
+        lvsStreamHeld_.clear();
+        auto report = stream->finish(std::move(taken));
+        if (!report.ok) {
+            if (streamTab != nullptr) { // its rows pointed into the circuits
+                streamTab->circuits.clear();
+                streamTab->treeModel->setCircuits(&streamTab->circuits);
+                streamTab->diffModel->setDiffs({});
+            }
+            logEvent(tr("LVS job %1: streamed report unreadable: %2")
+                         .arg(job.id)
+                         .arg(report.error));
+            QMessageBox::critical(this, tr("Failed to load"), report.error);
+            return;
+        }
+        ReportTab &tab =
+            streamTab != nullptr ? *streamTab : tabForLoad(job.jsonPath);
+        showReport(tab, std::move(report),
+                   job.jsonPath.isEmpty() ? tr("netgen job %1").arg(job.id)
+                                          : job.jsonPath);
+        addRecentFile(job.jsonPath);
+        return;
+    }
+    // A lone run behaves like the old Run button and opens its report; batch
+    // results stay in the queue to be loaded on demand.
+    if (single && idle) {
+        loadLvsJob(row);
+    }
+}
+
+void MainWindow::showLvsStreamProgress() {
+    if (!lvsStream_) {
+        return;
+    }
+    QVector<NetgenJsonParser::Report::Circuit> fresh =
+        lvsStream_->takeCircuits();
+    if (!lvsStreamShown_) {
+        lvsStreamTab_ = &tabForLoad(QString());
+        lvsStreamTab_->source = tr("netgen job %1").arg(lvsStreamJobId_);
+        refreshTabTitle(*lvsStreamTab_);
+        activateTab(tabIndex(*lvsStreamTab_));
+        lvsStreamTab_->proxyModel->setAllowedCircuits({});
+        lvsStreamShown_ = true;
+    }
+    // Its tab was closed; finish() still opens the whole report.
+    if (lvsStreamTab_ == nullptr) {
+        lvsStreamHeld_ += std::move(fresh);
+        return;
+    }
+    ReportTab &tab = *lvsStreamTab_;
+    // The tab keeps every circuit taken, in stream order, for finish().
+    // Until the hierarchy is known they are listed flat, and only those
+    // with diffs of their own; finish() prunes and nests them. Each tick
+    // appends rows rather than rebuilding the models.
+    QVector<NetgenJsonParser::DiffEntry> freshDiffs;
+    for (auto &cir : fresh) {
+        cir.isTopLevel = !cir.diffs.isEmpty();
+        freshDiffs += cir.diffs;
+    }
+    // The tree points into tab.circuits, so it is rebuilt only when the
+    // vector moved; reserving twice the size makes that rare.
+    const NetgenJsonParser::Report::Circuit *before = tab.circuits.constData();
+    if (tab.circuits.capacity() - tab.circuits.size() < fresh.size()) {
+        tab.circuits.reserve(2 * (tab.circuits.size() + fresh.size()));
+    }
+    tab.circuits += std::move(fresh);
+    if (tab.circuits.constData() != before) {
+        tab.treeModel->setCircuits(&tab.circuits);
+        tab.treeCurrent = QPersistentModelIndex();
+    } else {
+        tab.treeModel->appendCircuits();
+    }
+    // The query server gets the report once finish() has linked it; a
+    // snapshot per tick would copy every circuit again.
+    tab.diffModel->appendDiffs(freshDiffs);
+    showStatus(tr("Streaming netgen report: %1 circuits compared, %2 with "
+                  "differences")
+                   .arg(lvsStream_->circuitCount())
+                   .arg(tab.treeModel->rowCount()));
+}
+
+void MainWindow::updateLvsStatus() {
+    if ((lvsStatusLabel_ == nullptr) || (lvsQueue_ == nullptr)) {
+        return;
+    }
+    lvsJobModel_->refreshRunning();
+    const int running = lvsQueue_->runningCount();
+    const int queued = lvsQueue_->pendingCount() - running;
+    if (running == 0 && queued == 0) {
+        lvsStatusLabel_->setText(tr("Idle"));
+        return;
+    }
+    lvsStatusLabel_->setText(
+        tr("%1 running, %2 queued").arg(running).arg(queued));
 }
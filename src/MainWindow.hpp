@@ -2,7 +2,11 @@
 
 #include <QDir>
 #include <QMainWindow>
+#include <QPersistentModelIndex>
 #include <QStringList>
+#include <array>
+#include <memory>
+#include <vector>
 
 class QLabel;
 class QTableView;
@@ -13,16 +17,33 @@ class QComboBox;
 class QLineEdit;
 class QMenu;
 class QStackedWidget;
+class QTabBar;
 class QPushButton;
 class QDockWidget;
 class QPlainTextEdit;
 class QLineEdit;
 class QTreeView;
+class QTimer;
+class QSpinBox;
+class QCheckBox;
+class QTreeWidget;
+class QFileSystemWatcher;
+class MemoryReport;
+class LvsJobQueue;
+class LvsJobModel;
+class QueryServer;
+class DiffClusterModel;
+class SpiceIndex;
 
 #include "models/CircuitTreeModel.hpp"
 #include "models/DiffEntryModel.hpp"
 #include "models/DiffFilterProxyModel.hpp"
+#include "models/DiffMasters.hpp"
+#include "parsers/DiffDetailCache.hpp"
 #include "parsers/NetgenJsonParser.hpp"
+#include "parsers/NetgenJsonStreamParser.hpp"
+#include "parsers/PropertyTolerances.hpp"
+#include "parsers/StringPool.hpp"
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -30,9 +51,64 @@ class MainWindow : public QMainWindow {
   public:
     explicit MainWindow(QWidget *parent = nullptr);
 
+    // Opens the report in a new tab, or reloads it in the tab showing it.
     auto loadFile(const QString &path, bool showError = false) -> bool;
+    // Starts or stops the local query endpoint (View -> Query Server).
+    void setQueryServerEnabled(bool enabled);
+    // Marks the current report's diffs new or unchanged against the report
+    // at baselinePath, opened in a tab if needed, and adds the baseline's
+    // fixed diffs (File -> Compare With Baseline).
+    auto compareWith(const QString &baselinePath) -> bool;
+    // Marks the diffs of every tab covered by the rules in path (File ->
+    // Load Waivers); see WaiverSet for the format.
+    auto loadWaivers(const QString &path, bool showError = false) -> bool;
+    // Compares property values within the tolerances in path (File -> Load
+    // Tolerances) and reloads the open reports; see PropertyTolerances.
+    auto loadTolerances(const QString &path, bool showError = false) -> bool;
+    // Netlists the Source dock (View -> Source) shows diffs in, indexed in
+    // the background while it is open; the LVS dock's layout and
+    // schematic files unless set here.
+    void setSourceNetlists(const QString &layout, const QString &schematic);
+
+  protected:
+    auto eventFilter(QObject *watched, QEvent *event) -> bool override;
 
   private:
+    // One open report with its own models; the views show the current
+    // tab's, so switching tabs rebinds them without reparsing or
+    // refiltering. Strings and identical per-cell data are shared between
+    // tabs through stringPool_.
+    struct ReportTab {
+        QString source;
+        NetgenJsonParser::Summary summary;
+        QVector<NetgenJsonParser::Report::Circuit> circuits;
+        DiffMasters masters; // instance counts shown by diffModel
+        // Set while the report was loaded with details on demand; shared
+        // with the query server's snapshot.
+        std::shared_ptr<const DiffDetailCache> detailCache;
+        qint64 fileSize{0};
+        DiffEntryModel *diffModel{nullptr};
+        DiffFilterProxyModel *proxyModel{nullptr};
+        CircuitTreeModel *treeModel{nullptr};
+        QPersistentModelIndex treeCurrent;
+        QString typeText;
+        QString searchText;
+        QString baseline; // source compared with; empty without a delta
+        QString deltaText;
+    };
+
+    void showReport(ReportTab &tab, NetgenJsonParser::Report &&report,
+                    const QString &source);
+    auto addTab() -> ReportTab &;
+    // The tab already showing path, else the current tab while it is
+    // empty, else a new one.
+    auto tabForLoad(const QString &path) -> ReportTab &;
+    auto tabIndex(const ReportTab &tab) const -> int;
+    void activateTab(int index);
+    void closeTab(int index);
+    void chooseBaseline();
+    void refreshTabTitle(const ReportTab &tab);
+    void addRecentFile(const QString &path);
     void buildUi();
     void buildMenus();
     void setSummary(int device, int net, int shorts, int opens,
@@ -53,14 +129,62 @@ class MainWindow : public QMainWindow {
     void refreshLogView();
     void openLvsDialog();
     void ensureLvsDock();
+    void startLvsRun();
+    void startQuickCompare();
+    void enqueueLvsJob(const QString &layout, const QString &schematic,
+                       const QString &rules);
+    void importLvsJobList();
+    void loadLvsJob(int row);
+    void onLvsJobFinished(int row, bool ok);
+    void updateLvsStatus();
+    void showLvsStreamProgress();
     void applyCircuitFilter(const QModelIndex &index);
+    // Circuits under index, with the other entries of their masters so
+    // that "Unique per master" still shows a repeated cell's diffs.
+    static auto allowedCircuits(const ReportTab &tab,
+                                const QModelIndex &index) -> QSet<int>;
+    void applyUniqueMasters(ReportTab &tab);
+    // Regroups the rows the current tab's filter shows while "Group
+    // similar" is checked, and empties the grouped view otherwise.
+    void refreshClusters();
+    void showClusterMember(const QModelIndex &index);
+    // One side of the Source dock.
+    struct SourcePane {
+        QString netlist; // to show
+        QString indexed; // what index was built from
+        std::shared_ptr<const SpiceIndex> index;
+        bool indexing{false};
+        QLabel *label{nullptr};
+        QPlainTextEdit *view{nullptr};
+        // The files of index; a change drops index before anything reads
+        // a mapping that may have shrunk under it.
+        QFileSystemWatcher *watcher{nullptr};
+    };
+
+    void ensureSourceDock();
+    // Starts indexing side's netlist unless its index is current.
+    void indexNetlist(int side);
+    // Drops side's index, and re-indexes while the dock shows.
+    void sourceFileChanged(int side);
+    void showDiffSource(const QModelIndex &current);
+    void ensurePerfDock();
+    void refreshPerfView();
+    void exportTrace();
+    // All tabs, or only one.
+    auto memoryReport(const ReportTab *only = nullptr) const -> MemoryReport;
+    void refreshMemoryView();
+    void publishSnapshot();
 
-    DiffEntryModel *diffModel_{nullptr};
-    DiffFilterProxyModel *proxyModel_{nullptr};
-    CircuitTreeModel *circuitTreeModel_{nullptr};
     QTableView *diffTable_{nullptr};
     QTreeView *circuitTree_{nullptr};
     QComboBox *typeFilter_{nullptr};
+    QComboBox *deltaFilter_{nullptr};
+    QCheckBox *hideWaived_{nullptr};
+    QCheckBox *groupSimilar_{nullptr};
+    QCheckBox *uniqueMasters_{nullptr};
+    QTreeView *clusterView_{nullptr};
+    DiffClusterModel *clusterModel_{nullptr};
+    QTimer *clusterTimer_{nullptr}; // coalesces proxy changes
     QLineEdit *searchField_{nullptr};
     QMenu *recentMenu_{nullptr};
     QStringList recentFiles_;
@@ -68,6 +192,7 @@ class MainWindow : public QMainWindow {
     QStackedWidget *stack_{nullptr};
     QWidget *contentPage_{nullptr};
     QWidget *welcomePage_{nullptr};
+    QTabBar *tabBar_{nullptr};
     QPushButton *loadButton_{nullptr};
     QLabel *deviceMismatchLabel_{nullptr};
     QLabel *netMismatchLabel_{nullptr};
@@ -83,6 +208,45 @@ class MainWindow : public QMainWindow {
     QLineEdit *lvsLayoutEdit_{nullptr};
     QLineEdit *lvsSchematicEdit_{nullptr};
     QLineEdit *lvsRulesEdit_{nullptr};
-    QVector<NetgenJsonParser::Report::Circuit> circuits_;
+    QLabel *lvsStatusLabel_{nullptr};
+    QPushButton *lvsRunButton_{nullptr};
+    QPushButton *lvsQuickButton_{nullptr};
+    QPushButton *lvsCancelButton_{nullptr};
+    QTimer *lvsTicker_{nullptr};
+    QSpinBox *lvsConcurrency_{nullptr};
+    QCheckBox *lvsForceRerun_{nullptr};
+    QCheckBox *lvsStreamJson_{nullptr};
+    QCheckBox *lvsKeepJson_{nullptr};
+    QTimer *lvsStreamTimer_{nullptr};
+    std::unique_ptr<NetgenJsonStreamParser> lvsStream_;
+    int lvsStreamJobId_{-1};
+    bool lvsStreamShown_{false};
+    // Circuits taken from lvsStream_ once its tab was closed; until then
+    // they live in the tab's circuits. finish() gets them back.
+    QVector<NetgenJsonParser::Report::Circuit> lvsStreamHeld_;
+    QTableView *lvsJobTable_{nullptr};
+    LvsJobQueue *lvsQueue_{nullptr};
+    LvsJobModel *lvsJobModel_{nullptr};
+    int lvsBatchSize_{0};
+    QDockWidget *sourceDock_{nullptr};
+    std::array<SourcePane, 2> sourcePanes_; // layout, schematic
+    QDockWidget *perfDock_{nullptr};
+    QTreeWidget *perfTree_{nullptr};
+    QCheckBox *perfRecord_{nullptr};
+    QLabel *perfStatusLabel_{nullptr};
+    QTimer *perfTimer_{nullptr};
+    qsizetype perfShown_{-1}; // event count the view was built from
+    QTreeWidget *memoryTree_{nullptr};
+    QLabel *memoryStatusLabel_{nullptr};
+    QSpinBox *memoryBudget_{nullptr};
+    qint64 firstPaintStartNs_{-1}; // set by showReport while tracing
+    std::vector<std::unique_ptr<ReportTab>> tabs_; // in tab bar order
+    ReportTab *tab_{nullptr};                       // current
+    ReportTab *lvsStreamTab_{nullptr};
+    StringPool stringPool_;
+    QueryServer *queryServer_{nullptr};
+    QAction *queryServerAction_{nullptr};
+    std::shared_ptr<const WaiverSet> waivers_; // shared by all tabs
+    PropertyTolerances tolerances_; // applied when a report is parsed
     QString lvsLastDir_{QDir::currentPath()};
 };
@@ -0,0 +1,117 @@
+#pragma once
+
+// opensvs_core: netgen LVS report handling on QtCore alone; no class
+// below uses QtGui or QtWidgets.
+//
+//   NetgenJsonParser        parseFile() turns a netgen `-json` report into a
+//                           Report: per-circuit summaries, DiffEntry rows and
+//                           the subcircuit hierarchy.
+//   NetgenJsonStreamParser  the same from chunks of a report still being
+//                           written (pipes, stdin, FIFOs).
+//   NetConnectivity         shorts and opens in netgen's badnets: nets on
+//                           one side that sum to a net on the other.
+//   PinMatcher              missing, renamed and reordered pins in
+//                           netgen's pin pairing.
+//   DeviceHistogram         device counts per class on both sides, rolled
+//                           up through the hierarchy.
+//   SpiceNumber             allocation-free parsing of SPICE values with
+//                           scale suffixes (1u, 10k, 1meg).
+//   PropertyTolerances      per-parameter relative/absolute tolerances for
+//                           property values, from a rule file.
+//   SpiceTokenizer          SPICE statements and tokens in place, as
+//                           SpiceIndex and SpiceNetlist read them.
+//   SpiceIndex              memory-mapped SPICE netlists indexed by
+//                           subckt, instance and net for jump-to-source.
+//   SpiceNetlist            SPICE netlists read into subcircuits, ports
+//                           and elements, includes followed.
+//   NetlistComparator       layout against schematic netlist without
+//                           netgen, by partition refinement, as netgen's
+//                           JSON for parseCircuits(); unchanged cells are
+//                           taken from the Records of an earlier run.
+//   SubcktHashes            Merkle digests of a netlist's subcircuits,
+//                           which tell the comparator what changed.
+//   DiffDetailCache         details of a report parsed with
+//                           Details::OnDemand, spilled to a temporary file
+//                           per diff and read back through an LRU cache.
+//   StringPool              interned strings and per-cell data shared by
+//                           several reports of the same design.
+//   DiffDelta               new / fixed / unchanged diffs of a report
+//                           against a baseline run, by hash join.
+//   DiffFilter              type / search / circuit / delta / waiver /
+//                           master predicate used by the GUI table and the
+//                           CLI.
+//   WaiverSet               accepted mismatches from a waiver file, compiled
+//                           into one multi-pattern matcher.
+//   DiffClusters            groups of diffs that repeat one issue, by
+//                           index- and magnitude-masked signature.
+//   DiffMasters             circuits grouped by cell master, with each
+//                           master's instance count under the top cells.
+//   DiffExporter            summary and diff rows as text, CSV, TSV or JSON.
+//   DiffEntryModel          diff rows as a table model, details read on
+//                           demand through a DiffDetailCache off the GUI
+//                           thread.
+//   DiffFilterProxyModel    DiffFilter over a DiffEntryModel.
+//   CircuitTreeModel        the subcircuit hierarchy as a tree model.
+//   DiffClusterModel        DiffClusters as a two-level tree model.
+//   LvsRunner               one asynchronous netgen run with live output,
+//                           cancel and, through a FIFO, a streamed report.
+//   NetgenOutTail           per-cell verdicts from netgen's `.out` log
+//                           while it is written.
+//   DetachedThread          work on a self-deleting thread that may outlive
+//                           the object that started it.
+//   LvsJobQueue             netgen runs with bounded concurrency, served
+//                           from an LvsResultCache on a hit.
+//   LvsResultCache          netgen reports keyed by a content hash of the
+//                           inputs and everything they include.
+//   Tracer                  opt-in timing spans (OPENSVS_TRACE_SCOPE) with
+//                           Chrome trace export.
+//   MemoryReport            heap bytes held by a parsed report, by field.
+//   MemoryBudget            configurable budget and the bytes-per-file-byte
+//                           ratio learned from earlier loads.
+//
+// Link with find_package(opensvs) and target opensvs::core. All classes are
+// reentrant: separate instances may be used from separate threads.
+//
+//   const auto report = NetgenJsonParser::parseFile(path);
+//   if (!report.ok) { /* report.error */ }
+//   DiffFilter filter;
+//   filter.setTypeFilter(QStringLiteral("net_mismatch"));
+//   for (const auto &circuit : report.circuits)
+//       for (const auto &entry : circuit.diffs)
+//           if (filter.accepts(entry)) { /* ... */ }
+
+#include "diagnostics/MemoryBudget.hpp"
+#include "diagnostics/MemoryReport.hpp"
+#include "diagnostics/Tracer.hpp"
+#include "exporters/DiffExporter.hpp"
+#include "lvs/DetachedThread.hpp"
+#include "lvs/LvsJobQueue.hpp"
+#include "lvs/LvsResultCache.hpp"
+#include "lvs/LvsRunner.hpp"
+#include "lvs/NetgenOutTail.hpp"
+#include "models/CircuitTreeModel.hpp"
+#include "models/DiffClusterModel.hpp"
+#include "models/DiffClusters.hpp"
+#include "models/DiffDelta.hpp"
+#include "models/DiffEntryCommon.hpp"
+#include "models/DiffEntryModel.hpp"
+#include "models/DiffFilter.hpp"
+#include "models/DiffFilterProxyModel.hpp"
+#include "models/DiffMasters.hpp"
+#include "models/WaiverSet.hpp"
+#include "parsers/DeviceHistogram.hpp"
+#include "parsers/DiffDetailCache.hpp"
+#include "parsers/NetConnectivity.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+#include "parsers/NetgenJsonStreamParser.hpp"
+#include "parsers/NetlistComparator.hpp"
+#include "parsers/PinMatcher.hpp"
+#include "parsers/PropertyTolerances.hpp"
+#include "parsers/SpiceIndex.hpp"
+#include "parsers/SpiceNetlist.hpp"
+#include "parsers/SpiceNumber.hpp"
+#include "parsers/SpiceTokenizer.hpp"
+#include "parsers/StringPool.hpp"
+#include "parsers/SubcktHashes.hpp"
+
+#include "OpenSvsVersion.hpp"
@@ -0,0 +1,848 @@
+#include "cli/Cli.hpp"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QLocale>
+#include <QSet>
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <utility>
+
+#include "diagnostics/MemoryBudget.hpp"
+#include "diagnostics/MemoryReport.hpp"
+#include "diagnostics/Tracer.hpp"
+#include "exporters/DiffExporter.hpp"
+#include "models/DiffClusters.hpp"
+#include "models/DiffDelta.hpp"
+#include "models/DiffFilter.hpp"
+#include "models/DiffMasters.hpp"
+#include "models/WaiverSet.hpp"
+#include "parsers/DeviceHistogram.hpp"
+#include "parsers/DiffDetailCache.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+#include "parsers/NetgenJsonStreamParser.hpp"
+#include "parsers/NetlistComparator.hpp"
+#include "parsers/PropertyTolerances.hpp"
+
+namespace {
+const qint64 stdinChunk = 4 * 1024 * 1024;
+
+auto readReport(const QString &path, NetgenJsonParser::Details details,
+                const PropertyTolerances &tolerances)
+    -> NetgenJsonParser::Report {
+    if (path != QStringLiteral("-")) {
+        return NetgenJsonParser::parseFile(path, details, tolerances);
+    }
+    OPENSVS_TRACE_SCOPE("read standard input", "cli");
+    QFile in;
+    NetgenJsonStreamParser stream;
+    stream.setTolerances(tolerances);
+    if (!in.open(stdin, QIODevice::ReadOnly)) {
+        NetgenJsonParser::Report report;
+        report.error = QStringLiteral("Failed to read standard input");
+        return report;
+    }
+    while (!stream.hasError()) {
+        const QByteArray chunk = in.read(stdinChunk);
+        if (chunk.isEmpty()) {
+            break;
+        }
+        stream.feed(chunk);
+    }
+    return stream.finish();
+}
+
+// The in-process comparison, read as the netgen report it writes. With a
+// records file, cells unchanged since the run that saved it are reused.
+auto compareNetlists(const QString &layout, const QString &schematic,
+                     const QStringList &flatten,
+                     const PropertyTolerances &tolerances,
+                     const QString &recordsPath, QTextStream &err)
+    -> NetgenJsonParser::Report {
+    NetlistComparator::Options options;
+    options.flatten = flatten;
+    NetlistComparator::Records records;
+    QString error;
+    if (!recordsPath.isEmpty()) {
+        // A missing or unreadable file only means nothing is reused.
+        if (QFileInfo::exists(recordsPath) &&
+            !records.load(recordsPath, &error)) {
+            err << "Note: " << error << "; comparing every cell\n";
+        }
+        options.previous = &records;
+        options.records = &records;
+    }
+    const QJsonArray circuits =
+        NetlistComparator::compareFiles(layout, schematic, options, &error);
+    NetgenJsonParser::Report report;
+    if (circuits.isEmpty()) {
+        report.error = error;
+        return report;
+    }
+    if (!recordsPath.isEmpty()) {
+        if (!records.save(recordsPath, &error)) {
+            report.error = error;
+            return report;
+        }
+        err << "Note: reused " << records.reusedCount() << " of "
+            << records.cells.size() << " cells from " << recordsPath
+            << '\n';
+    }
+    return NetgenJsonParser::parseCircuits(circuits, tolerances);
+}
+
+// Field separator of the delimited formats.
+auto separator(DiffExporter::Format format) -> QChar {
+    return format == DiffExporter::Format::Csv ? QLatin1Char(',')
+                                               : QLatin1Char('\t');
+}
+
+void writeDelta(QTextStream &out, DiffExporter::Format format,
+                const QString &baseline, const DiffDelta::Result &delta) {
+    const qint64 fixed = delta.fixed.size();
+    if (format == DiffExporter::Format::Text) {
+        out << "Baseline: " << baseline << '\n'
+            << "Delta: " << delta.newCount << " new, " << fixed
+            << " fixed, " << delta.unchangedCount << " unchanged\n";
+        return;
+    }
+    const QChar sep = separator(format);
+    out << "delta" << sep << "count\n"
+        << "new" << sep << delta.newCount << '\n'
+        << "fixed" << sep << fixed << '\n'
+        << "unchanged" << sep << delta.unchangedCount << '\n';
+}
+
+void writeWaivers(QTextStream &out, DiffExporter::Format format,
+                  const QString &path, const WaiverSet &waivers,
+                  qint64 waived) {
+    if (format == DiffExporter::Format::Text) {
+        out << "Waivers: " << path << " (" << waivers.rules().size()
+            << " rules)\n"
+            << "Waived: " << waived << '\n';
+        return;
+    }
+    const QChar sep = separator(format);
+    out << "waiver_rules" << sep << "waived\n"
+        << waivers.rules().size() << sep << waived << '\n';
+}
+
+void writeMasters(QTextStream &out, DiffExporter::Format format,
+                  const DiffMasters &masters) {
+    const qint64 duplicates = masters.duplicateCircuits().size();
+    if (format == DiffExporter::Format::Text) {
+        out << "Masters: " << masters.masters().size() << " ("
+            << duplicates << " repeated entries left out)\n"
+            << "Diff occurrences: " << masters.occurrenceCount()
+            << " across instances\n";
+        return;
+    }
+    const QChar sep = separator(format);
+    out << "masters" << sep << "duplicate_entries" << sep << "occurrences\n"
+        << masters.masters().size() << sep << duplicates << sep
+        << masters.occurrenceCount() << '\n';
+}
+
+// Rolled-up device classes of each top-level circuit.
+void writeDevices(QTextStream &out, DiffExporter::Format format,
+                  const QVector<NetgenJsonParser::Report::Circuit> &circuits,
+                  const QVector<QVector<DeviceHistogram::ClassCount>> &rows) {
+    const bool text = format == DiffExporter::Format::Text;
+    const QChar sep = separator(format);
+    if (!text) {
+        out << "layout_cell" << sep << "schematic_cell" << sep << "class"
+            << sep << "layout" << sep << "schematic\n";
+    }
+    for (qsizetype i = 0; i < circuits.size(); ++i) {
+        const auto &cir = circuits.at(i);
+        if (!cir.isTopLevel) {
+            continue;
+        }
+        if (text) {
+            out << "Devices with subcells: " << cir.layoutCell << " vs "
+                << cir.schematicCell << '\n';
+        }
+        for (const auto &row : rows.at(i)) {
+            if (text) {
+                out << "    " << row.deviceClass << ": " << row.layout
+                    << " vs " << row.schematic
+                    << (row.layout != row.schematic ? " **Mismatch**" : "")
+                    << '\n';
+            } else {
+                out << cir.layoutCell << sep << cir.schematicCell << sep
+                    << row.deviceClass << sep << row.layout << sep
+                    << row.schematic << '\n';
+            }
+        }
+    }
+}
+
+auto devicesJson(const QVector<NetgenJsonParser::Report::Circuit> &circuits,
+                 const QVector<QVector<DeviceHistogram::ClassCount>> &rows)
+    -> QJsonArray {
+    QJsonArray array;
+    for (qsizetype i = 0; i < circuits.size(); ++i) {
+        const auto &cir = circuits.at(i);
+        if (!cir.isTopLevel) {
+            continue;
+        }
+        QJsonArray classes;
+        for (const auto &row : rows.at(i)) {
+            classes.append(
+                QJsonObject{{QStringLiteral("class"), row.deviceClass},
+                            {QStringLiteral("layout"), row.layout},
+                            {QStringLiteral("schematic"), row.schematic}});
+        }
+        array.append(
+            QJsonObject{{QStringLiteral("layout_cell"), cir.layoutCell},
+                        {QStringLiteral("schematic_cell"), cir.schematicCell},
+                        {QStringLiteral("classes"), classes}});
+    }
+    return array;
+}
+
+void writeGroups(QTextStream &out, DiffExporter::Format format,
+                 const QVector<DiffClusters::Cluster> &clusters) {
+    if (format == DiffExporter::Format::Text) {
+        for (const auto &cluster : clusters) {
+            out << cluster.rows.size() << " x "
+                << NetgenJsonParser::toTypeString(cluster.type) << " ("
+                << NetgenJsonParser::toSubtypeString(cluster.subtype) << ") "
+                << cluster.layoutCell << ": " << cluster.name << '\n'
+                << "    " << cluster.details << '\n';
+        }
+        return;
+    }
+    const bool csv = format == DiffExporter::Format::Csv;
+    const QChar sep = separator(format);
+    out << QStringList{QStringLiteral("count"), QStringLiteral("type"),
+                       QStringLiteral("subtype"), QStringLiteral("object"),
+                       QStringLiteral("layout_cell"),
+                       QStringLiteral("schematic_cell"),
+                       QStringLiteral("details")}
+               .join(sep)
+        << '\n';
+    for (const auto &cluster : clusters) {
+        QStringList fields{
+            NetgenJsonParser::toTypeString(cluster.type),
+            NetgenJsonParser::toSubtypeString(cluster.subtype), cluster.name,
+            cluster.layoutCell, cluster.schematicCell, cluster.details};
+        for (QString &field : fields) {
+            field = csv ? DiffExporter::csvField(field)
+                        : DiffExporter::tsvField(field);
+        }
+        out << cluster.rows.size() << sep << fields.join(sep) << '\n';
+    }
+}
+
+auto groupsJson(const QVector<DiffClusters::Cluster> &clusters)
+    -> QJsonArray {
+    QJsonArray groups;
+    for (const auto &cluster : clusters) {
+        groups.append(QJsonObject{
+            {QStringLiteral("count"), static_cast<qint64>(cluster.rows.size())},
+            {QStringLiteral("type"),
+             NetgenJsonParser::toTypeString(cluster.type)},
+            {QStringLiteral("subtype"),
+             NetgenJsonParser::toSubtypeString(cluster.subtype)},
+            {QStringLiteral("object"), cluster.name},
+            {QStringLiteral("layout_cell"), cluster.layoutCell},
+            {QStringLiteral("schematic_cell"), cluster.schematicCell},
+            {QStringLiteral("details"), cluster.details}});
+    }
+    return groups;
+}
+
+// Writes the recorded spans when run() returns, whichever way it does.
+class TraceFile {
+  public:
+    TraceFile(QString path, QTextStream &err)
+        : path_(std::move(path)), err_(err) {
+        Tracer::setEnabled(true);
+    }
+    ~TraceFile() {
+        Tracer::setEnabled(false);
+        QString error;
+        if (!Tracer::saveChromeTrace(path_, &error)) {
+            err_ << "Failed to write trace " << path_ << ": " << error
+                 << '\n';
+        }
+    }
+    TraceFile(const TraceFile &) = delete;
+    auto operator=(const TraceFile &) -> TraceFile & = delete;
+
+  private:
+    QString path_;
+    QTextStream &err_;
+};
+
+// The command line, checked once; run() reads nothing else.
+struct Options {
+    DiffExporter::Format format = DiffExporter::Format::Text;
+    QString path;      // the report, or with netlists the layout netlist
+    QString schematic; // with netlists
+    QString source;    // path as the output names it
+    bool netlists = false;
+    QStringList flatten;
+    QString incremental;
+    QString baseline;
+    QString delta;
+    QString waivers;
+    QString tolerances;
+    QString trace;
+    bool onDemand = false;
+    QString type;
+    QString search;
+    std::optional<QString> cell;
+    bool showWaived = false;
+    bool group = false;
+    bool uniqueMasters = false;
+    bool devices = false;
+    bool memory = false;
+    bool listDiffs = false;
+    bool summary = false;
+};
+
+// Fills *options from arguments. Returns an exit code when there is
+// nothing left to run: help, version, or a usage error written to err.
+auto parseOptions(const QStringList &arguments, Options *options,
+                  QTextStream &out, QTextStream &err) -> std::optional<int> {
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        QStringLiteral("OpenSVS headless netgen JSON report summary"));
+    const QCommandLineOption helpOption = parser.addHelpOption();
+    const QCommandLineOption versionOption = parser.addVersionOption();
+    const QCommandLineOption summaryOption(
+        QStringLiteral("summary"),
+        QStringLiteral("Print the report summary (default)."));
+    const QCommandLineOption listOption(QStringLiteral("list-diffs"),
+                                        QStringLiteral("Print the diffs."));
+    const QCommandLineOption formatOption(
+        QStringLiteral("format"),
+        QStringLiteral("Output format: text, json, csv or tsv."),
+        QStringLiteral("format"), QStringLiteral("text"));
+    const QCommandLineOption typeOption(
+        QStringLiteral("type"),
+        QStringLiteral("Only diffs of this type, e.g. net_mismatch."),
+        QStringLiteral("type"));
+    const QCommandLineOption searchOption(
+        QStringLiteral("search"),
+        QStringLiteral("Only diffs whose object or details match (regex)."),
+        QStringLiteral("pattern"));
+    const QCommandLineOption cellOption(
+        QStringLiteral("cell"),
+        QStringLiteral("Only diffs in this cell and its subcells."),
+        QStringLiteral("cell"));
+    const QCommandLineOption traceOption(
+        QStringLiteral("trace"),
+        QStringLiteral("Write timing spans as Chrome trace JSON to file."),
+        QStringLiteral("file"));
+    const QCommandLineOption onDemandOption(
+        QStringLiteral("details-on-demand"),
+        QStringLiteral("Keep only the diff core in memory and read details "
+                       "back from the file; implied over the memory "
+                       "budget."));
+    const QCommandLineOption baselineOption(
+        QStringLiteral("baseline"),
+        QStringLiteral("Compare with an earlier report of the same design "
+                       "and count new, fixed and unchanged diffs."),
+        QStringLiteral("file"));
+    const QCommandLineOption deltaOption(
+        QStringLiteral("delta"),
+        QStringLiteral("With --baseline, only new, fixed or unchanged "
+                       "diffs; fixed ones come from the baseline."),
+        QStringLiteral("status"));
+    const QCommandLineOption waiversOption(
+        QStringLiteral("waivers"),
+        QStringLiteral("Leave out diffs covered by the rules in file."),
+        QStringLiteral("file"));
+    const QCommandLineOption tolerancesOption(
+        QStringLiteral("tolerances"),
+        QStringLiteral("Compare property values as numbers within the "
+                       "per-parameter tolerances in file."),
+        QStringLiteral("file"));
+    const QCommandLineOption showWaivedOption(
+        QStringLiteral("show-waived"),
+        QStringLiteral("With --waivers, still list and count waived diffs."));
+    const QCommandLineOption groupOption(
+        QStringLiteral("group"),
+        QStringLiteral("List one row per group of similar diffs, largest "
+                       "first, instead of every diff."));
+    const QCommandLineOption uniqueMastersOption(
+        QStringLiteral("unique-masters"),
+        QStringLiteral("Count the diffs of a cell reported more than once "
+                       "only once, and sum them over its instances."));
+    const QCommandLineOption devicesOption(
+        QStringLiteral("devices"),
+        QStringLiteral("Print the device count per class of each top-level "
+                       "cell, subcells included."));
+    const QCommandLineOption memoryOption(
+        QStringLiteral("memory"),
+        QStringLiteral("Print the memory held by the parsed report."));
+    const QCommandLineOption netlistsOption(
+        QStringLiteral("netlists"),
+        QStringLiteral("Compare the layout and schematic SPICE netlists "
+                       "given instead of a report, without netgen."));
+    const QCommandLineOption flattenOption(
+        QStringLiteral("flatten"),
+        QStringLiteral("With --netlists, flatten this cell into its "
+                       "parents; may be repeated."),
+        QStringLiteral("cell"));
+    const QCommandLineOption incrementalOption(
+        QStringLiteral("incremental"),
+        QStringLiteral("With --netlists, reuse the results of subcircuits "
+                       "unchanged since the run that saved file, and save "
+                       "this run's there."),
+        QStringLiteral("file"));
+    parser.addOptions({summaryOption, listOption, formatOption, typeOption,
+                       searchOption, cellOption, traceOption, memoryOption,
+                       onDemandOption, baselineOption, deltaOption,
+                       waiversOption, showWaivedOption, groupOption,
+                       uniqueMastersOption, devicesOption, tolerancesOption,
+                       netlistsOption, flattenOption, incrementalOption});
+    parser.addPositionalArgument(
+        QStringLiteral("report"),
+        QStringLiteral("netgen JSON report, or - to read standard input; "
+                       "with --netlists, the layout and schematic "
+                       "netlists."));
+
+    if (!parser.parse(arguments)) {
+        err << parser.errorText() << '\n';
+        return Cli::ExitError;
+    }
+    if (parser.isSet(helpOption)) {
+        out << parser.helpText();
+        return Cli::ExitClean;
+    }
+    if (parser.isSet(versionOption)) {
+        out << QCoreApplication::applicationName() << ' '
+            << QCoreApplication::applicationVersion() << '\n';
+        return Cli::ExitClean;
+    }
+
+    bool formatOk = false;
+    options->format =
+        DiffExporter::parseFormat(parser.value(formatOption), &formatOk);
+    if (!formatOk) {
+        err << "Unknown format: " << parser.value(formatOption) << '\n';
+        return Cli::ExitError;
+    }
+    const QStringList positional = parser.positionalArguments();
+    const bool netlists = parser.isSet(netlistsOption);
+    if (netlists && (positional.size() != 2 ||
+                     positional.contains(QStringLiteral("-")))) {
+        err << "Expected a layout and a schematic netlist file\n";
+        return Cli::ExitError;
+    }
+    if (!netlists && positional.size() != 1) {
+        err << "Expected exactly one report file\n";
+        return Cli::ExitError;
+    }
+    if (!netlists && parser.isSet(flattenOption)) {
+        err << "--flatten needs --netlists\n";
+        return Cli::ExitError;
+    }
+    if (!netlists && parser.isSet(incrementalOption)) {
+        err << "--incremental needs --netlists\n";
+        return Cli::ExitError;
+    }
+    const QString path = positional.first();
+    const QString deltaStatus = parser.value(deltaOption).trimmed();
+    if (!deltaStatus.isEmpty() && !parser.isSet(baselineOption)) {
+        err << "--delta needs --baseline\n";
+        return Cli::ExitError;
+    }
+    if (!deltaStatus.isEmpty() && deltaStatus != QStringLiteral("new") &&
+        deltaStatus != QStringLiteral("fixed") &&
+        deltaStatus != QStringLiteral("unchanged")) {
+        err << "Unknown delta: " << deltaStatus << '\n';
+        return Cli::ExitError;
+    }
+    const QString baselinePath = parser.value(baselineOption);
+    if (baselinePath == QStringLiteral("-") && path == QStringLiteral("-")) {
+        err << "Only one report can be read from standard input\n";
+        return Cli::ExitError;
+    }
+
+    options->path = path;
+    options->schematic = netlists ? positional.at(1) : QString();
+    options->source = path == QStringLiteral("-")
+                          ? QStringLiteral("-")
+                          : QFileInfo(path).absoluteFilePath();
+    options->netlists = netlists;
+    options->flatten = parser.values(flattenOption);
+    options->incremental = parser.value(incrementalOption);
+    options->baseline = baselinePath;
+    options->delta = deltaStatus;
+    options->waivers = parser.value(waiversOption);
+    options->tolerances = parser.value(tolerancesOption);
+    options->trace = parser.value(traceOption);
+    options->onDemand = parser.isSet(onDemandOption);
+    options->type = parser.value(typeOption);
+    options->search = parser.value(searchOption);
+    if (parser.isSet(cellOption)) {
+        options->cell = parser.value(cellOption);
+    }
+    options->showWaived = parser.isSet(showWaivedOption);
+    options->group = parser.isSet(groupOption);
+    options->uniqueMasters = parser.isSet(uniqueMastersOption);
+    options->devices = parser.isSet(devicesOption);
+    options->memory = parser.isSet(memoryOption);
+    // --format on its own asks for the rows; nothing at all, the summary.
+    // --group lists groups in place of the rows.
+    options->listDiffs = parser.isSet(listOption) || options->group ||
+                         (parser.isSet(formatOption) &&
+                          !parser.isSet(summaryOption));
+    options->summary = parser.isSet(summaryOption) || !options->listDiffs;
+    return std::nullopt;
+}
+
+// Built in place and never moved: diffs points into report and delta.
+struct Results {
+    WaiverSet waivers;
+    PropertyTolerances tolerances;
+    NetgenJsonParser::Report report;
+    std::optional<DiffDelta::Result> delta;
+    DiffMasters masters;
+    qint64 waivedCount = 0;
+    DiffExporter::DiffList diffs;
+
+    auto detailSource() const -> const DiffDetailCache * {
+        return report.detailCache.get();
+    }
+};
+
+// Standard input cannot be read twice, so its details stay resident.
+auto detailsFor(const Options &options, const MemoryBudget &budget,
+                const QString &file, qint64 inUse, QTextStream &err)
+    -> NetgenJsonParser::Details {
+    if (file == QStringLiteral("-")) {
+        return NetgenJsonParser::Details::Resident;
+    }
+    const qint64 fileSize = QFileInfo(file).size();
+    if (options.onDemand) {
+        return NetgenJsonParser::Details::OnDemand;
+    }
+    if (budget.exceeds(fileSize, inUse)) {
+        const QLocale locale = QLocale::c();
+        err << "Note: " << file << " is projected to need "
+            << locale.formattedDataSize(budget.project(fileSize))
+            << ", over the memory budget of "
+            << locale.formattedDataSize(budget.budgetBytes())
+            << "; reading details on demand\n";
+        return NetgenJsonParser::Details::OnDemand;
+    }
+    return NetgenJsonParser::Details::Resident;
+}
+
+// Reads the rule files, the report and the baseline; false once an error
+// is written to err.
+auto loadInputs(const Options &options, Results *results, QTextStream &err)
+    -> bool {
+    QString error;
+    if (!options.waivers.isEmpty() &&
+        !results->waivers.load(options.waivers, &error)) {
+        err << error << '\n';
+        return false;
+    }
+    if (!options.tolerances.isEmpty() &&
+        !results->tolerances.load(options.tolerances, &error)) {
+        err << error << '\n';
+        return false;
+    }
+
+    const MemoryBudget budget;
+    NetgenJsonParser::Report &report = results->report;
+    report = options.netlists
+                 ? compareNetlists(options.path, options.schematic,
+                                   options.flatten, results->tolerances,
+                                   options.incremental, err)
+                 : readReport(options.path,
+                              detailsFor(options, budget, options.path, 0,
+                                         err),
+                              results->tolerances);
+    if (!report.ok) {
+        err << report.error << '\n';
+        return false;
+    }
+    if (options.baseline.isEmpty()) {
+        return true;
+    }
+
+    const qint64 inUse = MemoryReport::measure(report.circuits).total();
+    const NetgenJsonParser::Report baseline = readReport(
+        options.baseline,
+        detailsFor(options, budget, options.baseline, inUse, err),
+        results->tolerances);
+    if (!baseline.ok) {
+        err << baseline.error << '\n';
+        return false;
+    }
+    OPENSVS_TRACE_SCOPE("compare with baseline", "cli");
+    // Fixed rows carry their details, so the baseline can go.
+    results->delta = DiffDelta::compare(baseline.circuits, report.circuits,
+                                        baseline.detailCache.get(),
+                                        results->detailSource());
+    return true;
+}
+
+// Applies masters, filters and waivers to fill results->diffs; false once
+// an error is written to err.
+auto selectDiffs(const Options &options, Results *results, QTextStream &err)
+    -> bool {
+    const NetgenJsonParser::Report &report = results->report;
+    const std::optional<DiffDelta::Result> &delta = results->delta;
+    const DiffDetailCache *detailSource = results->detailSource();
+    if (options.uniqueMasters) {
+        results->masters = DiffMasters::build(report.circuits);
+    }
+    DiffFilter filter;
+    if (options.uniqueMasters) {
+        filter.setDuplicateCircuits(results->masters.duplicateCircuits());
+    }
+    filter.setTypeFilter(options.type);
+    filter.setSearchTerm(options.search);
+    filter.setDeltaFilter(options.delta);
+    filter.setHideWaived(!options.showWaived);
+    if (options.cell) {
+        // A repeated cell's diffs are kept on its first entry.
+        const QSet<int> allowed = results->masters.sameMaster(
+            DiffFilter::circuitsUnder(report.circuits, *options.cell));
+        if (allowed.isEmpty()) {
+            err << "No circuit named " << *options.cell << '\n';
+            return false;
+        }
+        filter.setAllowedCircuits(allowed);
+    }
+    const QVector<int> waived = results->waivers.apply(report.circuits);
+    results->waivedCount = static_cast<qint64>(std::count_if(
+        waived.cbegin(), waived.cend(), [](int rule) { return rule >= 0; }));
+
+    OPENSVS_TRACE_SCOPE("filter diffs", "cli");
+    DiffExporter::DiffList &diffs = results->diffs;
+    qsizetype row = 0;
+    for (const auto &cir : report.circuits) {
+        for (const auto &entry : cir.diffs) {
+            const QString status =
+                delta ? DiffDelta::toStatusString(delta->current.at(row))
+                      : QString();
+            const bool isWaived = waived.at(row) >= 0;
+            ++row;
+            // One pass in file order, so each circuit is re-read once.
+            const bool accepted =
+                detailSource != nullptr && !filter.searchTerm().isEmpty()
+                    ? filter.accepts(
+                          NetgenJsonParser::toTypeString(entry.type),
+                          entry.name, detailSource->details(entry),
+                          static_cast<int>(entry.circuitIndex), status,
+                          isWaived)
+                    : filter.accepts(
+                          NetgenJsonParser::toTypeString(entry.type),
+                          entry.name, entry.details,
+                          static_cast<int>(entry.circuitIndex), status,
+                          isWaived);
+            if (accepted) {
+                diffs.push_back(&entry);
+            }
+        }
+    }
+    // Fixed diffs are not in the report; they are listed on request.
+    if (delta && !filter.deltaFilter().isEmpty()) {
+        for (const auto &entry : delta->fixed) {
+            if (filter.accepts(NetgenJsonParser::toTypeString(entry.type),
+                               entry.name, entry.details,
+                               static_cast<int>(entry.circuitIndex),
+                               QStringLiteral("fixed"),
+                               results->waivers.match(entry) >= 0)) {
+                diffs.push_back(&entry);
+            }
+        }
+    }
+    return true;
+}
+
+// The sections beyond summary and rows, computed only when asked for.
+struct Sections {
+    QVector<DiffClusters::Cluster> clusters;
+    MemoryReport usage;
+    QVector<QVector<DeviceHistogram::ClassCount>> devices;
+};
+
+auto sectionsFor(const Options &options, const Results &results)
+    -> Sections {
+    Sections sections;
+    if (options.group) {
+        sections.clusters =
+            DiffClusters::cluster(results.diffs, results.detailSource());
+    }
+    if (options.memory) {
+        sections.usage = MemoryReport::measure(results.report.circuits);
+    }
+    if (options.devices) {
+        sections.devices = DeviceHistogram::rolledUp(results.report.circuits);
+    }
+    return sections;
+}
+
+void writeMemory(QTextStream &out, DiffExporter::Format format,
+                 const MemoryReport &usage) {
+    if (format == DiffExporter::Format::Text) {
+        usage.writeText(out);
+    } else {
+        usage.writeDelimited(out, separator(format));
+    }
+}
+
+// The sections as the extra members of the JSON output.
+auto jsonSections(const Options &options, const Results &results,
+                  const Sections &sections) -> QJsonObject {
+    QJsonObject extra;
+    if (options.memory) {
+        extra.insert(QStringLiteral("memory"), sections.usage.toJson());
+    }
+    if (!options.waivers.isEmpty()) {
+        extra.insert(
+            QStringLiteral("waivers"),
+            QJsonObject{
+                {QStringLiteral("file"),
+                 QFileInfo(options.waivers).absoluteFilePath()},
+                {QStringLiteral("rules"),
+                 static_cast<qint64>(results.waivers.rules().size())},
+                {QStringLiteral("waived"), results.waivedCount}});
+    }
+    if (results.delta) {
+        const DiffDelta::Result &delta = *results.delta;
+        extra.insert(
+            QStringLiteral("delta"),
+            QJsonObject{
+                {QStringLiteral("baseline"),
+                 options.baseline == QStringLiteral("-")
+                     ? options.baseline
+                     : QFileInfo(options.baseline).absoluteFilePath()},
+                {QStringLiteral("new"), delta.newCount},
+                {QStringLiteral("fixed"),
+                 static_cast<qint64>(delta.fixed.size())},
+                {QStringLiteral("unchanged"), delta.unchangedCount}});
+    }
+    if (options.uniqueMasters) {
+        const DiffMasters &masters = results.masters;
+        extra.insert(
+            QStringLiteral("masters"),
+            QJsonObject{
+                {QStringLiteral("masters"),
+                 static_cast<qint64>(masters.masters().size())},
+                {QStringLiteral("duplicate_entries"),
+                 static_cast<qint64>(masters.duplicateCircuits().size())},
+                {QStringLiteral("occurrences"), masters.occurrenceCount()}});
+    }
+    if (options.devices) {
+        extra.insert(QStringLiteral("devices"),
+                     devicesJson(results.report.circuits, sections.devices));
+    }
+    if (options.group) {
+        extra.insert(QStringLiteral("groups"), groupsJson(sections.clusters));
+    }
+    return extra;
+}
+
+void writeOutput(const Options &options, const Results &results,
+                 QTextStream &out) {
+    const Sections sections = sectionsFor(options, results);
+    OPENSVS_TRACE_SCOPE("write output", "cli");
+    const DiffExporter::Format format = options.format;
+    const NetgenJsonParser::Report &report = results.report;
+    if (format == DiffExporter::Format::Json) {
+        DiffExporter::writeJson(out, report, options.source, results.diffs,
+                                options.summary,
+                                options.listDiffs && !options.group,
+                                jsonSections(options, results, sections),
+                                results.detailSource());
+        return;
+    }
+    if (options.summary) {
+        DiffExporter::writeSummary(out, format, report, options.source,
+                                   results.diffs);
+        if (!options.waivers.isEmpty()) {
+            out << '\n';
+            writeWaivers(out, format, options.waivers, results.waivers,
+                         results.waivedCount);
+        }
+        if (results.delta) {
+            out << '\n';
+            writeDelta(out, format, options.baseline, *results.delta);
+        }
+        if (options.uniqueMasters) {
+            out << '\n';
+            writeMasters(out, format, results.masters);
+        }
+        if (options.listDiffs) {
+            out << '\n';
+        }
+    }
+    if (options.group) {
+        writeGroups(out, format, sections.clusters);
+    } else if (options.listDiffs) {
+        DiffExporter::writeDiffs(out, format, report, results.diffs,
+                                 results.detailSource());
+    }
+    if (options.devices) {
+        out << '\n';
+        writeDevices(out, format, report.circuits, sections.devices);
+    }
+    if (options.memory) {
+        out << '\n';
+        writeMemory(out, format, sections.usage);
+    }
+}
+
+// Clean only when filtering left no diff.
+auto exitCode(const Results &results) -> int {
+    return results.diffs.isEmpty() ? Cli::ExitClean : Cli::ExitDiffs;
+}
+} // namespace
+
+auto Cli::isHeadless(int argc, char *argv[]) -> bool {
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (std::strcmp(arg, "--") == 0) {
+            return false;
+        }
+        if (std::strcmp(arg, "--summary") == 0 ||
+            std::strcmp(arg, "--list-diffs") == 0 ||
+            std::strcmp(arg, "--group") == 0 ||
+            std::strcmp(arg, "--memory") == 0 ||
+            std::strcmp(arg, "--devices") == 0 ||
+            std::strcmp(arg, "--netlists") == 0 ||
+            std::strcmp(arg, "--format") == 0 ||
+            std::strncmp(arg, "--format=", std::strlen("--format=")) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+auto Cli::run(const QStringList &arguments, QTextStream &out,
+              QTextStream &err) -> int {
+    Options options;
+    if (const std::optional<int> done =
+            parseOptions(arguments, &options, out, err)) {
+        return *done;
+    }
+    std::optional<TraceFile> trace;
+    if (!options.trace.isEmpty()) {
+        trace.emplace(options.trace, err);
+    }
+    Results results;
+    if (!loadInputs(options, &results, err) ||
+        !selectDiffs(options, &results, err)) {
+        return ExitError;
+    }
+    writeOutput(options, results, out);
+    out.flush();
+    return exitCode(results);
+}
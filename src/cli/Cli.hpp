@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QStringList>
+#include <QTextStream>
+
+// Headless front end: parses a report and prints its summary and filtered
+// diffs without touching QtGui or QtWidgets, so it runs on machines with no
+// display libraries. Shared by `opensvs-cli` and `opensvs --summary ...`.
+class Cli {
+  public:
+    enum ExitCode : char {
+        ExitClean = 0, // no diffs left after filtering
+        ExitDiffs = 1, // at least one diff
+        ExitError = 2  // bad arguments or unreadable report
+    };
+
+    // True if argv selects a headless mode (--summary, --list-diffs,
+    // --group, --memory, --format), checked before any QApplication is
+    // built.
+    static auto isHeadless(int argc, char *argv[]) -> bool;
+    // arguments includes the program name, as QCoreApplication::arguments().
+    static auto run(const QStringList &arguments, QTextStream &out,
+                    QTextStream &err) -> int;
+};
@@ -0,0 +1,17 @@
+#include <QCoreApplication>
+#include <QTextStream>
+#include <cstdio>
+
+#include "OpenSvsVersion.hpp"
+#include "cli/Cli.hpp"
+
+auto main(int argc, char *argv[]) -> int {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("opensvs-cli"));
+    QCoreApplication::setApplicationVersion(
+        QStringLiteral(OPENSVS_VERSION_STRING));
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    return Cli::run(QCoreApplication::arguments(), out, err);
+}
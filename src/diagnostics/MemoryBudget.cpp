@@ -0,0 +1,98 @@
+#include "diagnostics/MemoryBudget.hpp"
+
+#include <QSettings>
+#include <QStandardPaths>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+namespace {
+const auto budgetKey = QStringLiteral("memory/budget_bytes");
+const auto ratioKey = QStringLiteral("memory/bytes_per_file_byte");
+const auto loadsKey = QStringLiteral("memory/loads_seen");
+// Weight of the newest load in the moving average.
+const double ratioWeight = 0.3;
+} // namespace
+
+MemoryBudget::MemoryBudget(const QString &settingsPath)
+    : path_(settingsPath) {}
+
+auto MemoryBudget::defaultSettingsPath() -> QString {
+    const QString dir =
+        QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation);
+    return dir + QStringLiteral("/opensvs/opensvs.ini");
+}
+
+auto MemoryBudget::physicalMemory() -> qint64 {
+#if defined(Q_OS_UNIX) && defined(_SC_PHYS_PAGES)
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && pageSize > 0) {
+        return static_cast<qint64>(pages) * pageSize;
+    }
+#endif
+    return 0;
+}
+
+auto MemoryBudget::budgetBytes() const -> qint64 {
+    const qint64 configured = configuredBudgetBytes();
+    return configured > 0 ? configured : autoBudgetBytes();
+}
+
+auto MemoryBudget::autoBudgetBytes() -> qint64 {
+    return static_cast<qint64>(static_cast<double>(physicalMemory()) *
+                               defaultBudgetShare);
+}
+
+auto MemoryBudget::configuredBudgetBytes() const -> qint64 {
+    return QSettings(path_, QSettings::IniFormat)
+        .value(budgetKey, 0)
+        .toLongLong();
+}
+
+void MemoryBudget::setBudgetBytes(qint64 bytes) {
+    QSettings settings(path_, QSettings::IniFormat);
+    if (bytes > 0) {
+        settings.setValue(budgetKey, bytes);
+    } else {
+        settings.remove(budgetKey);
+    }
+}
+
+auto MemoryBudget::bytesPerFileByte() const -> double {
+    const double ratio = QSettings(path_, QSettings::IniFormat)
+                             .value(ratioKey, defaultRatio)
+                             .toDouble();
+    return ratio > 0 ? ratio : defaultRatio;
+}
+
+auto MemoryBudget::loadsSeen() const -> int {
+    return QSettings(path_, QSettings::IniFormat).value(loadsKey, 0).toInt();
+}
+
+auto MemoryBudget::project(qint64 fileSize) const -> qint64 {
+    return static_cast<qint64>(static_cast<double>(fileSize) *
+                               bytesPerFileByte());
+}
+
+auto MemoryBudget::exceeds(qint64 fileSize, qint64 inUse) const -> bool {
+    const qint64 budget = budgetBytes();
+    return budget > 0 && inUse + project(fileSize) > budget;
+}
+
+void MemoryBudget::recordLoad(qint64 fileSize, qint64 residentBytes) {
+    if (fileSize <= 0 || residentBytes <= 0) {
+        return;
+    }
+    const double observed =
+        static_cast<double>(residentBytes) / static_cast<double>(fileSize);
+    const int loads = loadsSeen();
+    const double ratio =
+        loads == 0 ? observed
+                   : bytesPerFileByte() * (1 - ratioWeight) +
+                         observed * ratioWeight;
+    QSettings settings(path_, QSettings::IniFormat);
+    settings.setValue(ratioKey, ratio);
+    settings.setValue(loadsKey, loads + 1);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QString>
+
+// Memory budget for loaded reports and the ratio of resident bytes per
+// report byte learned from earlier loads, so a load can be projected from
+// the file size alone. Persisted in an INI file shared by the GUI and the
+// CLI.
+class MemoryBudget {
+  public:
+    explicit MemoryBudget(const QString &settingsPath = defaultSettingsPath());
+
+    static auto defaultSettingsPath() -> QString;
+    // 0 when unknown (non-POSIX systems).
+    static auto physicalMemory() -> qint64;
+    // defaultBudgetShare of physicalMemory().
+    static auto autoBudgetBytes() -> qint64;
+
+    // Configured budget, or defaultBudgetShare of physical memory when
+    // none is set; 0 means unlimited.
+    auto budgetBytes() const -> qint64;
+    auto configuredBudgetBytes() const -> qint64; // 0 when unset
+    void setBudgetBytes(qint64 bytes);
+
+    auto bytesPerFileByte() const -> double;
+    auto loadsSeen() const -> int;
+    auto project(qint64 fileSize) const -> qint64;
+    // inUse: bytes already held by other open reports.
+    auto exceeds(qint64 fileSize, qint64 inUse = 0) const -> bool;
+    // Folds one measured load into the ratio (moving average).
+    void recordLoad(qint64 fileSize, qint64 residentBytes);
+
+    // Until a load is measured; a parsed netgen report is typically
+    // several times the size of its JSON.
+    static constexpr double defaultRatio = 8.0;
+    static constexpr double defaultBudgetShare = 0.75;
+
+  private:
+    QString path_;
+};
@@ -0,0 +1,188 @@
+#include "diagnostics/MemoryReport.hpp"
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QLocale>
+#include <QTextStream>
+#include <QtCore/qarraydata.h>
+#include <utility>
+
+namespace {
+using Circuit = NetgenJsonParser::Report::Circuit;
+using DiffEntry = NetgenJsonParser::DiffEntry;
+
+template <typename T> auto vectorBytes(const QVector<T> &vector) -> qint64 {
+    if (vector.capacity() == 0) {
+        return 0;
+    }
+    return static_cast<qint64>(sizeof(QArrayData)) +
+           static_cast<qint64>(vector.capacity()) * sizeof(T);
+}
+
+// Qt 6 QHash: spans of 128 one-byte offsets plus a node array each.
+template <typename K, typename V>
+auto hashBytes(const QHash<K, V> &hash) -> qint64 {
+    if (hash.capacity() == 0) {
+        return 0;
+    }
+    const qint64 spans = (static_cast<qint64>(hash.capacity()) + 127) / 128;
+    return static_cast<qint64>(sizeof(void *)) * 2 + spans * (128 + 16) +
+           static_cast<qint64>(hash.size()) * (sizeof(K) + sizeof(V));
+}
+
+// Counts each shared string payload and array once.
+class StringCounter {
+  public:
+    void count(const QString &value, MemoryReport::Item &item) {
+        const qint64 bytes = MemoryReport::stringBytes(value);
+        if (bytes == 0 || seen_.contains(value.constData())) {
+            return;
+        }
+        seen_.insert(value.constData());
+        item.bytes += bytes;
+        ++item.count;
+    }
+
+    // False if the array was counted before.
+    template <typename T>
+    auto countArray(const QVector<T> &vector, MemoryReport::Item &item)
+        -> bool {
+        if (vector.capacity() != 0 && seen_.contains(vector.constData())) {
+            return false;
+        }
+        seen_.insert(vector.constData());
+        item.bytes += vectorBytes(vector);
+        return true;
+    }
+
+  private:
+    QSet<const void *> seen_;
+};
+} // namespace
+
+auto MemoryReport::measure(const QVector<Circuit> &circuits) -> MemoryReport {
+    return measure(QVector<const QVector<Circuit> *>{&circuits});
+}
+
+auto MemoryReport::measure(const QVector<const QVector<Circuit> *> &reports)
+    -> MemoryReport {
+    Item circuitArray{QStringLiteral("circuits")};
+    Item cellNames{QStringLiteral("circuit cell names")};
+    Item diffRows{QStringLiteral("diff rows (DiffEntry)")};
+    Item diffName{QStringLiteral("diff strings: name")};
+    Item diffLayout{QStringLiteral("diff strings: layoutCell")};
+    Item diffSchematic{QStringLiteral("diff strings: schematicCell")};
+    Item diffDetails{QStringLiteral("diff strings: details")};
+    Item devicesA{QStringLiteral("devicesA lists")};
+    Item devicesB{QStringLiteral("devicesB lists")};
+    Item pins{QStringLiteral("pin tables")};
+    Item subcircuits{QStringLiteral("subcircuits hash tables")};
+
+    StringCounter strings;
+    for (const QVector<Circuit> *circuits : reports) {
+        circuitArray.bytes += vectorBytes(*circuits);
+        circuitArray.count += circuits->size();
+        for (const Circuit &cir : *circuits) {
+            strings.count(cir.layoutCell, cellNames);
+            strings.count(cir.schematicCell, cellNames);
+            if (strings.countArray(cir.diffs, diffRows)) {
+                diffRows.count += cir.diffs.size();
+                for (const DiffEntry &entry : cir.diffs) {
+                    strings.count(entry.name, diffName);
+                    strings.count(entry.layoutCell, diffLayout);
+                    strings.count(entry.schematicCell, diffSchematic);
+                    strings.count(entry.details, diffDetails);
+                }
+            }
+            for (const auto &[list, item] :
+                 {std::pair{&cir.devicesA, &devicesA},
+                  std::pair{&cir.devicesB, &devicesB},
+                  std::pair{&cir.pinsA, &pins},
+                  std::pair{&cir.pinsB, &pins}}) {
+                if (strings.countArray(*list, *item)) {
+                    for (const QString &name : *list) {
+                        strings.count(name, *item);
+                    }
+                }
+            }
+            devicesA.bytes += vectorBytes(cir.deviceCountsA);
+            devicesB.bytes += vectorBytes(cir.deviceCountsB);
+            subcircuits.bytes += hashBytes(cir.subcircuits);
+            for (auto it = cir.subcircuits.cbegin();
+                 it != cir.subcircuits.cend(); ++it) {
+                strings.count(it.key(), subcircuits);
+            }
+            subcircuits.count += cir.subcircuits.size();
+        }
+    }
+
+    MemoryReport report;
+    for (const Item &item :
+         {circuitArray, cellNames, diffRows, diffName, diffLayout,
+          diffSchematic, diffDetails, devicesA, devicesB, pins,
+          subcircuits}) {
+        report.items_.push_back(item);
+    }
+    return report;
+}
+
+void MemoryReport::add(const QString &name, qint64 bytes, qint64 count) {
+    items_.push_back(Item{name, bytes, count});
+}
+
+auto MemoryReport::items() const -> const QVector<Item> & { return items_; }
+
+auto MemoryReport::total() const -> qint64 {
+    qint64 sum = 0;
+    for (const Item &item : items_) {
+        sum += item.bytes;
+    }
+    return sum;
+}
+
+void MemoryReport::writeText(QTextStream &out) const {
+    const QLocale locale = QLocale::c();
+    for (const Item &item : items_) {
+        out << item.name.leftJustified(32) << ' '
+            << locale.formattedDataSize(item.bytes).rightJustified(10) << "  "
+            << item.count << '\n';
+    }
+    out << QStringLiteral("total").leftJustified(32) << ' '
+        << locale.formattedDataSize(total()).rightJustified(10) << '\n';
+}
+
+void MemoryReport::writeDelimited(QTextStream &out, QChar separator) const {
+    out << "item" << separator << "bytes" << separator << "count\n";
+    for (const Item &item : items_) {
+        out << item.name << separator << item.bytes << separator
+            << item.count << '\n';
+    }
+}
+
+auto MemoryReport::toJson() const -> QJsonObject {
+    QJsonArray items;
+    for (const Item &item : items_) {
+        items.append(QJsonObject{{QStringLiteral("item"), item.name},
+                                 {QStringLiteral("bytes"), item.bytes},
+                                 {QStringLiteral("count"), item.count}});
+    }
+    return QJsonObject{{QStringLiteral("items"), items},
+                       {QStringLiteral("total_bytes"), total()}};
+}
+
+auto MemoryReport::stringBytes(const QString &value) -> qint64 {
+    // capacity() is 0 for null strings and for QStringLiteral/raw data.
+    if (value.capacity() == 0) {
+        return 0;
+    }
+    return static_cast<qint64>(sizeof(QArrayData)) +
+           (static_cast<qint64>(value.capacity()) + 1) * sizeof(QChar);
+}
+
+auto MemoryReport::listBytes(const QStringList &list) -> qint64 {
+    qint64 bytes = vectorBytes(list);
+    for (const QString &value : list) {
+        bytes += stringBytes(value);
+    }
+    return bytes;
+}
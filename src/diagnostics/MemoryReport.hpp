@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "parsers/NetgenJsonParser.hpp"
+
+class QJsonObject;
+class QTextStream;
+
+// Approximate heap bytes held by a loaded report, counted by walking its
+// containers rather than asking the allocator: container capacity times
+// element size plus the payload of every string. Implicitly shared strings
+// are counted once, under the first item that reaches them. Allocator
+// overhead and fragmentation are not included, so the process uses more.
+class MemoryReport {
+  public:
+    struct Item {
+        QString name;
+        qint64 bytes = 0;
+        qint64 count = 0; // strings, elements or nodes behind bytes
+    };
+
+    // Breakdown of circuits as held after parsing: the circuit array,
+    // diff rows and their strings by field, device lists and subcircuit
+    // hash tables.
+    static auto measure(
+        const QVector<NetgenJsonParser::Report::Circuit> &circuits)
+        -> MemoryReport;
+    // Several reports together, e.g. the window's tabs: strings and arrays
+    // they share through StringPool are counted once.
+    static auto measure(
+        const QVector<const QVector<NetgenJsonParser::Report::Circuit> *>
+            &reports) -> MemoryReport;
+
+    void add(const QString &name, qint64 bytes, qint64 count);
+    auto items() const -> const QVector<Item> &;
+    auto total() const -> qint64;
+
+    void writeText(QTextStream &out) const;
+    void writeDelimited(QTextStream &out, QChar separator) const;
+    auto toJson() const -> QJsonObject;
+
+    // Heap bytes of one string or list, 0 for static or empty data.
+    static auto stringBytes(const QString &value) -> qint64;
+    static auto listBytes(const QStringList &list) -> qint64;
+
+  private:
+    QVector<Item> items_;
+};
@@ -0,0 +1,160 @@
+#include "diagnostics/Tracer.hpp"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <algorithm>
+
+std::atomic<bool> Tracer::enabled_{false};
+
+namespace {
+struct Store {
+    QMutex mutex;
+    QVector<Tracer::Event> events;
+    qint64 dropped = 0;
+};
+
+auto store() -> Store & {
+    static Store instance;
+    return instance;
+}
+
+auto currentThreadId() -> int {
+    static std::atomic<int> next{1};
+    thread_local const int id = next.fetch_add(1);
+    return id;
+}
+} // namespace
+
+Tracer::Span::Span(const char *name, const char *category)
+    : name_(name), category_(category),
+      startNs_(isEnabled() ? now() : -1) {}
+
+Tracer::Span::~Span() {
+    if (isActive()) {
+        record(name_, category_, startNs_, now(), detail_);
+    }
+}
+
+void Tracer::Span::setDetail(const QString &detail) {
+    if (isActive()) {
+        detail_ = detail;
+    }
+}
+
+void Tracer::setEnabled(bool enabled) {
+    now(); // start the clock before the first span
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+auto Tracer::now() -> qint64 {
+    static const QElapsedTimer epoch = [] {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return epoch.nsecsElapsed();
+}
+
+void Tracer::record(const char *name, const char *category, qint64 startNs,
+                    qint64 endNs, const QString &detail) {
+    Event event{name, category, startNs, endNs - startNs, currentThreadId(),
+                detail};
+    Store &s = store();
+    const QMutexLocker lock(&s.mutex);
+    if (s.events.size() >= maxEvents) {
+        ++s.dropped;
+        return;
+    }
+    s.events.push_back(std::move(event));
+}
+
+auto Tracer::eventCount() -> qsizetype {
+    Store &s = store();
+    const QMutexLocker lock(&s.mutex);
+    return s.events.size();
+}
+
+auto Tracer::events(qsizetype from) -> QVector<Event> {
+    Store &s = store();
+    const QMutexLocker lock(&s.mutex);
+    from = std::clamp<qsizetype>(from, 0, s.events.size());
+    return {s.events.cbegin() + from, s.events.cend()};
+}
+
+auto Tracer::droppedCount() -> qint64 {
+    Store &s = store();
+    const QMutexLocker lock(&s.mutex);
+    return s.dropped;
+}
+
+void Tracer::clear() {
+    Store &s = store();
+    const QMutexLocker lock(&s.mutex);
+    s.events.clear();
+    s.dropped = 0;
+}
+
+void Tracer::writeChromeTrace(QIODevice &out) {
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+    traceEvents.append(QJsonObject{
+        {QStringLiteral("name"), QStringLiteral("process_name")},
+        {QStringLiteral("ph"), QStringLiteral("M")},
+        {QStringLiteral("pid"), pid},
+        {QStringLiteral("args"),
+         QJsonObject{{QStringLiteral("name"),
+                      QCoreApplication::applicationName()}}},
+    });
+    for (const Event &event : events()) {
+        QJsonObject obj{
+            {QStringLiteral("name"), QString::fromUtf8(event.name)},
+            {QStringLiteral("cat"), QString::fromUtf8(event.category)},
+            {QStringLiteral("ph"), QStringLiteral("X")},
+            {QStringLiteral("ts"), event.startNs / 1e3},
+            {QStringLiteral("dur"), event.durationNs / 1e3},
+            {QStringLiteral("pid"), pid},
+            {QStringLiteral("tid"), event.threadId},
+        };
+        if (!event.detail.isEmpty()) {
+            obj.insert(QStringLiteral("args"),
+                       QJsonObject{{QStringLiteral("detail"), event.detail}});
+        }
+        traceEvents.append(obj);
+    }
+    const QJsonObject doc{
+        {QStringLiteral("traceEvents"), traceEvents},
+        {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")},
+        {QStringLiteral("otherData"),
+         QJsonObject{
+             {QStringLiteral("version"),
+              QCoreApplication::applicationVersion()},
+             {QStringLiteral("dropped_events"), droppedCount()},
+         }},
+    };
+    out.write(QJsonDocument(doc).toJson(QJsonDocument::Compact));
+}
+
+auto Tracer::saveChromeTrace(const QString &path, QString *error) -> bool {
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error != nullptr) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    writeChromeTrace(file);
+    if (!file.commit()) {
+        if (error != nullptr) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+class QIODevice;
+
+// Process-wide scoped timing spans. Recording is off until setEnabled(true);
+// a disabled span costs one relaxed atomic load. Spans are exported in the
+// Chrome trace event format that chrome://tracing and Perfetto open.
+// Spans close on whichever thread opened them (parser workers, the query
+// server) and are appended to one list under a lock.
+class Tracer {
+  public:
+    struct Event {
+        const char *name = nullptr;     // string literal
+        const char *category = nullptr; // string literal
+        qint64 startNs = 0;             // since the first call to now()
+        qint64 durationNs = 0;
+        int threadId = 0; // small per-thread number, 1 for the first
+        QString detail;
+    };
+
+    // Records [construction, destruction) if tracing was enabled when it
+    // was constructed.
+    class Span {
+      public:
+        explicit Span(const char *name, const char *category = "opensvs");
+        ~Span();
+        Span(const Span &) = delete;
+        auto operator=(const Span &) -> Span & = delete;
+
+        auto isActive() const -> bool { return startNs_ >= 0; }
+        void setDetail(const QString &detail);
+
+      private:
+        const char *name_;
+        const char *category_;
+        qint64 startNs_{-1};
+        QString detail_;
+    };
+
+    static auto isEnabled() -> bool {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    static void setEnabled(bool enabled);
+    static auto now() -> qint64;
+    static void record(const char *name, const char *category, qint64 startNs,
+                       qint64 endNs, const QString &detail = QString());
+
+    static auto eventCount() -> qsizetype;
+    // Events recorded since the first `from`, in order of completion.
+    static auto events(qsizetype from = 0) -> QVector<Event>;
+    static auto droppedCount() -> qint64;
+    static void clear();
+
+    static void writeChromeTrace(QIODevice &out);
+    static auto saveChromeTrace(const QString &path,
+                                QString *error = nullptr) -> bool;
+
+    // Older events are kept; later ones are counted as dropped.
+    static constexpr qsizetype maxEvents = 1 << 20;
+
+  private:
+    static std::atomic<bool> enabled_;
+};
+
+#define OPENSVS_TRACE_CONCAT_(a, b) a##b
+#define OPENSVS_TRACE_CONCAT(a, b) OPENSVS_TRACE_CONCAT_(a, b)
+// OPENSVS_TRACE_SCOPE("name") or OPENSVS_TRACE_SCOPE("name", "category")
+#define OPENSVS_TRACE_SCOPE(...)                                              \
+    const Tracer::Span OPENSVS_TRACE_CONCAT(opensvsTraceSpan, __LINE__)(      \
+        __VA_ARGS__)
@@ -0,0 +1,206 @@
+#include "exporters/DiffExporter.hpp"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <algorithm>
+#include <utility>
+
+#include "parsers/DiffDetailCache.hpp"
+
+namespace {
+auto summaryFields(const NetgenJsonParser::Report &report,
+                   const QString &source, qsizetype diffCount)
+    -> QVector<std::pair<QString, QString>> {
+    const auto &sum = report.summary;
+    return {
+        {QStringLiteral("report"), source},
+        {QStringLiteral("layout_cell"), sum.layoutCell},
+        {QStringLiteral("schematic_cell"), sum.schematicCell},
+        {QStringLiteral("circuits"), QString::number(report.circuits.size())},
+        {QStringLiteral("device_mismatches"),
+         QString::number(sum.deviceMismatches)},
+        {QStringLiteral("net_mismatches"), QString::number(sum.netMismatches)},
+        {QStringLiteral("shorts"), QString::number(sum.shorts)},
+        {QStringLiteral("opens"), QString::number(sum.opens)},
+        {QStringLiteral("total_devices"), QString::number(sum.totalDevices)},
+        {QStringLiteral("total_nets"), QString::number(sum.totalNets)},
+        {QStringLiteral("diffs"), QString::number(diffCount)}};
+}
+
+auto detailsOf(const NetgenJsonParser::DiffEntry &entry,
+               const DiffDetailCache *details) -> QString {
+    return details != nullptr ? details->details(entry) : entry.details;
+}
+
+auto diffFields(const NetgenJsonParser::DiffEntry &entry,
+                const DiffDetailCache *details) -> QStringList {
+    return {NetgenJsonParser::toTypeString(entry.type),
+            NetgenJsonParser::toSubtypeString(entry.subtype),
+            entry.name,
+            entry.layoutCell,
+            entry.schematicCell,
+            detailsOf(entry, details)};
+}
+
+auto diffHeader() -> QStringList {
+    return {QStringLiteral("type"),           QStringLiteral("subtype"),
+            QStringLiteral("object"),         QStringLiteral("layout_cell"),
+            QStringLiteral("schematic_cell"), QStringLiteral("details")};
+}
+
+auto flatten(const QString &value) -> QString {
+    QString flat = value;
+    flat.replace(QLatin1Char('\r'), QLatin1Char(' '));
+    flat.replace(QLatin1Char('\n'), QLatin1Char(' '));
+    return flat;
+}
+} // namespace
+
+auto DiffExporter::parseFormat(const QString &name, bool *ok) -> Format {
+    const QString lower = name.trimmed().toLower();
+    bool known = true;
+    Format format = Format::Text;
+    if (lower == QStringLiteral("csv")) {
+        format = Format::Csv;
+    } else if (lower == QStringLiteral("tsv")) {
+        format = Format::Tsv;
+    } else if (lower == QStringLiteral("json")) {
+        format = Format::Json;
+    } else if (lower != QStringLiteral("text")) {
+        known = false;
+    }
+    if (ok != nullptr) {
+        *ok = known;
+    }
+    return format;
+}
+
+void DiffExporter::writeSummary(QTextStream &out, Format format,
+                                const NetgenJsonParser::Report &report,
+                                const QString &source, const DiffList &diffs) {
+    if (format == Format::Json) {
+        writeJson(out, report, source, diffs, true, false);
+        return;
+    }
+    const auto fields = summaryFields(report, source, diffs.size());
+    if (format == Format::Csv || format == Format::Tsv) {
+        const bool csv = format == Format::Csv;
+        const QChar sep = csv ? QLatin1Char(',') : QLatin1Char('\t');
+        out << "field" << sep << "value" << '\n';
+        for (const auto &[key, value] : fields) {
+            out << key << sep << (csv ? csvField(value) : tsvField(value))
+                << '\n';
+        }
+        return;
+    }
+    for (const auto &[key, value] : fields) {
+        QString label = key;
+        label.replace(QLatin1Char('_'), QLatin1Char(' '));
+        label[0] = label.at(0).toUpper();
+        out << label << ": " << value << '\n';
+    }
+}
+
+void DiffExporter::writeDiffs(QTextStream &out, Format format,
+                              const NetgenJsonParser::Report &report,
+                              const DiffList &diffs,
+                              const DiffDetailCache *details) {
+    switch (format) {
+    case Format::Json:
+        writeJson(out, report, QString(), diffs, false, true, QJsonObject(),
+                  details);
+        return;
+    case Format::Csv:
+    case Format::Tsv: {
+        const bool csv = format == Format::Csv;
+        const QChar sep = csv ? QLatin1Char(',') : QLatin1Char('\t');
+        out << diffHeader().join(sep) << '\n';
+        for (const auto *entry : diffs) {
+            QStringList fields = diffFields(*entry, details);
+            for (QString &field : fields) {
+                field = csv ? csvField(field) : tsvField(field);
+            }
+            out << fields.join(sep) << '\n';
+        }
+        return;
+    }
+    case Format::Text:
+    default:
+        for (const auto *entry : diffs) {
+            out << NetgenJsonParser::toTypeString(entry->type) << " ("
+                << NetgenJsonParser::toSubtypeString(entry->subtype) << ") "
+                << entry->layoutCell << ": " << entry->name << '\n'
+                << "    " << flatten(detailsOf(*entry, details)) << '\n';
+        }
+        return;
+    }
+}
+
+void DiffExporter::writeJson(QTextStream &out,
+                             const NetgenJsonParser::Report &report,
+                             const QString &source, const DiffList &diffs,
+                             bool withSummary, bool withDiffs,
+                             const QJsonObject &extra,
+                             const DiffDetailCache *details) {
+    QJsonObject root = extra;
+    if (withSummary) {
+        root.insert(QStringLiteral("summary"),
+                    summaryJson(report, source, diffs.size()));
+    }
+    if (withDiffs) {
+        QJsonArray rows;
+        for (const auto *entry : diffs) {
+            rows.append(diffJson(*entry, details));
+        }
+        root.insert(QStringLiteral("diffs"), rows);
+    }
+    out << QString::fromUtf8(QJsonDocument(root).toJson());
+}
+
+auto DiffExporter::summaryJson(const NetgenJsonParser::Report &report,
+                               const QString &source, qsizetype diffCount)
+    -> QJsonObject {
+    QJsonObject summary;
+    for (const auto &[key, value] : summaryFields(report, source, diffCount)) {
+        bool isNumber = false;
+        const long long number = value.toLongLong(&isNumber);
+        if (isNumber) {
+            summary.insert(key, number);
+        } else {
+            summary.insert(key, value);
+        }
+    }
+    return summary;
+}
+
+auto DiffExporter::diffJson(const NetgenJsonParser::DiffEntry &entry,
+                            const DiffDetailCache *details) -> QJsonObject {
+    const QStringList header = diffHeader();
+    const QStringList fields = diffFields(entry, details);
+    QJsonObject row;
+    for (qsizetype i = 0; i < header.size(); ++i) {
+        row.insert(header.at(i), fields.at(i));
+    }
+    return row;
+}
+
+auto DiffExporter::csvField(const QString &value) -> QString {
+    const bool plain = std::none_of(value.cbegin(), value.cend(), [](QChar c) {
+        return c == QLatin1Char(',') || c == QLatin1Char('"') ||
+               c == QLatin1Char('\n') || c == QLatin1Char('\r');
+    });
+    if (plain) {
+        return value;
+    }
+    QString quoted = value;
+    quoted.replace(QLatin1Char('"'), QStringLiteral("\"\""));
+    return QLatin1Char('"') + quoted + QLatin1Char('"');
+}
+
+auto DiffExporter::tsvField(const QString &value) -> QString {
+    QString flat = flatten(value);
+    flat.replace(QLatin1Char('\t'), QLatin1Char(' '));
+    return flat;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+
+#include "parsers/NetgenJsonParser.hpp"
+
+class DiffDetailCache;
+
+// Writes a report summary and diff rows as plain text, CSV, TSV or JSON.
+// Shared by the headless CLI and anything else that needs a flat dump.
+class DiffExporter {
+  public:
+    enum class Format : char { Text, Csv, Tsv, Json };
+    using DiffList = QVector<const NetgenJsonParser::DiffEntry *>;
+
+    // Accepts "text", "csv", "tsv" and "json" (case-insensitive).
+    static auto parseFormat(const QString &name, bool *ok = nullptr)
+        -> Format;
+
+    // diffs are the rows selected for output; the summary reports their
+    // count next to the report totals.
+    static void writeSummary(QTextStream &out, Format format,
+                             const NetgenJsonParser::Report &report,
+                             const QString &source, const DiffList &diffs);
+    // details resolves rows of an on-demand report; nullptr writes the
+    // details the entries hold.
+    static void writeDiffs(QTextStream &out, Format format,
+                           const NetgenJsonParser::Report &report,
+                           const DiffList &diffs,
+                           const DiffDetailCache *details = nullptr);
+    // One JSON document with a "summary" object and/or a "diffs" array,
+    // plus any extra top-level keys (e.g. "memory").
+    static void writeJson(QTextStream &out,
+                          const NetgenJsonParser::Report &report,
+                          const QString &source, const DiffList &diffs,
+                          bool withSummary, bool withDiffs,
+                          const QJsonObject &extra = QJsonObject(),
+                          const DiffDetailCache *details = nullptr);
+
+    // Building blocks of writeJson, for callers that assemble their own
+    // documents.
+    static auto summaryJson(const NetgenJsonParser::Report &report,
+                            const QString &source, qsizetype diffCount)
+        -> QJsonObject;
+    static auto diffJson(const NetgenJsonParser::DiffEntry &entry,
+                         const DiffDetailCache *details = nullptr)
+        -> QJsonObject;
+
+    static auto csvField(const QString &value) -> QString;
+    static auto tsvField(const QString &value) -> QString;
+};
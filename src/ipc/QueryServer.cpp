@@ -0,0 +1,361 @@
+#include "ipc/QueryServer.hpp"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include <utility>
+
+#include "exporters/DiffExporter.hpp"
+#include "ipc/SingleInstance.hpp"
+#include "models/DiffFilter.hpp"
+
+namespace {
+using Circuit = NetgenJsonParser::Report::Circuit;
+using DiffEntry = NetgenJsonParser::DiffEntry;
+
+// A line longer than this is not a query; the connection is dropped.
+const qint64 maxRequestBytes = 1024 * 1024;
+
+auto circuitJson(const Circuit &cir) -> QJsonObject {
+    QJsonArray children;
+    for (const Circuit *child : cir.subcircuits) {
+        children.append(child->index);
+    }
+    return QJsonObject{
+        {QStringLiteral("index"), cir.index},
+        {QStringLiteral("layout_cell"), cir.layoutCell},
+        {QStringLiteral("schematic_cell"), cir.schematicCell},
+        {QStringLiteral("top_level"), cir.isTopLevel},
+        {QStringLiteral("diffs"), cir.diffs.size()},
+        {QStringLiteral("children"), children},
+    };
+}
+
+auto isCell(const Circuit &cir, const QString &cell) -> bool {
+    return cir.layoutCell == cell || cir.schematicCell == cell;
+}
+
+// Diffs whose object is a net: a mismatch, a short or open found on it, or
+// a pin, which is the net the cell exports under that name.
+auto isNetScoped(NetgenJsonParser::DiffType type) -> bool {
+    switch (type) {
+    case NetgenJsonParser::DiffType::NetMismatch:
+    case NetgenJsonParser::DiffType::Short:
+    case NetgenJsonParser::DiffType::Open:
+    case NetgenJsonParser::DiffType::PinMismatch:
+        return true;
+    default:
+        return false;
+    }
+}
+
+auto answerDiffs(const QJsonObject &request, const QuerySnapshot &snapshot,
+                 QJsonObject &reply) -> QString {
+    const auto &circuits = snapshot.report.circuits;
+    DiffFilter filter;
+    filter.setTypeFilter(request.value(QStringLiteral("type")).toString());
+    filter.setSearchTerm(request.value(QStringLiteral("search")).toString());
+    const QString cell = request.value(QStringLiteral("cell")).toString();
+    if (!cell.isEmpty()) {
+        const QSet<int> allowed = DiffFilter::circuitsUnder(circuits, cell);
+        if (allowed.isEmpty()) {
+            return QStringLiteral("no circuit named %1").arg(cell);
+        }
+        filter.setAllowedCircuits(allowed);
+    }
+    const qint64 offset = std::max<qint64>(
+        0, request.value(QStringLiteral("offset")).toInteger());
+    const qint64 limit = request.value(QStringLiteral("limit"))
+                             .toInteger(QueryServer::defaultLimit);
+    // Like the CLI: on-demand details are searched in one pass in file
+    // order, so each circuit is re-read once.
+    const DiffDetailCache *details = snapshot.details.get();
+    const bool searchDetails =
+        details != nullptr && !filter.searchTerm().isEmpty();
+
+    qint64 matched = 0;
+    QJsonArray rows;
+    for (const Circuit &cir : circuits) {
+        for (const DiffEntry &entry : cir.diffs) {
+            const bool accepted =
+                searchDetails
+                    ? filter.accepts(NetgenJsonParser::toTypeString(entry.type),
+                                     entry.name, details->details(entry),
+                                     static_cast<int>(entry.circuitIndex))
+                    : filter.accepts(entry);
+            if (!accepted) {
+                continue;
+            }
+            if (matched >= offset && (limit <= 0 || rows.size() < limit)) {
+                QJsonObject row = DiffExporter::diffJson(entry, details);
+                row.insert(QStringLiteral("circuit"), entry.circuitIndex);
+                rows.append(row);
+            }
+            ++matched;
+        }
+    }
+    reply.insert(QStringLiteral("total"), matched);
+    reply.insert(QStringLiteral("offset"), offset);
+    reply.insert(QStringLiteral("diffs"), rows);
+    return {};
+}
+
+auto answerNet(const QJsonObject &request, const QuerySnapshot &snapshot,
+               QJsonObject &reply) -> QString {
+    const QString net = request.value(QStringLiteral("net")).toString();
+    const QString cell = request.value(QStringLiteral("cell")).toString();
+    if (net.isEmpty() || cell.isEmpty()) {
+        return QStringLiteral("net and cell are required");
+    }
+    bool found = false;
+    QJsonArray rows;
+    for (const Circuit &cir : snapshot.report.circuits) {
+        if (!isCell(cir, cell)) {
+            continue;
+        }
+        found = true;
+        for (const DiffEntry &entry : cir.diffs) {
+            if (isNetScoped(entry.type) &&
+                entry.name.compare(net, Qt::CaseInsensitive) == 0) {
+                rows.append(
+                    DiffExporter::diffJson(entry, snapshot.details.get()));
+            }
+        }
+    }
+    // Circuits without diffs are pruned at load, so an unknown cell is
+    // also a clean one; say which.
+    reply.insert(QStringLiteral("cell_found"), found);
+    reply.insert(QStringLiteral("mismatched"), !rows.isEmpty());
+    reply.insert(QStringLiteral("diffs"), rows);
+    return {};
+}
+
+auto answerHierarchy(const QJsonObject &request,
+                     const QuerySnapshot &snapshot, QJsonObject &reply)
+    -> QString {
+    const auto &circuits = snapshot.report.circuits;
+    const QString cell = request.value(QStringLiteral("cell")).toString();
+    QJsonArray roots;
+    QJsonArray rows;
+    if (cell.isEmpty()) {
+        for (const Circuit &cir : circuits) {
+            if (cir.isTopLevel) {
+                roots.append(cir.index);
+            }
+            rows.append(circuitJson(cir));
+        }
+    } else {
+        const QSet<int> under = DiffFilter::circuitsUnder(circuits, cell);
+        if (under.isEmpty()) {
+            return QStringLiteral("no circuit named %1").arg(cell);
+        }
+        for (const Circuit &cir : circuits) {
+            if (isCell(cir, cell)) {
+                roots.append(cir.index);
+            }
+            if (under.contains(static_cast<int>(cir.index))) {
+                rows.append(circuitJson(cir));
+            }
+        }
+    }
+    reply.insert(QStringLiteral("roots"), roots);
+    reply.insert(QStringLiteral("circuits"), rows);
+    return {};
+}
+} // namespace
+
+auto QuerySnapshot::make(const QString &source,
+                         const NetgenJsonParser::Summary &summary,
+                         const QVector<Circuit> &circuits,
+                         std::shared_ptr<const DiffDetailCache> details)
+    -> std::shared_ptr<const QuerySnapshot> {
+    auto snapshot = std::make_shared<QuerySnapshot>();
+    snapshot->source = source;
+    snapshot->report.ok = true;
+    snapshot->report.summary = summary;
+    snapshot->report.detailsOnDemand = details != nullptr;
+    snapshot->details = std::move(details);
+
+    QVector<Circuit> &own = snapshot->report.circuits;
+    own = circuits;
+    own.detach();
+    for (Circuit &cir : own) {
+        for (auto it = cir.subcircuits.begin(); it != cir.subcircuits.end();
+             ++it) {
+            it.value() = &own[it.value() - circuits.constData()];
+        }
+    }
+    return snapshot;
+}
+
+class QueryServer::Worker : public QObject {
+  public:
+    explicit Worker(const QueryServer *owner) : owner_(owner) {}
+
+    auto listen(const QString &name) -> QString {
+        server_ = new QLocalServer(this);
+        server_->setSocketOptions(QLocalServer::UserAccessOption);
+        if (!listenReclaiming(*server_, name)) {
+            delete server_;
+            server_ = nullptr;
+            return {};
+        }
+        connect(server_, &QLocalServer::newConnection, this,
+                &Worker::accept);
+        return server_->fullServerName();
+    }
+
+    // Open connections are children of the server and close with it.
+    void close() {
+        delete server_;
+        server_ = nullptr;
+    }
+
+  private:
+    void accept() {
+        while (QLocalSocket *socket = server_->nextPendingConnection()) {
+            connect(socket, &QLocalSocket::disconnected, socket,
+                    &QObject::deleteLater);
+            connect(socket, &QLocalSocket::readyRead, this,
+                    [this, socket] { serve(socket); });
+        }
+    }
+
+    void serve(QLocalSocket *socket) {
+        while (socket->canReadLine()) {
+            const QByteArray line = socket->readLine().trimmed();
+            if (line.isEmpty()) {
+                continue;
+            }
+            const QJsonDocument doc = QJsonDocument::fromJson(line);
+            QJsonObject reply;
+            if (doc.isObject()) {
+                const auto snapshot = owner_->snapshot();
+                reply = QueryServer::answer(doc.object(), snapshot.get());
+            } else {
+                reply = QJsonObject{
+                    {QStringLiteral("ok"), false},
+                    {QStringLiteral("error"),
+                     QStringLiteral("request is not a JSON object")}};
+            }
+            socket->write(QJsonDocument(reply).toJson(QJsonDocument::Compact) +
+                          '\n');
+        }
+        if (socket->bytesAvailable() > maxRequestBytes) {
+            socket->abort();
+        }
+    }
+
+    const QueryServer *owner_;
+    QLocalServer *server_{nullptr};
+};
+
+QueryServer::QueryServer(QObject *parent) : QObject(parent) {}
+
+QueryServer::~QueryServer() { stop(); }
+
+auto QueryServer::defaultServerName() -> QString {
+    // Per user, independent of the display, so batch jobs find it too.
+    return QStringLiteral("opensvs-query-") +
+           QString::fromLatin1(
+               QCryptographicHash::hash(QDir::homePath().toUtf8(),
+                                        QCryptographicHash::Sha1)
+                   .toHex()
+                   .left(16));
+}
+
+auto QueryServer::start(const QString &name) -> bool {
+    if (isRunning()) {
+        return true;
+    }
+    thread_ = new QThread(this);
+    thread_->setObjectName(QStringLiteral("opensvs query server"));
+    worker_ = new Worker(this);
+    worker_->moveToThread(thread_);
+    connect(thread_, &QThread::finished, worker_, &QObject::deleteLater);
+    thread_->start();
+
+    QString full;
+    QMetaObject::invokeMethod(
+        worker_, [this, &name] { return worker_->listen(name); },
+        Qt::BlockingQueuedConnection, &full);
+    if (full.isEmpty()) {
+        stop();
+        return false;
+    }
+    fullServerName_ = full;
+    return true;
+}
+
+void QueryServer::stop() {
+    if (thread_ == nullptr) {
+        return;
+    }
+    QMetaObject::invokeMethod(
+        worker_, [this] { worker_->close(); }, Qt::BlockingQueuedConnection);
+    thread_->quit();
+    thread_->wait();
+    delete thread_; // the worker was deleted on finished
+    thread_ = nullptr;
+    worker_ = nullptr;
+    fullServerName_.clear();
+}
+
+auto QueryServer::isRunning() const -> bool { return thread_ != nullptr; }
+
+auto QueryServer::fullServerName() const -> QString {
+    return fullServerName_;
+}
+
+void QueryServer::setSnapshot(std::shared_ptr<const QuerySnapshot> snapshot) {
+    const QMutexLocker lock(&mutex_);
+    snapshot_ = std::move(snapshot);
+}
+
+auto QueryServer::snapshot() const -> std::shared_ptr<const QuerySnapshot> {
+    const QMutexLocker lock(&mutex_);
+    return snapshot_;
+}
+
+auto QueryServer::answer(const QJsonObject &request,
+                         const QuerySnapshot *snapshot) -> QJsonObject {
+    QJsonObject reply;
+    if (request.contains(QStringLiteral("id"))) {
+        reply.insert(QStringLiteral("id"), request.value(QStringLiteral("id")));
+    }
+    const QString cmd = request.value(QStringLiteral("cmd")).toString();
+    QString error;
+    if (cmd == QStringLiteral("ping")) {
+        reply.insert(QStringLiteral("loaded"), snapshot != nullptr);
+    } else if (snapshot == nullptr) {
+        error = QStringLiteral("no report loaded");
+    } else if (cmd == QStringLiteral("summary")) {
+        qsizetype diffs = 0;
+        for (const Circuit &cir : snapshot->report.circuits) {
+            diffs += cir.diffs.size();
+        }
+        reply.insert(QStringLiteral("summary"),
+                     DiffExporter::summaryJson(snapshot->report,
+                                               snapshot->source, diffs));
+    } else if (cmd == QStringLiteral("diffs")) {
+        error = answerDiffs(request, *snapshot, reply);
+    } else if (cmd == QStringLiteral("net")) {
+        error = answerNet(request, *snapshot, reply);
+    } else if (cmd == QStringLiteral("hierarchy")) {
+        error = answerHierarchy(request, *snapshot, reply);
+    } else {
+        error = QStringLiteral("unknown command: %1").arg(cmd);
+    }
+    reply.insert(QStringLiteral("ok"), error.isEmpty());
+    if (!error.isEmpty()) {
+        reply.insert(QStringLiteral("error"), error);
+    }
+    return reply;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <memory>
+
+#include "parsers/DiffDetailCache.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+
+class QJsonObject;
+class QThread;
+
+// Immutable copy of a loaded report for the query thread. The circuit
+// array is detached from the window's and its subcircuit links point into
+// the copy; strings and diff arrays stay implicitly shared.
+struct QuerySnapshot {
+    QString source;
+    NetgenJsonParser::Report report;
+    std::shared_ptr<const DiffDetailCache> details; // on-demand loads only
+
+    static auto make(const QString &source,
+                     const NetgenJsonParser::Summary &summary,
+                     const QVector<NetgenJsonParser::Report::Circuit> &circuits,
+                     std::shared_ptr<const DiffDetailCache> details)
+        -> std::shared_ptr<const QuerySnapshot>;
+};
+
+// Opt-in local endpoint that lets scripts interrogate the report on
+// screen without reparsing it. A QLocalServer (a Unix domain socket on
+// Linux) runs on its own thread and answers line-delimited JSON against
+// the latest snapshot; the GUI thread only swaps a shared_ptr, so a slow
+// query never blocks it. See answer() for the commands.
+class QueryServer : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit QueryServer(QObject *parent = nullptr);
+    ~QueryServer() override;
+    QueryServer(const QueryServer &) = delete;
+    auto operator=(const QueryServer &) -> QueryServer & = delete;
+
+    static auto defaultServerName() -> QString;
+
+    // Listens on name; false if it is taken by a live server or the
+    // socket cannot be created. Returns once the server is listening.
+    auto start(const QString &name = defaultServerName()) -> bool;
+    void stop();
+    auto isRunning() const -> bool;
+    // Socket path scripts connect to.
+    auto fullServerName() const -> QString;
+
+    void setSnapshot(std::shared_ptr<const QuerySnapshot> snapshot);
+    auto snapshot() const -> std::shared_ptr<const QuerySnapshot>;
+
+    // One request to one reply; "id" is echoed. Commands:
+    //   ping
+    //   summary
+    //   diffs      [type] [search] [cell] [offset] [limit]
+    //   net        net cell -> whether the net is mismatched in the cell
+    //   hierarchy  [cell]
+    static auto answer(const QJsonObject &request,
+                       const QuerySnapshot *snapshot) -> QJsonObject;
+
+    static constexpr int defaultLimit = 1000;
+
+  private:
+    class Worker;
+
+    QThread *thread_{nullptr};
+    Worker *worker_{nullptr};
+    QString fullServerName_;
+    mutable QMutex mutex_;
+    std::shared_ptr<const QuerySnapshot> snapshot_;
+};
@@ -0,0 +1,133 @@
+#include "ipc/SingleInstance.hpp"
+
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+namespace {
+// A request line longer than this is not a list of paths.
+const qint64 maxRequestBytes = 1024 * 1024;
+
+auto userName() -> QString {
+    for (const char *var : {"USER", "USERNAME", "LOGNAME"}) {
+        const QString value = qEnvironmentVariable(var);
+        if (!value.isEmpty()) {
+            return value;
+        }
+    }
+    return QStringLiteral("default");
+}
+} // namespace
+
+auto listenReclaiming(QLocalServer &server, const QString &name) -> bool {
+    if (server.listen(name)) {
+        return true;
+    }
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if (probe.waitForConnected(SingleInstance::defaultTimeoutMs)) {
+        return false; // a live server owns the name
+    }
+    QLocalServer::removeServer(name);
+    return server.listen(name);
+}
+
+SingleInstance::SingleInstance(const QString &name, QObject *parent)
+    : QObject(parent), name_(name) {}
+
+auto SingleInstance::defaultServerName() -> QString {
+    // Hashed: user names may hold characters not valid in a socket name.
+    const QByteArray key = (userName() + QLatin1Char('@') +
+                            qEnvironmentVariable("DISPLAY"))
+                               .toUtf8();
+    return QStringLiteral("opensvs-") +
+           QString::fromLatin1(
+               QCryptographicHash::hash(key, QCryptographicHash::Sha1)
+                   .toHex()
+                   .left(16));
+}
+
+auto SingleInstance::handOff(const QString &name, const QStringList &paths,
+                             int timeoutMs) -> bool {
+    QLocalSocket socket;
+    socket.connectToServer(name);
+    if (!socket.waitForConnected(timeoutMs)) {
+        return false;
+    }
+    const QJsonObject request{
+        {QStringLiteral("open"), QJsonArray::fromStringList(paths)}};
+    socket.write(QJsonDocument(request).toJson(QJsonDocument::Compact) +
+                 '\n');
+    if (!socket.waitForBytesWritten(timeoutMs)) {
+        return false;
+    }
+    while (!socket.canReadLine()) {
+        if (!socket.waitForReadyRead(timeoutMs)) {
+            return false;
+        }
+    }
+    const QJsonObject reply =
+        QJsonDocument::fromJson(socket.readLine()).object();
+    return reply.value(QStringLiteral("ok")).toBool();
+}
+
+auto SingleInstance::listen() -> bool {
+    if (server_ != nullptr) {
+        return server_->isListening();
+    }
+    auto *server = new QLocalServer(this);
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+    if (!listenReclaiming(*server, name_)) {
+        delete server;
+        return false;
+    }
+    server_ = server;
+    connect(server_, &QLocalServer::newConnection, this,
+            &SingleInstance::onNewConnection);
+    return true;
+}
+
+auto SingleInstance::isListening() const -> bool {
+    return server_ != nullptr && server_->isListening();
+}
+
+auto SingleInstance::serverName() const -> QString { return name_; }
+
+void SingleInstance::onNewConnection() {
+    while (QLocalSocket *socket = server_->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket,
+                &QObject::deleteLater);
+        connect(socket, &QLocalSocket::readyRead, this,
+                [this, socket] { onReadyRead(socket); });
+    }
+}
+
+void SingleInstance::onReadyRead(QLocalSocket *socket) {
+    if (!socket->canReadLine()) {
+        if (socket->bytesAvailable() > maxRequestBytes) {
+            socket->abort();
+        }
+        return;
+    }
+    const QJsonObject request =
+        QJsonDocument::fromJson(socket->readLine()).object();
+    QStringList paths;
+    for (const auto &value :
+         request.value(QStringLiteral("open")).toArray()) {
+        if (value.isString() && !value.toString().isEmpty()) {
+            paths << value.toString();
+        }
+    }
+    const QJsonObject reply{{QStringLiteral("ok"), !paths.isEmpty()}};
+    socket->write(QJsonDocument(reply).toJson(QJsonDocument::Compact) +
+                  '\n');
+    // Acknowledge before loading so the client exits right away.
+    socket->flush();
+    socket->disconnectFromServer();
+    if (!paths.isEmpty()) {
+        emit filesReceived(paths);
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class QLocalServer;
+class QLocalSocket;
+
+// server->listen(name), first removing a socket file that no live server
+// answers on (left by a crashed process). Shared by the local servers.
+auto listenReclaiming(QLocalServer &server, const QString &name) -> bool;
+
+// One running viewer per user and display session. The first
+// `opensvs --single-instance` listens on a local socket; later ones send
+// their report paths to it and exit before QApplication is even built, so
+// a report appears after its parse time rather than a full GUI start.
+//
+// Wire format: one JSON line {"open": [absolute paths]} from the client,
+// answered with {"ok": true} before the reports are loaded.
+class SingleInstance : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit SingleInstance(const QString &name = defaultServerName(),
+                            QObject *parent = nullptr);
+
+    // Per-user name, so two users on one host never share an instance.
+    static auto defaultServerName() -> QString;
+    // Hands paths to the instance listening on name; false if none answers
+    // within timeoutMs (then the caller starts its own window).
+    static auto handOff(const QString &name, const QStringList &paths,
+                        int timeoutMs = defaultTimeoutMs) -> bool;
+
+    // Starts listening; false if another live instance owns the name. A
+    // socket left behind by a crashed instance is removed and reused.
+    auto listen() -> bool;
+    auto isListening() const -> bool;
+    auto serverName() const -> QString;
+
+    static constexpr int defaultTimeoutMs = 1000;
+
+  signals:
+    void filesReceived(const QStringList &paths);
+
+  private:
+    void onNewConnection();
+    void onReadyRead(QLocalSocket *socket);
+
+    QString name_;
+    QLocalServer *server_{nullptr};
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QObject>
+#include <QThread>
+#include <utility>
+
+// Runs work on a thread of its own that deletes itself once work returns.
+// The thread has no parent: a running QThread must not be destroyed, so
+// it cannot belong to the window or queue that starts it, and closing one
+// mid-run leaves the thread to finish on its own. done, when given, then
+// runs on receiver's thread, and not at all if receiver is gone by then.
+class DetachedThread {
+  public:
+    template <typename Work> static void start(Work work) {
+        QThread *thread = QThread::create(std::move(work));
+        QObject::connect(thread, &QThread::finished, thread,
+                         &QObject::deleteLater);
+        thread->start();
+    }
+
+    template <typename Work, typename Done>
+    static void start(Work work, const QObject *receiver, Done done) {
+        QThread *thread = QThread::create(std::move(work));
+        QObject::connect(thread, &QThread::finished, thread,
+                         &QObject::deleteLater);
+        QObject::connect(thread, &QThread::finished, receiver,
+                         std::move(done));
+        thread->start();
+    }
+};
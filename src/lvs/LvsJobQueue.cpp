@@ -0,0 +1,401 @@
+#include "lvs/LvsJobQueue.hpp"
+#include "lvs/DetachedThread.hpp"
+#include "lvs/LvsResultCache.hpp"
+#include "lvs/NetgenOutTail.hpp"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+
+namespace {
+std::atomic<quint64> outPathSeq{0};
+} // namespace
+
+LvsJobQueue::LvsJobQueue(QObject *parent)
+    : QObject(parent), maxConcurrent_(defaultConcurrency()) {}
+
+LvsJobQueue::~LvsJobQueue() {
+    // Runners are children; their destructors kill any netgen still running.
+    for (auto *runner : std::as_const(runners_)) {
+        runner->disconnect(this);
+    }
+}
+
+auto LvsJobQueue::enqueue(const LvsRunner::Request &request,
+                          bool useCache) -> int {
+    Job job;
+    job.id = nextId_++;
+    job.request = request;
+    job.forceRerun = !useCache;
+    if (cache_) {
+        job.status = Status::Hashing;
+    }
+    const int row = static_cast<int>(jobs_.size());
+    emit jobAboutToBeAdded(row);
+    jobs_.push_back(job);
+    emit jobAdded(row);
+    if (job.status == Status::Hashing) {
+        hashJob(row);
+    } else {
+        schedule();
+    }
+    return row;
+}
+
+void LvsJobQueue::cancel(int row) {
+    if (row < 0 || row >= jobs_.size()) {
+        return;
+    }
+    Job &job = jobs_[row];
+    if (job.status == Status::Queued || job.status == Status::Hashing) {
+        job.status = Status::Canceled;
+        job.phase = LvsRunner::Phase::Canceled;
+        emit jobChanged(row);
+        emit jobFinished(row, false);
+        return;
+    }
+    if (job.status == Status::Running) {
+        if (auto *runner = runners_.value(job.id, nullptr)) {
+            runner->cancel();
+        }
+    }
+}
+
+void LvsJobQueue::cancelAll() {
+    for (int row = 0; row < jobs_.size(); ++row) {
+        cancel(row);
+    }
+}
+
+void LvsJobQueue::clearFinished() {
+    QVector<Job> remaining;
+    remaining.reserve(jobs_.size());
+    for (const Job &job : std::as_const(jobs_)) {
+        if (job.status == Status::Hashing || job.status == Status::Queued ||
+            job.status == Status::Running) {
+            remaining.push_back(job);
+        }
+    }
+    if (remaining.size() == jobs_.size()) {
+        return;
+    }
+    emit jobsAboutToBeReset();
+    jobs_ = remaining;
+    emit jobsReset();
+}
+
+void LvsJobQueue::setCache(std::shared_ptr<LvsResultCache> cache) {
+    cache_ = std::move(cache);
+}
+
+auto LvsJobQueue::cache() const -> std::shared_ptr<LvsResultCache> {
+    return cache_;
+}
+
+void LvsJobQueue::setMaxConcurrent(int count) {
+    maxConcurrent_ = count > 0 ? count : defaultConcurrency();
+    schedule();
+}
+
+auto LvsJobQueue::maxConcurrent() const -> int { return maxConcurrent_; }
+
+auto LvsJobQueue::jobs() const -> const QVector<Job> & { return jobs_; }
+
+auto LvsJobQueue::rowForId(int id) const -> int {
+    for (int row = 0; row < jobs_.size(); ++row) {
+        if (jobs_.at(row).id == id) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+auto LvsJobQueue::runningCount() const -> int {
+    return static_cast<int>(runners_.size());
+}
+
+auto LvsJobQueue::pendingCount() const -> int {
+    int count = 0;
+    for (const Job &job : jobs_) {
+        if (job.status == Status::Hashing || job.status == Status::Queued ||
+            job.status == Status::Running) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+auto LvsJobQueue::elapsedMs(int row) const -> qint64 {
+    if (row < 0 || row >= jobs_.size()) {
+        return 0;
+    }
+    const Job &job = jobs_.at(row);
+    if (const auto *runner = runners_.value(job.id, nullptr)) {
+        return runner->elapsedMs();
+    }
+    return job.durationMs;
+}
+
+auto LvsJobQueue::defaultConcurrency() -> int {
+    return std::max(1, QThread::idealThreadCount());
+}
+
+auto LvsJobQueue::toStatusString(Status status) -> QString {
+    switch (status) {
+    case Status::Hashing:
+        return QStringLiteral("hashing inputs");
+    case Status::Queued:
+        return QStringLiteral("queued");
+    case Status::Running:
+        return QStringLiteral("running");
+    case Status::Succeeded:
+        return QStringLiteral("done");
+    case Status::Failed:
+        return QStringLiteral("failed");
+    case Status::Canceled:
+    default:
+        return QStringLiteral("canceled");
+    }
+}
+
+auto LvsJobQueue::uniqueOutPath(const QDir &dir,
+                                const QString &prefix) -> QString {
+    const QString stamp = QDateTime::currentDateTime().toString(
+        QStringLiteral("yyyyMMdd_hhmmss_zzz"));
+    const qint64 pid = QCoreApplication::applicationPid();
+    while (true) {
+        const QString baseName = QStringLiteral("%1_%2_%3_%4")
+                                     .arg(prefix, stamp)
+                                     .arg(pid)
+                                     .arg(outPathSeq.fetch_add(1));
+        const QString outPath = dir.filePath(baseName + QStringLiteral(".out"));
+        if (!QFile::exists(outPath) &&
+            !QFile::exists(LvsRunner::jsonPathForOut(outPath))) {
+            return outPath;
+        }
+    }
+}
+
+void LvsJobQueue::schedule() {
+    for (int row = 0;
+         row < jobs_.size() && runningCount() < maxConcurrent_; ++row) {
+        if (jobs_.at(row).status == Status::Queued) {
+            startJob(row);
+        }
+    }
+}
+
+void LvsJobQueue::startJob(int row) {
+    Job &job = jobs_[row];
+    if (job.request.outPath.isEmpty()) {
+        job.request.outPath = uniqueOutPath(QDir::current());
+    }
+    job.jsonPath = job.request.streamJson && !job.request.keepJsonCopy
+                       ? QString()
+                       : LvsRunner::jsonPathForOut(job.request.outPath);
+    job.status = Status::Running;
+
+    const int id = job.id;
+    auto *runner = new LvsRunner(this);
+    runners_.insert(id, runner);
+    connect(runner, &LvsRunner::phaseChanged, this,
+            [this, id](LvsRunner::Phase phase) {
+                const int jobRow = rowForId(id);
+                if (jobRow >= 0) {
+                    jobs_[jobRow].phase = phase;
+                    emit jobChanged(jobRow);
+                }
+            });
+    connect(runner, &LvsRunner::outputReceived, this,
+            [this, id](const QStringList &lines, bool isError) {
+                const int jobRow = rowForId(id);
+                if (jobRow >= 0) {
+                    emit jobOutput(jobRow, lines, isError);
+                }
+            });
+    connect(runner->outTail(), &NetgenOutTail::cellFinished, this,
+            [this, id, runner](int index) {
+                const int jobRow = rowForId(id);
+                if (jobRow < 0) {
+                    return;
+                }
+                const NetgenOutTail::Cell &cell =
+                    runner->outTail()->cells().at(index);
+                const bool match =
+                    cell.verdict == NetgenOutTail::Verdict::Match;
+                Job &job = jobs_[jobRow];
+                if (match) {
+                    ++job.cellsMatched;
+                } else {
+                    ++job.cellsMismatched;
+                    job.mismatchedCells << cell.layoutCell;
+                }
+                emit jobChanged(jobRow);
+                emit jobCellFinished(jobRow, cell.layoutCell, match);
+            });
+    connect(runner, &LvsRunner::jsonChunk, this,
+            [this, id](const QByteArray &chunk) {
+                const int jobRow = rowForId(id);
+                if (jobRow >= 0) {
+                    emit jobJsonChunk(jobRow, chunk);
+                }
+            });
+    connect(runner, &LvsRunner::finished, this,
+            [this, id, runner](bool ok, const QString &jsonPath,
+                               const QString &error) {
+                runners_.remove(id);
+                runner->deleteLater();
+                const int jobRow = rowForId(id);
+                if (jobRow >= 0) {
+                    Job &done = jobs_[jobRow];
+                    done.durationMs = runner->elapsedMs();
+                    done.jsonPath = jsonPath;
+                    done.phase = runner->phase();
+                    if (ok && done.scope) {
+                        done.result = runner->resultSummary();
+                        finishScoped(jobRow);
+                        schedule();
+                        return;
+                    }
+                    if (done.scope && !done.scope->directory.isEmpty()) {
+                        QDir(done.scope->directory).removeRecursively();
+                    }
+                    done.scope.reset();
+                    if (ok) {
+                        done.status = Status::Succeeded;
+                        done.result = runner->resultSummary();
+                        storeResult(done);
+                    } else {
+                        done.status =
+                            runner->phase() == LvsRunner::Phase::Canceled
+                                ? Status::Canceled
+                                : Status::Failed;
+                        done.result = error.section(QLatin1Char('\n'), 0, 0);
+                    }
+                    emit jobChanged(jobRow);
+                    emit jobFinished(jobRow, ok);
+                }
+                schedule();
+            });
+
+    LvsRunner::Request run = job.request;
+    if (job.scope) {
+        run.layout = job.scope->layout;
+        run.schematic = job.scope->schematic;
+    }
+    emit jobChanged(row);
+    runner->start(run);
+}
+
+void LvsJobQueue::hashJob(int row) {
+    const int id = jobs_.at(row).id;
+    const LvsRunner::Request request = jobs_.at(row).request;
+    auto cache = cache_;
+    auto key = std::make_shared<QString>();
+    auto hit = std::make_shared<QString>();
+    auto error = std::make_shared<QString>();
+    auto scope = std::make_shared<NetgenScope::Plan>();
+    const bool reuse = !jobs_.at(row).forceRerun;
+    const QString scopeDir =
+        cache->directory().isEmpty()
+            ? QString()
+            : QDir(cache->directory())
+                  .filePath(QStringLiteral("scoped/%1_%2")
+                                .arg(QCoreApplication::applicationPid())
+                                .arg(id));
+    const auto hash = [cache, request, key, hit, error, scope, scopeDir,
+                       reuse]() {
+        *key = cache->computeKey(request, error.get());
+        *hit = cache->lookup(*key);
+        if ((hit->isEmpty() || !reuse) && !scopeDir.isEmpty()) {
+            *scope = NetgenScope::plan(request, *cache, scopeDir, reuse);
+        }
+    };
+    DetachedThread::start(hash, this, [this, id, key, hit, error, scope]() {
+        const int jobRow = rowForId(id);
+        if (jobRow < 0 || jobs_.at(jobRow).status != Status::Hashing) {
+            return; // canceled or cleared meanwhile
+        }
+        Job &job = jobs_[jobRow];
+        job.cacheKey = *key;
+        if (!hit->isEmpty() && !job.forceRerun) {
+            job.status = Status::Succeeded;
+            job.phase = LvsRunner::Phase::Finished;
+            job.cached = true;
+            job.jsonPath = *hit;
+            job.result = tr("cache hit");
+            emit jobChanged(jobRow);
+            emit jobFinished(jobRow, true);
+            return;
+        }
+        if (key->isEmpty() && !error->isEmpty()) {
+            job.result = *error; // still run netgen; it will report the error
+        }
+        if (!scope->cellKeys.isEmpty()) {
+            job.scope = scope;
+            job.cellsReused = static_cast<int>(scope->reused.size());
+            job.cellsMatched = job.cellsReused;
+        }
+        if (job.cellsReused > 0) {
+            // A stream would carry netgen's part of the report only.
+            job.request.streamJson = false;
+            job.request.keepJsonCopy = true;
+        }
+        job.status = Status::Queued;
+        emit jobChanged(jobRow);
+        schedule();
+    });
+}
+
+void LvsJobQueue::storeResult(const Job &job) {
+    if (!cache_ || job.cacheKey.isEmpty() || job.jsonPath.isEmpty()) {
+        return;
+    }
+    auto cache = cache_;
+    const QString key = job.cacheKey;
+    const QString jsonPath = job.jsonPath;
+    const QString outPath = job.request.outPath;
+    DetachedThread::start([cache, key, jsonPath, outPath]() {
+        cache->store(key, jsonPath, outPath);
+    });
+}
+
+void LvsJobQueue::finishScoped(int row) {
+    const Job &job = jobs_.at(row);
+    const int id = job.id;
+    auto cache = cache_;
+    const auto scope = job.scope;
+    const QString jsonPath = job.jsonPath;
+    auto error = std::make_shared<QString>();
+    const auto merge = [cache, scope, jsonPath, error]() {
+        if (!jsonPath.isEmpty() &&
+            NetgenScope::merge(jsonPath, *scope, error.get())) {
+            NetgenScope::remember(jsonPath, *scope, *cache);
+        }
+        if (!scope->directory.isEmpty()) {
+            QDir(scope->directory).removeRecursively();
+        }
+    };
+    DetachedThread::start(merge, this, [this, id, error]() {
+        const int jobRow = rowForId(id);
+        if (jobRow < 0) {
+            return;
+        }
+        Job &done = jobs_[jobRow];
+        done.scope.reset();
+        const bool ok = error->isEmpty();
+        if (ok) {
+            done.status = Status::Succeeded;
+            storeResult(done);
+        } else {
+            done.status = Status::Failed;
+            done.phase = LvsRunner::Phase::Failed;
+            done.result = *error;
+        }
+        emit jobChanged(jobRow);
+        emit jobFinished(jobRow, ok);
+    });
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QDir>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+#include "lvs/LvsRunner.hpp"
+#include "lvs/NetgenScope.hpp"
+
+class LvsResultCache;
+
+// FIFO of netgen LVS jobs executed with a bounded number of concurrent
+// LvsRunner instances. Jobs are addressed by row (insertion order). With a
+// result cache attached, inputs are hashed off the GUI thread first and a
+// cache hit completes the job without starting netgen. On a miss, cells
+// that are unchanged since an earlier run are black-boxed through
+// NetgenScope, so netgen compares only what changed.
+class LvsJobQueue : public QObject {
+    Q_OBJECT
+
+  public:
+    enum class Status : char {
+        Hashing,
+        Queued,
+        Running,
+        Succeeded,
+        Failed,
+        Canceled
+    };
+
+    struct Job {
+        int id = -1;
+        LvsRunner::Request request;
+        Status status = Status::Queued;
+        LvsRunner::Phase phase = LvsRunner::Phase::Idle;
+        qint64 durationMs = 0;
+        QString jsonPath; // empty if the report was only streamed
+        QString result; // netgen "Final result" line or error text
+        QString cacheKey;
+        bool cached = false;     // served from the result cache
+        bool forceRerun = false; // still stored in the cache when done
+        int cellsMatched = 0; // per-cell verdicts read from the .out log
+        int cellsMismatched = 0;
+        QStringList mismatchedCells;
+        // Cells taken from the cache instead of netgen; counted as matched.
+        int cellsReused = 0;
+        std::shared_ptr<const NetgenScope::Plan> scope; // until merged
+    };
+
+    explicit LvsJobQueue(QObject *parent = nullptr);
+    ~LvsJobQueue() override;
+
+    // Returns the row. useCache=false forces a rerun even on a cache hit;
+    // its result replaces the cached one.
+    auto enqueue(const LvsRunner::Request &request, bool useCache = true)
+        -> int;
+    void cancel(int row);
+    void cancelAll();
+    void clearFinished();
+
+    void setCache(std::shared_ptr<LvsResultCache> cache);
+    auto cache() const -> std::shared_ptr<LvsResultCache>;
+
+    void setMaxConcurrent(int count); // <= 0 resets to the core count
+    auto maxConcurrent() const -> int;
+
+    auto jobs() const -> const QVector<Job> &;
+    auto rowForId(int id) const -> int;
+    auto runningCount() const -> int;
+    auto pendingCount() const -> int; // hashing + queued + running
+    auto elapsedMs(int row) const -> qint64;
+
+    static auto defaultConcurrency() -> int;
+    static auto toStatusString(Status status) -> QString;
+    // Collision-free `<prefix>_<timestamp ms>_<pid>_<seq>.out` path in dir.
+    static auto uniqueOutPath(const QDir &dir,
+                              const QString &prefix = QStringLiteral("comp"))
+        -> QString;
+
+  signals:
+    // The AboutTo signals come before jobs() changes, as models need.
+    void jobsAboutToBeReset();
+    void jobsReset();
+    void jobAboutToBeAdded(int row);
+    void jobAdded(int row);
+    void jobChanged(int row);
+    void jobFinished(int row, bool ok);
+    void jobOutput(int row, const QStringList &lines, bool isError);
+    void jobJsonChunk(int row, const QByteArray &chunk); // streamJson jobs
+    void jobCellFinished(int row, const QString &cell, bool match);
+
+  private:
+    void schedule();
+    void startJob(int row);
+    void hashJob(int row);
+    void storeResult(const Job &job);
+    // Completes a scoped job once its report is merged and remembered.
+    void finishScoped(int row);
+
+    QVector<Job> jobs_;
+    QHash<int, LvsRunner *> runners_; // job id -> active runner
+    std::shared_ptr<LvsResultCache> cache_;
+    int maxConcurrent_;
+    int nextId_{1};
+};
@@ -0,0 +1,398 @@
+#include "lvs/LvsResultCache.hpp"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+
+namespace {
+const auto keyFormat = QByteArrayLiteral("opensvs-lvs-cache-v1");
+const auto cellFormat = QByteArrayLiteral("opensvs-lvs-cells-v1");
+const auto hashAlgorithm = QCryptographicHash::Blake2b_256;
+const qint64 readChunk = 4 * 1024 * 1024;
+const auto readOnly = QFileDevice::ReadOwner | QFileDevice::ReadGroup |
+                      QFileDevice::ReadOther;
+
+auto removeCached(const QString &path) -> bool {
+    QFile::setPermissions(path, QFileDevice::ReadOwner |
+                                    QFileDevice::WriteOwner);
+    return QFile::remove(path);
+}
+
+// The cache keeps its own read-only copy: a hard link would follow any
+// later in-place rewrite of the job's output. The copy gets a unique name
+// next to target, so concurrent stores never write the same file; the
+// caller renames it into place.
+auto copyToTemporary(const QString &from, const QString &target,
+                     QTemporaryFile *tmp) -> bool {
+    QFile in(from);
+    tmp->setFileTemplate(target + QStringLiteral(".XXXXXX.tmp"));
+    if (!in.open(QIODevice::ReadOnly) || !tmp->open()) {
+        return false;
+    }
+    while (!in.atEnd()) {
+        const QByteArray chunk = in.read(readChunk);
+        if (chunk.isEmpty() || tmp->write(chunk) != chunk.size()) {
+            return false;
+        }
+    }
+    tmp->close();
+    return true;
+}
+} // namespace
+
+LvsResultCache::LvsResultCache(const QString &directory) : dir_(directory) {}
+
+auto LvsResultCache::defaultDirectory() -> QString {
+    const QString base =
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (base.isEmpty()) {
+        return {};
+    }
+    return base + QStringLiteral("/lvs");
+}
+
+auto LvsResultCache::directory() const -> QString { return dir_; }
+
+auto LvsResultCache::computeKey(const LvsRunner::Request &request,
+                                QString *error) -> QString {
+    QCryptographicHash key(hashAlgorithm);
+    key.addData(keyFormat);
+    key.addData(netgenIdentity(request.program));
+
+    QSet<QString> visited;
+    const QList<std::pair<QByteArray, QString>> roots = {
+        {QByteArrayLiteral("layout"), request.layout},
+        {QByteArrayLiteral("schematic"), request.schematic},
+        {QByteArrayLiteral("rules"), request.rules}};
+    for (const auto &[role, root] : roots) {
+        key.addData(role);
+        if (!addTree(key, visited, root, error)) {
+            return {};
+        }
+    }
+
+    QMutexLocker lock(&mutex_);
+    saveMemo();
+    return QString::fromLatin1(key.result().toHex());
+}
+
+auto LvsResultCache::lookup(const QString &key) const -> QString {
+    if (key.isEmpty() || dir_.isEmpty()) {
+        return {};
+    }
+    const QString path = QDir(dir_).filePath(key + QStringLiteral(".json"));
+    return QFile::exists(path) ? path : QString();
+}
+
+auto LvsResultCache::store(const QString &key, const QString &jsonPath,
+                           const QString &outPath) -> bool {
+    if (key.isEmpty() || dir_.isEmpty() || !QDir().mkpath(dir_)) {
+        return false;
+    }
+    const QDir dir(dir_);
+    const QString out = dir.filePath(key + QStringLiteral(".out"));
+    const QString target = dir.filePath(key + QStringLiteral(".json"));
+    QTemporaryFile outTmp;
+    const bool haveOut =
+        QFile::exists(outPath) && copyToTemporary(outPath, out, &outTmp);
+    QTemporaryFile jsonTmp;
+    if (!copyToTemporary(jsonPath, target, &jsonTmp)) {
+        return false;
+    }
+
+    // Copies run unlocked; only the swap into place is serialized with
+    // other stores and clear(). The JSON goes last: its presence is what
+    // lookup() treats as a hit.
+    QMutexLocker lock(&mutex_);
+    if (haveOut) {
+        removeCached(out);
+        if (outTmp.rename(out)) {
+            QFile::setPermissions(out, readOnly);
+        }
+    }
+    removeCached(target);
+    if (!jsonTmp.rename(target)) {
+        return false;
+    }
+    return QFile::setPermissions(target, readOnly);
+}
+
+void LvsResultCache::clear() {
+    QMutexLocker lock(&mutex_);
+    memo_.clear();
+    memoLoaded_ = true;
+    if (!dir_.isEmpty()) {
+        QDir(dir_).removeRecursively();
+    }
+}
+
+auto LvsResultCache::scopeKey(const LvsRunner::Request &request,
+                              QString *error) -> QString {
+    QCryptographicHash key(hashAlgorithm);
+    key.addData(cellFormat);
+    key.addData(netgenIdentity(request.program));
+    QSet<QString> visited;
+    if (!addTree(key, visited, request.rules, error)) {
+        return {};
+    }
+    QMutexLocker lock(&mutex_);
+    saveMemo();
+    return QString::fromLatin1(key.result().toHex());
+}
+
+auto LvsResultCache::cellResults(const QString &scopeKey) const
+    -> QJsonObject {
+    if (scopeKey.isEmpty() || dir_.isEmpty()) {
+        return {};
+    }
+    QMutexLocker lock(&mutex_);
+    QFile file(cellsPath(scopeKey));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+auto LvsResultCache::storeCells(const QString &scopeKey,
+                                const QJsonObject &cells) -> bool {
+    if (scopeKey.isEmpty() || dir_.isEmpty() ||
+        !QDir().mkpath(QFileInfo(cellsPath(scopeKey)).absolutePath())) {
+        return false;
+    }
+    // Read and rewritten under the lock, so concurrent jobs add up.
+    QMutexLocker lock(&mutex_);
+    QJsonObject stored;
+    QFile in(cellsPath(scopeKey));
+    if (in.open(QIODevice::ReadOnly)) {
+        stored = QJsonDocument::fromJson(in.readAll()).object();
+        in.close();
+    }
+    for (auto it = cells.constBegin(); it != cells.constEnd(); ++it) {
+        stored.insert(it.key(), it.value());
+    }
+    QSaveFile file(cellsPath(scopeKey));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QJsonDocument(stored).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+auto LvsResultCache::netgenIdentity(const QString &program) -> QByteArray {
+    const QString resolved =
+        QFileInfo(program).isAbsolute()
+            ? program
+            : QStandardPaths::findExecutable(program);
+    const QFileInfo info(resolved);
+    if (resolved.isEmpty() || !info.exists()) {
+        return QByteArrayLiteral("netgen:missing");
+    }
+    // Binary identity stands in for the version string: probing
+    // `netgen -batch` costs a process launch per lookup.
+    return QStringLiteral("netgen:%1:%2:%3")
+        .arg(info.canonicalFilePath())
+        .arg(info.size())
+        .arg(info.lastModified().toMSecsSinceEpoch())
+        .toUtf8();
+}
+
+auto LvsResultCache::includeTarget(const QByteArray &line,
+                                   const QString &baseDir) -> QString {
+    const QByteArray trimmed = line.trimmed();
+    if (trimmed.isEmpty()) {
+        return {};
+    }
+    const QList<QByteArray> tokens = trimmed.simplified().split(' ');
+    if (tokens.size() < 2) {
+        return {};
+    }
+    const QByteArray directive = tokens.first().toLower();
+    if (directive != ".include" && directive != ".inc" &&
+        directive != ".lib" && directive != "source") {
+        return {};
+    }
+    QByteArray target = tokens.at(1);
+    while (!target.isEmpty() &&
+           (target.startsWith('"') || target.startsWith('\'') ||
+            target.startsWith('{'))) {
+        target.remove(0, 1);
+    }
+    while (!target.isEmpty() &&
+           (target.endsWith('"') || target.endsWith('\'') ||
+            target.endsWith('}'))) {
+        target.chop(1);
+    }
+    if (target.isEmpty()) {
+        return {};
+    }
+    return QFileInfo(QDir(baseDir), QFile::decodeName(target))
+        .absoluteFilePath();
+}
+
+auto LvsResultCache::digestFile(const QString &path,
+                                QString *error) -> FileDigest {
+    const QFileInfo info(path);
+    if (!info.isFile()) {
+        if (error != nullptr) {
+            *error = QStringLiteral("Input file not found: %1").arg(path);
+        }
+        return {};
+    }
+    const qint64 mtimeMs = info.lastModified().toMSecsSinceEpoch();
+    const qint64 ctimeMs = info.metadataChangeTime().toMSecsSinceEpoch();
+    {
+        QMutexLocker lock(&mutex_);
+        loadMemo();
+        const auto it = memo_.constFind(path);
+        if (it != memo_.cend() && it->size == info.size() &&
+            it->mtimeMs == mtimeMs && it->ctimeMs == ctimeMs) {
+            return *it;
+        }
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error != nullptr) {
+            *error = QStringLiteral("Failed to open file: %1").arg(path);
+        }
+        return {};
+    }
+    FileDigest digest;
+    digest.size = info.size();
+    digest.mtimeMs = mtimeMs;
+    digest.ctimeMs = ctimeMs;
+    QCryptographicHash hash(hashAlgorithm);
+    const QString baseDir = info.absolutePath();
+    QByteArray pending;
+    auto scanLine = [&](const QByteArray &line) {
+        const QString target = includeTarget(line, baseDir);
+        if (!target.isEmpty() && QFileInfo(target).isFile() &&
+            !digest.includes.contains(target)) {
+            digest.includes.append(target);
+        }
+    };
+    while (!file.atEnd()) {
+        const QByteArray chunk = file.read(readChunk);
+        if (chunk.isEmpty()) {
+            break;
+        }
+        hash.addData(chunk);
+        pending += chunk;
+        qsizetype start = 0;
+        for (qsizetype nl = pending.indexOf('\n'); nl >= 0;
+             nl = pending.indexOf('\n', start)) {
+            // Only directive lines are worth materializing.
+            const char first = pending.at(start);
+            if (first == '.' || first == 's' || first == ' ' ||
+                first == '\t') {
+                scanLine(pending.mid(start, nl - start));
+            }
+            start = nl + 1;
+        }
+        pending.remove(0, start);
+    }
+    if (!pending.isEmpty()) {
+        scanLine(pending);
+    }
+    digest.hash = hash.result();
+
+    QMutexLocker lock(&mutex_);
+    memo_.insert(path, digest);
+    return digest;
+}
+
+auto LvsResultCache::addTree(QCryptographicHash &key,
+                             QSet<QString> &visited, const QString &root,
+                             QString *error) -> bool {
+    // Depth-first over includes so the digest order is deterministic.
+    QStringList stack{QFileInfo(root).absoluteFilePath()};
+    while (!stack.isEmpty()) {
+        const QString path = stack.takeLast();
+        if (visited.contains(path)) {
+            continue;
+        }
+        visited.insert(path);
+        const FileDigest digest = digestFile(path, error);
+        if (digest.hash.isEmpty()) {
+            return false;
+        }
+        key.addData(digest.hash);
+        for (auto it = digest.includes.crbegin();
+             it != digest.includes.crend(); ++it) {
+            stack.append(*it);
+        }
+    }
+    return true;
+}
+
+void LvsResultCache::loadMemo() {
+    if (memoLoaded_) {
+        return;
+    }
+    memoLoaded_ = true;
+    QFile file(memoPath());
+    if (memoPath().isEmpty() || !file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+        const QJsonObject entry = it.value().toObject();
+        FileDigest digest;
+        digest.size = entry.value(QStringLiteral("size")).toInteger(-1);
+        digest.mtimeMs = entry.value(QStringLiteral("mtime")).toInteger(-1);
+        digest.ctimeMs = entry.value(QStringLiteral("ctime")).toInteger(-1);
+        digest.hash = QByteArray::fromHex(
+            entry.value(QStringLiteral("hash")).toString().toLatin1());
+        for (const QJsonValueConstRef &inc :
+             entry.value(QStringLiteral("includes")).toArray()) {
+            digest.includes.append(inc.toString());
+        }
+        if (!digest.hash.isEmpty()) {
+            memo_.insert(it.key(), digest);
+        }
+    }
+}
+
+void LvsResultCache::saveMemo() const {
+    if (memoPath().isEmpty() || !QDir().mkpath(dir_)) {
+        return;
+    }
+    QJsonObject root;
+    for (auto it = memo_.cbegin(); it != memo_.cend(); ++it) {
+        QJsonObject entry;
+        entry.insert(QStringLiteral("size"), it->size);
+        entry.insert(QStringLiteral("mtime"), it->mtimeMs);
+        entry.insert(QStringLiteral("ctime"), it->ctimeMs);
+        entry.insert(QStringLiteral("hash"),
+                     QString::fromLatin1(it->hash.toHex()));
+        entry.insert(QStringLiteral("includes"),
+                     QJsonArray::fromStringList(it->includes));
+        root.insert(it.key(), entry);
+    }
+    QSaveFile file(memoPath());
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+}
+
+auto LvsResultCache::memoPath() const -> QString {
+    if (dir_.isEmpty()) {
+        return {};
+    }
+    return QDir(dir_).filePath(QStringLiteral("digests.json"));
+}
+
+auto LvsResultCache::cellsPath(const QString &scopeKey) const -> QString {
+    return QDir(dir_).filePath(QStringLiteral("cells/%1.json").arg(scopeKey));
+}
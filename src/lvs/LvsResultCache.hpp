@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "lvs/LvsRunner.hpp"
+
+class QCryptographicHash;
+class QJsonObject;
+
+// Local cache of netgen LVS results keyed by a content hash of the layout,
+// schematic and rules files, every file they pull in through `.include`,
+// `.inc`, `.lib` or Tcl `source`, and the identity of the netgen binary.
+// Per-file digests are memoized by (size, mtime, ctime) so an unchanged
+// multi-GB netlist is not re-read just to discover a cache hit; ctime is
+// there because tools that keep the mtime (rsync -t, cp -p) cannot set it.
+// Cached reports are read-only copies. Clean comparisons of single cells
+// are kept as well, for NetgenScope to black-box those cells in later
+// runs. Every member may be called from
+// any thread: the digest memo and the publish step of store() share one
+// lock, so concurrent stores of a key and clear() do not interleave.
+class LvsResultCache {
+  public:
+    explicit LvsResultCache(const QString &directory = defaultDirectory());
+
+    static auto defaultDirectory() -> QString;
+    auto directory() const -> QString;
+
+    // Empty on failure (unreadable input); *error explains why.
+    auto computeKey(const LvsRunner::Request &request,
+                    QString *error = nullptr) -> QString;
+    // Path of the cached JSON report for key, or empty on a miss.
+    auto lookup(const QString &key) const -> QString;
+    auto store(const QString &key, const QString &jsonPath,
+               const QString &outPath) -> bool;
+    void clear();
+
+    // Hash of what a run depends on besides its netlists: the rules file,
+    // its includes and netgen. Empty on failure.
+    auto scopeKey(const LvsRunner::Request &request,
+                  QString *error = nullptr) -> QString;
+    // Cell comparisons stored under scopeKey, by NetgenScope cell key.
+    auto cellResults(const QString &scopeKey) const -> QJsonObject;
+    // Adds cells to those stored under scopeKey.
+    auto storeCells(const QString &scopeKey, const QJsonObject &cells)
+        -> bool;
+
+    static auto netgenIdentity(const QString &program) -> QByteArray;
+    // File named by an include/source directive on line, resolved against
+    // baseDir; empty if the line is not such a directive.
+    static auto includeTarget(const QByteArray &line,
+                              const QString &baseDir) -> QString;
+
+  private:
+    struct FileDigest {
+        qint64 size = -1;
+        qint64 mtimeMs = -1;
+        qint64 ctimeMs = -1; // status change time
+        QByteArray hash;
+        QStringList includes;
+    };
+
+    auto digestFile(const QString &path, QString *error) -> FileDigest;
+    // Adds root and, depth-first, the files it includes to key.
+    auto addTree(QCryptographicHash &key, QSet<QString> &visited,
+                 const QString &root, QString *error) -> bool;
+    auto cellsPath(const QString &scopeKey) const -> QString;
+    void loadMemo();
+    void saveMemo() const;
+    auto memoPath() const -> QString;
+
+    QString dir_;
+    mutable QMutex mutex_;
+    QHash<QString, FileDigest> memo_;
+    bool memoLoaded_{false};
+};
@@ -0,0 +1,375 @@
+#include "lvs/LvsRunner.hpp"
+#include "lvs/NetgenOutTail.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcessEnvironment>
+#include <QSocketNotifier>
+#include <QTimer>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const int killGraceMs = 3000;
+const int maxStderrTail = 20;
+const int destroyWaitMs = 1000;
+const qint64 msPerSecond = 1000;
+const qint64 secondsPerMinute = 60;
+const qint64 secondsPerHour = 3600;
+const qint64 fifoReadChunk = 1024 * 1024;
+} // namespace
+
+LvsRunner::LvsRunner(QObject *parent)
+    : QObject(parent), outTail_(new NetgenOutTail(this)) {}
+
+LvsRunner::~LvsRunner() {
+    if (isRunning()) {
+        proc_->disconnect(this);
+        proc_->kill();
+        proc_->waitForFinished(destroyWaitMs);
+    }
+    canceled_ = true; // nobody is left to consume the rest of the stream
+    closeJsonStream();
+}
+
+auto LvsRunner::start(const Request &request) -> bool {
+    if (isRunning()) {
+        return false;
+    }
+    if (proc_ != nullptr) {
+        proc_->deleteLater();
+        proc_ = nullptr;
+    }
+
+    request_ = request;
+    canceled_ = false;
+    stdoutBuffer_.clear();
+    stderrBuffer_.clear();
+    stderrTail_.clear();
+    resultSummary_.clear();
+    finalElapsedMs_ = 0;
+    jsonBytes_ = 0;
+    if (request_.streamJson && !openJsonStream()) {
+        request_.streamJson = false; // fall back to reading the file
+    }
+
+    workingDir_ = QFileInfo(request_.rules).absolutePath();
+    auto makeRelative = [this](const QString &path) {
+        return QDir(workingDir_).relativeFilePath(path);
+    };
+    args_.clear();
+    args_ << QStringLiteral("-batch") << QStringLiteral("lvs")
+          << makeRelative(request_.layout) << makeRelative(request_.schematic)
+          << makeRelative(request_.rules) << makeRelative(request_.outPath)
+          << QStringLiteral("-json");
+
+    proc_ = new QProcess(this);
+    if (!workingDir_.isEmpty()) {
+        proc_->setWorkingDirectory(workingDir_);
+    }
+    proc_->setProcessEnvironment(QProcessEnvironment::systemEnvironment());
+    connect(proc_, &QProcess::readyReadStandardOutput, this,
+            [this]() { drain(QProcess::StandardOutput, false); });
+    connect(proc_, &QProcess::readyReadStandardError, this,
+            [this]() { drain(QProcess::StandardError, false); });
+    connect(proc_, &QProcess::started, this, [this]() {
+        setPhase(Phase::Reading);
+        emit started();
+    });
+    connect(proc_, &QProcess::finished, this, &LvsRunner::onFinished);
+    connect(proc_, &QProcess::errorOccurred, this,
+            &LvsRunner::onErrorOccurred);
+
+    elapsed_.start();
+    outTail_->start(QFileInfo(request_.outPath).absoluteFilePath());
+    setPhase(Phase::Starting);
+    proc_->start(request_.program, args_);
+    return true;
+}
+
+void LvsRunner::cancel() {
+    if (!isRunning()) {
+        return;
+    }
+    canceled_ = true;
+    proc_->terminate();
+    QProcess *proc = proc_;
+    QTimer::singleShot(killGraceMs, proc, [proc]() {
+        if (proc->state() != QProcess::NotRunning) {
+            proc->kill();
+        }
+    });
+}
+
+auto LvsRunner::isRunning() const -> bool {
+    return (proc_ != nullptr) && proc_->state() != QProcess::NotRunning;
+}
+
+auto LvsRunner::phase() const -> Phase { return phase_; }
+
+auto LvsRunner::elapsedMs() const -> qint64 {
+    if (isRunning() && elapsed_.isValid()) {
+        return elapsed_.elapsed();
+    }
+    return finalElapsedMs_;
+}
+
+auto LvsRunner::request() const -> const Request & { return request_; }
+
+auto LvsRunner::jsonPath() const -> QString {
+    return jsonPathForOut(request_.outPath);
+}
+
+auto LvsRunner::arguments() const -> QStringList { return args_; }
+
+auto LvsRunner::workingDirectory() const -> QString { return workingDir_; }
+
+auto LvsRunner::resultSummary() const -> QString { return resultSummary_; }
+
+auto LvsRunner::isStreaming() const -> bool { return fifoFd_ >= 0; }
+
+auto LvsRunner::outTail() const -> NetgenOutTail * { return outTail_; }
+
+auto LvsRunner::toPhaseString(Phase phase) -> QString {
+    switch (phase) {
+    case Phase::Starting:
+        return QStringLiteral("starting");
+    case Phase::Reading:
+        return QStringLiteral("reading netlists");
+    case Phase::Comparing:
+        return QStringLiteral("comparing");
+    case Phase::Reporting:
+        return QStringLiteral("writing report");
+    case Phase::Finished:
+        return QStringLiteral("finished");
+    case Phase::Failed:
+        return QStringLiteral("failed");
+    case Phase::Canceled:
+        return QStringLiteral("canceled");
+    case Phase::Idle:
+    default:
+        return QStringLiteral("idle");
+    }
+}
+
+auto LvsRunner::jsonPathForOut(const QString &outPath) -> QString {
+    const QFileInfo info(outPath);
+    return info.dir().filePath(info.completeBaseName() +
+                               QStringLiteral(".json"));
+}
+
+auto LvsRunner::formatElapsed(qint64 ms) -> QString {
+    const qint64 secs = ms / msPerSecond;
+    return QStringLiteral("%1:%2:%3")
+        .arg(secs / secondsPerHour, 2, 10, QLatin1Char('0'))
+        .arg((secs / secondsPerMinute) % secondsPerMinute, 2, 10,
+             QLatin1Char('0'))
+        .arg(secs % secondsPerMinute, 2, 10, QLatin1Char('0'));
+}
+
+void LvsRunner::setPhase(Phase phase) {
+    if (phase_ == phase) {
+        return;
+    }
+    phase_ = phase;
+    emit phaseChanged(phase_);
+}
+
+void LvsRunner::drain(QProcess::ProcessChannel channel, bool flush) {
+    if (proc_ == nullptr) {
+        return;
+    }
+    const bool isError = channel == QProcess::StandardError;
+    QByteArray &buffer = isError ? stderrBuffer_ : stdoutBuffer_;
+    buffer += isError ? proc_->readAllStandardError()
+                      : proc_->readAllStandardOutput();
+
+    QStringList lines;
+    qsizetype start = 0;
+    for (qsizetype nl = buffer.indexOf('\n'); nl >= 0;
+         nl = buffer.indexOf('\n', start)) {
+        QByteArray raw = buffer.mid(start, nl - start);
+        if (raw.endsWith('\r')) {
+            raw.chop(1);
+        }
+        lines << QString::fromLocal8Bit(raw);
+        start = nl + 1;
+    }
+    buffer.remove(0, start);
+    if (flush && !buffer.isEmpty()) {
+        lines << QString::fromLocal8Bit(buffer);
+        buffer.clear();
+    }
+    if (lines.isEmpty()) {
+        return;
+    }
+
+    for (const QString &line : lines) {
+        if (isError) {
+            stderrTail_ << line;
+        } else {
+            updatePhaseFromLine(line);
+        }
+    }
+    while (stderrTail_.size() > maxStderrTail) {
+        stderrTail_.removeFirst();
+    }
+    emit outputReceived(lines, isError);
+}
+
+void LvsRunner::updatePhaseFromLine(const QString &line) {
+    // Heuristics over netgen's batch output; phases only move forward.
+    const QString finalResult = QStringLiteral("Final result:");
+    if (line.startsWith(finalResult)) {
+        resultSummary_ = line.mid(finalResult.size()).trimmed();
+        setPhase(Phase::Reporting);
+    } else if (phase_ < Phase::Comparing &&
+               (line.contains(QStringLiteral("Subcircuit summary")) ||
+                line.contains(QStringLiteral("Comparison output")) ||
+                line.startsWith(QStringLiteral("Flattening")))) {
+        setPhase(Phase::Comparing);
+    } else if (phase_ < Phase::Reading &&
+               line.startsWith(QStringLiteral("Reading netlist"))) {
+        setPhase(Phase::Reading);
+    }
+}
+
+void LvsRunner::onFinished(int exitCode, QProcess::ExitStatus status) {
+    drain(QProcess::StandardOutput, true);
+    drain(QProcess::StandardError, true);
+    finalElapsedMs_ = elapsed_.isValid() ? elapsed_.elapsed() : 0;
+    outTail_->stop();
+
+    const bool streamed = isStreaming();
+    const QString streamError = closeJsonStream();
+    const QString json =
+        streamed && !request_.keepJsonCopy ? QString() : jsonPath();
+    if (canceled_) {
+        setPhase(Phase::Canceled);
+        emit finished(false, json, tr("netgen run canceled"));
+        return;
+    }
+    if (status != QProcess::NormalExit || exitCode != 0) {
+        setPhase(Phase::Failed);
+        emit finished(false, json,
+                      tr("netgen exited with code %1:\n%2")
+                          .arg(exitCode)
+                          .arg(stderrTail_.join(QLatin1Char('\n'))));
+        return;
+    }
+    if (!streamError.isEmpty()) {
+        setPhase(Phase::Failed);
+        emit finished(false, json, streamError);
+        return;
+    }
+    if (streamed ? jsonBytes_ == 0 : !QFile::exists(json)) {
+        setPhase(Phase::Failed);
+        emit finished(
+            false, json,
+            tr("Expected JSON output not found at %1").arg(jsonPath()));
+        return;
+    }
+    setPhase(Phase::Finished);
+    emit finished(true, json, QString());
+}
+
+void LvsRunner::onErrorOccurred(QProcess::ProcessError error) {
+    if (error != QProcess::FailedToStart) {
+        return;
+    }
+    finalElapsedMs_ = elapsed_.isValid() ? elapsed_.elapsed() : 0;
+    outTail_->stop();
+    closeJsonStream();
+    setPhase(Phase::Failed);
+    emit finished(false, jsonPath(), tr("Could not start netgen process."));
+}
+
+auto LvsRunner::openJsonStream() -> bool {
+#ifdef Q_OS_UNIX
+    const QString path = jsonPath();
+    const QByteArray nativePath = QFile::encodeName(path);
+    QFile::remove(path);
+    if (::mkfifo(nativePath.constData(), S_IRUSR | S_IWUSR) != 0) {
+        return false;
+    }
+    // O_RDWR keeps the FIFO open with no writer attached, so reads report
+    // EAGAIN rather than EOF before netgen opens it and after it closes it.
+    fifoFd_ = ::open(nativePath.constData(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fifoFd_ < 0) {
+        QFile::remove(path);
+        return false;
+    }
+    if (request_.keepJsonCopy) {
+        jsonCopy_.setFileName(path + QStringLiteral(".part"));
+        if (!jsonCopy_.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            closeJsonStream();
+            return false;
+        }
+    }
+    fifoNotifier_ = new QSocketNotifier(fifoFd_, QSocketNotifier::Read, this);
+    connect(fifoNotifier_, &QSocketNotifier::activated, this,
+            &LvsRunner::readJsonStream);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LvsRunner::readJsonStream() {
+#ifdef Q_OS_UNIX
+    if (fifoFd_ < 0) {
+        return;
+    }
+    QByteArray chunk(fifoReadChunk, Qt::Uninitialized);
+    while (true) {
+        const ssize_t count = ::read(fifoFd_, chunk.data(), chunk.size());
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return; // EAGAIN: drained for now
+        }
+        const QByteArray data = chunk.left(count);
+        jsonBytes_ += count;
+        if (jsonCopy_.isOpen()) {
+            jsonCopy_.write(data);
+        }
+        emit jsonChunk(data);
+    }
+#endif
+}
+
+auto LvsRunner::closeJsonStream() -> QString {
+#ifdef Q_OS_UNIX
+    if (fifoFd_ < 0) {
+        return {};
+    }
+    if (!canceled_) {
+        readJsonStream();
+    }
+    delete fifoNotifier_;
+    fifoNotifier_ = nullptr;
+    ::close(fifoFd_);
+    fifoFd_ = -1;
+    const QString path = jsonPath();
+    QFile::remove(path);
+    if (!jsonCopy_.isOpen()) {
+        return {};
+    }
+    const bool written =
+        jsonCopy_.flush() && jsonCopy_.error() == QFileDevice::NoError;
+    jsonCopy_.close();
+    if (canceled_ || !written || !jsonCopy_.rename(path)) {
+        const QString error = tr("Could not write JSON copy to %1").arg(path);
+        jsonCopy_.remove();
+        return canceled_ ? QString() : error;
+    }
+#endif
+    return {};
+}
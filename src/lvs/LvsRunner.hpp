@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+
+class NetgenOutTail;
+class QSocketNotifier;
+
+// Runs a single `netgen -batch lvs ... -json` invocation asynchronously.
+// Output is streamed line by line through outputReceived(); the GUI thread is
+// never blocked while netgen works.
+// With Request::streamJson the JSON path is a FIFO instead of a file and the
+// report arrives through jsonChunk() while netgen is still comparing.
+class LvsRunner : public QObject {
+    Q_OBJECT
+
+  public:
+    enum class Phase : char {
+        Idle,
+        Starting,
+        Reading,
+        Comparing,
+        Reporting,
+        Finished,
+        Failed,
+        Canceled
+    };
+    Q_ENUM(Phase)
+
+    struct Request {
+        QString layout;
+        QString schematic;
+        QString rules;
+        QString outPath; // netgen .out file; JSON is written next to it
+        QString program = QStringLiteral("netgen");
+        bool streamJson = false;  // read the JSON through a FIFO (POSIX only)
+        bool keepJsonCopy = true; // when streaming, also write it to disk
+    };
+
+    explicit LvsRunner(QObject *parent = nullptr);
+    ~LvsRunner() override;
+
+    auto start(const Request &request) -> bool;
+    void cancel();
+
+    auto isRunning() const -> bool;
+    auto phase() const -> Phase;
+    auto elapsedMs() const -> qint64;
+    auto request() const -> const Request &;
+    auto jsonPath() const -> QString;
+    auto arguments() const -> QStringList;
+    auto workingDirectory() const -> QString;
+    auto resultSummary() const -> QString; // text after "Final result:"
+    auto isStreaming() const -> bool;
+    // Per-cell progress parsed from the .out log while netgen writes it.
+    auto outTail() const -> NetgenOutTail *;
+
+    static auto toPhaseString(Phase phase) -> QString;
+    static auto jsonPathForOut(const QString &outPath) -> QString;
+    static auto formatElapsed(qint64 ms) -> QString; // hh:mm:ss
+
+  signals:
+    void started();
+    void phaseChanged(LvsRunner::Phase phase);
+    void outputReceived(const QStringList &lines, bool isError);
+    void jsonChunk(const QByteArray &chunk);
+    void finished(bool ok, const QString &jsonPath, const QString &error);
+
+  private:
+    void setPhase(Phase phase);
+    void drain(QProcess::ProcessChannel channel, bool flush);
+    void updatePhaseFromLine(const QString &line);
+    void onFinished(int exitCode, QProcess::ExitStatus status);
+    void onErrorOccurred(QProcess::ProcessError error);
+    auto openJsonStream() -> bool;
+    void readJsonStream();
+    auto closeJsonStream() -> QString; // error text, empty on success
+
+    QProcess *proc_{nullptr};
+    Request request_;
+    QStringList args_;
+    QString workingDir_;
+    QByteArray stdoutBuffer_;
+    QByteArray stderrBuffer_;
+    QStringList stderrTail_;
+    QString resultSummary_;
+    QElapsedTimer elapsed_;
+    qint64 finalElapsedMs_{0};
+    int fifoFd_{-1};
+    QSocketNotifier *fifoNotifier_{nullptr};
+    NetgenOutTail *outTail_{nullptr};
+    QFile jsonCopy_;
+    qint64 jsonBytes_{0};
+    Phase phase_{Phase::Idle};
+    bool canceled_{false};
+};
@@ -0,0 +1,123 @@
+#include "lvs/NetgenOutTail.hpp"
+
+#include <QFile>
+#include <QTimer>
+#include <utility>
+
+NetgenOutTail::NetgenOutTail(QObject *parent)
+    : QObject(parent), timer_(new QTimer(this)) {
+    connect(timer_, &QTimer::timeout, this, &NetgenOutTail::poll);
+}
+
+void NetgenOutTail::start(const QString &path, int intervalMs) {
+    reset();
+    path_ = path;
+    timer_->start(intervalMs);
+}
+
+void NetgenOutTail::stop() {
+    timer_->stop();
+    poll();
+    if (!pending_.isEmpty()) {
+        feedLine(QString::fromLocal8Bit(std::exchange(pending_, {})));
+    }
+}
+
+void NetgenOutTail::poll() {
+    if (path_.isEmpty()) {
+        return;
+    }
+    QFile file(path_);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return; // netgen has not created it yet
+    }
+    if (file.size() < offset_) {
+        reset(); // rewritten from the start
+    }
+    if (file.size() == offset_ || !file.seek(offset_)) {
+        return;
+    }
+    const QByteArray data = file.readAll();
+    offset_ += data.size();
+    pending_ += data;
+
+    qsizetype start = 0;
+    for (qsizetype nl = pending_.indexOf('\n'); nl >= 0;
+         nl = pending_.indexOf('\n', start)) {
+        QByteArray raw = pending_.mid(start, nl - start);
+        if (raw.endsWith('\r')) {
+            raw.chop(1);
+        }
+        feedLine(QString::fromLocal8Bit(raw));
+        start = nl + 1;
+    }
+    pending_.remove(0, start);
+}
+
+void NetgenOutTail::feedLine(const QString &line) {
+    const QString trimmed = line.trimmed();
+    const QString circuit1 = QStringLiteral("Circuit 1:");
+    const QString finalResult = QStringLiteral("Final result:");
+    if (trimmed.startsWith(QStringLiteral("Subcircuit summary:"))) {
+        cells_.push_back(Cell{});
+        current_ = static_cast<int>(cells_.size()) - 1;
+        expectNames_ = true;
+        emit cellStarted(current_);
+    } else if (expectNames_ && trimmed.startsWith(circuit1)) {
+        // "Circuit 1: <name>     |Circuit 2: <name>"
+        Cell &cell = cells_[current_];
+        cell.layoutCell = trimmed.section(QLatin1Char('|'), 0, 0)
+                              .mid(circuit1.size())
+                              .trimmed();
+        cell.schematicCell = trimmed.section(QLatin1Char('|'), 1)
+                                 .section(QLatin1Char(':'), 1)
+                                 .trimmed();
+        expectNames_ = false;
+    } else if (trimmed.startsWith(QStringLiteral("Netlists match"))) {
+        finishCell(Verdict::Match);
+    } else if (trimmed.startsWith(QStringLiteral("Netlists do not match"))) {
+        finishCell(Verdict::Mismatch);
+    } else if (trimmed.startsWith(finalResult)) {
+        finalResult_ = trimmed.mid(finalResult.size()).trimmed();
+        emit finalResultSeen(finalResult_);
+    } else if (current_ >= 0) {
+        cells_[current_].mismatchFlags += static_cast<int>(
+            line.count(QStringLiteral("**Mismatch**")));
+    }
+}
+
+void NetgenOutTail::reset() {
+    offset_ = 0;
+    pending_.clear();
+    cells_.clear();
+    current_ = -1;
+    expectNames_ = false;
+    matched_ = 0;
+    mismatched_ = 0;
+    finalResult_.clear();
+}
+
+auto NetgenOutTail::path() const -> QString { return path_; }
+
+auto NetgenOutTail::cells() const -> const QVector<Cell> & { return cells_; }
+
+auto NetgenOutTail::matchedCount() const -> int { return matched_; }
+
+auto NetgenOutTail::mismatchedCount() const -> int { return mismatched_; }
+
+auto NetgenOutTail::finalResult() const -> QString { return finalResult_; }
+
+void NetgenOutTail::finishCell(Verdict verdict) {
+    if (current_ < 0) {
+        return;
+    }
+    cells_[current_].verdict = verdict;
+    if (verdict == Verdict::Match) {
+        ++matched_;
+    } else {
+        ++mismatched_;
+    }
+    const int finished = current_;
+    current_ = -1;
+    emit cellFinished(finished);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+class QTimer;
+
+// Follows netgen's human-readable `.out` log while it is being written and
+// turns each "Subcircuit summary:" block into a per-cell verdict as soon as
+// netgen prints "Netlists match" or "Netlists do not match." for it. The
+// file is polled from the last read offset, so it may not exist yet when
+// tailing starts.
+class NetgenOutTail : public QObject {
+    Q_OBJECT
+
+  public:
+    enum class Verdict : char { Pending, Match, Mismatch };
+
+    struct Cell {
+        QString layoutCell;
+        QString schematicCell;
+        int mismatchFlags = 0; // "**Mismatch**" marks in the summary block
+        Verdict verdict = Verdict::Pending;
+    };
+
+    explicit NetgenOutTail(QObject *parent = nullptr);
+
+    void start(const QString &path, int intervalMs = defaultIntervalMs);
+    void stop(); // reads whatever is left, then stops polling
+    void poll();
+
+    // Line-level parser, usable without a file.
+    void feedLine(const QString &line);
+    void reset();
+
+    auto path() const -> QString;
+    auto cells() const -> const QVector<Cell> &;
+    auto matchedCount() const -> int;
+    auto mismatchedCount() const -> int;
+    auto finalResult() const -> QString;
+
+    static constexpr int defaultIntervalMs = 500;
+
+  signals:
+    void cellStarted(int index);
+    void cellFinished(int index);
+    void finalResultSeen(const QString &result);
+
+  private:
+    void finishCell(Verdict verdict);
+
+    QTimer *timer_{nullptr};
+    QString path_;
+    qint64 offset_{0};
+    QByteArray pending_; // trailing partial line
+    QVector<Cell> cells_;
+    int current_{-1}; // cell whose verdict is still open
+    bool expectNames_{false};
+    int matched_{0};
+    int mismatched_{0};
+    QString finalResult_;
+};
@@ -0,0 +1,323 @@
+#include "lvs/NetgenScope.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStringList>
+#include <algorithm>
+#include <utility>
+
+#include "lvs/LvsResultCache.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+#include "parsers/SpiceNetlist.hpp"
+#include "parsers/SpiceTokenizer.hpp"
+#include "parsers/SubcktHashes.hpp"
+
+namespace {
+constexpr int maxIncludeDepth = 64;
+
+// Copies a netlist statement by statement, as SpiceNetlist reads it.
+class Scoper {
+  public:
+    explicit Scoper(const QSet<QString> &cells) : cells_(cells) {}
+
+    auto read(const QString &path, int depth) -> bool;
+
+    QByteArray text;
+    QString error;
+
+  private:
+    const QSet<QString> &cells_;
+    QSet<QString> visited_;
+    bool boxed_ = false; // inside the body of a dropped cell
+};
+
+auto Scoper::read(const QString &path, int depth) -> bool {
+    const QFileInfo info(path);
+    const QString canonical = info.canonicalFilePath();
+    if (!canonical.isEmpty() && visited_.contains(canonical)) {
+        return true;
+    }
+    QFile in(info.absoluteFilePath());
+    if (canonical.isEmpty() || !in.open(QIODevice::ReadOnly)) {
+        error = QStringLiteral("Failed to open file: %1").arg(path);
+        return false;
+    }
+    if (depth > maxIncludeDepth) {
+        error = QStringLiteral("%1: includes nested too deeply").arg(path);
+        return false;
+    }
+    visited_.insert(canonical);
+    const QByteArray data = in.readAll();
+    const QString dir = info.absolutePath();
+    qsizetype copied = 0;
+    // Copies up to token, and skips it when drop is set.
+    const auto copyTo = [&](const SpiceTokenizer::Token &token, bool drop) {
+        const qsizetype at = token.text - data.constData();
+        text.append(data.constData() + copied, at - copied);
+        copied = drop ? at + token.size : at;
+    };
+    // Copies up to the statement and skips it.
+    const auto cut = [&](const SpiceTokenizer::Statement &statement) {
+        copyTo(statement.tokens.front(), false);
+        const SpiceTokenizer::Token &last = statement.tokens.back();
+        copied = last.text - data.constData() + last.size;
+    };
+
+    SpiceTokenizer tokenizer([&](const SpiceTokenizer::Statement &statement) {
+        const SpiceTokenizer::Token &head = statement.tokens.front();
+        const bool named = statement.tokens.size() > 1;
+        if (boxed_) {
+            if (head.is(".ends")) {
+                boxed_ = false;
+            } else {
+                cut(statement);
+            }
+        } else if (head.is(".subckt") && named) {
+            boxed_ =
+                cells_.contains(statement.tokens.at(1).toString().toLower());
+        } else if (SpiceTokenizer::isInclude(head) && named) {
+            cut(statement);
+            const SpiceTokenizer::Token &file = statement.tokens.at(1);
+            return read(SpiceTokenizer::includePath(dir, file), depth + 1);
+        } else if (head.is(".lib") && named) {
+            // The copy lives elsewhere; point the library back at its file.
+            const SpiceTokenizer::Token &name = statement.tokens.at(1);
+            copyTo(name, true);
+            text.append(
+                QFile::encodeName(SpiceTokenizer::includePath(dir, name)));
+        } else if (head.is(".end") && depth > 0) {
+            cut(statement); // would end the whole copy
+        }
+        return true;
+    });
+    const bool ok = tokenizer.feed(data.constData(), data.size()) &&
+                    tokenizer.finish();
+    text.append(data.constData() + copied, data.size() - copied);
+    return ok;
+}
+
+auto samePorts(const SpiceNetlist::Cell &a, const SpiceNetlist::Cell &b)
+    -> bool {
+    return std::equal(a.ports.cbegin(), a.ports.cend(), b.ports.cbegin(),
+                      b.ports.cend(), [](const QString &x, const QString &y) {
+                          return x.compare(y, Qt::CaseInsensitive) == 0;
+                      });
+}
+
+// Defined cells that cell calls, lower-case.
+auto children(const SpiceNetlist &netlist, const QString &cell)
+    -> QStringList {
+    QStringList called;
+    for (const SpiceNetlist::Element &element :
+         netlist.cell(cell)->elements) {
+        if (element.kind == QLatin1Char('x') &&
+            netlist.cell(element.deviceClass) != nullptr) {
+            called.append(element.deviceClass.toLower());
+        }
+    }
+    return called;
+}
+
+// Lower-case name of a circuit comparing two cells of the same name.
+auto cellOf(const QJsonObject &circuit) -> QString {
+    const QJsonArray name = circuit.value(QStringLiteral("name")).toArray();
+    const QString layout = name.at(0).toString().toLower();
+    return name.size() == 2 && name.at(1).toString().toLower() == layout
+               ? layout
+               : QString();
+}
+
+auto readReport(const QString &path, QJsonArray *report, QString *error)
+    -> bool {
+    QFile in(path);
+    if (in.open(QIODevice::ReadOnly)) {
+        const QJsonDocument doc = QJsonDocument::fromJson(in.readAll());
+        if (doc.isArray()) {
+            *report = doc.array();
+            return true;
+        }
+    }
+    if (error != nullptr) {
+        *error = QStringLiteral("Unreadable netgen report: %1").arg(path);
+    }
+    return false;
+}
+
+auto writeFile(const QString &path, const QByteArray &data) -> bool {
+    QSaveFile out(path);
+    return QDir().mkpath(QFileInfo(path).absolutePath()) &&
+           out.open(QIODevice::WriteOnly) && out.write(data) == data.size() &&
+           out.commit();
+}
+} // namespace
+
+auto NetgenScope::plan(const LvsRunner::Request &request,
+                       LvsResultCache &cache, const QString &directory,
+                       bool reuse, QString *error) -> Plan {
+    Plan plan;
+    plan.layout = request.layout;
+    plan.schematic = request.schematic;
+    plan.scopeKey = cache.scopeKey(request, error);
+    SpiceNetlist layout;
+    SpiceNetlist schematic;
+    if (plan.scopeKey.isEmpty() || !layout.load(request.layout, error) ||
+        !schematic.load(request.schematic, error)) {
+        plan.scopeKey.clear();
+        return plan;
+    }
+    const SubcktHashes layoutHashes(layout);
+    const SubcktHashes schematicHashes(schematic);
+    for (const SpiceNetlist::Cell &cell : layout.cells()) {
+        const SpiceNetlist::Cell *other = schematic.cell(cell.name);
+        if (other != nullptr && samePorts(cell, *other)) {
+            plan.cellKeys.insert(cell.name.toLower(),
+                                 cellKey(layoutHashes.hash(cell.name),
+                                         schematicHashes.hash(cell.name)));
+        }
+    }
+    if (!reuse) {
+        return plan;
+    }
+
+    const QJsonObject stored = cache.cellResults(plan.scopeKey);
+    for (auto it = plan.cellKeys.cbegin(); it != plan.cellKeys.cend(); ++it) {
+        const QJsonValue circuit = stored.value(it.value());
+        if (circuit.isObject()) {
+            plan.reused.insert(it.key(), circuit.toObject());
+        }
+    }
+    // A mismatched cell netgen flattened into a clean parent is compared
+    // on its own only while the parent keeps its body.
+    for (bool dropped = true; dropped;) {
+        dropped = false;
+        for (auto it = plan.reused.begin(); it != plan.reused.end();) {
+            QStringList called = children(layout, it.key());
+            called += children(schematic, it.key());
+            const bool whole =
+                std::all_of(called.cbegin(), called.cend(),
+                            [&plan](const QString &child) {
+                                return plan.reused.contains(child);
+                            });
+            if (whole) {
+                ++it;
+            } else {
+                it = plan.reused.erase(it);
+                dropped = true;
+            }
+        }
+    }
+    if (plan.reused.isEmpty()) {
+        return plan;
+    }
+
+    // netgen names the top cell after the file, so the copies keep the
+    // file names.
+    const QSet<QString> boxes(plan.reused.keyBegin(), plan.reused.keyEnd());
+    const QDir dir(directory);
+    const QString scopedLayout =
+        dir.filePath(QStringLiteral("layout/") +
+                     QFileInfo(request.layout).fileName());
+    const QString scopedSchematic =
+        dir.filePath(QStringLiteral("schematic/") +
+                     QFileInfo(request.schematic).fileName());
+    const QByteArray layoutText = blackBoxed(request.layout, boxes, error);
+    const QByteArray schematicText =
+        blackBoxed(request.schematic, boxes, error);
+    if (layoutText.isEmpty() || schematicText.isEmpty() ||
+        !writeFile(scopedLayout, layoutText) ||
+        !writeFile(scopedSchematic, schematicText)) {
+        plan.reused.clear(); // run the netlists whole instead
+        return plan;
+    }
+    plan.layout = scopedLayout;
+    plan.schematic = scopedSchematic;
+    plan.directory = directory;
+    return plan;
+}
+
+auto NetgenScope::merge(const QString &jsonPath, const Plan &plan,
+                        QString *error) -> bool {
+    if (plan.reused.isEmpty()) {
+        return true;
+    }
+    QJsonArray fresh;
+    if (!readReport(jsonPath, &fresh, error)) {
+        return false;
+    }
+    QJsonArray merged;
+    QSet<QString> placed;
+    for (const QJsonValueConstRef &value : std::as_const(fresh)) {
+        const QString cell = cellOf(value.toObject());
+        const auto it = plan.reused.constFind(cell);
+        if (it == plan.reused.cend()) {
+            merged.append(value);
+        } else {
+            merged.append(*it);
+            placed.insert(cell);
+        }
+    }
+    QStringList missing;
+    for (auto it = plan.reused.cbegin(); it != plan.reused.cend(); ++it) {
+        if (!placed.contains(it.key())) {
+            missing.append(it.key());
+        }
+    }
+    missing.sort();
+    for (auto it = missing.crbegin(); it != missing.crend(); ++it) {
+        merged.prepend(plan.reused.value(*it));
+    }
+    if (!writeFile(jsonPath, QJsonDocument(merged).toJson(
+                                 QJsonDocument::Compact))) {
+        if (error != nullptr) {
+            *error = QStringLiteral("Failed to write file: %1").arg(jsonPath);
+        }
+        return false;
+    }
+    return true;
+}
+
+void NetgenScope::remember(const QString &jsonPath, const Plan &plan,
+                           LvsResultCache &cache) {
+    QJsonArray report;
+    if (plan.cellKeys.isEmpty() || !readReport(jsonPath, &report, nullptr)) {
+        return;
+    }
+    QJsonObject clean;
+    for (qsizetype i = 0; i < report.size(); ++i) {
+        const QJsonObject circuit = report.at(i).toObject();
+        const QString cell = cellOf(circuit);
+        const QString key = plan.cellKeys.value(cell);
+        NetgenJsonParser::Report::Circuit parsed;
+        if (key.isEmpty() || plan.reused.contains(cell) ||
+            !NetgenJsonParser::parseCircuit(circuit, i, parsed)) {
+            continue;
+        }
+        if (parsed.diffs.isEmpty() && parsed.pinsA.isEmpty()) {
+            clean.insert(key, circuit);
+        }
+    }
+    if (!clean.isEmpty()) {
+        cache.storeCells(plan.scopeKey, clean);
+    }
+}
+
+auto NetgenScope::cellKey(const QByteArray &layout,
+                          const QByteArray &schematic) -> QString {
+    return QString::fromLatin1(layout.toHex() + ':' + schematic.toHex());
+}
+
+auto NetgenScope::blackBoxed(const QString &path, const QSet<QString> &cells,
+                             QString *error) -> QByteArray {
+    Scoper scoper(cells);
+    if (!scoper.read(path, 0)) {
+        if (error != nullptr) {
+            *error = scoper.error;
+        }
+        return {};
+    }
+    return scoper.text;
+}
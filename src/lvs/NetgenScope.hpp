@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QSet>
+#include <QString>
+
+#include "lvs/LvsRunner.hpp"
+
+class LvsResultCache;
+
+// Narrows a queued netgen run to the cells that changed since earlier
+// runs. Every cell pair netgen found clean is stored in LvsResultCache
+// under the SubcktHashes digests of its two sides. When a later run has
+// both digests again, plan() writes copies of the netlists with that
+// cell's body emptied, so netgen takes it for a black box and pairs its
+// pins by name, and merge() puts the stored comparison back into the
+// report. A digest covers everything below its cell, so after a fix in
+// one leaf netgen compares that leaf and its ancestors only.
+// A cell is black-boxed only together with every cell below it, and not
+// if its two sides name their ports differently: netgen may have paired
+// those pins by topology instead.
+class NetgenScope {
+  public:
+    struct Plan {
+        QString layout; // netlists to run netgen on
+        QString schematic;
+        QString directory; // holds the scoped copies; empty if none
+        QString scopeKey;  // LvsResultCache::scopeKey
+        // Cells defined on both sides, lower-case name -> cell key.
+        QHash<QString, QString> cellKeys;
+        // Black-boxed cells, lower-case name -> stored circuit.
+        QHash<QString, QJsonObject> reused;
+    };
+
+    // Reads both netlists and finds the cells cache has clean results for;
+    // with reuse and at least one such cell, the scoped copies go into
+    // directory. Returns a plan running the netlists as given, and sets
+    // *error, if the inputs cannot be read.
+    static auto plan(const LvsRunner::Request &request, LvsResultCache &cache,
+                     const QString &directory, bool reuse,
+                     QString *error = nullptr) -> Plan;
+    // Replaces the black boxes in netgen's report at jsonPath with the
+    // stored circuits; stored cells netgen left out go first.
+    static auto merge(const QString &jsonPath, const Plan &plan,
+                      QString *error = nullptr) -> bool;
+    // Stores the clean cells of the report at jsonPath.
+    static void remember(const QString &jsonPath, const Plan &plan,
+                         LvsResultCache &cache);
+
+    static auto cellKey(const QByteArray &layout, const QByteArray &schematic)
+        -> QString;
+    // The netlist at path, includes read in place, with the bodies of
+    // cells (lower-case names) dropped. Empty on failure.
+    static auto blackBoxed(const QString &path, const QSet<QString> &cells,
+                           QString *error = nullptr) -> QByteArray;
+};
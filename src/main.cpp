@@ -2,15 +2,46 @@
 #include <QCommandLineParser>
 #include <QFileInfo>
 #include <QLoggingCategory>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 #include "MainWindow.hpp"
+#include "OpenSvsVersion.hpp"
+#include "cli/Cli.hpp"
+#include "diagnostics/Tracer.hpp"
+#include "ipc/SingleInstance.hpp"
 
-auto main(int argc, char *argv[]) -> int {
-    QApplication app(argc, argv);
-    QCoreApplication::setApplicationName(QStringLiteral("opensvs"));
-    QCoreApplication::setApplicationVersion(QStringLiteral("0.3"));
+namespace {
+struct Options {
+    QCommandLineOption trace{
+        QStringLiteral("trace"),
+        QStringLiteral("Record timing spans from startup and write them as "
+                       "Chrome trace JSON to file on exit."),
+        QStringLiteral("file")};
+    QCommandLineOption singleInstance{
+        QStringLiteral("single-instance"),
+        QStringLiteral("Open the report in an already running "
+                       "--single-instance viewer if there is one, else "
+                       "become that viewer.")};
+    QCommandLineOption queryServer{
+        QStringLiteral("query-server"),
+        QStringLiteral("Answer JSON queries about the loaded report on a "
+                       "local socket (View > Query Server).")};
+    QCommandLineOption waivers{
+        QStringLiteral("waivers"),
+        QStringLiteral("Mark the diffs covered by the waiver rules in file "
+                       "(File > Load Waivers)."),
+        QStringLiteral("file")};
+    QCommandLineOption tolerances{
+        QStringLiteral("tolerances"),
+        QStringLiteral("Compare property values within the tolerances in "
+                       "file (File > Load Tolerances)."),
+        QStringLiteral("file")};
+};
 
-    QCommandLineParser parser;
+void setUp(QCommandLineParser &parser, const Options &options) {
     parser.setApplicationDescription(
         QStringLiteral("OpenSVS netgen JSON viewer"));
     parser.addHelpOption();
@@ -18,10 +49,110 @@ auto main(int argc, char *argv[]) -> int {
     parser.addPositionalArgument(
         QStringLiteral("file"),
         QStringLiteral("Optional netgen JSON report to load on startup."));
+    parser.addOptions({options.trace, options.singleInstance,
+                       options.queryServer, options.waivers,
+                       options.tolerances});
+}
+
+auto hasArgument(int argc, char *argv[], const char *name) -> bool {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--") == 0) {
+            return false;
+        }
+        if (std::strcmp(argv[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Sends the reports to a running instance using QtCore only; true if it
+// took them and this process is done. Only the file is handed over, so any
+// other option (--trace, --waivers, --tolerances, ...) starts a viewer of
+// its own instead of being dropped.
+auto handOffToRunningInstance(int argc, char *argv[]) -> bool {
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    const Options options;
+    setUp(parser, options);
+    if (!parser.parse(QCoreApplication::arguments()) ||
+        parser.positionalArguments().isEmpty()) {
+        return false;
+    }
+    const QStringList names = parser.optionNames();
+    if (!std::all_of(names.cbegin(), names.cend(), [](const QString &name) {
+            return name == QStringLiteral("single-instance");
+        })) {
+        return false;
+    }
+    return SingleInstance::handOff(
+        SingleInstance::defaultServerName(),
+        {QFileInfo(parser.positionalArguments().first()).absoluteFilePath()});
+}
+} // namespace
+
+auto main(int argc, char *argv[]) -> int {
+    // Headless requests are answered before any widget code is initialized.
+    if (Cli::isHeadless(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        QCoreApplication::setApplicationName(QStringLiteral("opensvs"));
+        QCoreApplication::setApplicationVersion(
+            QStringLiteral(OPENSVS_VERSION_STRING));
+        QTextStream out(stdout);
+        QTextStream err(stderr);
+        return Cli::run(QCoreApplication::arguments(), out, err);
+    }
+    // So is a hand-off to a viewer that is already up.
+    if (hasArgument(argc, argv, "--single-instance") &&
+        handOffToRunningInstance(argc, argv)) {
+        return 0;
+    }
+
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("opensvs"));
+    QCoreApplication::setApplicationVersion(
+        QStringLiteral(OPENSVS_VERSION_STRING));
+
+    QCommandLineParser parser;
+    const Options options;
+    setUp(parser, options);
     parser.process(app);
+    if (parser.isSet(options.trace)) {
+        Tracer::setEnabled(true);
+    }
 
     MainWindow window;
 
+    SingleInstance instance;
+    if (parser.isSet(options.singleInstance)) {
+        if (!instance.listen()) {
+            qWarning() << "Another instance owns"
+                       << instance.serverName() << "; running standalone";
+        }
+        QObject::connect(&instance, &SingleInstance::filesReceived, &window,
+                         [&window](const QStringList &paths) {
+                             for (const QString &path : paths) {
+                                 window.loadFile(path, /*showError=*/true);
+                             }
+                             window.showNormal();
+                             window.raise();
+                             window.activateWindow();
+                         });
+    }
+
+    if (parser.isSet(options.queryServer)) {
+        window.setQueryServerEnabled(true);
+    }
+
+    if (parser.isSet(options.waivers)) {
+        window.loadWaivers(parser.value(options.waivers), /*showError=*/true);
+    }
+
+    if (parser.isSet(options.tolerances)) {
+        window.loadTolerances(parser.value(options.tolerances),
+                              /*showError=*/true);
+    }
+
     const QStringList positional = parser.positionalArguments();
     if (!positional.isEmpty()) {
         const QString filePath =
@@ -32,5 +163,12 @@ auto main(int argc, char *argv[]) -> int {
     }
 
     window.show();
-    return QApplication::exec();
+    const int code = QApplication::exec();
+    if (parser.isSet(options.trace)) {
+        QString error;
+        if (!Tracer::saveChromeTrace(parser.value(options.trace), &error)) {
+            qWarning() << "Failed to write trace:" << error;
+        }
+    }
+    return code;
 }
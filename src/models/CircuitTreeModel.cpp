@@ -3,12 +3,38 @@
 #include <QString>
 #include <QtCore>
 
+#include "diagnostics/Tracer.hpp"
+
 CircuitTreeModel::CircuitTreeModel(QObject *parent)
     : QAbstractItemModel(parent) {}
 
+auto CircuitTreeModel::memoryBytes() const -> qint64 {
+    using Rows = QVector<DeviceHistogram::ClassCount>;
+    auto bytes = static_cast<qint64>(storage_.capacity() *
+                                     sizeof(std::unique_ptr<Node>)) +
+                 static_cast<qint64>(roots_.capacity() * sizeof(Node *)) +
+                 static_cast<qint64>(deviceMismatches_.capacity() *
+                                     sizeof(Rows));
+    for (const auto &rows : deviceMismatches_) {
+        bytes += static_cast<qint64>(rows.capacity() *
+                                     sizeof(DeviceHistogram::ClassCount));
+    }
+    for (const auto &node : storage_) {
+        bytes += static_cast<qint64>(sizeof(Node)) +
+                 static_cast<qint64>(node->children.capacity() *
+                                     sizeof(Node *));
+    }
+    return bytes;
+}
+
+auto CircuitTreeModel::nodeCount() const -> qint64 {
+    return static_cast<qint64>(storage_.size());
+}
+
 void CircuitTreeModel::clear() {
     roots_.clear();
     storage_.clear();
+    deviceMismatches_.clear();
 }
 
 auto CircuitTreeModel::buildNode(NetgenJsonParser::Report::Circuit *circuit,
@@ -26,10 +52,15 @@ auto CircuitTreeModel::buildNode(NetgenJsonParser::Report::Circuit *circuit,
 
 void CircuitTreeModel::setCircuits(
     QVector<NetgenJsonParser::Report::Circuit> *circuits) {
+    OPENSVS_TRACE_SCOPE("CircuitTreeModel::setCircuits", "model");
     beginResetModel();
     clear();
     circuits_ = circuits;
     if (circuits_ != nullptr) {
+        deviceMismatches_ = DeviceHistogram::rolledUp(*circuits_);
+        for (auto &rows : deviceMismatches_) {
+            rows = DeviceHistogram::mismatches(rows);
+        }
         for (auto &circuit : *circuits_) {
             if (circuit.isTopLevel) {
                 roots_.append(buildNode(&circuit, nullptr));
@@ -39,6 +70,29 @@ void CircuitTreeModel::setCircuits(
     endResetModel();
 }
 
+void CircuitTreeModel::appendCircuits() {
+    if (circuits_ == nullptr) {
+        return;
+    }
+    QVector<Node *> added;
+    for (qsizetype i = deviceMismatches_.size(); i < circuits_->size(); ++i) {
+        auto &circuit = (*circuits_)[i];
+        deviceMismatches_.append(
+            DeviceHistogram::mismatches(DeviceHistogram::of(circuit)));
+        if (circuit.isTopLevel) {
+            added.append(buildNode(&circuit, nullptr));
+        }
+    }
+    if (added.isEmpty()) {
+        return;
+    }
+    const auto first = static_cast<int>(roots_.size());
+    beginInsertRows(QModelIndex(), first,
+                    first + static_cast<int>(added.size()) - 1);
+    roots_ += added;
+    endInsertRows();
+}
+
 auto CircuitTreeModel::index(
     int row, int column, const QModelIndex &parentIdx) const -> QModelIndex {
     if (column != 0) {
@@ -86,7 +140,8 @@ auto CircuitTreeModel::columnCount(const QModelIndex & /*parent*/) const
 
 auto CircuitTreeModel::data(const QModelIndex &idx,
                             int role) const -> QVariant {
-    if (!idx.isValid() || role != Qt::DisplayRole) {
+    if (!idx.isValid() ||
+        (role != Qt::DisplayRole && role != Qt::ToolTipRole)) {
         return {};
     }
     Node *node = static_cast<Node *>(idx.internalPointer());
@@ -94,7 +149,23 @@ auto CircuitTreeModel::data(const QModelIndex &idx,
         return {};
     }
     const auto *cir = node->circuit;
-    return QStringLiteral("%1 vs %2").arg(cir->layoutCell, cir->schematicCell);
+    if (role == Qt::DisplayRole) {
+        return QStringLiteral("%1 vs %2").arg(cir->layoutCell,
+                                              cir->schematicCell);
+    }
+    const auto rows = deviceMismatches_.value(cir->index);
+    if (rows.isEmpty()) {
+        return {};
+    }
+    QStringList lines{QStringLiteral("Device counts with subcells (layout "
+                                     "vs schematic):")};
+    for (const auto &row : rows) {
+        lines.append(QStringLiteral("%1: %2 vs %3")
+                         .arg(row.deviceClass)
+                         .arg(row.layout)
+                         .arg(row.schematic));
+    }
+    return lines.join(QLatin1Char('\n'));
 }
 
 auto CircuitTreeModel::circuitForIndex(const QModelIndex &idx)
@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 
+#include "parsers/DeviceHistogram.hpp"
 #include "parsers/NetgenJsonParser.hpp"
 
 class CircuitTreeModel : public QAbstractItemModel {
@@ -13,6 +14,10 @@ class CircuitTreeModel : public QAbstractItemModel {
     explicit CircuitTreeModel(QObject *parent = nullptr);
 
     void setCircuits(QVector<NetgenJsonParser::Report::Circuit> *circuits);
+    // Adds top-level rows for the circuits appended to the vector since
+    // setCircuits or the last call, which must not have reallocated it.
+    // Their tooltips count their own devices, not their subcells'.
+    void appendCircuits();
     auto index(int row, int column, const QModelIndex &parent = QModelIndex())
         const -> QModelIndex override;
     auto parent(const QModelIndex &child) const -> QModelIndex override;
@@ -25,6 +30,9 @@ class CircuitTreeModel : public QAbstractItemModel {
 
     static auto circuitForIndex(const QModelIndex &idx)
         -> NetgenJsonParser::Report::Circuit *;
+    // Heap bytes of the tree nodes (the circuits are not owned).
+    auto memoryBytes() const -> qint64;
+    auto nodeCount() const -> qint64;
 
   private:
     struct Node {
@@ -35,6 +43,9 @@ class CircuitTreeModel : public QAbstractItemModel {
 
     QVector<NetgenJsonParser::Report::Circuit> *circuits_{nullptr};
     QVector<Node *> roots_;
+    // Per circuit index, the device classes whose rolled-up counts
+    // differ; shown as the item tooltip.
+    QVector<QVector<DeviceHistogram::ClassCount>> deviceMismatches_;
     mutable std::vector<std::unique_ptr<Node>> storage_;
 
     void clear();
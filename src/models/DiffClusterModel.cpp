@@ -0,0 +1,135 @@
+#include "models/DiffClusterModel.hpp"
+#include "models/DiffEntryCommon.hpp"
+
+#include "diagnostics/Tracer.hpp"
+#include "models/DiffEntryModel.hpp"
+
+namespace {
+// internalId of a cluster row; member rows carry their cluster + 1.
+const quintptr clusterId = 0;
+} // namespace
+
+DiffClusterModel::DiffClusterModel(QObject *parent)
+    : QAbstractItemModel(parent) {}
+
+void DiffClusterModel::setRows(const DiffEntryModel *source,
+                               const QVector<int> &rows) {
+    OPENSVS_TRACE_SCOPE("DiffClusterModel::setRows", "model");
+    beginResetModel();
+    source_ = source;
+    clusters_.clear();
+    if (source_ != nullptr) {
+        const auto &diffs = source_->diffs();
+        DiffClusters::DiffList list;
+        list.reserve(rows.size());
+        for (const int row : rows) {
+            list.append(&diffs.at(row));
+        }
+        clusters_ = DiffClusters::cluster(list);
+        for (auto &cluster : clusters_) {
+            for (int &member : cluster.rows) {
+                member = rows.at(member);
+            }
+        }
+    }
+    endResetModel();
+}
+
+auto DiffClusterModel::clusterCount() const -> int {
+    return static_cast<int>(clusters_.size());
+}
+
+auto DiffClusterModel::sourceRow(const QModelIndex &index) const -> int {
+    if (!index.isValid() || index.internalId() == clusterId) {
+        return -1;
+    }
+    return clusters_.at(static_cast<int>(index.internalId() - 1))
+        .rows.at(index.row());
+}
+
+auto DiffClusterModel::index(int row, int column,
+                             const QModelIndex &parent) const -> QModelIndex {
+    if (column < 0 || column >= DiffEntryColumns::NUM_COLUMNS || row < 0 ||
+        row >= rowCount(parent)) {
+        return {};
+    }
+    if (!parent.isValid()) {
+        return createIndex(row, column, clusterId);
+    }
+    return createIndex(row, column, static_cast<quintptr>(parent.row()) + 1);
+}
+
+auto DiffClusterModel::parent(const QModelIndex &child) const
+    -> QModelIndex {
+    if (!child.isValid() || child.internalId() == clusterId) {
+        return {};
+    }
+    return createIndex(static_cast<int>(child.internalId() - 1), 0,
+                       clusterId);
+}
+
+auto DiffClusterModel::rowCount(const QModelIndex &parent) const -> int {
+    if (!parent.isValid()) {
+        return static_cast<int>(clusters_.size());
+    }
+    if (parent.internalId() != clusterId || parent.column() != 0) {
+        return 0;
+    }
+    return static_cast<int>(clusters_.at(parent.row()).rows.size());
+}
+
+auto DiffClusterModel::columnCount(const QModelIndex & /*parent*/) const
+    -> int {
+    return DiffEntryColumns::NUM_COLUMNS;
+}
+
+auto DiffClusterModel::data(const QModelIndex &index,
+                            int role) const -> QVariant {
+    if (!index.isValid() || source_ == nullptr) {
+        return {};
+    }
+    const int member = sourceRow(index);
+    if (member >= 0) {
+        return source_->data(source_->index(member, index.column()), role);
+    }
+
+    const auto &cluster = clusters_.at(index.row());
+    const auto count = static_cast<int>(cluster.rows.size());
+    if (role == CountRole) {
+        return count;
+    }
+    if (role == Qt::ToolTipRole) {
+        return QStringLiteral("%1 diffs like %2")
+            .arg(count)
+            .arg(source_->diffs().at(cluster.rows.first()).name);
+    }
+    if (role != Qt::DisplayRole) {
+        return {};
+    }
+    switch (index.column()) {
+    case DiffEntryColumns::TYPE:
+        return QStringLiteral("%1 (%2)")
+            .arg(NetgenJsonParser::toTypeString(cluster.type))
+            .arg(count);
+    case DiffEntryColumns::SUBTYPE:
+        return NetgenJsonParser::toSubtypeString(cluster.subtype);
+    case DiffEntryColumns::OBJECT:
+        return cluster.name;
+    case DiffEntryColumns::LAYOUT_CELL:
+        return cluster.layoutCell;
+    case DiffEntryColumns::SCHEMATIC_CELL:
+        return cluster.schematicCell;
+    case DiffEntryColumns::DETAILS:
+        return cluster.details;
+    default:
+        return {};
+    }
+}
+
+auto DiffClusterModel::headerData(int section, Qt::Orientation orientation,
+                                  int role) const -> QVariant {
+    if (source_ == nullptr) {
+        return {};
+    }
+    return source_->headerData(section, orientation, role);
+}
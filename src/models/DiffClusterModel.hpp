@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QVector>
+
+#include "models/DiffClusters.hpp"
+
+class DiffEntryModel;
+
+// Two-level view of DiffClusters: one top-level row per cluster with the
+// masked signature and the member count, and the member diffs below it in
+// the columns of DiffEntryModel.
+class DiffClusterModel : public QAbstractItemModel {
+    Q_OBJECT
+  public:
+    explicit DiffClusterModel(QObject *parent = nullptr);
+
+    // Member count of a cluster row; invalid for member rows.
+    static constexpr int CountRole = Qt::UserRole + 1;
+
+    // Clusters the given rows of source (e.g. the rows a filter proxy
+    // shows), by their resident details; source is not owned and must
+    // outlive the model or the next call. nullptr clears the model.
+    void setRows(const DiffEntryModel *source, const QVector<int> &rows);
+    auto clusterCount() const -> int;
+    // The source row of a member index; -1 for cluster rows.
+    auto sourceRow(const QModelIndex &index) const -> int;
+
+    auto index(int row, int column, const QModelIndex &parent = QModelIndex())
+        const -> QModelIndex override;
+    auto parent(const QModelIndex &child) const -> QModelIndex override;
+    auto
+    rowCount(const QModelIndex &parent = QModelIndex()) const -> int override;
+    auto columnCount(const QModelIndex &parent = QModelIndex()) const
+        -> int override;
+    auto data(const QModelIndex &index,
+              int role = Qt::DisplayRole) const -> QVariant override;
+    auto headerData(int section, Qt::Orientation orientation,
+                    int role = Qt::DisplayRole) const -> QVariant override;
+
+  private:
+    const DiffEntryModel *source_{nullptr};
+    QVector<DiffClusters::Cluster> clusters_; // rows are source rows
+};
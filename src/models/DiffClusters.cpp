@@ -0,0 +1,162 @@
+#include "models/DiffClusters.hpp"
+
+#include <QHash>
+#include <algorithm>
+#include <cmath>
+
+#include "diagnostics/Tracer.hpp"
+#include "models/DiffDelta.hpp"
+#include "parsers/DiffDetailCache.hpp"
+#include "parsers/SpiceNumber.hpp"
+
+namespace {
+const QChar separator(0x1f);
+
+auto isWordChar(QChar c) -> bool {
+    return c.isLetter() || c == QLatin1Char('_');
+}
+
+auto isDigit(const QString &text, qsizetype i) -> bool {
+    return i < text.size() && text[i].isDigit();
+}
+
+auto skipDigits(const QString &text, qsizetype i) -> qsizetype {
+    while (isDigit(text, i)) {
+        ++i;
+    }
+    return i;
+}
+
+// Scale suffix and unit letters, as SpiceNumber reads them.
+auto isUnitChar(QChar c) -> bool {
+    const char16_t u = c.unicode();
+    return (u >= u'a' && u <= u'z') || (u >= u'A' && u <= u'Z');
+}
+
+auto decade(double value) -> QString {
+    if (value == 0.0 || !std::isfinite(value)) {
+        return QStringLiteral("0");
+    }
+    // The epsilon keeps 1u (0.999...e-6 in binary) in its own decade.
+    const int exponent =
+        static_cast<int>(std::floor(std::log10(std::fabs(value)) + 1e-9));
+    return QStringLiteral("~1e%1").arg(exponent);
+}
+
+auto maskedCell(const QString &cell, const QChar *&last, QString &masked)
+    -> const QString & {
+    // Diffs arrive circuit by circuit with shared cell strings.
+    if (cell.constData() != last) {
+        last = cell.constData();
+        masked = DiffClusters::maskedName(cell);
+    }
+    return masked;
+}
+} // namespace
+
+auto DiffClusters::maskedName(const QString &name) -> QString {
+    QString masked;
+    masked.reserve(name.size());
+    for (qsizetype i = 0; i < name.size();) {
+        if (!name[i].isDigit()) {
+            masked.append(name[i++]);
+            continue;
+        }
+        masked.append(QLatin1Char('#'));
+        i = skipDigits(name, i);
+    }
+    return masked;
+}
+
+auto DiffClusters::maskedDetails(const QString &details) -> QString {
+    QString masked;
+    masked.reserve(details.size());
+    for (qsizetype i = 0; i < details.size();) {
+        if (!details[i].isDigit()) {
+            masked.append(details[i++]);
+            continue;
+        }
+        qsizetype end = skipDigits(details, i);
+        if (i > 0 && isWordChar(details[i - 1])) {
+            masked.append(QLatin1Char('#')); // an index: m3, bit_12
+            i = end;
+            continue;
+        }
+        if (end + 1 < details.size() && details[end] == QLatin1Char('.') &&
+            details[end + 1].isDigit()) {
+            end = skipDigits(details, end + 1);
+        }
+        if (end < details.size() && (details[end] == QLatin1Char('e') ||
+                                     details[end] == QLatin1Char('E'))) {
+            qsizetype k = end + 1;
+            if (k < details.size() && (details[k] == QLatin1Char('+') ||
+                                       details[k] == QLatin1Char('-'))) {
+                ++k;
+            }
+            if (isDigit(details, k)) {
+                end = skipDigits(details, k);
+            }
+        }
+        while (end < details.size() && isUnitChar(details[end])) {
+            ++end;
+        }
+        double value = 0.0;
+        SpiceNumber::parse(QStringView(details).mid(i, end - i), &value);
+        masked.append(decade(value));
+        i = end;
+    }
+    return DiffDelta::normalizedDetails(masked);
+}
+
+auto DiffClusters::cluster(const DiffList &diffs,
+                           const DiffDetailCache *details)
+    -> QVector<Cluster> {
+    OPENSVS_TRACE_SCOPE("DiffClusters::cluster", "model");
+    QVector<Cluster> clusters;
+    QHash<QString, int> bySignature;
+    const QChar *lastLayout = nullptr;
+    const QChar *lastSchematic = nullptr;
+    QString layout;
+    QString schematic;
+    for (int row = 0; row < diffs.size(); ++row) {
+        const DiffEntry &entry = *diffs.at(row);
+        const QString name = maskedName(entry.name);
+        const QString &layoutCell =
+            maskedCell(entry.layoutCell, lastLayout, layout);
+        const QString &schematicCell =
+            maskedCell(entry.schematicCell, lastSchematic, schematic);
+        const QString text = maskedDetails(
+            details != nullptr ? details->details(entry) : entry.details);
+
+        QString signature;
+        signature.reserve(name.size() + layoutCell.size() +
+                          schematicCell.size() + text.size() + 6);
+        signature.append(QChar(static_cast<int>(entry.type) + 1));
+        signature.append(QChar(static_cast<int>(entry.subtype) + 1));
+        signature.append(name).append(separator);
+        signature.append(layoutCell).append(separator);
+        signature.append(schematicCell).append(separator);
+        signature.append(text);
+
+        const auto it = bySignature.constFind(signature);
+        if (it != bySignature.cend()) {
+            clusters[*it].rows.append(row);
+            continue;
+        }
+        bySignature.insert(signature, static_cast<int>(clusters.size()));
+        Cluster cluster;
+        cluster.type = entry.type;
+        cluster.subtype = entry.subtype;
+        cluster.name = name;
+        cluster.layoutCell = layoutCell;
+        cluster.schematicCell = schematicCell;
+        cluster.details = text;
+        cluster.rows.append(row);
+        clusters.append(std::move(cluster));
+    }
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [](const Cluster &a, const Cluster &b) {
+                         return a.rows.size() > b.rows.size();
+                     });
+    return clusters;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+#include "parsers/NetgenJsonParser.hpp"
+
+class DiffDetailCache;
+
+// Groups diffs that are one issue repeated, such as the same missing
+// instance in every bit slice or the same parameter on every finger of a
+// device. Each diff gets a signature of its type, subtype, cells, name
+// and details in which index digits become '#' ("data[12]" -> "data[#]",
+// "XM3" -> "XM#") and numbers become their decade ("1.5u" -> "~1e-6");
+// diffs with equal signatures form a cluster, found with one hash lookup
+// per diff.
+class DiffClusters {
+  public:
+    using DiffEntry = NetgenJsonParser::DiffEntry;
+    using DiffList = QVector<const DiffEntry *>;
+
+    struct Cluster {
+        NetgenJsonParser::DiffType type = NetgenJsonParser::DiffType::Unknown;
+        DiffEntry::Subtype subtype = DiffEntry::Subtype::Unknown;
+        // The signature's masked fields, shared by all members.
+        QString name;
+        QString layoutCell;
+        QString schematicCell;
+        QString details;
+        QVector<int> rows; // positions in the clustered list, ascending
+    };
+
+    // Largest cluster first, ties in order of their first member. details
+    // resolves rows of an on-demand report; nullptr uses the entries'.
+    static auto cluster(const DiffList &diffs,
+                        const DiffDetailCache *details = nullptr)
+        -> QVector<Cluster>;
+
+    // Digit runs replaced by '#'.
+    static auto maskedName(const QString &name) -> QString;
+    // Digits inside words masked like names, free-standing numbers (read
+    // by SpiceNumber, scale and unit letters included) replaced by "~1eN"
+    // for their decade, and pin lists sorted as in
+    // DiffDelta::normalizedDetails.
+    static auto maskedDetails(const QString &details) -> QString;
+};
@@ -0,0 +1,175 @@
+#include "models/DiffDelta.hpp"
+
+#include <QHash>
+#include <QStringList>
+
+#include "diagnostics/Tracer.hpp"
+#include "parsers/DiffDetailCache.hpp"
+
+namespace {
+using DiffEntry = NetgenJsonParser::DiffEntry;
+
+struct Key {
+    NetgenJsonParser::DiffType type = NetgenJsonParser::DiffType::Unknown;
+    DiffEntry::Subtype subtype = DiffEntry::Subtype::Unknown;
+    QString layoutCell;
+    QString schematicCell;
+    QString name;
+    QString details;
+
+    auto operator==(const Key &other) const -> bool {
+        return type == other.type && subtype == other.subtype &&
+               name == other.name && layoutCell == other.layoutCell &&
+               schematicCell == other.schematicCell &&
+               details == other.details;
+    }
+};
+
+auto qHash(const Key &key, size_t seed = 0) -> size_t {
+    return qHashMulti(seed, static_cast<int>(key.type),
+                      static_cast<int>(key.subtype), key.layoutCell,
+                      key.schematicCell, key.name, key.details);
+}
+
+auto detailsOf(const DiffEntry &entry, const DiffDetailCache *cache)
+    -> QString {
+    return cache != nullptr ? cache->details(entry) : entry.details;
+}
+
+auto keyOf(const DiffEntry &entry, const DiffDetailCache *cache) -> Key {
+    return Key{entry.type,
+               entry.subtype,
+               entry.layoutCell,
+               entry.schematicCell,
+               entry.name,
+               DiffDelta::normalizedDetails(detailsOf(entry, cache))};
+}
+
+auto sortedList(const QString &list) -> QString {
+    QStringList items = list.split(QStringLiteral(", "));
+    items.sort();
+    return items.join(QStringLiteral(", "));
+}
+
+// One " | " part: the list in "(connected to a, b)" or after the last ": ".
+auto normalizedPart(const QString &part) -> QString {
+    if (!part.contains(QStringLiteral(", "))) {
+        return part;
+    }
+    const QString connected = QStringLiteral("(connected to ");
+    const qsizetype open = part.indexOf(connected);
+    if (open >= 0 && part.endsWith(QLatin1Char(')'))) {
+        const qsizetype from = open + connected.size();
+        return part.left(from) +
+               sortedList(part.mid(from, part.size() - from - 1)) +
+               QLatin1Char(')');
+    }
+    const qsizetype colon = part.lastIndexOf(QStringLiteral(": "));
+    if (colon >= 0) {
+        return part.left(colon + 2) + sortedList(part.mid(colon + 2));
+    }
+    return part;
+}
+} // namespace
+
+auto DiffDelta::normalizedDetails(const QString &details) -> QString {
+    const QString simple = details.simplified();
+    if (!simple.contains(QStringLiteral(", "))) {
+        return simple;
+    }
+    QStringList parts = simple.split(QStringLiteral(" | "));
+    for (QString &part : parts) {
+        part = normalizedPart(part);
+    }
+    return parts.join(QStringLiteral(" | "));
+}
+
+auto DiffDelta::toStatusString(Status status) -> QString {
+    switch (status) {
+    case Status::New:
+        return QStringLiteral("new");
+    case Status::Fixed:
+        return QStringLiteral("fixed");
+    case Status::Unchanged:
+        break;
+    }
+    return QStringLiteral("unchanged");
+}
+
+auto DiffDelta::compare(const QVector<Circuit> &baseline,
+                        const QVector<Circuit> &current,
+                        const DiffDetailCache *baselineDetails,
+                        const DiffDetailCache *currentDetails) -> Result {
+    OPENSVS_TRACE_SCOPE("DiffDelta::compare", "model");
+    qsizetype baselineCount = 0;
+    for (const Circuit &cir : baseline) {
+        baselineCount += cir.diffs.size();
+    }
+
+    // Build: how many times each key occurs in the baseline. The keys are
+    // kept so that on-demand details are read once.
+    QVector<Key> baselineKeys;
+    baselineKeys.reserve(baselineCount);
+    QHash<Key, int> remaining;
+    remaining.reserve(baselineCount);
+    for (const Circuit &cir : baseline) {
+        for (const DiffEntry &entry : cir.diffs) {
+            baselineKeys.append(keyOf(entry, baselineDetails));
+            ++remaining[baselineKeys.constLast()];
+        }
+    }
+
+    // Probe: each current diff consumes one baseline occurrence.
+    Result result;
+    qsizetype currentCount = 0;
+    for (const Circuit &cir : current) {
+        currentCount += cir.diffs.size();
+    }
+    result.current.reserve(currentCount);
+    for (const Circuit &cir : current) {
+        for (const DiffEntry &entry : cir.diffs) {
+            const auto it = remaining.find(keyOf(entry, currentDetails));
+            if (it != remaining.end() && *it > 0) {
+                --*it;
+                result.current.append(Status::Unchanged);
+                ++result.unchangedCount;
+            } else {
+                result.current.append(Status::New);
+                ++result.newCount;
+            }
+        }
+    }
+
+    QHash<QString, long long> currentCells;
+    long long top = -1;
+    for (const Circuit &cir : current) {
+        const QString cell =
+            cir.layoutCell + QLatin1Char('\n') + cir.schematicCell;
+        if (!currentCells.contains(cell)) {
+            currentCells.insert(cell, cir.index);
+        }
+        if (top < 0 && cir.isTopLevel) {
+            top = cir.index;
+        }
+    }
+
+    // Whatever the current report did not consume was fixed.
+    qsizetype next = 0;
+    for (const Circuit &cir : baseline) {
+        for (const DiffEntry &entry : cir.diffs) {
+            const Key &key = baselineKeys.at(next++);
+            const auto it = remaining.find(key);
+            if (*it == 0) {
+                continue;
+            }
+            --*it;
+            DiffEntry fixed = entry;
+            fixed.details = detailsOf(entry, baselineDetails);
+            fixed.sourceIndex = -1;
+            fixed.circuitIndex = currentCells.value(
+                cir.layoutCell + QLatin1Char('\n') + cir.schematicCell, top);
+            result.fixed.append(fixed);
+        }
+    }
+    return result;
+}
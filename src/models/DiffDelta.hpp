@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+#include "parsers/NetgenJsonParser.hpp"
+
+class DiffDetailCache;
+
+// Regression diff between two reports of the same design: which diffs of
+// the current report are new, which persist from the baseline and which
+// baseline diffs are fixed. Diffs are matched on an identity key (type,
+// subtype, layout and schematic cell, object name and normalized details)
+// with a hash join, so the cost is linear in the number of diffs. Repeated
+// keys are matched one to one.
+class DiffDelta {
+  public:
+    using Circuit = NetgenJsonParser::Report::Circuit;
+    using DiffEntry = NetgenJsonParser::DiffEntry;
+
+    enum class Status : char { Unchanged, New, Fixed };
+
+    struct Result {
+        // One per diff of the current report, in circuit and diff order.
+        QVector<Status> current;
+        // Baseline diffs without a counterpart, in baseline order, with
+        // resolved details and circuitIndex moved to the current circuit
+        // of the same cells (else the current top circuit, else -1) so
+        // that circuit filters place them.
+        QVector<DiffEntry> fixed;
+        qint64 newCount = 0;
+        qint64 unchangedCount = 0;
+    };
+
+    // The details of on-demand reports are read through their caches.
+    static auto compare(const QVector<Circuit> &baseline,
+                        const QVector<Circuit> &current,
+                        const DiffDetailCache *baselineDetails = nullptr,
+                        const DiffDetailCache *currentDetails = nullptr)
+        -> Result;
+
+    // Whitespace collapsed and comma-separated pin or net lists sorted, so
+    // that a list netgen printed in another order still matches.
+    static auto normalizedDetails(const QString &details) -> QString;
+
+    static auto toStatusString(Status status) -> QString; // "new", ...
+};
@@ -0,0 +1,25 @@
+#include "models/DiffEntryDelegate.hpp"
+
+#include <QColor>
+#include <QPalette>
+
+#include "models/DiffDelta.hpp"
+#include "models/DiffEntryModel.hpp"
+
+DiffEntryDelegate::DiffEntryDelegate(QObject *parent)
+    : QStyledItemDelegate(parent) {}
+
+void DiffEntryDelegate::initStyleOption(QStyleOptionViewItem *option,
+                                        const QModelIndex &index) const {
+    QStyledItemDelegate::initStyleOption(option, index);
+    if (index.data(DiffEntryModel::WaiverRole).isValid()) {
+        option->palette.setColor(QPalette::Text, QColor(Qt::gray));
+    }
+    const QString delta = index.data(DiffEntryModel::DeltaRole).toString();
+    if (delta == DiffDelta::toStatusString(DiffDelta::Status::New)) {
+        option->backgroundBrush = QColor(255, 228, 225);
+    } else if (delta ==
+               DiffDelta::toStatusString(DiffDelta::Status::Fixed)) {
+        option->backgroundBrush = QColor(224, 245, 224);
+    }
+}
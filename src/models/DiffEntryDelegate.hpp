@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QStyledItemDelegate>
+
+// Colours diff rows from the state DiffEntryModel exposes: waived rows in
+// gray, rows new against the baseline in red and fixed ones in green. The
+// models stay on QtCore; the colours live here with the widgets.
+class DiffEntryDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+  public:
+    explicit DiffEntryDelegate(QObject *parent = nullptr);
+
+  protected:
+    void initStyleOption(QStyleOptionViewItem *option,
+                         const QModelIndex &index) const override;
+};
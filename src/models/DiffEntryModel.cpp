@@ -1,6 +1,19 @@
 #include "models/DiffEntryModel.hpp"
 #include "models/DiffEntryCommon.hpp"
 
+#include <algorithm>
+#include <utility>
+
+#include "diagnostics/Tracer.hpp"
+#include "lvs/DetachedThread.hpp"
+#include "models/DiffMasters.hpp"
+#include "parsers/DiffDetailCache.hpp"
+
+namespace {
+// Rows whose details the model keeps once read, about a few screens.
+const qsizetype maxLoadedDetails = 4096;
+} // namespace
+
 DiffEntryModel::DiffEntryModel(QObject *parent) : QAbstractTableModel(parent) {}
 
 auto DiffEntryModel::rowCount(const QModelIndex &parent) const -> int {
@@ -30,6 +43,43 @@ auto DiffEntryModel::data(const QModelIndex &index,
     if (role == Qt::UserRole) {
         return entry.circuitIndex;
     }
+    if (role == ResidentDetailsRole) {
+        return index.column() == DiffEntryColumns::DETAILS ? entry.details
+                                                           : QVariant();
+    }
+    if (role == InstancesRole) {
+        return instances(index.row());
+    }
+    if (role == WaiverRole) {
+        const QString waiver = waiverText(index.row());
+        return waiver.isNull() ? QVariant() : waiver;
+    }
+    if (role == Qt::ToolTipRole) {
+        QStringList lines;
+        if (index.row() < statuses_.size()) {
+            lines << QStringLiteral("Compared with baseline: %1")
+                         .arg(DiffDelta::toStatusString(
+                             statuses_.at(index.row())));
+        }
+        const QString waiver = waiverText(index.row());
+        if (!waiver.isNull()) {
+            lines << QStringLiteral("Waived: %1").arg(waiver);
+        }
+        const qint64 count = instances(index.row());
+        if (count > 1) {
+            lines << QStringLiteral("%1 instances of %2")
+                         .arg(count)
+                         .arg(entry.layoutCell.isEmpty() ? entry.schematicCell
+                                                         : entry.layoutCell);
+        }
+        return lines.isEmpty() ? QVariant() : lines.join(QLatin1Char('\n'));
+    }
+    if (role == DeltaRole) {
+        if (index.row() >= statuses_.size()) {
+            return {};
+        }
+        return DiffDelta::toStatusString(statuses_.at(index.row()));
+    }
     if (role != Qt::DisplayRole) {
         return {};
     }
@@ -45,7 +95,7 @@ auto DiffEntryModel::data(const QModelIndex &index,
     case DiffEntryColumns::SCHEMATIC_CELL:
         return entry.schematicCell;
     case DiffEntryColumns::DETAILS:
-        return entry.details;
+        return details(index.row());
     default:
         return {};
     }
@@ -53,9 +103,14 @@ auto DiffEntryModel::data(const QModelIndex &index,
 
 auto DiffEntryModel::headerData(int section, Qt::Orientation orientation,
                                 int role) const -> QVariant {
-    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+    if (role != Qt::DisplayRole) {
         return {};
     }
+    if (orientation == Qt::Vertical) {
+        // Only multiplied rows are marked, so the header stays narrow.
+        const qint64 count = instances(section);
+        return count > 1 ? QStringLiteral("\u00d7%1").arg(count) : QVariant();
+    }
 
     switch (section) {
     case DiffEntryColumns::TYPE:
@@ -75,9 +130,166 @@ auto DiffEntryModel::headerData(int section, Qt::Orientation orientation,
     }
 }
 
+auto DiffEntryModel::memoryBytes() const -> qint64 {
+    return static_cast<qint64>(
+        diffs_.capacity() * sizeof(NetgenJsonParser::DiffEntry) +
+        statuses_.capacity() * sizeof(DiffDelta::Status) +
+        waived_.capacity() * sizeof(int));
+}
+
+void DiffEntryModel::setDetailSource(
+    std::shared_ptr<const DiffDetailCache> source) {
+    beginResetModel();
+    detailSource_ = std::move(source);
+    forgetDetails();
+    endResetModel();
+}
+
+auto DiffEntryModel::details(int row) const -> QString {
+    const auto &entry = diffs_.at(row);
+    if (detailSource_ == nullptr) {
+        return entry.details;
+    }
+    const auto loaded = loadedDetails_.constFind(row);
+    if (loaded != loadedDetails_.cend()) {
+        return *loaded;
+    }
+    QString text;
+    if (detailSource_->cached(entry, &text)) {
+        return text;
+    }
+    requestDetails(row);
+    return loadingDetails.toString();
+}
+
+void DiffEntryModel::requestDetails(int row) const {
+    pendingDetails_.insert(row);
+    if (readingDetails_) {
+        return;
+    }
+    // Queued, so that one paint asks for all its rows in one read.
+    readingDetails_ = true;
+    QMetaObject::invokeMethod(const_cast<DiffEntryModel *>(this),
+                              &DiffEntryModel::readDetails,
+                              Qt::QueuedConnection);
+}
+
+void DiffEntryModel::readDetails() {
+    const QSet<int> pending = std::exchange(pendingDetails_, {});
+    auto rows = std::make_shared<QVector<int>>();
+    auto entries = std::make_shared<QVector<NetgenJsonParser::DiffEntry>>();
+    for (const int row : pending) {
+        if (row < diffs_.size()) {
+            rows->append(row);
+            entries->append(diffs_.at(row));
+        }
+    }
+    if (rows->isEmpty()) { // reset since the rows were asked for
+        readingDetails_ = false;
+        return;
+    }
+    auto texts = std::make_shared<QStringList>();
+    auto read = [source = detailSource_, entries, texts]() {
+        OPENSVS_TRACE_SCOPE("DiffEntryModel::readDetails", "model");
+        for (const auto &entry : std::as_const(*entries)) {
+            texts->append(source != nullptr ? source->details(entry)
+                                            : entry.details);
+        }
+    };
+    auto done = [this, generation = generation_, rows, texts]() {
+        readingDetails_ = false;
+        if (generation == generation_) {
+            if (loadedDetails_.size() > maxLoadedDetails) {
+                loadedDetails_.clear();
+            }
+            for (qsizetype i = 0; i < rows->size(); ++i) {
+                loadedDetails_.insert(rows->at(i), texts->at(i));
+            }
+            const auto [first, last] =
+                std::minmax_element(rows->cbegin(), rows->cend());
+            emit dataChanged(index(*first, DiffEntryColumns::DETAILS),
+                             index(*last, DiffEntryColumns::DETAILS),
+                             {Qt::DisplayRole});
+        }
+        if (!pendingDetails_.isEmpty()) {
+            readingDetails_ = true;
+            readDetails();
+        }
+    };
+    DetachedThread::start(read, this, done);
+}
+
+void DiffEntryModel::forgetDetails() {
+    ++generation_;
+    pendingDetails_.clear();
+    loadedDetails_.clear();
+}
+
+void DiffEntryModel::setMasters(const DiffMasters *masters) {
+    beginResetModel();
+    masters_ = masters;
+    endResetModel();
+}
+
 void DiffEntryModel::setDiffs(
-    const QVector<NetgenJsonParser::DiffEntry> &diffs) {
+    const QVector<NetgenJsonParser::DiffEntry> &diffs,
+    const QVector<DiffDelta::Status> &statuses) {
+    OPENSVS_TRACE_SCOPE("DiffEntryModel::setDiffs", "model");
     beginResetModel();
     diffs_ = diffs;
+    statuses_ = statuses;
+    forgetDetails();
+    waived_ = waivers_ ? waivers_->apply(diffs_) : QVector<int>();
+    endResetModel();
+}
+
+void DiffEntryModel::appendDiffs(
+    const QVector<NetgenJsonParser::DiffEntry> &diffs) {
+    if (diffs.isEmpty()) {
+        return;
+    }
+    const auto first = static_cast<int>(diffs_.size());
+    beginInsertRows(QModelIndex(), first,
+                    first + static_cast<int>(diffs.size()) - 1);
+    diffs_ += diffs;
+    if (waivers_) {
+        waived_ += waivers_->apply(diffs);
+    }
+    endInsertRows();
+}
+
+void DiffEntryModel::setWaivers(std::shared_ptr<const WaiverSet> waivers) {
+    OPENSVS_TRACE_SCOPE("DiffEntryModel::setWaivers", "model");
+    beginResetModel();
+    waivers_ = std::move(waivers);
+    waived_ = waivers_ ? waivers_->apply(diffs_) : QVector<int>();
     endResetModel();
 }
+
+auto DiffEntryModel::diffs() const
+    -> const QVector<NetgenJsonParser::DiffEntry> & {
+    return diffs_;
+}
+
+auto DiffEntryModel::waivedCount() const -> qsizetype {
+    return std::count_if(waived_.cbegin(), waived_.cend(),
+                         [](int rule) { return rule >= 0; });
+}
+
+auto DiffEntryModel::waiverText(int row) const -> QString {
+    const int rule = row < waived_.size() ? waived_.at(row) : -1;
+    if (rule < 0) {
+        return {};
+    }
+    const WaiverSet::Rule &waiver = waivers_->rules().at(rule);
+    return !waiver.reason.isEmpty()
+               ? waiver.reason
+               : QStringLiteral("rule on line %1").arg(waiver.line);
+}
+
+auto DiffEntryModel::instances(int row) const -> qint64 {
+    if (masters_ == nullptr || row < 0 || row >= diffs_.size()) {
+        return 1;
+    }
+    return masters_->instances(diffs_.at(row).circuitIndex);
+}
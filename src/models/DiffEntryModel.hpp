@@ -1,15 +1,34 @@
 #pragma once
 
 #include <QAbstractTableModel>
+#include <QHash>
+#include <QSet>
 #include <QVector>
+#include <memory>
 
+#include "models/DiffDelta.hpp"
+#include "models/WaiverSet.hpp"
 #include "parsers/NetgenJsonParser.hpp"
 
+class DiffDetailCache;
+class DiffMasters;
+
 class DiffEntryModel : public QAbstractTableModel {
     Q_OBJECT
   public:
     explicit DiffEntryModel(QObject *parent = nullptr);
 
+    // Details column without reading on-demand details from the file; the
+    // filter proxy searches this so a search never scans the whole report.
+    static constexpr int ResidentDetailsRole = Qt::UserRole + 1;
+    // DiffDelta status string of the row; invalid without a baseline.
+    static constexpr int DeltaRole = Qt::UserRole + 2;
+    // Reason of the waiver covering the row; invalid when not waived.
+    static constexpr int WaiverRole = Qt::UserRole + 3;
+    // Instances of the row's cell master under the top cells; 1 without
+    // masters.
+    static constexpr int InstancesRole = Qt::UserRole + 4;
+
     auto
     rowCount(const QModelIndex &parent = QModelIndex()) const -> int override;
     auto columnCount(const QModelIndex &parent = QModelIndex()) const
@@ -19,8 +38,50 @@ class DiffEntryModel : public QAbstractTableModel {
     auto headerData(int section, Qt::Orientation orientation,
                     int role = Qt::DisplayRole) const -> QVariant override;
 
-    void setDiffs(const QVector<NetgenJsonParser::DiffEntry> &diffs);
+    // statuses holds one DiffDelta status per row when the report is
+    // compared with a baseline, and is empty otherwise.
+    void setDiffs(const QVector<NetgenJsonParser::DiffEntry> &diffs,
+                  const QVector<DiffDelta::Status> &statuses = {});
+    // Adds rows after the last one without resetting the model; the new
+    // rows have no delta status.
+    void appendDiffs(const QVector<NetgenJsonParser::DiffEntry> &diffs);
+    // Marks rows covered by waivers, now and after each setDiffs; nullptr
+    // clears the marks.
+    void setWaivers(std::shared_ptr<const WaiverSet> waivers);
+    auto diffs() const -> const QVector<NetgenJsonParser::DiffEntry> &;
+    auto waivedCount() const -> qsizetype;
+    // Resolves details dropped by an on-demand load; nullptr shows entries
+    // as they are. Details not yet cached are read on a worker thread: the
+    // cell shows a placeholder until dataChanged brings them in.
+    void setDetailSource(std::shared_ptr<const DiffDetailCache> source);
+    // Instance counts per cell master, shown as "xN" in the vertical
+    // header; not owned, nullptr counts every row once.
+    void setMasters(const DiffMasters *masters);
+    // Heap bytes of the row array; the strings are shared with the report.
+    auto memoryBytes() const -> qint64;
+
+    // Shown for details still being read.
+    static constexpr QStringView loadingDetails = u"\u2026";
 
   private:
+    auto waiverText(int row) const -> QString;
+    auto instances(int row) const -> qint64;
+    auto details(int row) const -> QString;
+    void requestDetails(int row) const;
+    void readDetails();
+    void forgetDetails();
+
     QVector<NetgenJsonParser::DiffEntry> diffs_;
+    QVector<DiffDelta::Status> statuses_;
+    std::shared_ptr<const WaiverSet> waivers_;
+    QVector<int> waived_; // rule per row, -1 if none
+    std::shared_ptr<const DiffDetailCache> detailSource_;
+    // Rows whose details wait for a read, details read for rows, and
+    // whether a read is running; generation_ tells a read that finishes
+    // after a reset to drop its rows.
+    mutable QSet<int> pendingDetails_;
+    QHash<int, QString> loadedDetails_;
+    mutable bool readingDetails_{false};
+    quint64 generation_{0};
+    const DiffMasters *masters_{nullptr};
 };
@@ -0,0 +1,132 @@
+#include "models/DiffFilter.hpp"
+
+void DiffFilter::setTypeFilter(const QString &type) {
+    typeFilter_ = type.trimmed();
+    if (typeFilter_.compare(QStringLiteral("All"), Qt::CaseInsensitive) == 0) {
+        typeFilter_.clear();
+    }
+}
+
+void DiffFilter::setSearchTerm(const QString &term) {
+    searchTerm_ = term.trimmed();
+    if (searchTerm_.isEmpty()) {
+        searchRegexValid_ = false;
+    } else {
+        QRegularExpression::PatternOptions opts =
+            QRegularExpression::CaseInsensitiveOption |
+            QRegularExpression::UseUnicodePropertiesOption;
+        searchRegex_ = QRegularExpression(searchTerm_, opts);
+        searchRegexValid_ = searchRegex_.isValid();
+    }
+}
+
+void DiffFilter::setAllowedCircuits(const QSet<int> &circuits) {
+    circuitFilter_ = circuits;
+}
+
+void DiffFilter::setDeltaFilter(const QString &status) {
+    deltaFilter_ = status.trimmed();
+    if (deltaFilter_.compare(QStringLiteral("All"), Qt::CaseInsensitive) == 0) {
+        deltaFilter_.clear();
+    }
+}
+
+void DiffFilter::setHideWaived(bool hide) { hideWaived_ = hide; }
+
+void DiffFilter::setDuplicateCircuits(const QSet<int> &circuits) {
+    duplicateCircuits_ = circuits;
+}
+
+auto DiffFilter::circuitsUnder(
+    const QVector<NetgenJsonParser::Report::Circuit> &circuits,
+    const QString &cell) -> QSet<int> {
+    QSet<int> allowed;
+    QVector<const NetgenJsonParser::Report::Circuit *> stack;
+    for (const auto &cir : circuits) {
+        if (cir.layoutCell == cell || cir.schematicCell == cell) {
+            stack.push_back(&cir);
+        }
+    }
+    while (!stack.isEmpty()) {
+        const auto *cir = stack.takeLast();
+        if (allowed.contains(static_cast<int>(cir->index))) {
+            continue;
+        }
+        allowed.insert(static_cast<int>(cir->index));
+        for (const auto *child : cir->subcircuits) {
+            stack.push_back(child);
+        }
+    }
+    return allowed;
+}
+
+auto DiffFilter::typeFilter() const -> QString { return typeFilter_; }
+
+auto DiffFilter::searchTerm() const -> QString { return searchTerm_; }
+
+auto DiffFilter::allowedCircuits() const -> const QSet<int> & {
+    return circuitFilter_;
+}
+
+auto DiffFilter::deltaFilter() const -> QString { return deltaFilter_; }
+
+auto DiffFilter::hidesWaived() const -> bool { return hideWaived_; }
+
+auto DiffFilter::duplicateCircuits() const -> const QSet<int> & {
+    return duplicateCircuits_;
+}
+
+auto DiffFilter::isEmpty() const -> bool {
+    return typeFilter_.isEmpty() && searchTerm_.isEmpty() &&
+           circuitFilter_.isEmpty() && deltaFilter_.isEmpty() &&
+           !hideWaived_ && duplicateCircuits_.isEmpty();
+}
+
+auto DiffFilter::accepts(const NetgenJsonParser::DiffEntry &entry) const
+    -> bool {
+    return accepts(NetgenJsonParser::toTypeString(entry.type), entry.name,
+                   entry.details, static_cast<int>(entry.circuitIndex));
+}
+
+auto DiffFilter::accepts(const QString &type, const QString &object,
+                         const QString &details, int circuitId,
+                         const QString &delta, bool waived) const -> bool {
+    if (hideWaived_ && waived) {
+        return false;
+    }
+
+    if (!typeFilter_.isEmpty() &&
+        type.compare(typeFilter_, Qt::CaseInsensitive) != 0) {
+        return false;
+    }
+
+    if (!deltaFilter_.isEmpty() &&
+        delta.compare(deltaFilter_, Qt::CaseInsensitive) != 0) {
+        return false;
+    }
+
+    if (!circuitFilter_.isEmpty() && !circuitFilter_.contains(circuitId)) {
+        return false;
+    }
+
+    if (duplicateCircuits_.contains(circuitId)) {
+        return false;
+    }
+
+    if (!searchTerm_.isEmpty()) {
+        if (searchRegexValid_) {
+            if (!searchRegex_.match(object).hasMatch() &&
+                !searchRegex_.match(details).hasMatch()) {
+                return false;
+            }
+        } else {
+            const QString needle = searchTerm_.toLower();
+            if (!object.toLower().contains(needle) &&
+                !details.toLower().contains(needle)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
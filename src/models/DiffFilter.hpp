@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QRegularExpression>
+#include <QSet>
+#include <QString>
+
+#include "parsers/NetgenJsonParser.hpp"
+
+// Type/search/circuit/delta/waiver/master predicate shared by
+// DiffFilterProxyModel and the headless CLI.
+class DiffFilter {
+  public:
+    void setTypeFilter(const QString &type); // empty or "All": no type filter
+    void setSearchTerm(const QString &term); // regex, else substring
+    void setAllowedCircuits(const QSet<int> &circuits); // empty: all
+    // "new", "fixed" or "unchanged" (DiffDelta); empty or "All": no filter.
+    void setDeltaFilter(const QString &status);
+    // Drop rows a WaiverSet covers; off by default.
+    void setHideWaived(bool hide);
+    // Drop rows of circuit entries that repeat a cell master
+    // (DiffMasters::duplicateCircuits); empty keeps every entry.
+    void setDuplicateCircuits(const QSet<int> &circuits);
+    // Indices of the circuits named cell (layout or schematic) and
+    // everything below them, for setAllowedCircuits; empty if no circuit
+    // has that name.
+    static auto circuitsUnder(
+        const QVector<NetgenJsonParser::Report::Circuit> &circuits,
+        const QString &cell) -> QSet<int>;
+
+    auto typeFilter() const -> QString;
+    auto searchTerm() const -> QString;
+    auto allowedCircuits() const -> const QSet<int> &;
+    auto deltaFilter() const -> QString;
+    auto hidesWaived() const -> bool;
+    auto duplicateCircuits() const -> const QSet<int> &;
+    auto isEmpty() const -> bool;
+
+    auto accepts(const NetgenJsonParser::DiffEntry &entry) const -> bool;
+    // delta is the row's DiffDelta status; rows without one (no baseline)
+    // only pass when no delta filter is set.
+    auto accepts(const QString &type, const QString &object,
+                 const QString &details, int circuitId,
+                 const QString &delta = {}, bool waived = false) const
+        -> bool;
+
+  private:
+    QString typeFilter_;
+    QString searchTerm_;
+    QRegularExpression searchRegex_;
+    bool searchRegexValid_{false};
+    QSet<int> circuitFilter_;
+    QString deltaFilter_;
+    bool hideWaived_{false};
+    QSet<int> duplicateCircuits_;
+};
@@ -1,38 +1,65 @@
 #include "models/DiffFilterProxyModel.hpp"
 #include "models/DiffEntryCommon.hpp"
+#include "models/DiffEntryModel.hpp"
 
 #include <QModelIndex>
 #include <QString>
 
+#include "diagnostics/Tracer.hpp"
+
 DiffFilterProxyModel::DiffFilterProxyModel(QObject *parent)
     : QSortFilterProxyModel(parent) {
     setFilterCaseSensitivity(Qt::CaseInsensitive);
 }
 
 void DiffFilterProxyModel::setTypeFilter(const QString &type) {
-    typeFilter_ = type.trimmed();
+    OPENSVS_TRACE_SCOPE("DiffFilterProxyModel::setTypeFilter", "filter");
+    filter_.setTypeFilter(type);
     invalidateFilter();
 }
 
 void DiffFilterProxyModel::setSearchTerm(const QString &term) {
-    searchTerm_ = term.trimmed();
-    if (searchTerm_.isEmpty()) {
-        searchRegexValid_ = false;
-    } else {
-        QRegularExpression::PatternOptions opts =
-            QRegularExpression::CaseInsensitiveOption |
-            QRegularExpression::UseUnicodePropertiesOption;
-        searchRegex_ = QRegularExpression(searchTerm_, opts);
-        searchRegexValid_ = searchRegex_.isValid();
-    }
+    OPENSVS_TRACE_SCOPE("DiffFilterProxyModel::setSearchTerm", "filter");
+    filter_.setSearchTerm(term);
     invalidateFilter();
 }
 
 void DiffFilterProxyModel::setAllowedCircuits(const QSet<int> &circuits) {
-    circuitFilter_ = circuits;
+    OPENSVS_TRACE_SCOPE("DiffFilterProxyModel::setAllowedCircuits", "filter");
+    filter_.setAllowedCircuits(circuits);
+    invalidateFilter();
+}
+
+void DiffFilterProxyModel::setDeltaFilter(const QString &status) {
+    OPENSVS_TRACE_SCOPE("DiffFilterProxyModel::setDeltaFilter", "filter");
+    filter_.setDeltaFilter(status);
+    invalidateFilter();
+}
+
+void DiffFilterProxyModel::setHideWaived(bool hide) {
+    OPENSVS_TRACE_SCOPE("DiffFilterProxyModel::setHideWaived", "filter");
+    filter_.setHideWaived(hide);
+    invalidateFilter();
+}
+
+void DiffFilterProxyModel::setDuplicateCircuits(const QSet<int> &circuits) {
+    OPENSVS_TRACE_SCOPE("DiffFilterProxyModel::setDuplicateCircuits",
+                        "filter");
+    filter_.setDuplicateCircuits(circuits);
     invalidateFilter();
 }
 
+auto DiffFilterProxyModel::mappingBytes() const -> qint64 {
+    if (sourceModel() == nullptr) {
+        return 0;
+    }
+    // One mapping for the flat table: proxy->source rows, source->proxy
+    // rows and the same pair for columns, all int vectors.
+    const qint64 rows = rowCount() + sourceModel()->rowCount();
+    const qint64 columns = columnCount() + sourceModel()->columnCount();
+    return (rows + columns) * static_cast<qint64>(sizeof(int));
+}
+
 auto DiffFilterProxyModel::filterAcceptsRow(
     int source_row, const QModelIndex &source_parent) const -> bool {
     if (sourceModel() == nullptr) {
@@ -63,38 +90,24 @@ auto DiffFilterProxyModel::filterAcceptsRow(
         sourceModel()->data(typeIdx, Qt::DisplayRole).toString();
     const QString object =
         sourceModel()->data(objIdx, Qt::DisplayRole).toString();
-    const QString details =
-        sourceModel()->data(detailsIdx, Qt::DisplayRole).toString();
+    // Details read on demand are not searched: that would re-read the
+    // whole report on every keystroke.
+    QVariant details =
+        sourceModel()->data(detailsIdx, DiffEntryModel::ResidentDetailsRole);
+    if (!details.isValid()) {
+        details = sourceModel()->data(detailsIdx, Qt::DisplayRole);
+    }
     const int circuitId =
         circuitIdx.isValid()
             ? sourceModel()->data(circuitIdx, Qt::UserRole).toInt()
             : -1;
+    const QString delta =
+        sourceModel()->data(typeIdx, DiffEntryModel::DeltaRole).toString();
 
-    if (!typeFilter_.isEmpty() &&
-        typeFilter_.compare(QStringLiteral("All"), Qt::CaseInsensitive) != 0) {
-        if (type.compare(typeFilter_, Qt::CaseInsensitive) != 0) {
-            return false;
-        }
-    }
-
-    if (!circuitFilter_.isEmpty() && !circuitFilter_.contains(circuitId)) {
-        return false;
-    }
-
-    if (!searchTerm_.isEmpty()) {
-        if (searchRegexValid_) {
-            if (!searchRegex_.match(object).hasMatch() &&
-                !searchRegex_.match(details).hasMatch()) {
-                return false;
-            }
-        } else {
-            const QString needle = searchTerm_.toLower();
-            if (!object.toLower().contains(needle) &&
-                !details.toLower().contains(needle)) {
-                return false;
-            }
-        }
-    }
+    const bool waived =
+        filter_.hidesWaived() &&
+        sourceModel()->data(typeIdx, DiffEntryModel::WaiverRole).isValid();
 
-    return true;
+    return filter_.accepts(type, object, details.toString(), circuitId,
+                           delta, waived);
 }
@@ -1,9 +1,10 @@
 #pragma once
 
-#include <QRegularExpression>
 #include <QSet>
 #include <QSortFilterProxyModel>
 
+#include "models/DiffFilter.hpp"
+
 class DiffFilterProxyModel : public QSortFilterProxyModel {
     Q_OBJECT
   public:
@@ -15,6 +16,13 @@ class DiffFilterProxyModel : public QSortFilterProxyModel {
         const QString &term); // case-insensitive substring on object/details
     void setAllowedCircuits(
         const QSet<int> &circuits); // empty set means no circuit filter
+    void setDeltaFilter(
+        const QString &status); // "new", "fixed", "unchanged"; "All": none
+    void setHideWaived(bool hide); // rows with a WaiverRole
+    void setDuplicateCircuits(
+        const QSet<int> &circuits); // entries repeating a cell master
+    // Estimated bytes of the source<->proxy row mapping.
+    auto mappingBytes() const -> qint64;
 
   protected:
     auto
@@ -22,9 +30,5 @@ class DiffFilterProxyModel : public QSortFilterProxyModel {
                      const QModelIndex &source_parent) const -> bool override;
 
   private:
-    QString typeFilter_;
-    QString searchTerm_;
-    QRegularExpression searchRegex_;
-    bool searchRegexValid_{false};
-    QSet<int> circuitFilter_;
+    DiffFilter filter_;
 };
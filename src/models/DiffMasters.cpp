@@ -0,0 +1,153 @@
+#include "models/DiffMasters.hpp"
+
+#include <QHash>
+#include <algorithm>
+
+#include "diagnostics/Tracer.hpp"
+
+auto DiffMasters::build(const QVector<Circuit> &circuits) -> DiffMasters {
+    OPENSVS_TRACE_SCOPE("DiffMasters::build", "model");
+    DiffMasters result;
+    long long maxIndex = -1;
+    for (const Circuit &cir : circuits) {
+        maxIndex = std::max(maxIndex, cir.index);
+    }
+    result.masterOfCircuit_.fill(-1, static_cast<qsizetype>(maxIndex + 1));
+
+    QHash<QString, int> byPair;
+    QVector<qsizetype> representative; // position in circuits, per master
+    for (qsizetype i = 0; i < circuits.size(); ++i) {
+        const Circuit &cir = circuits.at(i);
+        const QString pair =
+            cir.layoutCell + QLatin1Char('\n') + cir.schematicCell;
+        auto it = byPair.find(pair);
+        if (it == byPair.end()) {
+            it = byPair.insert(pair, static_cast<int>(result.masters_.size()));
+            result.masters_.append(Master{cir.layoutCell, cir.schematicCell,
+                                          {}, 1});
+            representative.append(i);
+        }
+        result.masters_[*it].circuits.append(static_cast<int>(cir.index));
+        if (cir.index >= 0) {
+            result.masterOfCircuit_[cir.index] = *it;
+        }
+    }
+
+    // Children as linkHierarchy finds them: devicesA names, by layout cell
+    // first, then by schematic cell.
+    QHash<QString, int> byLayout;
+    QHash<QString, int> bySchematic;
+    for (int m = 0; m < result.masters_.size(); ++m) {
+        const Master &master = result.masters_.at(m);
+        if (!master.layoutCell.isEmpty()) {
+            byLayout.insert(master.layoutCell, m);
+        }
+        if (!master.schematicCell.isEmpty()) {
+            bySchematic.insert(master.schematicCell, m);
+        }
+    }
+    struct Edge {
+        int child = 0;
+        qint64 count = 0;
+    };
+    const qsizetype count = result.masters_.size();
+    QVector<QVector<Edge>> children(count);
+    QVector<int> parents(count, 0);
+    for (int m = 0; m < count; ++m) {
+        const Circuit &cir = circuits.at(representative.at(m));
+        for (qsizetype k = 0; k < cir.devicesA.size(); ++k) {
+            const QString &name = cir.devicesA.at(k);
+            int child = byLayout.value(name, -1);
+            if (child < 0) {
+                child = bySchematic.value(name, -1);
+            }
+            if (child < 0 || child == m) {
+                continue;
+            }
+            const qint64 instances =
+                k < cir.deviceCountsA.size() ? cir.deviceCountsA.at(k) : 1;
+            children[m].append(Edge{child, std::max<qint64>(instances, 0)});
+            ++parents[child];
+        }
+    }
+
+    // Parents before children (Kahn's order): a top cell exists once, and
+    // a child once per instance in each instance of each parent.
+    QVector<qint64> instances(count, 0);
+    QVector<int> ready;
+    for (int m = 0; m < count; ++m) {
+        if (parents.at(m) == 0) {
+            instances[m] = 1;
+            ready.append(m);
+        }
+    }
+    for (qsizetype next = 0; next < ready.size(); ++next) {
+        const int m = ready.at(next);
+        for (const Edge &edge : std::as_const(children[m])) {
+            instances[edge.child] += instances.at(m) * edge.count;
+            if (--parents[edge.child] == 0) {
+                ready.append(edge.child);
+            }
+        }
+    }
+
+    for (int m = 0; m < count; ++m) {
+        // Cells on a cycle, or only listed with a count of 0, still exist.
+        Master &master = result.masters_[m];
+        master.instances = std::max<qint64>(instances.at(m), 1);
+        const auto diffs = static_cast<qint64>(
+            circuits.at(representative.at(m)).diffs.size());
+        result.uniqueDiffs_ += diffs;
+        result.occurrences_ += diffs * master.instances;
+    }
+    return result;
+}
+
+auto DiffMasters::masters() const -> const QVector<Master> & {
+    return masters_;
+}
+
+auto DiffMasters::masterOf(long long circuitIndex) const -> int {
+    return circuitIndex >= 0 && circuitIndex < masterOfCircuit_.size()
+               ? masterOfCircuit_.at(circuitIndex)
+               : -1;
+}
+
+auto DiffMasters::instances(long long circuitIndex) const -> qint64 {
+    const int master = masterOf(circuitIndex);
+    return master >= 0 ? masters_.at(master).instances : 1;
+}
+
+auto DiffMasters::duplicateCircuits() const -> QSet<int> {
+    QSet<int> duplicates;
+    for (const Master &master : masters_) {
+        for (qsizetype i = 1; i < master.circuits.size(); ++i) {
+            duplicates.insert(master.circuits.at(i));
+        }
+    }
+    return duplicates;
+}
+
+auto DiffMasters::sameMaster(const QSet<int> &circuits) const -> QSet<int> {
+    QSet<int> all;
+    QSet<int> seen;
+    for (const int circuit : circuits) {
+        const int master = masterOf(circuit);
+        if (master < 0) {
+            all.insert(circuit);
+            continue;
+        }
+        if (seen.contains(master)) {
+            continue;
+        }
+        seen.insert(master);
+        for (const int entry : masters_.at(master).circuits) {
+            all.insert(entry);
+        }
+    }
+    return all;
+}
+
+auto DiffMasters::uniqueDiffCount() const -> qint64 { return uniqueDiffs_; }
+
+auto DiffMasters::occurrenceCount() const -> qint64 { return occurrences_; }
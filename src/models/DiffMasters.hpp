@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include "parsers/NetgenJsonParser.hpp"
+
+// Circuits grouped by cell master, the layout/schematic cell pair. A cell
+// that several circuit entries report carries the same diffs in each; the
+// first entry represents the master and the others are duplicates. Each
+// master also knows how often it is instantiated under the top cells:
+// the sum over its parents of the parent's instances times the count the
+// parent's devicesA gives the cell.
+class DiffMasters {
+  public:
+    using Circuit = NetgenJsonParser::Report::Circuit;
+
+    struct Master {
+        QString layoutCell;
+        QString schematicCell;
+        QVector<int> circuits; // entries of this pair; the first represents
+        qint64 instances = 1;
+    };
+
+    static auto build(const QVector<Circuit> &circuits) -> DiffMasters;
+
+    auto masters() const -> const QVector<Master> &;
+    // Master of a circuit index, or -1 when it is not one of the circuits.
+    auto masterOf(long long circuitIndex) const -> int;
+    // Instances of the circuit's master; 1 for unknown circuits.
+    auto instances(long long circuitIndex) const -> qint64;
+    // Entries that repeat a master an earlier entry reports, for
+    // DiffFilter::setDuplicateCircuits.
+    auto duplicateCircuits() const -> QSet<int>;
+    // All entries of the masters of the given circuits.
+    auto sameMaster(const QSet<int> &circuits) const -> QSet<int>;
+    // Diffs of the representative entries, and the same weighted by their
+    // masters' instances.
+    auto uniqueDiffCount() const -> qint64;
+    auto occurrenceCount() const -> qint64;
+
+  private:
+    QVector<Master> masters_;
+    QVector<int> masterOfCircuit_; // by circuit index, -1 if none
+    qint64 uniqueDiffs_ = 0;
+    qint64 occurrences_ = 0;
+};
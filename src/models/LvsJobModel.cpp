@@ -0,0 +1,132 @@
+#include "models/LvsJobModel.hpp"
+
+#include <QBrush>
+#include <QColor>
+#include <QFileInfo>
+
+LvsJobModel::LvsJobModel(LvsJobQueue *queue, QObject *parent)
+    : QAbstractTableModel(parent), queue_(queue) {
+    connect(queue_, &LvsJobQueue::jobAboutToBeAdded, this, [this](int row) {
+        beginInsertRows(QModelIndex(), row, row);
+    });
+    connect(queue_, &LvsJobQueue::jobAdded, this,
+            [this]() { endInsertRows(); });
+    connect(queue_, &LvsJobQueue::jobChanged, this, [this](int row) {
+        emit dataChanged(index(row, 0), index(row, JOB_NUM_COLUMNS - 1));
+    });
+    connect(queue_, &LvsJobQueue::jobsAboutToBeReset, this,
+            [this]() { beginResetModel(); });
+    connect(queue_, &LvsJobQueue::jobsReset, this,
+            [this]() { endResetModel(); });
+}
+
+auto LvsJobModel::rowCount(const QModelIndex &parent) const -> int {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return static_cast<int>(queue_->jobs().size());
+}
+
+auto LvsJobModel::columnCount(const QModelIndex &parent) const -> int {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return LvsJobColumns::JOB_NUM_COLUMNS;
+}
+
+auto LvsJobModel::data(const QModelIndex &index, int role) const -> QVariant {
+    if (!index.isValid() || index.row() >= queue_->jobs().size()) {
+        return {};
+    }
+    const auto &job = queue_->jobs().at(index.row());
+    if (role == Qt::UserRole) {
+        return job.jsonPath;
+    }
+    const bool cellsColumn = index.column() == LvsJobColumns::JOB_CELLS;
+    if (role == Qt::ToolTipRole && cellsColumn &&
+        !job.mismatchedCells.isEmpty()) {
+        return QStringLiteral("Mismatched cells:\n%1")
+            .arg(job.mismatchedCells.join(QLatin1Char('\n')));
+    }
+    // Flag a failing run as soon as its first cell mismatches.
+    if (role == Qt::ForegroundRole && cellsColumn && job.cellsMismatched > 0) {
+        return QBrush(QColor(Qt::red));
+    }
+    if (role == Qt::ToolTipRole) {
+        return QStringLiteral("%1\n%2\n%3\n-> %4")
+            .arg(job.request.layout, job.request.schematic, job.request.rules,
+                 job.jsonPath);
+    }
+    if (role != Qt::DisplayRole) {
+        return {};
+    }
+    switch (index.column()) {
+    case LvsJobColumns::JOB_ID:
+        return job.id;
+    case LvsJobColumns::JOB_LAYOUT:
+        return QFileInfo(job.request.layout).fileName();
+    case LvsJobColumns::JOB_SCHEMATIC:
+        return QFileInfo(job.request.schematic).fileName();
+    case LvsJobColumns::JOB_STATUS:
+        if (job.status == LvsJobQueue::Status::Running) {
+            return QStringLiteral("running (%1)")
+                .arg(LvsRunner::toPhaseString(job.phase));
+        }
+        if (job.cached) {
+            return QStringLiteral("done (cached)");
+        }
+        return LvsJobQueue::toStatusString(job.status);
+    case LvsJobColumns::JOB_CELLS:
+        if (job.cellsMatched == 0 && job.cellsMismatched == 0) {
+            return {};
+        }
+        return QStringLiteral("%1 ok / %2 failed")
+            .arg(job.cellsMatched)
+            .arg(job.cellsMismatched);
+    case LvsJobColumns::JOB_DURATION:
+        if (job.status == LvsJobQueue::Status::Queued ||
+            job.status == LvsJobQueue::Status::Hashing || job.cached) {
+            return {};
+        }
+        return LvsRunner::formatElapsed(queue_->elapsedMs(index.row()));
+    case LvsJobColumns::JOB_RESULT:
+        return job.result;
+    default:
+        return {};
+    }
+}
+
+auto LvsJobModel::headerData(int section, Qt::Orientation orientation,
+                             int role) const -> QVariant {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return {};
+    }
+    switch (section) {
+    case LvsJobColumns::JOB_ID:
+        return QStringLiteral("#");
+    case LvsJobColumns::JOB_LAYOUT:
+        return QStringLiteral("Layout");
+    case LvsJobColumns::JOB_SCHEMATIC:
+        return QStringLiteral("Schematic");
+    case LvsJobColumns::JOB_STATUS:
+        return QStringLiteral("Status");
+    case LvsJobColumns::JOB_CELLS:
+        return QStringLiteral("Cells");
+    case LvsJobColumns::JOB_DURATION:
+        return QStringLiteral("Duration");
+    case LvsJobColumns::JOB_RESULT:
+        return QStringLiteral("Result");
+    default:
+        return {};
+    }
+}
+
+void LvsJobModel::refreshRunning() {
+    const auto &jobs = queue_->jobs();
+    for (int row = 0; row < jobs.size(); ++row) {
+        if (jobs.at(row).status == LvsJobQueue::Status::Running) {
+            emit dataChanged(index(row, LvsJobColumns::JOB_DURATION),
+                             index(row, LvsJobColumns::JOB_DURATION));
+        }
+    }
+}
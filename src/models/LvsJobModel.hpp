@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QAbstractTableModel>
+
+#include "lvs/LvsJobQueue.hpp"
+
+enum LvsJobColumns : char {
+    JOB_ID = 0,
+    JOB_LAYOUT,
+    JOB_SCHEMATIC,
+    JOB_STATUS,
+    JOB_CELLS,
+    JOB_DURATION,
+    JOB_RESULT,
+    JOB_NUM_COLUMNS
+};
+
+class LvsJobModel : public QAbstractTableModel {
+    Q_OBJECT
+  public:
+    explicit LvsJobModel(LvsJobQueue *queue, QObject *parent = nullptr);
+
+    auto
+    rowCount(const QModelIndex &parent = QModelIndex()) const -> int override;
+    auto columnCount(const QModelIndex &parent = QModelIndex()) const
+        -> int override;
+    auto data(const QModelIndex &index,
+              int role = Qt::DisplayRole) const -> QVariant override;
+    auto headerData(int section, Qt::Orientation orientation,
+                    int role = Qt::DisplayRole) const -> QVariant override;
+
+    void refreshRunning(); // re-polls elapsed time of running jobs
+
+  private:
+    LvsJobQueue *queue_{nullptr};
+};
@@ -0,0 +1,503 @@
+#include "models/WaiverSet.hpp"
+
+#include <QFile>
+#include <QHash>
+#include <QStringList>
+#include <algorithm>
+#include <deque>
+
+#include "diagnostics/Tracer.hpp"
+
+namespace {
+using DiffType = NetgenJsonParser::DiffType;
+using Subtype = NetgenJsonParser::DiffEntry::Subtype;
+
+const int typeCount = static_cast<int>(DiffType::PinMismatch) + 1;
+const int subtypeCount = static_cast<int>(Subtype::DeviceCount) + 1;
+// Object regexes per alternation: one failed search skips them all, one
+// hit re-checks only these.
+const int regexGroupSize = 32;
+
+auto isRegex(const QString &value) -> bool {
+    return value.startsWith(QStringLiteral("re:"));
+}
+
+auto isWildcard(QChar c) -> bool {
+    return c == QLatin1Char('*') || c == QLatin1Char('?') ||
+           c == QLatin1Char('[') || c == QLatin1Char(']') ||
+           c == QLatin1Char('\\');
+}
+
+auto patternOf(const QString &value) -> QRegularExpression {
+    if (isRegex(value)) {
+        return QRegularExpression(
+            value.mid(3), QRegularExpression::CaseInsensitiveOption |
+                              QRegularExpression::UseUnicodePropertiesOption);
+    }
+    return QRegularExpression(
+        QRegularExpression::wildcardToRegularExpression(
+            value, QRegularExpression::NonPathWildcardConversion),
+        QRegularExpression::CaseInsensitiveOption);
+}
+
+// The longest run of plain characters in a glob: every name the glob
+// matches contains it.
+auto longestLiteral(const QString &glob) -> QString {
+    qsizetype bestFrom = 0;
+    qsizetype bestLength = 0;
+    qsizetype from = 0;
+    bool inClass = false;
+    for (qsizetype i = 0; i <= glob.size(); ++i) {
+        const bool plain = i < glob.size() && !inClass && !isWildcard(glob[i]);
+        if (i < glob.size() && glob[i] == QLatin1Char('[')) {
+            inClass = true;
+        } else if (i < glob.size() && glob[i] == QLatin1Char(']')) {
+            inClass = false;
+        }
+        if (plain) {
+            continue;
+        }
+        if (i - from > bestLength) {
+            bestFrom = from;
+            bestLength = i - from;
+        }
+        from = i + 1;
+    }
+    return glob.mid(bestFrom, bestLength).toLower();
+}
+
+auto maskOf(const QString &value, int count,
+            QString (*name)(int)) -> quint32 {
+    if (value.isEmpty()) {
+        return (1U << count) - 1;
+    }
+    const QRegularExpression pattern = patternOf(value);
+    quint32 mask = 0;
+    for (int i = 0; i < count; ++i) {
+        const QString text = name(i);
+        QString underscored = text;
+        underscored.replace(QLatin1Char(' '), QLatin1Char('_'));
+        if (pattern.match(text).hasMatch() ||
+            pattern.match(underscored).hasMatch()) {
+            mask |= 1U << i;
+        }
+    }
+    return mask;
+}
+
+auto typeName(int type) -> QString {
+    return NetgenJsonParser::toTypeString(static_cast<DiffType>(type));
+}
+
+auto subtypeName(int subtype) -> QString {
+    return NetgenJsonParser::toSubtypeString(static_cast<Subtype>(subtype));
+}
+} // namespace
+
+// Per-pass state, so that the rules themselves stay const and shareable.
+class WaiverSet::Scratch {
+  public:
+    explicit Scratch(qsizetype rules)
+        : stamp(rules, 0), memoLayout(rules, nullptr),
+          memoSchematic(rules, nullptr), memoResult(rules, false) {}
+
+    QVector<quint32> stamp; // == serial: already a candidate
+    quint32 serial = 0;
+    QVector<int> candidates;
+    // Last cell pair each rule's cell pattern was checked against.
+    QVector<const QChar *> memoLayout;
+    QVector<const QChar *> memoSchematic;
+    QVector<bool> memoResult;
+    // Unanchored rules whose cell pattern accepts a cell pair.
+    QHash<QString, QVector<int>> unanchoredByCell;
+    const QChar *lastLayout = nullptr;
+    const QChar *lastSchematic = nullptr;
+    QVector<int> lastUnanchored;
+};
+
+auto WaiverSet::load(const QString &path, QString *error) -> bool {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        parse(QString());
+        if (error != nullptr) {
+            *error = QStringLiteral("Failed to open file: %1").arg(path);
+        }
+        return false;
+    }
+    QString parseError;
+    if (!parse(QString::fromUtf8(file.readAll()), &parseError)) {
+        if (error != nullptr) {
+            *error = QStringLiteral("%1: %2").arg(path, parseError);
+        }
+        return false;
+    }
+    return true;
+}
+
+auto WaiverSet::parse(const QString &text, QString *error) -> bool {
+    OPENSVS_TRACE_SCOPE("WaiverSet::parse", "filter");
+    rules_.clear();
+    auto fail = [&](int line, const QString &message) {
+        rules_.clear();
+        compile();
+        if (error != nullptr) {
+            *error = QStringLiteral("line %1: %2").arg(line).arg(message);
+        }
+        return false;
+    };
+
+    const QStringList lines = text.split(QLatin1Char('\n'));
+    for (qsizetype i = 0; i < lines.size(); ++i) {
+        const int lineNumber = static_cast<int>(i) + 1;
+        QString line = lines.at(i);
+        QString reason;
+        // '#' at the start or after a blank begins the reason.
+        for (qsizetype k = 0; k < line.size(); ++k) {
+            if (line[k] == QLatin1Char('#') &&
+                (k == 0 || line[k - 1].isSpace())) {
+                reason = line.mid(k + 1).trimmed();
+                line.truncate(k);
+                break;
+            }
+        }
+        const QStringList tokens =
+            line.simplified().split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        if (tokens.isEmpty()) {
+            continue;
+        }
+
+        Rule rule;
+        rule.line = lineNumber;
+        rule.reason = reason;
+        for (const QString &token : tokens) {
+            const qsizetype eq = token.indexOf(QLatin1Char('='));
+            if (eq <= 0 || eq == token.size() - 1) {
+                return fail(lineNumber,
+                            QStringLiteral("expected field=pattern, got %1")
+                                .arg(token));
+            }
+            const QString key = token.left(eq).toLower();
+            QString *field = nullptr;
+            if (key == QStringLiteral("type")) {
+                field = &rule.type;
+            } else if (key == QStringLiteral("subtype")) {
+                field = &rule.subtype;
+            } else if (key == QStringLiteral("cell")) {
+                field = &rule.cell;
+            } else if (key == QStringLiteral("object")) {
+                field = &rule.object;
+            } else {
+                return fail(lineNumber,
+                            QStringLiteral("unknown field %1").arg(key));
+            }
+            if (!field->isEmpty()) {
+                return fail(lineNumber,
+                            QStringLiteral("%1 given twice").arg(key));
+            }
+            *field = token.mid(eq + 1);
+            const QRegularExpression pattern = patternOf(*field);
+            if (!pattern.isValid()) {
+                return fail(lineNumber, QStringLiteral("bad %1 pattern: %2")
+                                            .arg(key, pattern.errorString()));
+            }
+        }
+        rules_.append(rule);
+    }
+    compile();
+    return true;
+}
+
+auto WaiverSet::rules() const -> const QVector<Rule> & { return rules_; }
+
+auto WaiverSet::isEmpty() const -> bool { return rules_.isEmpty(); }
+
+void WaiverSet::compile() {
+    OPENSVS_TRACE_SCOPE("WaiverSet::compile", "filter");
+    compiled_.clear();
+    regexGroups_.clear();
+    unanchored_.clear();
+    std::vector<QHash<char16_t, int>> next(1);
+    std::vector<QVector<int>> outputs(1);
+
+    QVector<int> regexRules;
+    for (int r = 0; r < rules_.size(); ++r) {
+        const Rule &rule = rules_.at(r);
+        Compiled c;
+        c.typeMask = maskOf(rule.type, typeCount, typeName);
+        c.subtypeMask = maskOf(rule.subtype, subtypeCount, subtypeName);
+        c.anyCell = rule.cell.isEmpty();
+        if (!c.anyCell) {
+            c.cell = patternOf(rule.cell);
+        }
+
+        QString literal;
+        if (isRegex(rule.object)) {
+            c.objectKind = ObjectKind::Pattern;
+            c.object = patternOf(rule.object);
+            regexRules.append(r);
+        } else if (!rule.object.isEmpty()) {
+            if (std::none_of(rule.object.cbegin(), rule.object.cend(),
+                             isWildcard)) {
+                c.objectKind = ObjectKind::Exact;
+                c.exactObject = rule.object;
+            } else {
+                c.objectKind = ObjectKind::Pattern;
+                c.object = patternOf(rule.object);
+            }
+            literal = longestLiteral(rule.object);
+        }
+        compiled_.append(c);
+
+        if (literal.isEmpty()) {
+            if (!isRegex(rule.object)) {
+                unanchored_.append(r);
+            }
+            continue;
+        }
+        int node = 0;
+        for (const QChar ch : literal) {
+            const auto it = next[node].constFind(ch.unicode());
+            if (it != next[node].cend()) {
+                node = *it;
+                continue;
+            }
+            const int created = static_cast<int>(next.size());
+            next[node].insert(ch.unicode(), created);
+            next.emplace_back();
+            outputs.emplace_back();
+            node = created;
+        }
+        outputs[node].append(r);
+    }
+
+    // Failure and output links, breadth first.
+    nodes_.assign(next.size(), Node{});
+    std::deque<int> queue;
+    for (const int child : next[0]) {
+        queue.push_back(child);
+    }
+    while (!queue.empty()) {
+        const int u = queue.front();
+        queue.pop_front();
+        for (auto it = next[u].cbegin(); it != next[u].cend(); ++it) {
+            const int v = it.value();
+            int f = nodes_[u].fail;
+            while (f != 0 && !next[f].contains(it.key())) {
+                f = nodes_[f].fail;
+            }
+            const int target = next[f].value(it.key(), 0);
+            nodes_[v].fail = target != v ? target : 0;
+            const int fail = nodes_[v].fail;
+            nodes_[v].outputLink =
+                !outputs[fail].isEmpty() ? fail : nodes_[fail].outputLink;
+            queue.push_back(v);
+        }
+    }
+    edges_.clear();
+    for (std::size_t n = 0; n < next.size(); ++n) {
+        Node &node = nodes_[n];
+        node.firstEdge = static_cast<int>(edges_.size());
+        node.edgeCount = static_cast<int>(next[n].size());
+        node.rules = outputs[n];
+        for (auto it = next[n].cbegin(); it != next[n].cend(); ++it) {
+            edges_.push_back(Edge{it.key(), it.value()});
+        }
+        std::sort(edges_.begin() + node.firstEdge, edges_.end(),
+                  [](const Edge &a, const Edge &b) { return a.c < b.c; });
+    }
+
+    // A member with capture groups would shift the group numbers of the
+    // members after it, and its own backreferences would point at the
+    // wrong group once joined, so such rules get a group of their own.
+    QVector<int> joinable;
+    for (const int r : std::as_const(regexRules)) {
+        const Compiled &c = compiled_.at(r);
+        if (c.object.captureCount() == 0) {
+            joinable.append(r);
+            continue;
+        }
+        RegexGroup group;
+        group.rules.append(r);
+        group.typeMask = c.typeMask;
+        group.any = c.object;
+        regexGroups_.append(group);
+    }
+    for (qsizetype from = 0; from < joinable.size(); from += regexGroupSize) {
+        RegexGroup group;
+        QStringList alternatives;
+        for (qsizetype i = from;
+             i < std::min(from + regexGroupSize, joinable.size()); ++i) {
+            const int r = joinable.at(i);
+            group.rules.append(r);
+            group.typeMask |= compiled_.at(r).typeMask;
+            alternatives.append(QStringLiteral("(?:%1)").arg(
+                rules_.at(r).object.mid(3)));
+        }
+        group.any = QRegularExpression(
+            alternatives.join(QLatin1Char('|')),
+            QRegularExpression::CaseInsensitiveOption |
+                QRegularExpression::UseUnicodePropertiesOption);
+        regexGroups_.append(group);
+    }
+}
+
+auto WaiverSet::step(int node, char16_t c) const -> int {
+    const Node &n = nodes_[node];
+    const auto begin = edges_.cbegin() + n.firstEdge;
+    const auto end = begin + n.edgeCount;
+    const auto it =
+        std::lower_bound(begin, end, c, [](const Edge &e, char16_t value) {
+            return e.c < value;
+        });
+    return it != end && it->c == c ? it->to : -1;
+}
+
+auto WaiverSet::cellMatches(int rule, const DiffEntry &entry,
+                            Scratch &scratch) const -> bool {
+    const Compiled &c = compiled_.at(rule);
+    if (c.anyCell) {
+        return true;
+    }
+    // Diffs arrive circuit by circuit with shared cell strings, so the
+    // last answer usually holds.
+    const QChar *layout = entry.layoutCell.constData();
+    const QChar *schematic = entry.schematicCell.constData();
+    if (scratch.memoLayout[rule] != layout ||
+        scratch.memoSchematic[rule] != schematic) {
+        scratch.memoLayout[rule] = layout;
+        scratch.memoSchematic[rule] = schematic;
+        scratch.memoResult[rule] =
+            c.cell.match(entry.layoutCell).hasMatch() ||
+            c.cell.match(entry.schematicCell).hasMatch();
+    }
+    return scratch.memoResult[rule];
+}
+
+auto WaiverSet::objectMatches(int rule, const QString &object) const
+    -> bool {
+    const Compiled &c = compiled_.at(rule);
+    switch (c.objectKind) {
+    case ObjectKind::Exact:
+        return object.compare(c.exactObject, Qt::CaseInsensitive) == 0;
+    case ObjectKind::Pattern:
+        return c.object.match(object).hasMatch();
+    case ObjectKind::Any:
+        break;
+    }
+    return true;
+}
+
+auto WaiverSet::matchWith(const DiffEntry &entry, Scratch &scratch) const
+    -> int {
+    if (rules_.isEmpty()) {
+        return -1;
+    }
+    ++scratch.serial;
+    scratch.candidates.clear();
+    auto add = [&scratch](int rule) {
+        if (scratch.stamp[rule] != scratch.serial) {
+            scratch.stamp[rule] = scratch.serial;
+            scratch.candidates.append(rule);
+        }
+    };
+    const quint32 typeBit = 1U << static_cast<int>(entry.type);
+
+    // Rules whose object literal occurs in the name, in one scan.
+    if (nodes_.size() > 1) {
+        int state = 0;
+        for (const QChar ch : entry.name) {
+            const char16_t c = ch.toLower().unicode();
+            int target = step(state, c);
+            while (target < 0 && state != 0) {
+                state = nodes_[state].fail;
+                target = step(state, c);
+            }
+            state = std::max(target, 0);
+            for (int n = nodes_[state].rules.isEmpty()
+                             ? nodes_[state].outputLink
+                             : state;
+                 n >= 0; n = nodes_[n].outputLink) {
+                for (const int rule : nodes_[n].rules) {
+                    add(rule);
+                }
+            }
+        }
+    }
+
+    for (const RegexGroup &group : regexGroups_) {
+        if ((group.typeMask & typeBit) != 0 &&
+            (!group.any.isValid() || group.any.match(entry.name).hasMatch())) {
+            for (const int rule : group.rules) {
+                add(rule);
+            }
+        }
+    }
+
+    if (!unanchored_.isEmpty()) {
+        const QChar *layout = entry.layoutCell.constData();
+        const QChar *schematic = entry.schematicCell.constData();
+        if (layout != scratch.lastLayout ||
+            schematic != scratch.lastSchematic) {
+            const QString key =
+                entry.layoutCell + QLatin1Char('\n') + entry.schematicCell;
+            auto it = scratch.unanchoredByCell.find(key);
+            if (it == scratch.unanchoredByCell.end()) {
+                QVector<int> rules;
+                for (const int rule : unanchored_) {
+                    if (cellMatches(rule, entry, scratch)) {
+                        rules.append(rule);
+                    }
+                }
+                it = scratch.unanchoredByCell.insert(key, rules);
+            }
+            scratch.lastUnanchored = *it;
+            scratch.lastLayout = layout;
+            scratch.lastSchematic = schematic;
+        }
+        for (const int rule : std::as_const(scratch.lastUnanchored)) {
+            add(rule);
+        }
+    }
+
+    // The first rule in the file wins.
+    std::sort(scratch.candidates.begin(), scratch.candidates.end());
+    const quint32 subtypeBit = 1U << static_cast<int>(entry.subtype);
+    for (const int rule : std::as_const(scratch.candidates)) {
+        const Compiled &c = compiled_.at(rule);
+        if ((c.typeMask & typeBit) != 0 && (c.subtypeMask & subtypeBit) != 0 &&
+            cellMatches(rule, entry, scratch) &&
+            objectMatches(rule, entry.name)) {
+            return rule;
+        }
+    }
+    return -1;
+}
+
+auto WaiverSet::match(const DiffEntry &entry) const -> int {
+    Scratch scratch(rules_.size());
+    return matchWith(entry, scratch);
+}
+
+auto WaiverSet::apply(const QVector<DiffEntry> &rows) const -> QVector<int> {
+    OPENSVS_TRACE_SCOPE("WaiverSet::apply", "filter");
+    QVector<int> result;
+    result.reserve(rows.size());
+    Scratch scratch(rules_.size());
+    for (const DiffEntry &entry : rows) {
+        result.append(matchWith(entry, scratch));
+    }
+    return result;
+}
+
+auto WaiverSet::apply(const QVector<Circuit> &circuits) const
+    -> QVector<int> {
+    OPENSVS_TRACE_SCOPE("WaiverSet::apply", "filter");
+    QVector<int> result;
+    Scratch scratch(rules_.size());
+    for (const Circuit &cir : circuits) {
+        for (const DiffEntry &entry : cir.diffs) {
+            result.append(matchWith(entry, scratch));
+        }
+    }
+    return result;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QRegularExpression>
+#include <QString>
+#include <QVector>
+#include <vector>
+
+#include "parsers/NetgenJsonParser.hpp"
+
+// Accepted, known mismatches. A waiver file has one rule per line:
+//
+//   # decap W/L differ by design
+//   type=property_mismatch cell=decap_* object=*   # reason shown in the UI
+//   object=re:^dummy_\d+$ subtype=missing_instance
+//
+// Fields are type, subtype (spaces written as _), cell (layout or
+// schematic) and object; values are case-insensitive globs, or regexes
+// after "re:". A missing field matches anything, and text after " #" is
+// the rule's reason. The rules are compiled once: object globs are found
+// through an Aho-Corasick automaton over their longest literal run, object
+// regexes are tried in grouped alternations, and the rest are listed per
+// cell, so applying thousands of rules costs about one scan per diff.
+class WaiverSet {
+  public:
+    using Circuit = NetgenJsonParser::Report::Circuit;
+    using DiffEntry = NetgenJsonParser::DiffEntry;
+
+    struct Rule {
+        QString type;
+        QString subtype;
+        QString cell;
+        QString object;
+        QString reason;
+        int line = 0;
+    };
+
+    // Replace the rules; on error the set is left empty and error names
+    // the offending line.
+    auto load(const QString &path, QString *error = nullptr) -> bool;
+    auto parse(const QString &text, QString *error = nullptr) -> bool;
+
+    auto rules() const -> const QVector<Rule> &;
+    auto isEmpty() const -> bool;
+
+    // Index of the first rule that waives entry, or -1.
+    auto match(const DiffEntry &entry) const -> int;
+    // match() for every row in one pass, sharing the per-cell work.
+    auto apply(const QVector<DiffEntry> &rows) const -> QVector<int>;
+    // The same for every diff of circuits, in circuit and diff order.
+    auto apply(const QVector<Circuit> &circuits) const -> QVector<int>;
+
+  private:
+    enum class ObjectKind : char { Any, Exact, Pattern };
+    struct Compiled {
+        quint32 typeMask = 0;    // bit per DiffType
+        quint32 subtypeMask = 0; // bit per DiffEntry::Subtype
+        bool anyCell = true;
+        QRegularExpression cell;
+        ObjectKind objectKind = ObjectKind::Any;
+        QString exactObject; // a glob without wildcards
+        QRegularExpression object;
+    };
+    struct Node {
+        int firstEdge = 0;
+        int edgeCount = 0;
+        int fail = 0;
+        int outputLink = -1; // nearest suffix node with rules
+        QVector<int> rules;
+    };
+    struct Edge {
+        char16_t c = 0;
+        int to = 0;
+    };
+    struct RegexGroup {
+        QRegularExpression any; // alternation of the members' objects
+        quint32 typeMask = 0;
+        QVector<int> rules;
+    };
+    class Scratch;
+
+    void compile();
+    auto step(int node, char16_t c) const -> int;
+    auto cellMatches(int rule, const DiffEntry &entry, Scratch &scratch) const
+        -> bool;
+    auto objectMatches(int rule, const QString &object) const -> bool;
+    auto matchWith(const DiffEntry &entry, Scratch &scratch) const -> int;
+
+    QVector<Rule> rules_;
+    QVector<Compiled> compiled_;
+    std::vector<Node> nodes_; // automaton; 0 is the root
+    std::vector<Edge> edges_; // per node, sorted by c
+    QVector<RegexGroup> regexGroups_;
+    QVector<int> unanchored_; // no object literal to search for
+};
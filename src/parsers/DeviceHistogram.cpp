@@ -0,0 +1,113 @@
+#include "parsers/DeviceHistogram.hpp"
+
+#include <QHash>
+#include <utility>
+
+#include "diagnostics/Tracer.hpp"
+
+namespace {
+using ClassCount = DeviceHistogram::ClassCount;
+
+// Rows keyed by class, in first-seen order.
+class Rows {
+  public:
+    auto row(const QString &deviceClass) -> ClassCount & {
+        auto it = index_.constFind(deviceClass);
+        if (it == index_.cend()) {
+            it = index_.insert(deviceClass, static_cast<int>(rows_.size()));
+            rows_.append(ClassCount{deviceClass, 0, 0});
+        }
+        return rows_[*it];
+    }
+
+    auto take() -> QVector<ClassCount> { return std::move(rows_); }
+
+  private:
+    QHash<QString, int> index_;
+    QVector<ClassCount> rows_;
+};
+} // namespace
+
+auto DeviceHistogram::compare(const QStringList &classesA,
+                              const QVector<int> &countsA,
+                              const QStringList &classesB,
+                              const QVector<int> &countsB)
+    -> QVector<ClassCount> {
+    Rows rows;
+    for (qsizetype i = 0; i < classesA.size(); ++i) {
+        rows.row(classesA.at(i)).layout += countsA.value(i);
+    }
+    for (qsizetype i = 0; i < classesB.size(); ++i) {
+        rows.row(classesB.at(i)).schematic += countsB.value(i);
+    }
+    return rows.take();
+}
+
+auto DeviceHistogram::of(const Circuit &circuit) -> QVector<ClassCount> {
+    return compare(circuit.devicesA, circuit.deviceCountsA, circuit.devicesB,
+                   circuit.deviceCountsB);
+}
+
+auto DeviceHistogram::rolledUp(const QVector<Circuit> &circuits)
+    -> QVector<QVector<ClassCount>> {
+    OPENSVS_TRACE_SCOPE("DeviceHistogram::rolledUp", "model");
+    QHash<QString, int> byLayout;
+    QHash<QString, int> bySchematic;
+    for (qsizetype i = 0; i < circuits.size(); ++i) {
+        const Circuit &cir = circuits.at(i);
+        if (!cir.layoutCell.isEmpty()) {
+            byLayout.insert(cir.layoutCell, static_cast<int>(i));
+        }
+        if (!cir.schematicCell.isEmpty()) {
+            bySchematic.insert(cir.schematicCell, static_cast<int>(i));
+        }
+    }
+
+    enum class State : char { Todo, Active, Done };
+    QVector<State> state(circuits.size(), State::Todo);
+    QVector<QVector<ClassCount>> result(circuits.size());
+    // Depth is bounded by the hierarchy, a few levels in practice.
+    auto visit = [&](auto &&self, int at) -> void {
+        state[at] = State::Active;
+        Rows rows;
+        for (const ClassCount &own : of(circuits.at(at))) {
+            int child = byLayout.value(own.deviceClass, -1);
+            if (child < 0) {
+                child = bySchematic.value(own.deviceClass, -1);
+            }
+            if (child >= 0 && state.at(child) == State::Todo) {
+                self(self, child);
+            }
+            if (child < 0 || state.at(child) != State::Done) {
+                ClassCount &row = rows.row(own.deviceClass);
+                row.layout += own.layout;
+                row.schematic += own.schematic;
+                continue;
+            }
+            for (const ClassCount &inner : std::as_const(result[child])) {
+                ClassCount &row = rows.row(inner.deviceClass);
+                row.layout += own.layout * inner.layout;
+                row.schematic += own.schematic * inner.schematic;
+            }
+        }
+        result[at] = rows.take();
+        state[at] = State::Done;
+    };
+    for (qsizetype i = 0; i < circuits.size(); ++i) {
+        if (state.at(i) == State::Todo) {
+            visit(visit, static_cast<int>(i));
+        }
+    }
+    return result;
+}
+
+auto DeviceHistogram::mismatches(const QVector<ClassCount> &rows)
+    -> QVector<ClassCount> {
+    QVector<ClassCount> off;
+    for (const ClassCount &row : rows) {
+        if (row.layout != row.schematic) {
+            off.append(row);
+        }
+    }
+    return off;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "parsers/NetgenJsonParser.hpp"
+
+// Device counts per class on both sides of a circuit, from the `devices`
+// arrays, joined on the class name through one hash. netgen marks the
+// classes whose counts differ with **Mismatch** in its .out file; those
+// are the rows where layout != schematic, even when the totals agree.
+// rolledUp() replaces each subcell class with the subcell's own rolled-up
+// counts times its instances, so a cell's rows cover its whole hierarchy.
+// Subcells that matched cleanly are pruned from reports and stay rows of
+// their own class, equal on both sides.
+class DeviceHistogram {
+  public:
+    using Circuit = NetgenJsonParser::Report::Circuit;
+
+    struct ClassCount {
+        QString deviceClass;
+        qint64 layout = 0;
+        qint64 schematic = 0;
+    };
+
+    // Layout classes in order, then schematic-only ones; a class listed
+    // twice on one side is summed.
+    static auto compare(const QStringList &classesA,
+                        const QVector<int> &countsA,
+                        const QStringList &classesB,
+                        const QVector<int> &countsB) -> QVector<ClassCount>;
+    static auto of(const Circuit &circuit) -> QVector<ClassCount>;
+    // Per position in circuits. Subcells are found by cell name as
+    // linkHierarchy finds them; a subcell on a cycle stays a class.
+    static auto rolledUp(const QVector<Circuit> &circuits)
+        -> QVector<QVector<ClassCount>>;
+    static auto mismatches(const QVector<ClassCount> &rows)
+        -> QVector<ClassCount>;
+};
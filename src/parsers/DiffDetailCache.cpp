@@ -0,0 +1,111 @@
+#include "parsers/DiffDetailCache.hpp"
+
+#include <QMutexLocker>
+#include <limits>
+
+#include "diagnostics/MemoryReport.hpp"
+#include "diagnostics/Tracer.hpp"
+
+DiffDetailCache::DiffDetailCache(qint64 maxBytes) {
+    offsets_.append(0);
+    cache_.setMaxCost(maxBytes);
+}
+
+auto DiffDetailCache::spill(QVector<NetgenJsonParser::DiffEntry> &diffs)
+    -> bool {
+    if (diffs.isEmpty()) {
+        return true;
+    }
+    const QMutexLocker lock(&mutex_);
+    // sourceIndex is an int.
+    if (offsets_.size() + diffs.size() > std::numeric_limits<int>::max()) {
+        return false;
+    }
+    if (!file_.isOpen() && !file_.open()) {
+        return false;
+    }
+    const qint64 start = offsets_.last();
+    QByteArray bytes;
+    QVector<qint64> ends;
+    ends.reserve(diffs.size());
+    for (const auto &entry : diffs) {
+        bytes += entry.details.toUtf8();
+        ends.append(start + bytes.size());
+    }
+    if (!file_.seek(start) || file_.write(bytes) != bytes.size()) {
+        return false;
+    }
+    for (qsizetype i = 0; i < diffs.size(); ++i) {
+        diffs[i].sourceIndex = static_cast<int>(offsets_.size() - 1);
+        diffs[i].details = QString();
+        offsets_.append(ends.at(i));
+    }
+    return true;
+}
+
+auto DiffDetailCache::details(const NetgenJsonParser::DiffEntry &entry) const
+    -> QString {
+    if (!entry.details.isNull() || entry.sourceIndex < 0) {
+        return entry.details;
+    }
+    const QMutexLocker lock(&mutex_);
+    if (const QString *cached = cache_.object(entry.sourceIndex)) {
+        ++hits_;
+        return *cached;
+    }
+    ++misses_;
+    const QString value = load(entry.sourceIndex);
+    // QCache deletes what does not fit; value is already copied out.
+    cache_.insert(entry.sourceIndex, new QString(value),
+                  MemoryReport::stringBytes(value));
+    return value;
+}
+
+auto DiffDetailCache::cached(const NetgenJsonParser::DiffEntry &entry,
+                             QString *details) const -> bool {
+    if (!entry.details.isNull() || entry.sourceIndex < 0) {
+        *details = entry.details;
+        return true;
+    }
+    const QMutexLocker lock(&mutex_);
+    const QString *cached = cache_.object(entry.sourceIndex);
+    if (cached == nullptr) {
+        return false;
+    }
+    ++hits_;
+    *details = *cached;
+    return true;
+}
+
+auto DiffDetailCache::load(int at) const -> QString {
+    OPENSVS_TRACE_SCOPE("DiffDetailCache::load", "parser");
+    if (at + 1 >= offsets_.size() || !file_.seek(offsets_.at(at))) {
+        return {};
+    }
+    return QString::fromUtf8(file_.read(offsets_.at(at + 1) - offsets_.at(at)));
+}
+
+auto DiffDetailCache::spilledBytes() const -> qint64 {
+    const QMutexLocker lock(&mutex_);
+    return offsets_.last();
+}
+
+auto DiffDetailCache::cachedBytes() const -> qint64 {
+    const QMutexLocker lock(&mutex_);
+    return cache_.totalCost();
+}
+
+auto DiffDetailCache::cachedEntries() const -> qint64 {
+    const QMutexLocker lock(&mutex_);
+    return cache_.size();
+}
+
+auto DiffDetailCache::hits() const -> qint64 {
+    const QMutexLocker lock(&mutex_);
+    return hits_;
+}
+
+auto DiffDetailCache::misses() const -> qint64 {
+    const QMutexLocker lock(&mutex_);
+    return misses_;
+}
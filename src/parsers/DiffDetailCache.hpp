@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QCache>
+#include <QMutex>
+#include <QString>
+#include <QTemporaryFile>
+#include <QVector>
+
+#include "parsers/NetgenJsonParser.hpp"
+
+// Details of a report parsed with NetgenJsonParser::Details::OnDemand. The
+// parser spills each diff's details to a temporary file as it drops them
+// and records the diff's byte range there, so reading one back is a short
+// read with no re-parse, however large its circuit is. Details read back
+// stay in an LRU cache bounded in bytes. The query server reads it on its
+// own thread while the window does, so lookups share one lock.
+class DiffDetailCache {
+  public:
+    explicit DiffDetailCache(qint64 maxBytes = defaultMaxBytes);
+
+    // Moves the details of diffs to the spill file and points each entry's
+    // sourceIndex at them. Returns false, and leaves the details resident,
+    // if the file cannot be written.
+    auto spill(QVector<NetgenJsonParser::DiffEntry> &diffs) -> bool;
+
+    // entry.details when resident; otherwise read back from the spill file.
+    auto details(const NetgenJsonParser::DiffEntry &entry) const -> QString;
+    // details() when it would not read the file; false on a cache miss.
+    auto cached(const NetgenJsonParser::DiffEntry &entry,
+                QString *details) const -> bool;
+
+    auto spilledBytes() const -> qint64;
+    auto cachedBytes() const -> qint64;
+    auto cachedEntries() const -> qint64;
+    auto hits() const -> qint64;
+    auto misses() const -> qint64;
+
+    static constexpr qint64 defaultMaxBytes = 64 * 1024 * 1024;
+
+  private:
+    auto load(int at) const -> QString;
+
+    mutable QMutex mutex_;
+    mutable QTemporaryFile file_;
+    QVector<qint64> offsets_; // start of each spilled diff, then the end
+    mutable QCache<int, QString> cache_;
+    mutable qint64 hits_{0};
+    mutable qint64 misses_{0};
+};
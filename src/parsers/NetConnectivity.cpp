@@ -0,0 +1,145 @@
+#include "parsers/NetConnectivity.hpp"
+
+#include <utility>
+
+namespace {
+using Fanout = QHash<QString, int>;
+using Net = NetConnectivity::Net;
+
+// Sorted "class:pin*count" terms, equal for nets with the same fanout.
+auto signature(const Fanout &pins) -> QString {
+    QStringList terms;
+    terms.reserve(pins.size());
+    for (auto it = pins.cbegin(); it != pins.cend(); ++it) {
+        terms.append(it.key() + QLatin1Char('*') +
+                     QString::number(it.value()));
+    }
+    terms.sort();
+    return terms.join(QLatin1Char(' '));
+}
+
+// Whether every device on part is also on host.
+auto fits(const Fanout &part, const Fanout &host) -> bool {
+    for (auto it = part.cbegin(); it != part.cend(); ++it) {
+        if (host.value(it.key()) < it.value()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// For each free host, the free parts that fit into it and into no other
+// free host, in part order.
+auto piecesOf(const QVector<Net> &hosts, const QVector<bool> &hostFree,
+              const QVector<Net> &parts, const QVector<bool> &partFree)
+    -> QVector<QVector<int>> {
+    QHash<QString, QVector<int>> hostsOn; // pin -> free hosts on it
+    for (qsizetype h = 0; h < hosts.size(); ++h) {
+        if (!hostFree.at(h)) {
+            continue;
+        }
+        for (auto it = hosts.at(h).pins.cbegin();
+             it != hosts.at(h).pins.cend(); ++it) {
+            hostsOn[it.key()].append(static_cast<int>(h));
+        }
+    }
+    QVector<QVector<int>> pieces(hosts.size());
+    for (qsizetype p = 0; p < parts.size(); ++p) {
+        const Fanout &pins = parts.at(p).pins;
+        if (!partFree.at(p) || pins.isEmpty()) {
+            continue;
+        }
+        // A host must carry every pin of the part, so scanning the hosts
+        // on its rarest pin is enough.
+        const QVector<int> *rarest = nullptr;
+        for (auto it = pins.cbegin(); it != pins.cend(); ++it) {
+            const auto on = hostsOn.constFind(it.key());
+            if (on == hostsOn.constEnd()) {
+                rarest = nullptr;
+                break;
+            }
+            if (rarest == nullptr || on->size() < rarest->size()) {
+                rarest = &*on;
+            }
+        }
+        if (rarest == nullptr) {
+            continue;
+        }
+        int host = -1;
+        int fitting = 0;
+        for (const int h : *rarest) {
+            if (fits(pins, hosts.at(h).pins)) {
+                host = h;
+                if (++fitting > 1) {
+                    break;
+                }
+            }
+        }
+        if (fitting == 1) {
+            pieces[host].append(static_cast<int>(p));
+        }
+    }
+    return pieces;
+}
+
+// Hosts that are exactly the sum of two or more pieces; their nets are
+// taken off the free lists.
+void collect(NetConnectivity::Kind kind, const QVector<Net> &hosts,
+             QVector<bool> &hostFree, const QVector<Net> &parts,
+             QVector<bool> &partFree,
+             QVector<NetConnectivity::Finding> &findings) {
+    const QVector<QVector<int>> pieces =
+        piecesOf(hosts, hostFree, parts, partFree);
+    for (qsizetype h = 0; h < hosts.size(); ++h) {
+        if (pieces.at(h).size() < 2) {
+            continue;
+        }
+        Fanout sum;
+        for (const int p : pieces.at(h)) {
+            for (auto it = parts.at(p).pins.cbegin();
+                 it != parts.at(p).pins.cend(); ++it) {
+                sum[it.key()] += it.value();
+            }
+        }
+        if (sum != hosts.at(h).pins) {
+            continue;
+        }
+        NetConnectivity::Finding finding;
+        finding.kind = kind;
+        finding.net = hosts.at(h).name;
+        for (const int p : pieces.at(h)) {
+            finding.nets.append(parts.at(p).name);
+            partFree[p] = false;
+        }
+        hostFree[h] = false;
+        findings.append(finding);
+    }
+}
+} // namespace
+
+auto NetConnectivity::classify(const QVector<Net> &layout,
+                               const QVector<Net> &schematic)
+    -> QVector<Finding> {
+    QVector<bool> layoutFree(layout.size(), true);
+    QVector<bool> schematicFree(schematic.size(), true);
+
+    // Nets with the same fanout on both sides are taken as matched.
+    QHash<QString, QVector<int>> layoutWith; // signature -> layout nets
+    for (qsizetype i = layout.size() - 1; i >= 0; --i) {
+        layoutWith[signature(layout.at(i).pins)].append(static_cast<int>(i));
+    }
+    for (qsizetype i = 0; i < schematic.size(); ++i) {
+        const auto it = layoutWith.find(signature(schematic.at(i).pins));
+        if (it != layoutWith.end() && !it->isEmpty()) {
+            layoutFree[it->takeLast()] = false;
+            schematicFree[i] = false;
+        }
+    }
+
+    QVector<Finding> findings;
+    collect(Kind::Short, layout, layoutFree, schematic, schematicFree,
+            findings);
+    collect(Kind::Open, schematic, schematicFree, layout, layoutFree,
+            findings);
+    return findings;
+}
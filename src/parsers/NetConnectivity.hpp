@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Shorts and opens in one group of netgen's badnets. netgen lists each net
+// by fanout: how many devices of a class sit on each of their pins, not
+// which devices. Nets are therefore only ever joined across the sides,
+// and only when the counts balance: a layout net whose fanout is exactly
+// the sum of several schematic nets is a short, the layout merging what
+// the schematic keeps apart, and a schematic net that is the sum of
+// several layout nets is an open. Nets on one side are never joined
+// through a class pin they share. Nets with the same fanout on both sides
+// pair off first; a net that fits into more than one counterpart is
+// ambiguous and left to the per-net mismatches.
+class NetConnectivity {
+  public:
+    struct Net {
+        QString name;
+        QHash<QString, int> pins; // "class:pin" -> devices on it
+    };
+
+    enum class Kind : char { Short, Open };
+
+    struct Finding {
+        Kind kind = Kind::Short;
+        QString net;      // the layout net of a short, schematic of an open
+        QStringList nets; // the other side's nets, in input order
+    };
+
+    // Shorts in layout order, then opens in schematic order. A group costs
+    // its pin count times the counterparts sharing each net's rarest pin.
+    static auto classify(const QVector<Net> &layout,
+                         const QVector<Net> &schematic) -> QVector<Finding>;
+};
@@ -11,9 +11,23 @@
 #include <qjsonarray.h>
 #include <qjsonvalue.h>
 
-auto NetgenJsonParser::parseFile(const QString &path)
+#include "diagnostics/Tracer.hpp"
+#include "parsers/DeviceHistogram.hpp"
+#include "parsers/NetConnectivity.hpp"
+#include "parsers/NetgenJsonStreamParser.hpp"
+#include "parsers/PinMatcher.hpp"
+
+namespace {
+const qint64 streamChunk = 4 * 1024 * 1024;
+} // namespace
+
+auto NetgenJsonParser::parseFile(const QString &path, Details details,
+                                 const PropertyTolerances &tolerances)
     -> NetgenJsonParser::Report {
+    Tracer::Span span("NetgenJsonParser::parseFile", "parser");
+    span.setDetail(path);
     Report report;
+    report.tolerances = tolerances;
 
     QFile file(path);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -21,9 +35,39 @@ auto NetgenJsonParser::parseFile(const QString &path)
         return report;
     }
 
-    const QByteArray data = file.readAll();
+    // Holds one circuit's JSON at a time, which for a flattened top cell is
+    // still most of the file, and spills the details to disk as it goes.
+    if (details == Details::OnDemand) {
+        OPENSVS_TRACE_SCOPE("stream file", "parser");
+        NetgenJsonStreamParser stream;
+        stream.setKeepDetails(false);
+        stream.setTolerances(tolerances);
+        while (!stream.hasError()) {
+            const QByteArray chunk = file.read(streamChunk);
+            if (chunk.isEmpty()) {
+                break;
+            }
+            stream.feed(chunk);
+        }
+        if (file.error() != QFileDevice::NoError) {
+            report.error = QStringLiteral("Failed to read file: %1: %2")
+                               .arg(path, file.errorString());
+            return report;
+        }
+        return stream.finish();
+    }
+
+    QByteArray data;
+    {
+        OPENSVS_TRACE_SCOPE("read file", "parser");
+        data = file.readAll();
+    }
     QJsonParseError parseError;
-    const QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+    QJsonDocument doc;
+    {
+        OPENSVS_TRACE_SCOPE("QJsonDocument::fromJson", "parser");
+        doc = QJsonDocument::fromJson(data, &parseError);
+    }
     if (parseError.error != QJsonParseError::NoError) {
         report.error = QStringLiteral("JSON parse error: %1")
                            .arg(parseError.errorString());
@@ -41,423 +85,567 @@ auto NetgenJsonParser::parseFile(const QString &path)
             QStringLiteral("Root JSON array is empty or has no object");
         return report;
     }
+    return parseCircuits(arr, tolerances);
+}
 
-    report.circuits.reserve(arr.size());
-    int circuitIdx = 0;
-    for (const QJsonValueConstRef &rootVal : arr) {
+auto NetgenJsonParser::parseCircuits(const QJsonArray &circuits,
+                                     const PropertyTolerances &tolerances)
+    -> NetgenJsonParser::Report {
+    OPENSVS_TRACE_SCOPE("extract diffs", "parser");
+    Report report;
+    report.tolerances = tolerances;
+    report.circuits.reserve(circuits.size());
+    long long circuitIdx = 0;
+    for (const QJsonValueConstRef &rootVal : circuits) {
         if (!rootVal.isObject()) {
             continue;
         }
-        const QJsonObject rootObj = rootVal.toObject();
-        const QJsonValue namesVal = rootObj.value(QStringLiteral("name"));
-        if (!namesVal.isArray()) {
-            continue;
-        }
-        const QJsonArray namesArr = namesVal.toArray();
-        if (namesArr.isEmpty()) {
-            continue;
-        }
         Report::Circuit sub;
-        sub.index = circuitIdx;
-
-        const QJsonArray netsArr =
-            rootObj.value(QStringLiteral("nets")).toArray();
-        if (!netsArr.isEmpty()) {
-            sub.summary.totalNets = netsArr.first().toInt(0);
+        if (parseCircuit(rootVal.toObject(), circuitIdx, sub, tolerances)) {
+            report.circuits.push_back(std::move(sub));
+            ++circuitIdx;
         }
+    }
 
-        const QJsonArray devicesArr =
-            rootObj.value(QStringLiteral("devices")).toArray();
-        if (!devicesArr.isEmpty() && devicesArr.first().isArray()) {
-            int total = 0;
+    linkHierarchy(report);
+    report.ok = true;
+    return report;
+}
+
+auto NetgenJsonParser::parseCircuit(const QJsonObject &rootObj,
+                                    long long circuitIdx,
+                                    Report::Circuit &sub,
+                                    const PropertyTolerances &tolerances)
+    -> bool {
+    const QJsonValue namesVal = rootObj.value(QStringLiteral("name"));
+    if (!namesVal.isArray()) {
+        return false;
+    }
+    const QJsonArray namesArr = namesVal.toArray();
+    if (namesArr.isEmpty()) {
+        return false;
+    }
+    sub.index = circuitIdx;
+
+    const QJsonArray netsArr = rootObj.value(QStringLiteral("nets")).toArray();
+    if (!netsArr.isEmpty()) {
+        sub.summary.totalNets = netsArr.first().toInt(0);
+    }
+
+    const QJsonArray devicesArr =
+        rootObj.value(QStringLiteral("devices")).toArray();
+    if (!devicesArr.isEmpty() && devicesArr.first().isArray()) {
+        int total = 0;
+        for (const QJsonValueConstRef &devVal : devicesArr.first().toArray()) {
+            if (devVal.isArray()) {
+                const QJsonArray pair = devVal.toArray();
+                if (pair.size() > 1) {
+                    if (pair.at(0).isString()) {
+                        sub.devicesA.append(pair.at(0).toString());
+                        sub.deviceCountsA.append(pair.at(1).toInt(0));
+                    }
+                    total += pair.at(1).toInt(0);
+                }
+            }
+        }
+        sub.summary.totalDevices = total;
+        if (devicesArr.size() > 1) {
             for (const QJsonValueConstRef &devVal :
-                 devicesArr.first().toArray()) {
+                 devicesArr.at(1).toArray()) {
                 if (devVal.isArray()) {
                     const QJsonArray pair = devVal.toArray();
                     if (pair.size() > 1) {
                         if (pair.at(0).isString()) {
-                            sub.devicesA.append(pair.at(0).toString());
+                            sub.devicesB.append(pair.at(0).toString());
+                            sub.deviceCountsB.append(pair.at(1).toInt(0));
                         }
-                        total += pair.at(1).toInt(0);
                     }
                 }
             }
-            sub.summary.totalDevices = total;
-            if (devicesArr.size() > 1) {
-                int totalB = 0;
-                for (const QJsonValueConstRef &devVal :
-                     devicesArr.at(1).toArray()) {
-                    if (devVal.isArray()) {
-                        const QJsonArray pair = devVal.toArray();
-                        if (pair.size() > 1) {
-                            if (pair.at(0).isString()) {
-                                sub.devicesB.append(pair.at(0).toString());
-                            }
-                            totalB += pair.at(1).toInt(0);
-                        }
-                    }
+        }
+    }
+
+    sub.layoutCell = !namesArr.empty() ? namesArr.at(0).toString() : QString();
+    sub.schematicCell =
+        namesArr.size() > 1 ? namesArr.at(1).toString() : QString();
+    const QJsonArray propertiesArr =
+        rootObj.value(QStringLiteral("properties")).toArray();
+    for (const QJsonValueConstRef &val : propertiesArr) {
+        const QJsonArray pairArr = val.toArray();
+        if (pairArr.size() < 2) {
+            continue;
+        }
+        const QJsonArray deviceA = pairArr.at(0).toArray();
+        const QJsonArray deviceB = pairArr.at(1).toArray();
+        if (deviceA.size() < 2 || deviceB.size() < 2) {
+            continue;
+        }
+        const QString nameA = deviceA.at(0).toString();
+        const QString nameB = deviceB.at(0).toString();
+        const QJsonArray paramsA = deviceA.at(1).toArray();
+        const QJsonArray paramsB = deviceB.at(1).toArray();
+        const int maxParams = std::max(static_cast<int>(paramsA.size()),
+                                       static_cast<int>(paramsB.size()));
+        for (int i = 0; i < maxParams; ++i) {
+            const QJsonArray paramA =
+                i < paramsA.size() ? paramsA.at(i).toArray() : QJsonArray();
+            const QJsonArray paramB =
+                i < paramsB.size() ? paramsB.at(i).toArray() : QJsonArray();
+            const QString paramNameA =
+                !paramA.isEmpty() ? paramA.at(0).toString() : QString();
+            const QString paramNameB =
+                !paramB.isEmpty() ? paramB.at(0).toString() : QString();
+            const bool missingParamA = paramNameA.contains(
+                QStringLiteral("(no matching parameter)"), Qt::CaseSensitive);
+            const bool missingParamB = paramNameB.contains(
+                QStringLiteral("(no matching parameter)"), Qt::CaseSensitive);
+
+            QString param = QStringLiteral("unknown");
+            QString valA = QStringLiteral("(missing)");
+            QString valB = QStringLiteral("(missing)");
+
+            if (missingParamA && !missingParamB) {
+                if (!paramNameB.isEmpty()) {
+                    param = paramNameB;
+                }
+            } else if (missingParamB && !missingParamA) {
+                if (!paramNameA.isEmpty()) {
+                    param = paramNameA;
                 }
-                if (total != totalB) {
-                    sub.summary.deviceMismatches = 1;
+            } else {
+                if (!paramNameA.isEmpty()) {
+                    param = paramNameA;
+                } else if (!paramNameB.isEmpty()) {
+                    param = paramNameB;
                 }
             }
-        }
 
-        sub.layoutCell =
-            !namesArr.empty() ? namesArr.at(0).toString() : QString();
-        sub.schematicCell =
-            namesArr.size() > 1 ? namesArr.at(1).toString() : QString();
-        const QJsonArray propertiesArr =
-            rootObj.value(QStringLiteral("properties")).toArray();
-        for (const QJsonValueConstRef &val : propertiesArr) {
-            const QJsonArray pairArr = val.toArray();
-            if (pairArr.size() < 2) {
-                continue;
+            if (paramA.size() > 1) {
+                valA = paramA.at(1).toString();
             }
-            const QJsonArray deviceA = pairArr.at(0).toArray();
-            const QJsonArray deviceB = pairArr.at(1).toArray();
-            if (deviceA.size() < 2 || deviceB.size() < 2) {
-                continue;
+            if (paramB.size() > 1) {
+                valB = paramB.at(1).toString();
             }
-            const QString nameA = deviceA.at(0).toString();
-            const QString nameB = deviceB.at(0).toString();
-            const QJsonArray paramsA = deviceA.at(1).toArray();
-            const QJsonArray paramsB = deviceB.at(1).toArray();
-            const int maxParams = std::max(static_cast<int>(paramsA.size()),
-                                           static_cast<int>(paramsB.size()));
-            for (int i = 0; i < maxParams; ++i) {
-                const QJsonArray paramA =
-                    i < paramsA.size() ? paramsA.at(i).toArray() : QJsonArray();
-                const QJsonArray paramB =
-                    i < paramsB.size() ? paramsB.at(i).toArray() : QJsonArray();
-                const QString paramNameA =
-                    !paramA.isEmpty() ? paramA.at(0).toString() : QString();
-                const QString paramNameB =
-                    !paramB.isEmpty() ? paramB.at(0).toString() : QString();
-                const bool missingParamA = paramNameA.contains(
-                    QStringLiteral("(no matching parameter)"),
-                    Qt::CaseSensitive);
-                const bool missingParamB = paramNameB.contains(
-                    QStringLiteral("(no matching parameter)"),
-                    Qt::CaseSensitive);
-
-                QString param = QStringLiteral("unknown");
-                QString valA = QStringLiteral("(missing)");
-                QString valB = QStringLiteral("(missing)");
-
-                if (missingParamA && !missingParamB) {
-                    if (!paramNameB.isEmpty()) {
-                        param = paramNameB;
-                    }
-                } else if (missingParamB && !missingParamA) {
-                    if (!paramNameA.isEmpty()) {
-                        param = paramNameA;
-                    }
-                } else {
-                    if (!paramNameA.isEmpty()) {
-                        param = paramNameA;
-                    } else if (!paramNameB.isEmpty()) {
-                        param = paramNameB;
-                    }
-                }
 
-                if (paramA.size() > 1) {
-                    valA = paramA.at(1).toString();
-                }
-                if (paramB.size() > 1) {
-                    valB = paramB.at(1).toString();
-                }
-
-                if (valA == valB) {
-                    continue;
-                }
-                DiffEntry entry;
-                entry.type = DiffType::PropertyMismatch;
-                entry.subtype = DiffEntry::Subtype::MissingParameter;
-                entry.name = !nameA.isEmpty() ? nameA : nameB;
-                entry.layoutCell = sub.layoutCell;
-                entry.schematicCell = sub.schematicCell;
-                entry.details =
-                    QStringLiteral("%1: %2 vs %3").arg(param, valA, valB);
-                entry.circuitIndex = circuitIdx;
-                sub.diffs.push_back(entry);
+            // Numbers are compared by value within the tolerance, so
+            // "1e-6" vs "1u" or "0.35" vs "0.350000" are not reported.
+            if (tolerances.matches(param, valA, valB)) {
+                continue;
             }
+            DiffEntry entry;
+            entry.type = DiffType::PropertyMismatch;
+            entry.subtype = DiffEntry::Subtype::MissingParameter;
+            entry.name = !nameA.isEmpty() ? nameA : nameB;
+            entry.layoutCell = sub.layoutCell;
+            entry.schematicCell = sub.schematicCell;
+            entry.details =
+                QStringLiteral("%1: %2 vs %3").arg(param, valA, valB);
+            entry.circuitIndex = circuitIdx;
+            sub.diffs.push_back(entry);
         }
+    }
 
-        const QJsonArray badnetsArr =
-            rootObj.value(QStringLiteral("badnets")).toArray();
+    const QJsonArray badnetsArr =
+        rootObj.value(QStringLiteral("badnets")).toArray();
 
-        struct NetInfo {
-            QString rawName;
-            QStringList connections;
-        };
-        QHash<QString, NetInfo> netsA;
-        QHash<QString, NetInfo> netsB;
-        QStringList nameOrder;
-
-        auto normalizeName = [](const QString &n) {
-            QString lower = n.trimmed().toLower();
-            if (lower == QStringLiteral("gnd") ||
-                lower == QStringLiteral("0")) {
-                return QStringLiteral("0");
+    struct NetInfo {
+        QString rawName;
+        QStringList connections;
+    };
+    QHash<QString, NetInfo> netsA;
+    QHash<QString, NetInfo> netsB;
+    QStringList nameOrder;
+
+    auto normalizeName = [](const QString &n) {
+        QString lower = n.trimmed().toLower();
+        if (lower == QStringLiteral("gnd") || lower == QStringLiteral("0")) {
+            return QStringLiteral("0");
+        }
+        return lower;
+    };
+    auto connectionList = [](const QJsonArray &arr) {
+        QStringList parts;
+        for (const QJsonValueConstRef &ref_conn : arr) {
+            const QJsonArray conn = ref_conn.toArray();
+            if (conn.size() >= 2) {
+                QString dev = conn.at(0).toString();
+                const QString port = conn.at(1).toString();
+                const int count = conn.size() > 2 ? conn.at(2).toInt() : 0;
+                parts << QStringLiteral("%1:%2 (%3)").arg(dev, port).arg(count);
             }
-            return lower;
-        };
-        auto connectionList = [](const QJsonArray &arr) {
-            QStringList parts;
-            for (const QJsonValueConstRef &ref_conn : arr) {
-                const QJsonArray conn = ref_conn.toArray();
-                if (conn.size() >= 2) {
-                    QString dev = conn.at(0).toString();
-                    const QString port = conn.at(1).toString();
-                    const int count = conn.size() > 2 ? conn.at(2).toInt() : 0;
-                    parts << QStringLiteral("%1:%2 (%3)")
-                                 .arg(dev, port)
-                                 .arg(count);
-                }
+        }
+        return parts;
+    };
+    auto captureNet = [&](const QJsonArray &netArr,
+                          QHash<QString, NetInfo> &dest) {
+        if (netArr.size() < 2) {
+            return;
+        }
+        NetInfo info;
+        info.rawName = netArr.at(0).toString();
+        if (info.rawName.contains(QStringLiteral("(no matching net)"),
+                                  Qt::CaseInsensitive)) {
+            return;
+        }
+        info.connections = connectionList(netArr.at(1).toArray());
+        const QString key = normalizeName(info.rawName);
+        if (!dest.contains(key)) {
+            dest.insert(key, info);
+            if (!nameOrder.contains(key)) {
+                nameOrder.append(key);
             }
-            return parts;
-        };
-        auto captureNet = [&](const QJsonArray &netArr,
-                              QHash<QString, NetInfo> &dest) {
+        } else {
+            dest[key] = info;
+        }
+    };
+
+    // Fanout of each net of a badnets group, for NetConnectivity.
+    auto connectivityNets = [](const QJsonArray &netsList) {
+        QVector<NetConnectivity::Net> nets;
+        nets.reserve(netsList.size());
+        for (const QJsonValueConstRef &ref_net : netsList) {
+            const QJsonArray netArr = ref_net.toArray();
             if (netArr.size() < 2) {
-                return;
+                continue;
             }
-            NetInfo info;
-            info.rawName = netArr.at(0).toString();
-            if (info.rawName.contains(QStringLiteral("(no matching net)"),
-                                      Qt::CaseInsensitive)) {
-                return;
+            NetConnectivity::Net net;
+            net.name = netArr.at(0).toString();
+            if (net.name.contains(QStringLiteral("(no matching net)"),
+                                  Qt::CaseInsensitive)) {
+                continue;
             }
-            info.connections = connectionList(netArr.at(1).toArray());
-            const QString key = normalizeName(info.rawName);
-            if (!dest.contains(key)) {
-                dest.insert(key, info);
-                if (!nameOrder.contains(key)) {
-                    nameOrder.append(key);
+            for (const QJsonValueConstRef &ref_conn :
+                 netArr.at(1).toArray()) {
+                const QJsonArray conn = ref_conn.toArray();
+                if (conn.size() >= 2 && !conn.at(0).toString().isEmpty()) {
+                    net.pins[conn.at(0).toString() + QLatin1Char(':') +
+                             conn.at(1).toString()] +=
+                        conn.size() > 2 ? conn.at(2).toInt() : 1;
                 }
-            } else {
-                dest[key] = info;
             }
-        };
+            nets.append(net);
+        }
+        return nets;
+    };
+    QVector<NetConnectivity::Finding> connectivity;
 
-        for (const QJsonValueConstRef &val : badnetsArr) {
-            if (!val.isArray()) {
-                continue;
-            }
-            QJsonArray pairArr = val.toArray();
-            if (pairArr.size() == 1 && pairArr.at(0).isArray()) {
-                pairArr = pairArr.at(0).toArray();
-            }
-            if (pairArr.size() == 2 && pairArr.at(0).isArray() &&
-                pairArr.at(1).isArray()) {
-                const QJsonArray netsListA = pairArr.at(0).toArray();
-                const QJsonArray netsListB = pairArr.at(1).toArray();
-                for (const QJsonValueConstRef &netA : netsListA) {
-                    if (netA.isArray()) {
-                        captureNet(netA.toArray(), netsA);
-                    }
+    for (const QJsonValueConstRef &val : badnetsArr) {
+        if (!val.isArray()) {
+            continue;
+        }
+        QJsonArray pairArr = val.toArray();
+        if (pairArr.size() == 1 && pairArr.at(0).isArray()) {
+            pairArr = pairArr.at(0).toArray();
+        }
+        if (pairArr.size() == 2 && pairArr.at(0).isArray() &&
+            pairArr.at(1).isArray()) {
+            const QJsonArray netsListA = pairArr.at(0).toArray();
+            const QJsonArray netsListB = pairArr.at(1).toArray();
+            for (const QJsonValueConstRef &netA : netsListA) {
+                if (netA.isArray()) {
+                    captureNet(netA.toArray(), netsA);
                 }
-                for (const QJsonValueConstRef &netB : netsListB) {
-                    if (netB.isArray()) {
-                        captureNet(netB.toArray(), netsB);
-                    }
+            }
+            for (const QJsonValueConstRef &netB : netsListB) {
+                if (netB.isArray()) {
+                    captureNet(netB.toArray(), netsB);
                 }
             }
+            connectivity += NetConnectivity::classify(
+                connectivityNets(netsListA), connectivityNets(netsListB));
         }
+    }
 
-        for (const QString &name : nameOrder) {
-            const bool hasA = netsA.contains(name);
-            const bool hasB = netsB.contains(name);
-            if (hasA && hasB) {
-                const auto &netA = netsA.value(name);
-                const auto &netB = netsB.value(name);
-                const QSet<QString> setA(netA.connections.begin(),
-                                         netA.connections.end());
-                const QSet<QString> setB(netB.connections.begin(),
-                                         netB.connections.end());
-                QStringList onlyA;
-                for (const auto &conn : netA.connections) {
-                    if (!setB.contains(conn)) {
-                        onlyA.append(conn);
-                    }
+    for (const QString &name : nameOrder) {
+        const bool hasA = netsA.contains(name);
+        const bool hasB = netsB.contains(name);
+        if (hasA && hasB) {
+            const auto &netA = netsA.value(name);
+            const auto &netB = netsB.value(name);
+            const QSet<QString> setA(netA.connections.begin(),
+                                     netA.connections.end());
+            const QSet<QString> setB(netB.connections.begin(),
+                                     netB.connections.end());
+            QStringList onlyA;
+            for (const auto &conn : netA.connections) {
+                if (!setB.contains(conn)) {
+                    onlyA.append(conn);
                 }
-                QStringList onlyB;
-                for (const auto &conn : netB.connections) {
-                    if (!setA.contains(conn)) {
-                        onlyB.append(conn);
-                    }
-                }
-                if (!onlyA.isEmpty() || !onlyB.isEmpty()) {
-                    DiffEntry entry;
-                    entry.type = DiffType::NetMismatch;
-                    const bool bothSides = !onlyA.isEmpty() && !onlyB.isEmpty();
-                    entry.subtype =
-                        bothSides ? DiffEntry::Subtype::UnmatchedConnections
-                                  : DiffEntry::Subtype::MissingConnection;
-                    entry.name =
-                        !netA.rawName.isEmpty() ? netA.rawName : netB.rawName;
-                    entry.layoutCell = sub.layoutCell;
-                    entry.schematicCell = sub.schematicCell;
-                    QStringList parts;
-                    if (!onlyA.isEmpty()) {
-                        parts << QStringLiteral(
-                                     "The following pins are connected only in "
-                                     "Layout circuit: %1")
-                                     .arg(onlyA.join(QStringLiteral(", ")));
-                    }
-                    if (!onlyB.isEmpty()) {
-                        parts << QStringLiteral(
-                                     "The following pins are connected only in "
-                                     "Schematics circuit: %1")
-                                     .arg(onlyB.join(QStringLiteral(", ")));
-                    }
-                    entry.details = parts.join(QStringLiteral(" | "));
-                    entry.circuitIndex = circuitIdx;
-                    sub.diffs.push_back(entry);
-                    sub.summary.netMismatches += 1;
+            }
+            QStringList onlyB;
+            for (const auto &conn : netB.connections) {
+                if (!setA.contains(conn)) {
+                    onlyB.append(conn);
                 }
-            } else {
+            }
+            if (!onlyA.isEmpty() || !onlyB.isEmpty()) {
                 DiffEntry entry;
                 entry.type = DiffType::NetMismatch;
-                entry.subtype = DiffEntry::Subtype::NoMatchingNet;
-                const QString displayName = hasA ? netsA.value(name).rawName
-                                                 : netsB.value(name).rawName;
-                entry.name = displayName.isEmpty() ? name : displayName;
+                const bool bothSides = !onlyA.isEmpty() && !onlyB.isEmpty();
+                entry.subtype =
+                    bothSides ? DiffEntry::Subtype::UnmatchedConnections
+                              : DiffEntry::Subtype::MissingConnection;
+                entry.name =
+                    !netA.rawName.isEmpty() ? netA.rawName : netB.rawName;
                 entry.layoutCell = sub.layoutCell;
                 entry.schematicCell = sub.schematicCell;
-                if (hasA) {
-                    const auto &netA = netsA.value(name);
-                    entry.details =
-                        QStringLiteral("No matching net in Schematics circuit "
-                                       "for %1 (connected to %2)")
-                            .arg(netA.rawName,
-                                 netA.connections.join(QStringLiteral(", ")));
-                } else {
-                    const auto &netB = netsB.value(name);
-                    entry.details =
-                        QStringLiteral("No matching net in Layout circuit for "
-                                       "%1 (connected to %2)")
-                            .arg(netB.rawName,
-                                 netB.connections.join(QStringLiteral(", ")));
+                QStringList parts;
+                if (!onlyA.isEmpty()) {
+                    parts << QStringLiteral(
+                                 "The following pins are connected only in "
+                                 "Layout circuit: %1")
+                                 .arg(onlyA.join(QStringLiteral(", ")));
                 }
+                if (!onlyB.isEmpty()) {
+                    parts << QStringLiteral(
+                                 "The following pins are connected only in "
+                                 "Schematics circuit: %1")
+                                 .arg(onlyB.join(QStringLiteral(", ")));
+                }
+                entry.details = parts.join(QStringLiteral(" | "));
                 entry.circuitIndex = circuitIdx;
                 sub.diffs.push_back(entry);
                 sub.summary.netMismatches += 1;
             }
+        } else {
+            DiffEntry entry;
+            entry.type = DiffType::NetMismatch;
+            entry.subtype = DiffEntry::Subtype::NoMatchingNet;
+            const QString displayName = hasA ? netsA.value(name).rawName
+                                             : netsB.value(name).rawName;
+            entry.name = displayName.isEmpty() ? name : displayName;
+            entry.layoutCell = sub.layoutCell;
+            entry.schematicCell = sub.schematicCell;
+            if (hasA) {
+                const auto &netA = netsA.value(name);
+                entry.details =
+                    QStringLiteral("No matching net in Schematics circuit "
+                                   "for %1 (connected to %2)")
+                        .arg(netA.rawName,
+                             netA.connections.join(QStringLiteral(", ")));
+            } else {
+                const auto &netB = netsB.value(name);
+                entry.details =
+                    QStringLiteral("No matching net in Layout circuit for "
+                                   "%1 (connected to %2)")
+                        .arg(netB.rawName,
+                             netB.connections.join(QStringLiteral(", ")));
+            }
+            entry.circuitIndex = circuitIdx;
+            sub.diffs.push_back(entry);
+            sub.summary.netMismatches += 1;
         }
+    }
 
-        const QJsonArray badElementsArr =
-            rootObj.value(QStringLiteral("badelements")).toArray();
-        auto processElementPair = [&](const QJsonArray &listA,
-                                      const QJsonArray &listB) {
-            const int maxCount = std::max(static_cast<int>(listA.size()),
-                                          static_cast<int>(listB.size()));
-            for (int i = 0; i < maxCount; ++i) {
-                const QJsonArray elemA =
-                    i < listA.size() ? listA.at(i).toArray() : QJsonArray();
-                const QJsonArray elemB =
-                    i < listB.size() ? listB.at(i).toArray() : QJsonArray();
-                const QString instanceNameA =
-                    !elemA.isEmpty() ? elemA.at(0).toString() : QString();
-                const QString instanceNameB =
-                    !elemB.isEmpty() ? elemB.at(0).toString() : QString();
-                const bool missingA =
-                    instanceNameA.contains(
-                        QStringLiteral("(no matching instance)"),
-                        Qt::CaseInsensitive) ||
-                    elemA.isEmpty();
-                const bool missingB =
-                    instanceNameB.contains(
-                        QStringLiteral("(no matching instance)"),
-                        Qt::CaseInsensitive) ||
-                    elemB.isEmpty();
-
-                if (missingA != missingB) {
-                    DiffEntry entry;
-                    entry.type = DiffType::InstanceMismatch;
-                    entry.subtype = DiffEntry::Subtype::MissingInstance;
-                    entry.name = missingA ? instanceNameB : instanceNameA;
-                    entry.layoutCell = sub.layoutCell;
-                    entry.schematicCell = sub.schematicCell;
-                    entry.details =
-                        missingA ? QStringLiteral("The instance is present "
-                                                  "only in Schematics circuit")
-                                 : QStringLiteral("The instance is present "
-                                                  "only in Layout circuit");
-                    entry.circuitIndex = circuitIdx;
-                    sub.diffs.push_back(entry);
-                    sub.summary.deviceMismatches += 1;
-                } else if (!(missingA || missingB)) {
-                    DiffEntry entryA;
-                    entryA.type = DiffType::InstanceMismatch;
-                    entryA.subtype = DiffEntry::Subtype::NoMatchingInstance;
-                    entryA.name =
-                        instanceNameA.split(QStringLiteral(":")).first();
-                    entryA.layoutCell = sub.layoutCell;
-                    entryA.schematicCell = sub.schematicCell;
-                    entryA.details =
-                        QStringLiteral("Instance %1 present in Layout circuit "
-                                       "has no matching instance")
-                            .arg(instanceNameA);
-                    entryA.circuitIndex = circuitIdx;
-                    sub.diffs.push_back(entryA);
-                    sub.summary.deviceMismatches += 1;
-
-                    DiffEntry entryB;
-                    entryB.type = DiffType::InstanceMismatch;
-                    entryB.subtype = DiffEntry::Subtype::NoMatchingInstance;
-                    entryB.name =
-                        instanceNameB.split(QStringLiteral(":")).first();
-                    ;
-                    entryB.layoutCell = sub.layoutCell;
-                    entryB.schematicCell = sub.schematicCell;
-                    entryB.details =
-                        QStringLiteral("Instance %1 present in Schematics "
-                                       "circuit has no matching instance")
-                            .arg(instanceNameB);
-                    entryB.circuitIndex = circuitIdx;
-                    sub.diffs.push_back(entryB);
-                    sub.summary.deviceMismatches += 1;
-                }
+    for (const NetConnectivity::Finding &finding : connectivity) {
+        const bool isShort = finding.kind == NetConnectivity::Kind::Short;
+        DiffEntry entry;
+        entry.type = isShort ? DiffType::Short : DiffType::Open;
+        entry.subtype = isShort ? DiffEntry::Subtype::MergedNets
+                                : DiffEntry::Subtype::SplitNet;
+        entry.name = finding.net;
+        entry.layoutCell = sub.layoutCell;
+        entry.schematicCell = sub.schematicCell;
+        entry.details =
+            isShort ? QStringLiteral("Layout net %1 joins schematic nets %2")
+                          .arg(finding.net,
+                               finding.nets.join(QStringLiteral(", ")))
+                    : QStringLiteral("Schematic net %1 is split over layout "
+                                     "nets %2")
+                          .arg(finding.net,
+                               finding.nets.join(QStringLiteral(", ")));
+        entry.circuitIndex = circuitIdx;
+        sub.diffs.push_back(entry);
+        if (isShort) {
+            sub.summary.shorts += 1;
+        } else {
+            sub.summary.opens += 1;
+        }
+    }
+
+    const QJsonArray badElementsArr =
+        rootObj.value(QStringLiteral("badelements")).toArray();
+    auto processElementPair = [&](const QJsonArray &listA,
+                                  const QJsonArray &listB) {
+        const int maxCount = std::max(static_cast<int>(listA.size()),
+                                      static_cast<int>(listB.size()));
+        for (int i = 0; i < maxCount; ++i) {
+            const QJsonArray elemA =
+                i < listA.size() ? listA.at(i).toArray() : QJsonArray();
+            const QJsonArray elemB =
+                i < listB.size() ? listB.at(i).toArray() : QJsonArray();
+            const QString instanceNameA =
+                !elemA.isEmpty() ? elemA.at(0).toString() : QString();
+            const QString instanceNameB =
+                !elemB.isEmpty() ? elemB.at(0).toString() : QString();
+            const bool missingA =
+                instanceNameA.contains(QStringLiteral("(no matching instance)"),
+                                       Qt::CaseInsensitive) ||
+                elemA.isEmpty();
+            const bool missingB =
+                instanceNameB.contains(QStringLiteral("(no matching instance)"),
+                                       Qt::CaseInsensitive) ||
+                elemB.isEmpty();
+
+            if (missingA != missingB) {
+                DiffEntry entry;
+                entry.type = DiffType::InstanceMismatch;
+                entry.subtype = DiffEntry::Subtype::MissingInstance;
+                entry.name = missingA ? instanceNameB : instanceNameA;
+                entry.layoutCell = sub.layoutCell;
+                entry.schematicCell = sub.schematicCell;
+                entry.details =
+                    missingA ? QStringLiteral("The instance is present "
+                                              "only in Schematics circuit")
+                             : QStringLiteral("The instance is present "
+                                              "only in Layout circuit");
+                entry.circuitIndex = circuitIdx;
+                sub.diffs.push_back(entry);
+                sub.summary.deviceMismatches += 1;
+            } else if (!(missingA || missingB)) {
+                DiffEntry entryA;
+                entryA.type = DiffType::InstanceMismatch;
+                entryA.subtype = DiffEntry::Subtype::NoMatchingInstance;
+                entryA.name = instanceNameA.split(QStringLiteral(":")).first();
+                entryA.layoutCell = sub.layoutCell;
+                entryA.schematicCell = sub.schematicCell;
+                entryA.details =
+                    QStringLiteral("Instance %1 present in Layout circuit "
+                                   "has no matching instance")
+                        .arg(instanceNameA);
+                entryA.circuitIndex = circuitIdx;
+                sub.diffs.push_back(entryA);
+                sub.summary.deviceMismatches += 1;
+
+                DiffEntry entryB;
+                entryB.type = DiffType::InstanceMismatch;
+                entryB.subtype = DiffEntry::Subtype::NoMatchingInstance;
+                entryB.name = instanceNameB.split(QStringLiteral(":")).first();
+                ;
+                entryB.layoutCell = sub.layoutCell;
+                entryB.schematicCell = sub.schematicCell;
+                entryB.details =
+                    QStringLiteral("Instance %1 present in Schematics "
+                                   "circuit has no matching instance")
+                        .arg(instanceNameB);
+                entryB.circuitIndex = circuitIdx;
+                sub.diffs.push_back(entryB);
+                sub.summary.deviceMismatches += 1;
             }
-        };
+        }
+    };
 
-        if (!badElementsArr.isEmpty()) {
-            if (badElementsArr.size() == 2 && badElementsArr.at(0).isArray() &&
-                badElementsArr.at(1).isArray()) {
-                processElementPair(badElementsArr.at(0).toArray(),
-                                   badElementsArr.at(1).toArray());
-            } else if (badElementsArr.size() == 1 &&
-                       badElementsArr.first().isArray()) {
-                const QJsonArray first = badElementsArr.first().toArray();
-                if (first.size() == 2 && first.at(0).isArray() &&
-                    first.at(1).isArray()) {
-                    processElementPair(first.at(0).toArray(),
-                                       first.at(1).toArray());
+    if (!badElementsArr.isEmpty()) {
+        if (badElementsArr.size() == 2 && badElementsArr.at(0).isArray() &&
+            badElementsArr.at(1).isArray()) {
+            processElementPair(badElementsArr.at(0).toArray(),
+                               badElementsArr.at(1).toArray());
+        } else if (badElementsArr.size() == 1 &&
+                   badElementsArr.first().isArray()) {
+            const QJsonArray first = badElementsArr.first().toArray();
+            if (first.size() == 2 && first.at(0).isArray() &&
+                first.at(1).isArray()) {
+                processElementPair(first.at(0).toArray(),
+                                   first.at(1).toArray());
+            }
+        } else {
+            for (const QJsonValueConstRef &val : badElementsArr) {
+                if (!val.isArray()) {
+                    continue;
                 }
-            } else {
-                for (const QJsonValueConstRef &val : badElementsArr) {
-                    if (!val.isArray()) {
-                        continue;
-                    }
-                    QJsonArray pair = val.toArray();
-                    if (pair.size() == 1 && pair.at(0).isArray()) {
-                        pair = pair.at(0).toArray();
-                    }
-                    if (pair.size() == 2 && pair.at(0).isArray() &&
-                        pair.at(1).isArray()) {
-                        processElementPair(pair.at(0).toArray(),
-                                           pair.at(1).toArray());
-                    }
+                QJsonArray pair = val.toArray();
+                if (pair.size() == 1 && pair.at(0).isArray()) {
+                    pair = pair.at(0).toArray();
+                }
+                if (pair.size() == 2 && pair.at(0).isArray() &&
+                    pair.at(1).isArray()) {
+                    processElementPair(pair.at(0).toArray(),
+                                       pair.at(1).toArray());
                 }
             }
         }
+    }
+    // One diff per device class whose counts differ, as netgen's
+    // **Mismatch** lines; equal totals can still hide a swapped class.
+    for (const DeviceHistogram::ClassCount &row :
+         DeviceHistogram::mismatches(DeviceHistogram::of(sub))) {
+        DiffEntry entry;
+        entry.type = DiffType::DeviceMismatch;
+        entry.subtype = DiffEntry::Subtype::DeviceCount;
+        entry.name = row.deviceClass;
+        entry.layoutCell = sub.layoutCell;
+        entry.schematicCell = sub.schematicCell;
+        entry.details = QStringLiteral("Class %1: %2 in Layout circuit, %3 "
+                                       "in Schematics circuit")
+                            .arg(row.deviceClass)
+                            .arg(row.layout)
+                            .arg(row.schematic);
+        entry.circuitIndex = circuitIdx;
+        sub.diffs.push_back(entry);
+        sub.summary.deviceMismatches += 1;
+    }
 
-        report.circuits.push_back(sub);
-        ++circuitIdx;
+    // Identical lists, such as the usual [""] placeholders, are skipped
+    // without building the table.
+    const QJsonArray pinsArr = rootObj.value(QStringLiteral("pins")).toArray();
+    if (pinsArr.size() == 2 && pinsArr.at(0) != pinsArr.at(1)) {
+        auto pinList = [](const QJsonValue &value) {
+            QStringList pins;
+            for (const QJsonValueConstRef &pin : value.toArray()) {
+                pins << pin.toString();
+            }
+            return pins;
+        };
+        const QStringList pinsA = pinList(pinsArr.at(0));
+        const QStringList pinsB = pinList(pinsArr.at(1));
+        const QVector<PinMatcher::Finding> pinFindings =
+            PinMatcher::compare(pinsA, pinsB);
+        if (!pinFindings.isEmpty()) {
+            sub.pinsA = pinsA;
+            sub.pinsB = pinsB;
+        }
+        for (const PinMatcher::Finding &finding : pinFindings) {
+            DiffEntry entry;
+            entry.type = DiffType::PinMismatch;
+            entry.name = finding.pin;
+            entry.layoutCell = sub.layoutCell;
+            entry.schematicCell = sub.schematicCell;
+            switch (finding.kind) {
+            case PinMatcher::Kind::Missing:
+                entry.subtype = DiffEntry::Subtype::MissingPin;
+                entry.details =
+                    finding.layoutPos >= 0
+                        ? QStringLiteral("The pin is present only in "
+                                         "Layout circuit")
+                        : QStringLiteral("The pin is present only in "
+                                         "Schematics circuit");
+                break;
+            case PinMatcher::Kind::Renamed:
+                entry.subtype = DiffEntry::Subtype::PinNameMismatch;
+                entry.details =
+                    QStringLiteral("Layout pin %1 is matched with "
+                                   "schematic pin %2 (pin %3)")
+                        .arg(finding.pin, finding.other)
+                        .arg(finding.layoutPos + 1);
+                break;
+            case PinMatcher::Kind::Reordered:
+                entry.subtype = DiffEntry::Subtype::PinOrder;
+                entry.details =
+                    QStringLiteral("The pin is pin %1 in Layout circuit "
+                                   "but pin %2 in Schematics circuit")
+                        .arg(finding.layoutPos + 1)
+                        .arg(finding.schematicPos + 1);
+                break;
+            }
+            entry.circuitIndex = circuitIdx;
+            sub.diffs.push_back(entry);
+        }
     }
+    return true;
+}
 
+void NetgenJsonParser::linkHierarchy(Report &report) {
+    OPENSVS_TRACE_SCOPE("NetgenJsonParser::linkHierarchy", "parser");
     // Build lookup maps
     QHash<QString, Report::Circuit *> layoutMap;
     QHash<QString, Report::Circuit *> schematicMap;
@@ -574,9 +762,6 @@ auto NetgenJsonParser::parseFile(const QString &path)
             linkChild(name);
         }
     }
-
-    report.ok = true;
-    return report;
 }
 
 auto NetgenJsonParser::toTypeString(NetgenJsonParser::DiffType type)
@@ -590,6 +775,12 @@ auto NetgenJsonParser::toTypeString(NetgenJsonParser::DiffType type)
         return QStringLiteral("instance_mismatch");
     case NetgenJsonParser::DiffType::PropertyMismatch:
         return QStringLiteral("property_mismatch");
+    case NetgenJsonParser::DiffType::Short:
+        return QStringLiteral("short");
+    case NetgenJsonParser::DiffType::Open:
+        return QStringLiteral("open");
+    case NetgenJsonParser::DiffType::PinMismatch:
+        return QStringLiteral("pin_mismatch");
     case NetgenJsonParser::DiffType::Unknown:
     default:
         return QStringLiteral("unknown");
@@ -611,6 +802,18 @@ auto NetgenJsonParser::toSubtypeString(
         return QStringLiteral("missing instance");
     case DiffEntry::Subtype::NoMatchingInstance:
         return QStringLiteral("no matching instance");
+    case DiffEntry::Subtype::MergedNets:
+        return QStringLiteral("merged nets");
+    case DiffEntry::Subtype::SplitNet:
+        return QStringLiteral("split net");
+    case DiffEntry::Subtype::MissingPin:
+        return QStringLiteral("missing pin");
+    case DiffEntry::Subtype::PinNameMismatch:
+        return QStringLiteral("pin name mismatch");
+    case DiffEntry::Subtype::PinOrder:
+        return QStringLiteral("pin order");
+    case DiffEntry::Subtype::DeviceCount:
+        return QStringLiteral("device count");
     case DiffEntry::Subtype::Unknown:
     default:
         return QStringLiteral("unknown");
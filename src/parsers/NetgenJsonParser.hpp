@@ -3,6 +3,13 @@
 #include <QHash>
 #include <QString>
 #include <QVector>
+#include <memory>
+
+#include "parsers/PropertyTolerances.hpp"
+
+class DiffDetailCache;
+class QJsonArray;
+class QJsonObject;
 
 class NetgenJsonParser {
   public:
@@ -11,7 +18,10 @@ class NetgenJsonParser {
         NetMismatch,
         DeviceMismatch,
         InstanceMismatch,
-        PropertyMismatch
+        PropertyMismatch,
+        Short, // one layout net joins several schematic nets
+        Open,  // one schematic net is split over several layout nets
+        PinMismatch
     };
 
     struct Summary {
@@ -34,9 +44,18 @@ class NetgenJsonParser {
             UnmatchedConnections,
             NoMatchingNet,
             MissingInstance,
-            NoMatchingInstance
+            NoMatchingInstance,
+            MergedNets,
+            SplitNet,
+            MissingPin,
+            PinNameMismatch,
+            PinOrder,
+            DeviceCount
         };
         Subtype subtype = Subtype::Unknown;
+        // Where the report's DiffDetailCache keeps details dropped by an
+        // on-demand parse; -1 while they are resident.
+        int sourceIndex = -1;
         QString name;
         QString layoutCell;
         QString schematicCell;
@@ -48,21 +67,60 @@ class NetgenJsonParser {
         bool ok = false;
         QString error;
         Summary summary;
+        // Details were dropped after parsing (DiffEntry::details is null)
+        // and are read back through detailCache.
+        bool detailsOnDemand = false;
+        std::shared_ptr<const DiffDetailCache> detailCache;
+        // Property values within these tolerances were not reported.
+        PropertyTolerances tolerances;
         struct Circuit {
             Summary summary;
             QString layoutCell;
             QString schematicCell;
             QStringList devicesA;
+            // Instances of each devicesA entry (device or subcell).
+            QVector<int> deviceCountsA;
             QStringList devicesB;
+            QVector<int> deviceCountsB;
+            // netgen's pin pairing, layout and schematic name per position;
+            // empty unless a pin mismatches.
+            QStringList pinsA;
+            QStringList pinsB;
             QVector<DiffEntry> diffs;
             bool isTopLevel{true};
             QHash<QString, Circuit *> subcircuits;
             long long index = -1;
+            // Byte range of this circuit's element in the source JSON; -1
+            // when parsed from a whole-document read.
+            qint64 sourceOffset = -1;
+            qint64 sourceLength = 0;
         };
         QVector<Circuit> circuits;
     };
 
-    static auto parseFile(const QString &path) -> Report;
+    enum class Details : char {
+        Resident, // whole document in memory, every field kept
+        OnDemand  // streamed one circuit at a time, details dropped
+    };
+
+    static auto parseFile(const QString &path,
+                          Details details = Details::Resident,
+                          const PropertyTolerances &tolerances = {})
+        -> Report;
+    // A top-level array already in memory, such as NetlistComparator's,
+    // read as parseFile reads a file.
+    static auto parseCircuits(const QJsonArray &circuits,
+                              const PropertyTolerances &tolerances = {})
+        -> Report;
+    // Building blocks shared with NetgenJsonStreamParser. parseCircuit fills
+    // sub from one element of the top-level array and returns false if the
+    // element is not a circuit comparison; linkHierarchy prunes circuits
+    // without (descendant) diffs, rebuilds the summary and links children.
+    static auto parseCircuit(const QJsonObject &rootObj, long long circuitIdx,
+                             Report::Circuit &sub,
+                             const PropertyTolerances &tolerances = {})
+        -> bool;
+    static void linkHierarchy(Report &report);
 
     static auto toTypeString(DiffType type) -> QString;
     static auto toSubtypeString(DiffEntry::Subtype subtype) -> QString;
@@ -0,0 +1,183 @@
+#include "parsers/NetgenJsonStreamParser.hpp"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <utility>
+
+#include "parsers/DiffDetailCache.hpp"
+
+namespace {
+auto isSpace(char c) -> bool {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+} // namespace
+
+void NetgenJsonStreamParser::setKeepDetails(bool keep) {
+    spill_ = keep ? nullptr : std::make_shared<DiffDetailCache>();
+    report_.detailsOnDemand = !keep;
+    report_.detailCache = spill_;
+}
+
+void NetgenJsonStreamParser::setTolerances(
+    const PropertyTolerances &tolerances) {
+    report_.tolerances = tolerances;
+}
+
+void NetgenJsonStreamParser::feed(const QByteArray &chunk) {
+    consumed_ += chunk.size();
+    scan(chunk.constData(), chunk.size());
+}
+
+auto NetgenJsonStreamParser::takeCircuits() -> QVector<Report::Circuit> {
+    return std::exchange(report_.circuits, {});
+}
+
+auto NetgenJsonStreamParser::circuitCount() const -> long long {
+    return circuits_;
+}
+
+auto NetgenJsonStreamParser::bytesConsumed() const -> qint64 {
+    return consumed_;
+}
+
+auto NetgenJsonStreamParser::hasError() const -> bool {
+    return state_ == State::Error;
+}
+
+auto NetgenJsonStreamParser::error() const -> QString {
+    return report_.error;
+}
+
+auto NetgenJsonStreamParser::finish(QVector<Report::Circuit> taken)
+    -> Report {
+    Report report = std::move(report_);
+    if (!taken.isEmpty()) {
+        taken.append(std::move(report.circuits));
+        report.circuits = std::move(taken);
+    }
+    if (state_ == State::BeforeArray && consumed_ > 0) {
+        report.error = QStringLiteral("Root JSON is not an object");
+    } else if (state_ != State::Done && state_ != State::Error) {
+        report.error =
+            QStringLiteral("JSON parse error: unexpected end of input");
+    } else if (state_ == State::Done && elements_ == 0) {
+        report.error =
+            QStringLiteral("Root JSON array is empty or has no object");
+    }
+    if (report.error.isEmpty()) {
+        NetgenJsonParser::linkHierarchy(report);
+        report.ok = true;
+    } else {
+        report.circuits.clear();
+        report.detailCache.reset();
+    }
+    *this = NetgenJsonStreamParser();
+    return report;
+}
+
+void NetgenJsonStreamParser::scan(const char *data, qsizetype size) {
+    const qint64 base = consumed_ - size; // feed() has counted the chunk
+    qsizetype elementStart = state_ == State::InElement ? 0 : -1;
+    for (qsizetype i = 0; i < size && state_ != State::Error; ++i) {
+        const char c = data[i];
+        switch (state_) {
+        case State::BeforeArray:
+            if (c == '[') {
+                state_ = State::InArray;
+            } else if (!isSpace(c)) {
+                fail(QStringLiteral("Root JSON is not an object"));
+            }
+            break;
+        case State::InArray:
+            if (c == ']') {
+                state_ = State::Done;
+            } else if (c != ',' && !isSpace(c)) {
+                state_ = State::InElement;
+                elementStart = i;
+                elementOffset_ = base + i;
+                --i; // rescan the first byte as part of the element
+            }
+            break;
+        case State::InElement:
+            if (inString_) {
+                if (escaped_) {
+                    escaped_ = false;
+                } else if (c == '\\') {
+                    escaped_ = true;
+                } else if (c == '"') {
+                    inString_ = false;
+                }
+                break;
+            }
+            if (c == '"') {
+                inString_ = true;
+            } else if (c == '{' || c == '[') {
+                ++depth_;
+            } else if (c == '}' || c == ']') {
+                if (depth_ == 0 && c == ']') { // root array ends on a scalar
+                    element_.append(data + elementStart, i - elementStart);
+                    parseElement();
+                    --i;
+                    break;
+                }
+                if (depth_ == 0) {
+                    fail(QStringLiteral("JSON parse error: unbalanced '}'"));
+                    break;
+                }
+                if (--depth_ == 0) {
+                    element_.append(data + elementStart, i + 1 - elementStart);
+                    parseElement();
+                }
+            } else if (c == ',' && depth_ == 0) {
+                element_.append(data + elementStart, i - elementStart);
+                parseElement();
+            }
+            break;
+        case State::Done:
+            if (!isSpace(c)) {
+                fail(QStringLiteral(
+                    "JSON parse error: garbage at the end of the document"));
+            }
+            break;
+        case State::Error:
+            break;
+        }
+    }
+    if (state_ == State::InElement && elementStart >= 0) {
+        element_.append(data + elementStart, size - elementStart);
+    }
+}
+
+void NetgenJsonStreamParser::parseElement() {
+    state_ = State::InArray;
+    ++elements_;
+    const QByteArray element = std::exchange(element_, QByteArray());
+    // parseFile skips non-object elements; so does the stream.
+    if (!element.trimmed().startsWith('{')) {
+        return;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(element, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        fail(QStringLiteral("JSON parse error: %1")
+                 .arg(parseError.errorString()));
+        return;
+    }
+    Report::Circuit sub;
+    if (NetgenJsonParser::parseCircuit(doc.object(), circuits_, sub,
+                                       report_.tolerances)) {
+        ++circuits_;
+        sub.sourceOffset = elementOffset_;
+        sub.sourceLength = element.size();
+        if (spill_) {
+            spill_->spill(sub.diffs); // details stay resident on failure
+        }
+        report_.circuits.push_back(std::move(sub));
+    }
+}
+
+void NetgenJsonStreamParser::fail(const QString &message) {
+    state_ = State::Error;
+    report_.error = message;
+    element_.clear();
+}
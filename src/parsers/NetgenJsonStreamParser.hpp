@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+#include "parsers/NetgenJsonParser.hpp"
+
+// Incremental counterpart of NetgenJsonParser::parseFile for netgen output
+// that is still being written (a FIFO or a growing file). Bytes are fed in
+// arbitrary chunks; every element of the top-level array is parsed as soon
+// as its closing brace arrives, so only one circuit is buffered at a time.
+class NetgenJsonStreamParser {
+  public:
+    using Report = NetgenJsonParser::Report;
+
+    // false moves DiffEntry::details to a DiffDetailCache once a circuit is
+    // parsed; the report then has detailsOnDemand and detailCache set.
+    // Circuits always carry their byte range.
+    void setKeepDetails(bool keep);
+    // Passed to parseCircuit and kept in the report; set before feeding.
+    void setTolerances(const PropertyTolerances &tolerances);
+    void feed(const QByteArray &chunk);
+    // Circuits completed since the last call, unpruned and unlinked, with
+    // indices in stream order. They are moved out: the parser no longer
+    // holds them and finish() needs them back.
+    auto takeCircuits() -> QVector<Report::Circuit>;
+    auto circuitCount() const -> long long;
+    auto bytesConsumed() const -> qint64;
+    auto hasError() const -> bool;
+    auto error() const -> QString;
+
+    // Ends the stream and returns the report parseFile would have produced
+    // for the same bytes. taken holds every circuit takeCircuits() handed
+    // out, in stream order with their indices and diffs; the hierarchy is
+    // linked afresh. The parser is reset afterwards.
+    auto finish(QVector<Report::Circuit> taken = {}) -> Report;
+
+  private:
+    enum class State : char { BeforeArray, InArray, InElement, Done, Error };
+
+    void scan(const char *data, qsizetype size);
+    void parseElement();
+    void fail(const QString &message);
+
+    State state_{State::BeforeArray};
+    QByteArray element_; // bytes of the element being scanned
+    qint64 elementOffset_{0};
+    int depth_{0};
+    bool inString_{false};
+    bool escaped_{false};
+    long long elements_{0};
+    long long circuits_{0}; // parsed, taken or not
+    qint64 consumed_{0};
+    std::shared_ptr<DiffDetailCache> spill_; // without keepDetails
+    Report report_;
+};
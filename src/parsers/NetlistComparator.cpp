@@ -0,0 +1,1552 @@
+#include "parsers/NetlistComparator.hpp"
+
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSemaphore>
+#include <QSet>
+#include <QThreadPool>
+#include <QVector>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <optional>
+
+#include "diagnostics/Tracer.hpp"
+#include "parsers/SpiceNetlist.hpp"
+#include "parsers/SpiceNumber.hpp"
+#include "parsers/SubcktHashes.hpp"
+
+namespace {
+using Cell = SpiceNetlist::Cell;
+using Element = SpiceNetlist::Element;
+using CellRecord = NetlistComparator::CellRecord;
+using Records = NetlistComparator::Records;
+using Color = quint64;
+
+constexpr int maxDepth = 64;
+constexpr qsizetype parallelChunk = qsizetype(1) << 14;
+const QString noMatchingNet = QStringLiteral("(no matching net)");
+const QString noMatchingInstance = QStringLiteral("(no matching instance)");
+const QString noMatchingPin = QStringLiteral("(no matching pin)");
+const QString noMatchingParameter =
+    QStringLiteral("(no matching parameter)");
+const QString noValue = QStringLiteral("(no value)");
+const QString recordsFormat = QStringLiteral("opensvs-netlist-records-v2");
+
+auto splitmix(quint64 x) -> quint64 {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+auto combine(quint64 a, quint64 b) -> quint64 {
+    return splitmix(a ^ (b + 0x9e3779b97f4a7c15ULL + (a << 6) + (a >> 2)));
+}
+
+// FNV-1a over the lower-cased text, the same in every process.
+auto hashText(const QString &text) -> quint64 {
+    quint64 hash = 14695981039346656037ULL;
+    for (const QChar c : text) {
+        hash = (hash ^ c.toLower().unicode()) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Runs fn(begin, end) over [0, count) in chunks on the global pool, the
+// calling thread taking chunks too.
+template <typename Fn> void parallelFor(qsizetype count, const Fn &fn) {
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const qsizetype chunks = (count + parallelChunk - 1) / parallelChunk;
+    const int helpers = static_cast<int>(std::min<qsizetype>(
+                            chunks, pool->maxThreadCount())) -
+                        1;
+    if (helpers <= 0) {
+        fn(0, count);
+        return;
+    }
+    std::atomic<qsizetype> next{0};
+    auto run = [&] {
+        for (qsizetype c = next++; c < chunks; c = next++) {
+            fn(c * parallelChunk, std::min(count, (c + 1) * parallelChunk));
+        }
+    };
+    QSemaphore done;
+    for (int i = 0; i < helpers; ++i) {
+        pool->start([&] {
+            run();
+            done.release();
+        });
+    }
+    run();
+    done.acquire(helpers);
+}
+
+// Pin roles, shared by both sides of every comparison.
+class Labels {
+  public:
+    auto id(const QString &key, const QString &group, const QString &first)
+        -> int {
+        const auto it = ids_.constFind(key);
+        if (it != ids_.cend()) {
+            return *it;
+        }
+        const auto id = static_cast<int>(hashes_.size());
+        ids_.insert(key, id);
+        hashes_.append(hashText(key));
+        groups_.append(group);
+        firsts_.append(first);
+        return id;
+    }
+    auto id(const QString &key, const QString &name) -> int {
+        return id(key, name, name);
+    }
+    // A proxy pin: named apart, but the same role as the pin it stands in
+    // for on the other side.
+    auto alias(int of, const QString &key, const QString &name) -> int {
+        const auto it = ids_.constFind(key);
+        if (it != ids_.cend()) {
+            return *it;
+        }
+        const auto id = static_cast<int>(hashes_.size());
+        ids_.insert(key, id);
+        hashes_.append(hashes_.at(of));
+        groups_.append(name);
+        firsts_.append(name);
+        return id;
+    }
+    auto hash(int id) const -> quint64 { return hashes_.at(id); }
+    // "drain|source" for a net's pin counts, "drain" for a device's.
+    auto group(int id) const -> const QString & { return groups_.at(id); }
+    auto first(int id) const -> const QString & { return firsts_.at(id); }
+
+  private:
+    QHash<QString, int> ids_;
+    QVector<quint64> hashes_;
+    QStringList groups_;
+    QStringList firsts_;
+};
+
+struct Pin {
+    int label = 0;
+    int net = 0;
+};
+
+struct Device {
+    QString name;
+    QString deviceClass;
+    Color classKey = 0;
+    QVector<Pin> pins;
+    const Element *element = nullptr;  // primitives only
+    QVector<const Element *> parallel; // folded into this one
+    bool alive = true;
+};
+
+struct Net {
+    QString name;
+    QVector<QPair<int, int>> pins; // device, pin index
+};
+
+struct Graph {
+    QVector<Device> devices;
+    QVector<Net> nets;
+    QHash<QString, int> netIds; // lower-case, path-qualified
+    QVector<int> ports;         // net of each cell port and global pin
+    QSet<int> proxyNets;        // made for proxy pins, never matched
+
+    auto netFor(const QString &key, const QString &name) -> int {
+        const auto it = netIds.constFind(key);
+        if (it != netIds.cend()) {
+            return *it;
+        }
+        const auto id = static_cast<int>(nets.size());
+        netIds.insert(key, id);
+        nets.append(Net{name, {}});
+        return id;
+    }
+};
+
+// How a compared pair, or a cell one side leaves undefined, appears in
+// its parents. A pin the other side lacks gets a proxy there, as netgen
+// adds one: a pin of the same role on a net of its own.
+struct CellResult {
+    bool clean = false;
+    QVector<int> labelsA; // per port
+    QVector<int> labelsB;
+    QVector<QPair<QString, int>> globalsA; // global pins: net, label
+    QVector<QPair<QString, int>> globalsB;
+    QVector<int> proxiesA; // labels
+    QVector<int> proxiesB;
+};
+
+// Declared global nets a cell reaches without a port, itself or through
+// its subcircuits; compared, the cell gets a pin for each.
+class GlobalUse {
+  public:
+    explicit GlobalUse(const SpiceNetlist &netlist) : netlist_(netlist) {}
+
+    auto of(const Cell &cell, int depth = 0) -> const QStringList & {
+        const QString key = cell.name.toLower();
+        const auto it = memo_.constFind(key);
+        if (it != memo_.cend()) {
+            return *it;
+        }
+        QStringList used;
+        if (depth <= maxDepth) {
+            QSet<QString> ports;
+            for (const QString &port : cell.ports) {
+                ports.insert(port.toLower());
+            }
+            QSet<QString> seen;
+            auto add = [&](const QString &net) {
+                const QString lower = net.toLower();
+                if (!ports.contains(lower) && !seen.contains(lower)) {
+                    seen.insert(lower);
+                    used.append(net);
+                }
+            };
+            for (const Element &element : cell.elements) {
+                for (const QString &node : element.nodes) {
+                    if (netlist_.isDeclaredGlobal(node)) {
+                        add(node);
+                    }
+                }
+                const Cell *child = element.kind == QLatin1Char('x')
+                                        ? netlist_.cell(element.deviceClass)
+                                        : nullptr;
+                if (child != nullptr && child != &cell) {
+                    for (const QString &net : of(*child, depth + 1)) {
+                        add(net);
+                    }
+                }
+            }
+        }
+        return *memo_.insert(key, used);
+    }
+
+  private:
+    const SpiceNetlist &netlist_;
+    QHash<QString, QStringList> memo_;
+};
+
+struct Context {
+    Labels labels;
+    QHash<QString, CellResult> results; // lower-case cell name
+    QHash<QString, int> order;          // of the results' making
+    QSet<QString> flatten;              // lower-case
+
+    auto blackBox(const QString &cell) const -> const CellResult * {
+        const QString key = cell.toLower();
+        if (flatten.contains(key)) {
+            return nullptr;
+        }
+        const auto it = results.constFind(key);
+        return it != results.cend() && it->clean ? &*it : nullptr;
+    }
+};
+
+// Pin labels of a primitive by its letter.
+auto primitiveLabels(Labels &labels, QChar kind, qsizetype count)
+    -> QVector<int> {
+    QVector<int> ids;
+    ids.reserve(count);
+    const QString ds = QStringLiteral("drain|source");
+    for (qsizetype i = 0; i < count; ++i) {
+        int id = 0;
+        switch (kind.toLatin1()) {
+        case 'm': {
+            static const char *const names[] = {"drain", "gate", "source",
+                                                "bulk"};
+            const QString name = QString::fromLatin1(names[i % 4]);
+            id = (i == 0 || i == 2) ? labels.id(ds, ds, name)
+                                    : labels.id(name, name);
+            break;
+        }
+        case 'r':
+        case 'c':
+        case 'l': {
+            const QString ends = QStringLiteral("end_a|end_b");
+            id = labels.id(ends, ends,
+                           i == 0 ? QStringLiteral("end_a")
+                                  : QStringLiteral("end_b"));
+            break;
+        }
+        case 'd': {
+            const QString name = i == 0 ? QStringLiteral("anode")
+                                        : QStringLiteral("cathode");
+            id = labels.id(name, name);
+            break;
+        }
+        case 'q': {
+            static const char *const names[] = {"collector", "base",
+                                                "emitter", "substrate"};
+            const QString name = QString::fromLatin1(names[i % 4]);
+            id = labels.id(name, name);
+            break;
+        }
+        default:
+            id = labels.id(QStringLiteral("%1:%2").arg(kind).arg(i),
+                           QString::number(i + 1));
+            break;
+        }
+        ids.append(id);
+    }
+    return ids;
+}
+
+// Expands one side of a cell pair into its graph.
+class Builder {
+  public:
+    Builder(const SpiceNetlist &netlist, bool layout, Context &context,
+            Graph &graph)
+        : netlist_(netlist), layout_(layout), context_(context),
+          graph_(graph) {}
+
+    // Global pins follow the ports.
+    void build(const Cell &cell, const QStringList &globalPins);
+
+  private:
+    void expand(const Cell &cell, const QString &prefix,
+                const QVector<int> &ports, int depth);
+    void addDevice(const QString &name, const QString &deviceClass,
+                   const QVector<int> &labels, const QVector<int> &nets,
+                   const Element *element);
+
+    const SpiceNetlist &netlist_;
+    bool layout_;
+    Context &context_;
+    Graph &graph_;
+    QVector<QPair<int, int>> proxies_; // device, label
+};
+
+void Builder::build(const Cell &cell, const QStringList &globalPins) {
+    for (const QString &port : cell.ports + globalPins) {
+        graph_.ports.append(graph_.netFor(port.toLower(), port));
+    }
+    expand(cell, QString(), graph_.ports.mid(0, cell.ports.size()), 0);
+
+    // Proxy pins go on nets of their own, numbered on from the real ones
+    // and by cell in the order the cells were compared, as netgen does.
+    std::stable_sort(proxies_.begin(), proxies_.end(),
+                     [&](const auto &x, const auto &y) {
+                         const auto rank = [&](int device) {
+                             return context_.order.value(
+                                 graph_.devices.at(device)
+                                     .deviceClass.toLower());
+                         };
+                         return rank(x.first) < rank(y.first);
+                     });
+    for (const auto &proxy : std::as_const(proxies_)) {
+        const QString name =
+            QStringLiteral("dummy_%1").arg(graph_.nets.size() + 1);
+        const auto net = static_cast<int>(graph_.nets.size());
+        graph_.nets.append(Net{name, {}});
+        graph_.proxyNets.insert(net);
+        graph_.devices[proxy.first].pins.append(Pin{proxy.second, net});
+    }
+}
+
+void Builder::addDevice(const QString &name, const QString &deviceClass,
+                        const QVector<int> &labels, const QVector<int> &nets,
+                        const Element *element) {
+    Device device;
+    device.name = name;
+    device.deviceClass = deviceClass;
+    device.classKey = hashText(deviceClass);
+    device.element = element;
+    device.pins.reserve(nets.size());
+    for (qsizetype i = 0; i < nets.size(); ++i) {
+        device.pins.append(Pin{labels.at(i), nets.at(i)});
+    }
+    graph_.devices.append(std::move(device));
+}
+
+void Builder::expand(const Cell &cell, const QString &prefix,
+                     const QVector<int> &ports, int depth) {
+    QHash<QString, int> local;
+    for (qsizetype i = 0; i < cell.ports.size() && i < ports.size(); ++i) {
+        local.insert(cell.ports.at(i).toLower(), ports.at(i));
+    }
+    const QString lowerPrefix = prefix.toLower();
+    auto netOf = [&](const QString &name) {
+        const QString lower = name.toLower();
+        const auto it = local.constFind(lower);
+        if (it != local.cend()) {
+            return *it;
+        }
+        if (netlist_.isGlobal(name)) {
+            return graph_.netFor(lower, name);
+        }
+        return graph_.netFor(lowerPrefix + lower, prefix + name);
+    };
+
+    for (const Element &element : cell.elements) {
+        const QString name =
+            prefix + element.deviceClass + QLatin1Char(':') +
+            element.name.mid(1);
+        QVector<int> nets;
+        nets.reserve(element.nodes.size());
+        for (const QString &node : element.nodes) {
+            nets.append(netOf(node));
+        }
+        if (element.kind != QLatin1Char('x')) {
+            addDevice(name, element.deviceClass,
+                      primitiveLabels(context_.labels, element.kind,
+                                      nets.size()),
+                      nets, &element);
+            continue;
+        }
+
+        const Cell *child = netlist_.cell(element.deviceClass);
+        const CellResult *result = context_.blackBox(element.deviceClass);
+        if (child == nullptr && result == nullptr) {
+            QVector<int> labels;
+            for (qsizetype i = 0; i < nets.size(); ++i) {
+                labels.append(context_.labels.id(
+                    QStringLiteral("pin:%1").arg(i), QString::number(i + 1)));
+            }
+            addDevice(name, element.deviceClass, labels, nets, nullptr);
+            continue;
+        }
+        if (child == &cell || depth >= maxDepth) {
+            continue; // recursive definition
+        }
+        if (result == nullptr) {
+            // Ports the instance leaves open become nets of their own.
+            QVector<int> childPorts = nets.mid(0, child->ports.size());
+            const QString childPrefix = name + QLatin1Char('/');
+            for (qsizetype i = childPorts.size(); i < child->ports.size();
+                 ++i) {
+                const QString &port = child->ports.at(i);
+                childPorts.append(graph_.netFor(
+                    childPrefix.toLower() + port.toLower(),
+                    childPrefix + port));
+            }
+            expand(*child, childPrefix, childPorts, depth + 1);
+            continue;
+        }
+
+        const QVector<int> &portLabels =
+            layout_ ? result->labelsA : result->labelsB;
+        const qsizetype count = std::min(nets.size(), portLabels.size());
+        QVector<int> labels = portLabels.mid(0, count);
+        nets.resize(count);
+        for (const auto &global : layout_ ? result->globalsA
+                                          : result->globalsB) {
+            labels.append(global.second);
+            nets.append(graph_.netFor(global.first.toLower(), global.first));
+        }
+        addDevice(name, element.deviceClass, labels, nets, nullptr);
+        const auto device = static_cast<int>(graph_.devices.size() - 1);
+        for (const int proxy :
+             layout_ ? result->proxiesA : result->proxiesB) {
+            proxies_.append({device, proxy});
+        }
+    }
+}
+
+auto sortedPins(const Device &device) -> QVector<QPair<int, int>> {
+    QVector<QPair<int, int>> pins;
+    pins.reserve(device.pins.size());
+    for (const Pin &pin : device.pins) {
+        pins.append({pin.label, pin.net});
+    }
+    std::sort(pins.begin(), pins.end());
+    return pins;
+}
+
+using Parameters = QVector<QPair<QString, QString>>;
+
+// The parameter parallel copies of a primitive add up in, as netgen
+// merges them: a transistor's width, a capacitor's value, a resistor's or
+// inductor's inverse. Empty where only the count, m, adds up.
+auto additiveParameter(QChar kind) -> QString {
+    switch (kind.toLatin1()) {
+    case 'm':
+        return QStringLiteral("w");
+    case 'c':
+    case 'r':
+    case 'l':
+        return QStringLiteral("value");
+    default:
+        return {};
+    }
+}
+
+// The parameters parallel copies must share to be folded, sorted.
+auto sharedParameters(const Element &element) -> Parameters {
+    const QString additive = additiveParameter(element.kind);
+    Parameters shared;
+    for (const auto &parameter : element.parameters) {
+        if (parameter.first != additive &&
+            parameter.first != QStringLiteral("m")) {
+            shared.append(parameter);
+        }
+    }
+    std::sort(shared.begin(), shared.end());
+    return shared;
+}
+
+// A primitive's parameters with its parallel copies folded in: the
+// additive one summed over the copies, each taken m times, and m dropped.
+// Without an additive parameter, or if a value is not a number, m is
+// summed instead.
+auto foldedParameters(const Device &device) -> Parameters {
+    const Element &first = *device.element;
+    const QString additive = additiveParameter(first.kind);
+    const bool inverse = first.kind == QLatin1Char('r') ||
+                         first.kind == QLatin1Char('l');
+    const auto valueOf = [](const Element &element,
+                            const QString &name) -> std::optional<double> {
+        double value = 0.0;
+        for (const auto &parameter : element.parameters) {
+            if (parameter.first == name &&
+                SpiceNumber::parse(parameter.second, &value)) {
+                return value;
+            }
+        }
+        return std::nullopt;
+    };
+    double count = 0.0;
+    double sum = 0.0;
+    bool summed = !additive.isEmpty();
+    for (const Element *element :
+         QVector<const Element *>{&first} + device.parallel) {
+        const double m = valueOf(*element, QStringLiteral("m")).value_or(1.0);
+        const std::optional<double> value = valueOf(*element, additive);
+        count += m;
+        summed = summed && value && (!inverse || *value != 0.0);
+        if (summed) {
+            sum += m * (inverse ? 1.0 / *value : *value);
+        }
+    }
+    Parameters parameters;
+    for (const auto &parameter : first.parameters) {
+        if (parameter.first == QStringLiteral("m")) {
+            continue;
+        }
+        parameters.append(
+            summed && parameter.first == additive
+                ? qMakePair(additive,
+                            QString::number(inverse ? 1.0 / sum : sum, 'g',
+                                            12))
+                : parameter);
+    }
+    if (!summed) {
+        parameters.append(
+            {QStringLiteral("m"), QString::number(count, 'g', 12)});
+    }
+    return parameters;
+}
+
+// Folds primitives of one class on the same nets, pin for pin, and with
+// the same shared parameters, into the first of them, then drops the
+// folded ones and links nets to pins.
+void finishGraph(Graph &graph) {
+    QHash<quint64, QVector<int>> buckets;
+    QVector<QVector<QPair<int, int>>> signatures(graph.devices.size());
+    for (qsizetype d = 0; d < graph.devices.size(); ++d) {
+        Device &device = graph.devices[d];
+        if (device.element == nullptr) {
+            continue;
+        }
+        signatures[d] = sortedPins(device);
+        quint64 key = device.classKey;
+        for (const auto &pin : signatures.at(d)) {
+            key = combine(key, (quint64(pin.first) << 32) ^
+                                   quint64(quint32(pin.second)));
+        }
+        QVector<int> &bucket = buckets[key];
+        bool folded = false;
+        for (const int other : bucket) {
+            Device &into = graph.devices[other];
+            if (into.classKey == device.classKey &&
+                signatures.at(other) == signatures.at(d) &&
+                sharedParameters(*into.element) ==
+                    sharedParameters(*device.element)) {
+                into.parallel.append(device.element);
+                device.alive = false;
+                folded = true;
+                break;
+            }
+        }
+        if (!folded) {
+            bucket.append(static_cast<int>(d));
+        }
+    }
+
+    QVector<Device> devices;
+    devices.reserve(graph.devices.size());
+    for (Device &device : graph.devices) {
+        if (device.alive) {
+            devices.append(std::move(device));
+        }
+    }
+    graph.devices = std::move(devices);
+    for (qsizetype d = 0; d < graph.devices.size(); ++d) {
+        const QVector<Pin> &pins = graph.devices.at(d).pins;
+        for (qsizetype p = 0; p < pins.size(); ++p) {
+            graph.nets[pins.at(p).net].pins.append(
+                {static_cast<int>(d), static_cast<int>(p)});
+        }
+    }
+}
+
+// Colors of both sides, refined together.
+class Refinement {
+  public:
+    Refinement(const Graph &a, const Graph &b, const Labels &labels)
+        : graphs_{&a, &b}, labels_(labels) {
+        const Color net = hashText(QStringLiteral("net"));
+        for (int s = 0; s < 2; ++s) {
+            const Graph &graph = *graphs_[s];
+            nets_[s].fill(net, graph.nets.size());
+            badNets_[s].fill(false, graph.nets.size());
+            proxyNets_[s].fill(false, graph.nets.size());
+            for (const int proxy : graph.proxyNets) {
+                proxyNets_[s][proxy] = true;
+            }
+            devices_[s].resize(graph.devices.size());
+            for (qsizetype d = 0; d < graph.devices.size(); ++d) {
+                devices_[s][d] = graph.devices.at(d).classKey;
+            }
+            badDevices_[s].fill(false, graph.devices.size());
+        }
+    }
+
+    void run();
+    // Nodes whose class has more members on one side.
+    auto badNets(int side) const -> const QVector<bool> & {
+        return badNets_[side];
+    }
+    auto badDevices(int side) const -> const QVector<bool> & {
+        return badDevices_[side];
+    }
+    auto netColor(int side, int net) const -> Color {
+        return nets_[side].at(net);
+    }
+    auto deviceColor(int side, int device) const -> Color {
+        return devices_[side].at(device);
+    }
+
+  private:
+    // One step for nets (or devices): rehash from the other kind, then
+    // settle. True if a node froze or thawed; classes counts the new
+    // colors.
+    auto step(bool nets, qsizetype *classes) -> bool;
+    // Nodes whose new class is unbalanced keep (or go back to) their
+    // current color and are bad; the others take the new one. A frozen
+    // class goes on rehashing, so its members that pair up across the
+    // sides thaw and only the odd ones stay bad. Pinned nodes, when
+    // given, stay frozen and are not counted.
+    static auto settle(std::array<QVector<Color>, 2> &next,
+                       std::array<QVector<bool>, 2> &bad,
+                       const std::array<QVector<Color>, 2> &current,
+                       const std::array<QVector<bool>, 2> *pinned,
+                       qsizetype *classes) -> bool;
+    // A device with no pin on a matched net is not matched either:
+    // nothing ties it to its counterpart.
+    void markUnanchored();
+    // Devices alone in their class on both sides are each other's
+    // counterpart, so their pins of one role must reach corresponding
+    // nets. If they join one bad net to two on the other side, they are
+    // not counterparts after all, and both are bad.
+    void markCrossedPairs();
+
+    std::array<const Graph *, 2> graphs_;
+    const Labels &labels_;
+    std::array<QVector<Color>, 2> nets_;
+    std::array<QVector<Color>, 2> devices_;
+    std::array<QVector<bool>, 2> badNets_;
+    std::array<QVector<bool>, 2> badDevices_;
+    std::array<QVector<bool>, 2> proxyNets_;
+};
+
+auto Refinement::settle(std::array<QVector<Color>, 2> &next,
+                        std::array<QVector<bool>, 2> &bad,
+                        const std::array<QVector<Color>, 2> &current,
+                        const std::array<QVector<bool>, 2> *pinned,
+                        qsizetype *classes) -> bool {
+    const auto isPinned = [&](int s, qsizetype i) {
+        return pinned != nullptr && (*pinned)[s].at(i);
+    };
+    QHash<Color, QPair<qsizetype, qsizetype>> counts;
+    counts.reserve(next[0].size() + next[1].size());
+    for (int s = 0; s < 2; ++s) {
+        for (qsizetype i = 0; i < next[s].size(); ++i) {
+            if (!isPinned(s, i)) {
+                auto &count = counts[next[s].at(i)];
+                ++(s == 0 ? count.first : count.second);
+            }
+        }
+    }
+    bool changed = false;
+    for (int s = 0; s < 2; ++s) {
+        for (qsizetype i = 0; i < next[s].size(); ++i) {
+            const auto count = counts.value(next[s].at(i));
+            const bool unbalanced =
+                isPinned(s, i) || count.first != count.second;
+            if (unbalanced) {
+                next[s][i] = current[s].at(i);
+            }
+            if (unbalanced != bad[s].at(i)) {
+                bad[s][i] = unbalanced;
+                changed = true;
+            }
+        }
+    }
+    *classes = counts.size();
+    return changed;
+}
+
+auto Refinement::step(bool nets, qsizetype *classes) -> bool {
+    std::array<QVector<Color>, 2> next;
+    for (int s = 0; s < 2; ++s) {
+        const Graph &graph = *graphs_[s];
+        const QVector<Color> &own = nets ? nets_[s] : devices_[s];
+        const QVector<Color> &other = nets ? devices_[s] : nets_[s];
+        next[s].resize(own.size());
+        Color *out = next[s].data();
+        // The sum makes the pins an unordered multiset.
+        parallelFor(own.size(), [&](qsizetype begin, qsizetype end) {
+            for (qsizetype i = begin; i < end; ++i) {
+                quint64 sum = 0;
+                if (nets) {
+                    for (const auto &pin : graph.nets.at(i).pins) {
+                        const Pin &at =
+                            graph.devices.at(pin.first).pins.at(pin.second);
+                        sum += combine(labels_.hash(at.label),
+                                       other.at(pin.first));
+                    }
+                } else {
+                    for (const Pin &pin : graph.devices.at(i).pins) {
+                        sum += combine(labels_.hash(pin.label),
+                                       other.at(pin.net));
+                    }
+                }
+                out[i] = combine(own.at(i), splitmix(sum));
+            }
+        });
+    }
+    std::array<QVector<Color>, 2> &current = nets ? nets_ : devices_;
+    const bool changed =
+        settle(next, nets ? badNets_ : badDevices_, current,
+               nets ? &proxyNets_ : nullptr, classes);
+    current = std::move(next);
+    return changed;
+}
+
+void Refinement::run() {
+    OPENSVS_TRACE_SCOPE("NetlistComparator refine", "parser");
+    qsizetype nodes = 0;
+    for (int s = 0; s < 2; ++s) {
+        nodes += nets_[s].size() + devices_[s].size();
+    }
+    qsizetype distinct = 0;
+    for (qsizetype round = 0; round <= nodes; ++round) {
+        qsizetype netClasses = 0;
+        qsizetype deviceClasses = 0;
+        const bool netsChanged = step(true, &netClasses);
+        const bool devicesChanged = step(false, &deviceClasses);
+        if (!netsChanged && !devicesChanged &&
+            netClasses + deviceClasses == distinct) {
+            break;
+        }
+        distinct = netClasses + deviceClasses;
+    }
+    markUnanchored();
+    markCrossedPairs();
+}
+
+void Refinement::markUnanchored() {
+    for (int s = 0; s < 2; ++s) {
+        const Graph &graph = *graphs_[s];
+        for (qsizetype d = 0; d < graph.devices.size(); ++d) {
+            const QVector<Pin> &pins = graph.devices.at(d).pins;
+            if (!pins.isEmpty() &&
+                std::all_of(pins.cbegin(), pins.cend(), [&](const Pin &pin) {
+                    return badNets_[s].at(pin.net);
+                })) {
+                badDevices_[s][d] = true;
+            }
+        }
+    }
+}
+
+void Refinement::markCrossedPairs() {
+    QHash<Color, std::array<QVector<int>, 2>> byColor;
+    for (int s = 0; s < 2; ++s) {
+        for (qsizetype d = 0; d < devices_[s].size(); ++d) {
+            if (!badDevices_[s].at(d)) {
+                byColor[devices_[s].at(d)][s].append(static_cast<int>(d));
+            }
+        }
+    }
+    // Bad nets, other than proxy nets, by the role of the one pin of that
+    // role on the device.
+    auto badPins = [&](int s, int d) {
+        QHash<quint64, int> nets;
+        QSet<quint64> repeated;
+        for (const Pin &pin : graphs_[s]->devices.at(d).pins) {
+            const quint64 role = labels_.hash(pin.label);
+            if (nets.contains(role)) {
+                repeated.insert(role);
+            }
+            nets.insert(role, pin.net);
+        }
+        for (auto it = nets.begin(); it != nets.end();) {
+            if (repeated.contains(it.key()) || !badNets_[s].at(*it) ||
+                proxyNets_[s].at(*it)) {
+                it = nets.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return nets;
+    };
+    for (const auto &members : std::as_const(byColor)) {
+        if (members[0].size() != 1 || members[1].size() != 1) {
+            continue;
+        }
+        const int a = members[0].first();
+        const int b = members[1].first();
+        const QHash<quint64, int> pinsA = badPins(0, a);
+        const QHash<quint64, int> pinsB = badPins(1, b);
+        std::array<QHash<int, int>, 2> counterpart; // net -> other side's
+        bool crossed = false;
+        for (auto it = pinsA.cbegin(); it != pinsA.cend() && !crossed; ++it) {
+            const auto other = pinsB.constFind(it.key());
+            if (other == pinsB.cend()) {
+                continue;
+            }
+            const std::array<int, 2> nets{*it, *other};
+            for (int s = 0; s < 2; ++s) {
+                const int seen = counterpart[s].value(nets[s], nets[1 - s]);
+                crossed = crossed || seen != nets[1 - s];
+                counterpart[s].insert(nets[s], seen);
+            }
+        }
+        if (crossed) {
+            badDevices_[0][a] = true;
+            badDevices_[1][b] = true;
+        }
+    }
+}
+
+// The file's top level, else its last subcircuit no other one uses.
+auto topCell(const SpiceNetlist &netlist) -> const Cell * {
+    if (!netlist.top().elements.isEmpty()) {
+        return &netlist.top();
+    }
+    QSet<QString> used;
+    for (const Cell &cell : netlist.cells()) {
+        for (const Element &element : cell.elements) {
+            if (element.kind == QLatin1Char('x')) {
+                used.insert(element.deviceClass.toLower());
+            }
+        }
+    }
+    for (auto it = netlist.cells().crbegin(); it != netlist.cells().crend();
+         ++it) {
+        if (!used.contains(it->name.toLower())) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+// The most nodes on an instance of each subcircuit name, lower-case.
+auto instancePins(const SpiceNetlist &netlist) -> QHash<QString, qsizetype> {
+    QHash<QString, qsizetype> pins;
+    auto scan = [&](const Cell &cell) {
+        for (const Element &element : cell.elements) {
+            if (element.kind == QLatin1Char('x')) {
+                qsizetype &most = pins[element.deviceClass.toLower()];
+                most = std::max(most, element.nodes.size());
+            }
+        }
+    };
+    scan(netlist.top());
+    for (const Cell &cell : netlist.cells()) {
+        scan(cell);
+    }
+    return pins;
+}
+
+class Comparison {
+  public:
+    Comparison(const SpiceNetlist &layout, const SpiceNetlist &schematic,
+               const NetlistComparator::Options &options)
+        : layout_(layout), schematic_(schematic), globalsA_(layout),
+          globalsB_(schematic),
+          instancePins_{instancePins(layout), instancePins(schematic)},
+          records_(options.records) {
+        for (const QString &cell : options.flatten) {
+            context_.flatten.insert(cell.toLower());
+        }
+        QStringList flatten(context_.flatten.cbegin(),
+                            context_.flatten.cend());
+        flatten.sort();
+        if (options.previous != nullptr &&
+            options.previous->flatten == flatten) {
+            previous_ = options.previous->cells; // records_ may alias it
+        }
+        if (options.previous != nullptr || records_ != nullptr) {
+            hashesA_ = SubcktHashes(layout);
+            hashesB_ = SubcktHashes(schematic);
+        }
+        if (records_ != nullptr) {
+            *records_ = Records();
+            records_->flatten = flatten;
+        }
+    }
+
+    auto run(const Cell &a, const Cell &b) -> QJsonArray {
+        visit(a, b, 0);
+        return circuits_;
+    }
+
+  private:
+    void visit(const Cell &a, const Cell &b, int depth);
+    void pairedBelow(const SpiceNetlist &netlist, const Cell &cell,
+                     const SpiceNetlist &other, QStringList &out,
+                     QSet<QString> &seen, int depth) const;
+    // A cell one side defines and the other only instantiates, kept a
+    // black box on both.
+    void blackBox(const QString &key);
+    // Declared globals the cell gets pins for; none at the file's top.
+    auto globalPins(const Cell &cell, bool layout) -> QStringList;
+    auto compareCell(const Cell &a, const Cell &b, int depth) -> QJsonObject;
+    auto reusable(const Cell &a, const Cell &b) -> const CellRecord *;
+    // How the pair appears in its parents, and its record.
+    void remember(const Cell &a, const Cell &b, const QJsonObject &circuit,
+                  const QVector<int> &portPairs, bool clean, bool reused);
+
+    const SpiceNetlist &layout_;
+    const SpiceNetlist &schematic_;
+    Context context_;
+    GlobalUse globalsA_;
+    GlobalUse globalsB_;
+    std::array<QHash<QString, qsizetype>, 2> instancePins_;
+    SubcktHashes hashesA_;
+    SubcktHashes hashesB_;
+    QHash<QString, CellRecord> previous_;
+    Records *records_;
+    QSet<QString> visited_; // lower-case cell names
+    QJsonArray circuits_;
+};
+
+// Subcircuits with a namesake on the other side, or that it instantiates
+// without defining, looking through the cells that will be flattened.
+void Comparison::pairedBelow(const SpiceNetlist &netlist, const Cell &cell,
+                             const SpiceNetlist &other, QStringList &out,
+                             QSet<QString> &seen, int depth) const {
+    if (depth > maxDepth) {
+        return;
+    }
+    const auto &otherInstances = instancePins_[&other == &layout_ ? 0 : 1];
+    for (const Element &element : cell.elements) {
+        if (element.kind != QLatin1Char('x')) {
+            continue;
+        }
+        const QString key = element.deviceClass.toLower();
+        const Cell *child = netlist.cell(key);
+        if (child == nullptr || child == &cell || seen.contains(key)) {
+            continue;
+        }
+        seen.insert(key);
+        const bool flattened = context_.flatten.contains(key);
+        if ((other.cell(key) != nullptr || otherInstances.contains(key)) &&
+            !flattened) {
+            out.append(key);
+        } else {
+            pairedBelow(netlist, *child, other, out, seen, depth + 1);
+        }
+    }
+}
+
+void Comparison::visit(const Cell &a, const Cell &b, int depth) {
+    visited_.insert(a.name.toLower());
+    QStringList children;
+    QSet<QString> seen;
+    pairedBelow(layout_, a, schematic_, children, seen, 0);
+    pairedBelow(schematic_, b, layout_, children, seen, 0);
+    for (const QString &child : children) {
+        if (visited_.contains(child) || depth >= maxDepth) {
+            continue;
+        }
+        const Cell *childA = layout_.cell(child);
+        const Cell *childB = schematic_.cell(child);
+        if (childA != nullptr && childB != nullptr) {
+            visit(*childA, *childB, depth + 1);
+        } else {
+            blackBox(child);
+        }
+    }
+    // The children are visited anyway: a reused pair that is not clean is
+    // flattened into its parents, which then need its children's results.
+    if (const CellRecord *record = reusable(a, b)) {
+        circuits_.append(record->circuit);
+        remember(a, b, record->circuit, record->portPairs, record->clean,
+                 true);
+        return;
+    }
+    circuits_.append(compareCell(a, b, depth));
+}
+
+void Comparison::blackBox(const QString &key) {
+    visited_.insert(key);
+    const bool layout = layout_.cell(key) != nullptr;
+    const Cell &cell = *(layout ? layout_ : schematic_).cell(key);
+    // Where the cell is not defined netgen numbers its pins.
+    QStringList numbered;
+    const qsizetype count = instancePins_[layout ? 1 : 0].value(key);
+    for (qsizetype i = 0; i < count; ++i) {
+        numbered.append(QString::number(i + 1));
+    }
+    Labels &labels = context_.labels;
+    CellResult result;
+    result.clean = true;
+    QVector<int> &own = layout ? result.labelsA : result.labelsB;
+    QVector<int> &other = layout ? result.labelsB : result.labelsA;
+    QVector<int> &ownProxies = layout ? result.proxiesA : result.proxiesB;
+    QVector<int> &otherProxies = layout ? result.proxiesB : result.proxiesA;
+    other.fill(-1, numbered.size());
+    for (qsizetype i = 0; i < cell.ports.size(); ++i) {
+        const QString &port = cell.ports.at(i);
+        own.append(labels.id(QStringLiteral("box:%1:%2").arg(key).arg(i),
+                             port));
+        const qsizetype j = numbered.indexOf(port);
+        if (j >= 0 && other.at(j) < 0) {
+            other[j] = own.last();
+        } else {
+            otherProxies.append(labels.alias(
+                own.last(), QStringLiteral("boxproxy:%1:%2").arg(key).arg(i),
+                QStringLiteral("proxy") + port));
+        }
+    }
+    for (qsizetype j = 0; j < numbered.size(); ++j) {
+        if (other.at(j) >= 0) {
+            continue;
+        }
+        other[j] = labels.id(QStringLiteral("box:%1:n%2").arg(key).arg(j),
+                             numbered.at(j));
+        ownProxies.append(labels.alias(
+            other.at(j), QStringLiteral("boxproxy:%1:n%2").arg(key).arg(j),
+            QStringLiteral("proxy") + numbered.at(j)));
+    }
+    context_.results.insert(key, result);
+    context_.order.insert(key, static_cast<int>(context_.order.size()));
+}
+
+auto Comparison::globalPins(const Cell &cell, bool layout) -> QStringList {
+    if (&cell == &(layout ? layout_ : schematic_).top()) {
+        return {};
+    }
+    return (layout ? globalsA_ : globalsB_).of(cell);
+}
+
+auto Comparison::reusable(const Cell &a, const Cell &b)
+    -> const CellRecord * {
+    const auto it = previous_.constFind(a.name.toLower());
+    if (it == previous_.cend()) {
+        return nullptr;
+    }
+    const QByteArray hashA = hashesA_.hash(a.name);
+    return !hashA.isEmpty() && it->layoutHash == hashA &&
+                   it->schematicHash == hashesB_.hash(b.name) &&
+                   it->portPairs.size() ==
+                       b.ports.size() + globalPins(b, false).size()
+               ? &*it
+               : nullptr;
+}
+
+void Comparison::remember(const Cell &a, const Cell &b,
+                          const QJsonObject &circuit,
+                          const QVector<int> &portPairs, bool clean,
+                          bool reused) {
+    Labels &labels = context_.labels;
+    const QString cellKey = a.name.toLower();
+    const QStringList globalsA = globalPins(a, true);
+    const QStringList globalsB = globalPins(b, false);
+    const QStringList pinsA = a.ports + globalsA;
+    const QStringList pinsB = b.ports + globalsB;
+    QVector<int> labelsA;
+    for (qsizetype i = 0; i < pinsA.size(); ++i) {
+        labelsA.append(labels.id(
+            QStringLiteral("port:%1:%2").arg(cellKey).arg(i), pinsA.at(i)));
+    }
+    QVector<int> labelsB;
+    QVector<bool> pairedA(pinsA.size(), false);
+    CellResult result;
+    result.clean = clean;
+    for (qsizetype j = 0; j < pinsB.size(); ++j) {
+        const int pair = portPairs.value(j, -1);
+        if (pair >= 0 && pair < labelsA.size()) {
+            labelsB.append(labelsA.at(pair));
+            pairedA[pair] = true;
+            continue;
+        }
+        labelsB.append(labels.id(
+            QStringLiteral("port:%1:b%2").arg(cellKey).arg(j), pinsB.at(j)));
+        result.proxiesA.append(labels.alias(
+            labelsB.last(), QStringLiteral("proxy:%1:b%2").arg(cellKey).arg(j),
+            QStringLiteral("proxy") + pinsB.at(j)));
+    }
+    for (qsizetype i = 0; i < pinsA.size(); ++i) {
+        if (!pairedA.at(i)) {
+            result.proxiesB.append(labels.alias(
+                labelsA.at(i),
+                QStringLiteral("proxy:%1:%2").arg(cellKey).arg(i),
+                QStringLiteral("proxy") + pinsA.at(i)));
+        }
+    }
+    result.labelsA = labelsA.mid(0, a.ports.size());
+    result.labelsB = labelsB.mid(0, b.ports.size());
+    for (qsizetype i = 0; i < globalsA.size(); ++i) {
+        result.globalsA.append(
+            {globalsA.at(i), labelsA.at(a.ports.size() + i)});
+    }
+    for (qsizetype j = 0; j < globalsB.size(); ++j) {
+        result.globalsB.append(
+            {globalsB.at(j), labelsB.at(b.ports.size() + j)});
+    }
+    context_.results.insert(cellKey, result);
+    if (!context_.order.contains(cellKey)) {
+        context_.order.insert(cellKey,
+                              static_cast<int>(context_.order.size()));
+    }
+    if (records_ != nullptr) {
+        CellRecord record;
+        record.layoutHash = hashesA_.hash(a.name);
+        record.schematicHash = hashesB_.hash(b.name);
+        record.circuit = circuit;
+        record.portPairs = portPairs;
+        record.clean = clean;
+        record.reused = reused;
+        records_->cells.insert(cellKey, record);
+    }
+}
+
+auto Comparison::compareCell(const Cell &a, const Cell &b, int depth)
+    -> QJsonObject {
+    Tracer::Span span("NetlistComparator::compareCell", "parser");
+    span.setDetail(a.name);
+    const QStringList pinsA = a.ports + globalPins(a, true);
+    const QStringList pinsB = b.ports + globalPins(b, false);
+    std::array<Graph, 2> graphs;
+    Builder(layout_, true, context_, graphs[0])
+        .build(a, pinsA.mid(a.ports.size()));
+    Builder(schematic_, false, context_, graphs[1])
+        .build(b, pinsB.mid(b.ports.size()));
+    for (Graph &graph : graphs) {
+        finishGraph(graph);
+    }
+    Refinement refinement(graphs[0], graphs[1], context_.labels);
+    refinement.run();
+    Labels &labels = context_.labels;
+
+    QJsonObject circuit;
+    circuit.insert(QStringLiteral("name"), QJsonArray{a.name, b.name});
+
+    // Device counts per class, in first-seen order.
+    QJsonArray devices;
+    std::array<QHash<QString, qsizetype>, 2> classCounts;
+    for (int s = 0; s < 2; ++s) {
+        QStringList order;
+        QHash<QString, QString> spelling;
+        for (const Device &device : graphs[s].devices) {
+            const QString key = device.deviceClass.toLower();
+            if (!classCounts[s].contains(key)) {
+                order.append(key);
+                spelling.insert(key, device.deviceClass);
+            }
+            ++classCounts[s][key];
+        }
+        QJsonArray rows;
+        for (const QString &key : order) {
+            rows.append(QJsonArray{spelling.value(key),
+                                   classCounts[s].value(key)});
+        }
+        devices.append(rows);
+    }
+    circuit.insert(QStringLiteral("devices"), devices);
+    circuit.insert(QStringLiteral("nets"),
+                   QJsonArray{graphs[0].nets.size(), graphs[1].nets.size()});
+
+    // Bad nodes grouped by color, groups in first-seen order, the shorter
+    // side padded as netgen pads it.
+    auto groups = [](const std::array<QVector<bool>, 2> &bad,
+                     const auto &colorOf) {
+        QVector<Color> order;
+        QHash<Color, std::array<QVector<int>, 2>> members;
+        for (int s = 0; s < 2; ++s) {
+            for (qsizetype i = 0; i < bad[s].size(); ++i) {
+                if (!bad[s].at(i)) {
+                    continue;
+                }
+                const Color color = colorOf(s, static_cast<int>(i));
+                if (!members.contains(color)) {
+                    order.append(color);
+                }
+                members[color][s].append(static_cast<int>(i));
+            }
+        }
+        QVector<std::array<QVector<int>, 2>> result;
+        for (const Color color : order) {
+            result.append(members.value(color));
+        }
+        return result;
+    };
+
+    bool clean = true;
+    QJsonArray badnets;
+    const auto netGroups = groups(
+        {refinement.badNets(0), refinement.badNets(1)},
+        [&](int s, int i) { return refinement.netColor(s, i); });
+    for (const auto &group : netGroups) {
+        const qsizetype rows = std::max(group[0].size(), group[1].size());
+        QJsonArray sides;
+        for (int s = 0; s < 2; ++s) {
+            const Graph &graph = graphs[s];
+            QJsonArray nets;
+            for (const int n : group[s]) {
+                QVector<QPair<QString, int>> keys;
+                QVector<int> counts;
+                for (const auto &pin : graph.nets.at(n).pins) {
+                    const Device &device = graph.devices.at(pin.first);
+                    const int label = device.pins.at(pin.second).label;
+                    const QPair<QString, int> key{device.deviceClass, label};
+                    const qsizetype at = keys.indexOf(key);
+                    if (at < 0) {
+                        keys.append(key);
+                        counts.append(1);
+                    } else {
+                        ++counts[at];
+                    }
+                }
+                QJsonArray pins;
+                for (qsizetype k = 0; k < keys.size(); ++k) {
+                    pins.append(QJsonArray{keys.at(k).first,
+                                           labels.group(keys.at(k).second),
+                                           counts.at(k)});
+                }
+                nets.append(QJsonArray{graph.nets.at(n).name, pins});
+            }
+            while (nets.size() < rows) {
+                nets.append(QJsonArray{
+                    noMatchingNet,
+                    QJsonArray{QJsonArray{QString(), QString(), 0}}});
+            }
+            sides.append(nets);
+        }
+        badnets.append(sides);
+        clean = false;
+    }
+    circuit.insert(QStringLiteral("badnets"), badnets);
+
+    QJsonArray badelements;
+    const auto deviceGroups = groups(
+        {refinement.badDevices(0), refinement.badDevices(1)},
+        [&](int s, int i) { return refinement.deviceColor(s, i); });
+    for (const auto &group : deviceGroups) {
+        const qsizetype rows = std::max(group[0].size(), group[1].size());
+        QJsonArray sides;
+        for (int s = 0; s < 2; ++s) {
+            const Graph &graph = graphs[s];
+            QJsonArray elements;
+            for (const int d : group[s]) {
+                const Device &device = graph.devices.at(d);
+                QJsonArray pins;
+                QSet<int> listed;
+                for (const Pin &pin : device.pins) {
+                    if (listed.contains(pin.label)) {
+                        continue;
+                    }
+                    listed.insert(pin.label);
+                    pins.append(QJsonArray{
+                        labels.first(pin.label),
+                        graph.nets.at(pin.net).pins.size()});
+                }
+                elements.append(QJsonArray{device.name, pins});
+            }
+            while (elements.size() < rows) {
+                elements.append(
+                    QJsonArray{noMatchingInstance,
+                               QJsonArray{QJsonArray{QString(), 0}}});
+            }
+            sides.append(elements);
+        }
+        badelements.append(sides);
+        clean = false;
+    }
+    circuit.insert(QStringLiteral("badelements"), badelements);
+    clean = clean && classCounts[0] == classCounts[1] &&
+            graphs[0].nets.size() == graphs[1].nets.size();
+
+    // Matched primitives, paired within a class by name; as in netgen,
+    // only once the topology matches.
+    QJsonArray properties;
+    std::array<QHash<Color, QVector<int>>, 2> byColor;
+    QVector<Color> colorOrder;
+    for (int s = 0; clean && s < 2; ++s) {
+        for (qsizetype d = 0; d < graphs[s].devices.size(); ++d) {
+            const Device &device = graphs[s].devices.at(d);
+            if (device.element == nullptr) {
+                continue;
+            }
+            const Color color =
+                refinement.deviceColor(s, static_cast<int>(d));
+            if (s == 0 && !byColor[0].contains(color)) {
+                colorOrder.append(color);
+            }
+            byColor[s][color].append(static_cast<int>(d));
+        }
+    }
+    for (const Color color : colorOrder) {
+        std::array<QVector<int>, 2> members{byColor[0].value(color),
+                                            byColor[1].value(color)};
+        if (members[0].size() != members[1].size()) {
+            continue;
+        }
+        for (int s = 0; s < 2; ++s) {
+            std::sort(members[s].begin(), members[s].end(),
+                      [&](int x, int y) {
+                          return graphs[s].devices.at(x).name <
+                                 graphs[s].devices.at(y).name;
+                      });
+        }
+        for (qsizetype i = 0; i < members[0].size(); ++i) {
+            const Device &da = graphs[0].devices.at(members[0].at(i));
+            const Device &db = graphs[1].devices.at(members[1].at(i));
+            // Once either side folded parallel copies, both compare sums.
+            const bool folded =
+                !da.parallel.isEmpty() || !db.parallel.isEmpty();
+            const Parameters parametersA =
+                folded ? foldedParameters(da) : da.element->parameters;
+            const Parameters parametersB =
+                folded ? foldedParameters(db) : db.element->parameters;
+            QHash<QString, QString> valuesB;
+            for (const auto &parameter : parametersB) {
+                valuesB.insert(parameter.first, parameter.second);
+            }
+            QJsonArray paramsA;
+            QJsonArray paramsB;
+            QSet<QString> namesA;
+            for (const auto &parameter : parametersA) {
+                namesA.insert(parameter.first);
+                const auto it = valuesB.constFind(parameter.first);
+                if (it == valuesB.cend()) {
+                    paramsA.append(
+                        QJsonArray{parameter.first, parameter.second});
+                    paramsB.append(
+                        QJsonArray{noMatchingParameter, noValue});
+                } else if (*it != parameter.second) {
+                    paramsA.append(
+                        QJsonArray{parameter.first, parameter.second});
+                    paramsB.append(QJsonArray{parameter.first, *it});
+                }
+            }
+            for (const auto &parameter : parametersB) {
+                if (!namesA.contains(parameter.first)) {
+                    paramsA.append(
+                        QJsonArray{noMatchingParameter, noValue});
+                    paramsB.append(
+                        QJsonArray{parameter.first, parameter.second});
+                }
+            }
+            if (!paramsA.isEmpty()) {
+                properties.append(QJsonArray{QJsonArray{da.name, paramsA},
+                                             QJsonArray{db.name, paramsB}});
+            }
+        }
+    }
+    if (!properties.isEmpty()) {
+        circuit.insert(QStringLiteral("properties"), properties);
+    }
+
+    // Ports paired by color and name, then color, then name.
+    const QVector<int> &portsA = graphs[0].ports;
+    const QVector<int> &portsB = graphs[1].ports;
+    QVector<int> pairOfA(portsA.size(), -1);
+    QVector<int> pairOfB(portsB.size(), -1);
+    auto pairPorts = [&](bool byColor, bool byName) {
+        for (qsizetype i = 0; i < portsA.size(); ++i) {
+            for (qsizetype j = 0; j < portsB.size() && pairOfA.at(i) < 0;
+                 ++j) {
+                if (pairOfB.at(j) >= 0 ||
+                    (byColor && refinement.netColor(0, portsA.at(i)) !=
+                                    refinement.netColor(1, portsB.at(j))) ||
+                    (byName && pinsA.at(i).compare(
+                                   pinsB.at(j), Qt::CaseInsensitive) != 0)) {
+                    continue;
+                }
+                pairOfA[i] = static_cast<int>(j);
+                pairOfB[j] = static_cast<int>(i);
+            }
+        }
+    };
+    pairPorts(true, true);
+    pairPorts(true, false);
+    pairPorts(false, true);
+
+    QJsonArray pinRowsA;
+    QJsonArray pinRowsB;
+    for (qsizetype i = 0; i < portsA.size(); ++i) {
+        pinRowsA.append(pinsA.at(i));
+        pinRowsB.append(pairOfA.at(i) >= 0 ? pinsB.at(pairOfA.at(i))
+                                           : noMatchingPin);
+    }
+    for (qsizetype j = 0; j < portsB.size(); ++j) {
+        if (pairOfB.at(j) < 0) {
+            pinRowsA.append(noMatchingPin);
+            pinRowsB.append(pinsB.at(j));
+        }
+    }
+    // As netgen, a subcircuit that fails lists no pins.
+    if (!pinRowsA.isEmpty() && (clean || depth == 0)) {
+        circuit.insert(QStringLiteral("pins"),
+                       QJsonArray{pinRowsA, pinRowsB});
+    }
+    remember(a, b, circuit, pairOfB, clean, false);
+    return circuit;
+}
+} // namespace
+
+NetlistComparator::Options::Options() = default;
+
+auto NetlistComparator::compare(const SpiceNetlist &layout,
+                                const SpiceNetlist &schematic,
+                                const Options &options, QString *error)
+    -> QJsonArray {
+    OPENSVS_TRACE_SCOPE("NetlistComparator::compare", "parser");
+    auto pick = [&](const SpiceNetlist &netlist, const QString &name)
+        -> const Cell * {
+        if (name.isEmpty()) {
+            return topCell(netlist);
+        }
+        if (name.compare(netlist.top().name, Qt::CaseInsensitive) == 0) {
+            return &netlist.top();
+        }
+        return netlist.cell(name);
+    };
+    const Cell *a = pick(layout, options.layoutCell);
+    const Cell *b = pick(schematic, options.schematicCell);
+    if (a == nullptr || b == nullptr) {
+        if (error != nullptr) {
+            const bool missingA = a == nullptr;
+            const QString name =
+                missingA ? options.layoutCell : options.schematicCell;
+            const QString file = missingA ? layout.top().name
+                                          : schematic.top().name;
+            *error = name.isEmpty()
+                         ? QStringLiteral("%1: no cell to compare").arg(file)
+                         : QStringLiteral("%1: no cell %2").arg(file, name);
+        }
+        return {};
+    }
+    return Comparison(layout, schematic, options).run(*a, *b);
+}
+
+auto NetlistComparator::compareFiles(const QString &layoutPath,
+                                     const QString &schematicPath,
+                                     const Options &options, QString *error)
+    -> QJsonArray {
+    SpiceNetlist layout;
+    SpiceNetlist schematic;
+    if (!layout.load(layoutPath, error) ||
+        !schematic.load(schematicPath, error)) {
+        return {};
+    }
+    return compare(layout, schematic, options, error);
+}
+
+auto NetlistComparator::Records::load(const QString &path, QString *error)
+    -> bool {
+    OPENSVS_TRACE_SCOPE("NetlistComparator::Records::load", "parser");
+    *this = Records();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error != nullptr) {
+            *error = QStringLiteral("Failed to open file: %1").arg(path);
+        }
+        return false;
+    }
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value(QStringLiteral("format")).toString() != recordsFormat) {
+        if (error != nullptr) {
+            *error = QStringLiteral("%1: not a netlist record file").arg(path);
+        }
+        return false;
+    }
+    for (const QJsonValueConstRef &cell :
+         root.value(QStringLiteral("flatten")).toArray()) {
+        flatten.append(cell.toString());
+    }
+    const QJsonObject entries = root.value(QStringLiteral("cells")).toObject();
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        const QJsonObject entry = it.value().toObject();
+        CellRecord record;
+        record.layoutHash = QByteArray::fromHex(
+            entry.value(QStringLiteral("layout_hash")).toString().toLatin1());
+        record.schematicHash =
+            QByteArray::fromHex(entry.value(QStringLiteral("schematic_hash"))
+                                    .toString()
+                                    .toLatin1());
+        record.circuit = entry.value(QStringLiteral("circuit")).toObject();
+        for (const QJsonValueConstRef &pair :
+             entry.value(QStringLiteral("port_pairs")).toArray()) {
+            record.portPairs.append(pair.toInt(-1));
+        }
+        record.clean = entry.value(QStringLiteral("clean")).toBool();
+        if (!record.layoutHash.isEmpty() && !record.circuit.isEmpty()) {
+            cells.insert(it.key(), record);
+        }
+    }
+    return true;
+}
+
+auto NetlistComparator::Records::save(const QString &path,
+                                      QString *error) const -> bool {
+    OPENSVS_TRACE_SCOPE("NetlistComparator::Records::save", "parser");
+    QJsonObject entries;
+    for (auto it = cells.cbegin(); it != cells.cend(); ++it) {
+        QJsonArray pairs;
+        for (const int pair : it->portPairs) {
+            pairs.append(pair);
+        }
+        QJsonObject entry;
+        entry.insert(QStringLiteral("layout_hash"),
+                     QString::fromLatin1(it->layoutHash.toHex()));
+        entry.insert(QStringLiteral("schematic_hash"),
+                     QString::fromLatin1(it->schematicHash.toHex()));
+        entry.insert(QStringLiteral("clean"), it->clean);
+        entry.insert(QStringLiteral("port_pairs"), pairs);
+        entry.insert(QStringLiteral("circuit"), it->circuit);
+        entries.insert(it.key(), entry);
+    }
+    QJsonObject root;
+    root.insert(QStringLiteral("format"), recordsFormat);
+    root.insert(QStringLiteral("flatten"), QJsonArray::fromStringList(flatten));
+    root.insert(QStringLiteral("cells"), entries);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) < 0 ||
+        !file.commit()) {
+        if (error != nullptr) {
+            *error = QStringLiteral("Failed to write file: %1").arg(path);
+        }
+        return false;
+    }
+    return true;
+}
+
+auto NetlistComparator::Records::reusedCount() const -> qsizetype {
+    return std::count_if(cells.cbegin(), cells.cend(),
+                         [](const CellRecord &record) {
+                             return record.reused;
+                         });
+}
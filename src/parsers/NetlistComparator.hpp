@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class SpiceNetlist;
+
+// A pre-LVS comparison of two SPICE netlists without netgen, written as
+// the JSON array netgen's `lvs -json` writes, so NetgenJsonParser reads it
+// into the usual diffs. Each side becomes a bipartite graph of devices
+// and nets, every device pin labelled by its role (drain and source share
+// one label, as netgen permutes them). Partitions are refined by hashing:
+// a net's color absorbs the multiset of (label, device color) on its
+// pins, then a device's the (label, net color) of its own, until the
+// partition stops splitting. A class that ends up with more nodes on one
+// side is frozen at its previous color and reported, so its neighbours
+// still match. A device is reported too when none of its nets matched, or
+// when it and the one device of its class on the other side join a bad
+// net to two different nets. Each round rehashes the nodes in chunks on
+// the global QThreadPool.
+//
+// Subcircuits are compared first, children before parents, and paired by
+// name. A pair that matches stays one device in its parents, its pins
+// labelled by the port pairing; anything else, or a cell named in
+// Options::flatten, is flattened into its parents ("inverter:0/nfet:1001"
+// as netgen names it). A compared subcircuit gets a pin for each
+// `.global` net it reaches. A subcircuit only one side defines, and the
+// other instantiates, is a black box on both: the undefined side numbers
+// its pins, as netgen does, and they pair by name. A pin the other side
+// lacks gets a proxy there, as in netgen, on a net of its own that never
+// matches. Parallel primitive devices of one class and otherwise equal
+// parameters are merged first, adding up their widths (or values, or m)
+// as netgen does, and matched primitives have their parameters compared
+// as text; the parser applies property tolerances.
+//
+// A run can keep its per-cell results as Records and hand them to the
+// next one: a pair whose SubcktHashes digests are unchanged on both sides
+// is taken from there instead of compared, so after a fix to one cell
+// only that cell and the cells above it are compared again.
+class NetlistComparator {
+  public:
+    // A compared cell pair as a later run reuses it.
+    struct CellRecord {
+        QByteArray layoutHash;
+        QByteArray schematicHash;
+        QJsonObject circuit;    // the pair's entry in the result
+        // Per schematic port, then global pin: layout pin or -1.
+        QVector<int> portPairs;
+        bool clean = false;
+        bool reused = false; // taken from the previous run; not saved
+    };
+
+    // The results of one run, saved as JSON between runs.
+    struct Records {
+        QStringList flatten;              // lower-case, sorted
+        QHash<QString, CellRecord> cells; // lower-case layout cell name
+
+        // Replaces the records; on error they are left empty.
+        auto load(const QString &path, QString *error = nullptr) -> bool;
+        auto save(const QString &path, QString *error = nullptr) const
+            -> bool;
+        auto reusedCount() const -> qsizetype;
+    };
+
+    struct Options {
+        // Defined out of line so the "= {}" defaults below can use the
+        // member initializers.
+        Options();
+
+        // Cells to compare; empty means the top level of the file, or its
+        // last subcircuit nothing instantiates.
+        QString layoutCell;
+        QString schematicCell;
+        QStringList flatten;
+        // Results of an earlier run with the same flatten list.
+        const Records *previous = nullptr;
+        // Receives this run's results, reused and fresh, when set.
+        Records *records = nullptr;
+    };
+
+    // One object per compared cell pair, children first; empty, with
+    // error set, when a top cell is not found.
+    static auto compare(const SpiceNetlist &layout,
+                        const SpiceNetlist &schematic,
+                        const Options &options = {},
+                        QString *error = nullptr) -> QJsonArray;
+    static auto compareFiles(const QString &layoutPath,
+                             const QString &schematicPath,
+                             const Options &options = {},
+                             QString *error = nullptr) -> QJsonArray;
+};
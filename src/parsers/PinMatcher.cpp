@@ -0,0 +1,86 @@
+#include "parsers/PinMatcher.hpp"
+
+#include <QHash>
+#include <algorithm>
+
+namespace {
+auto isReal(const QString &pin) -> bool {
+    return !pin.isEmpty() &&
+           !pin.contains(QStringLiteral("(no matching pin)"),
+                         Qt::CaseInsensitive);
+}
+
+auto pinAt(const QStringList &pins, qsizetype i) -> QString {
+    return i < pins.size() ? pins.at(i) : QString();
+}
+
+auto samePin(const QString &a, const QString &b) -> bool {
+    return a.compare(b, Qt::CaseInsensitive) == 0;
+}
+
+auto positions(const QStringList &pins) -> QHash<QString, int> {
+    QHash<QString, int> byName;
+    byName.reserve(pins.size());
+    for (qsizetype i = 0; i < pins.size(); ++i) {
+        if (isReal(pins.at(i))) {
+            byName.insert(pins.at(i).toLower(), static_cast<int>(i));
+        }
+    }
+    return byName;
+}
+} // namespace
+
+auto PinMatcher::allMatch(const QStringList &layout,
+                          const QStringList &schematic) -> bool {
+    const qsizetype count = std::max(layout.size(), schematic.size());
+    for (qsizetype i = 0; i < count; ++i) {
+        const QString a = pinAt(layout, i);
+        const QString b = pinAt(schematic, i);
+        if (a.isEmpty() && b.isEmpty()) {
+            continue;
+        }
+        if (!isReal(a) || !isReal(b) || !samePin(a, b)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto PinMatcher::compare(const QStringList &layout,
+                         const QStringList &schematic) -> QVector<Finding> {
+    QVector<Finding> findings;
+    if (allMatch(layout, schematic)) {
+        return findings;
+    }
+    const QHash<QString, int> inLayout = positions(layout);
+    const QHash<QString, int> inSchematic = positions(schematic);
+    const qsizetype count = std::max(layout.size(), schematic.size());
+    for (qsizetype i = 0; i < count; ++i) {
+        const QString a = pinAt(layout, i);
+        const QString b = pinAt(schematic, i);
+        const bool realA = isReal(a);
+        const bool realB = isReal(b);
+        if (realA && realB && samePin(a, b)) {
+            continue;
+        }
+        const int pos = static_cast<int>(i);
+        const int aElsewhere =
+            realA ? inSchematic.value(a.toLower(), -1) : -1;
+        const int bElsewhere = realB ? inLayout.value(b.toLower(), -1) : -1;
+        if (realA && realB && aElsewhere < 0 && bElsewhere < 0) {
+            findings.append(Finding{Kind::Renamed, a, b, pos, pos});
+            continue;
+        }
+        // A name on both sides is reported from its layout position.
+        if (realA) {
+            findings.append(aElsewhere >= 0
+                                ? Finding{Kind::Reordered, a, {}, pos,
+                                          aElsewhere}
+                                : Finding{Kind::Missing, a, {}, pos, -1});
+        }
+        if (realB && bElsewhere < 0) {
+            findings.append(Finding{Kind::Missing, b, {}, -1, pos});
+        }
+    }
+    return findings;
+}
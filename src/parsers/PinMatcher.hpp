@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Pin mismatches in netgen's `pins` pairing: position i of the layout list
+// was matched with position i of the schematic list, and a side without
+// a partner reads "(no matching pin)". Names are looked up in one hash per
+// side, case-insensitively, so a circuit costs about its pin count:
+//   Missing    the name is on one side only
+//   Renamed    a pair whose names differ and occur nowhere else
+//   Reordered  the name is on both sides but was paired elsewhere
+// Empty names are netgen's placeholders for pins it did not list. QtCore
+// only.
+class PinMatcher {
+  public:
+    enum class Kind : char { Missing, Renamed, Reordered };
+
+    struct Finding {
+        Kind kind = Kind::Missing;
+        QString pin;        // layout name, else schematic name
+        QString other;      // schematic name of a renamed pair
+        int layoutPos = -1; // 0-based; -1 when not on that side
+        int schematicPos = -1;
+    };
+
+    // Both lists hold only placeholders or pair equal names throughout.
+    static auto allMatch(const QStringList &layout,
+                         const QStringList &schematic) -> bool;
+    // Findings in position order, each pin reported once.
+    static auto compare(const QStringList &layout,
+                        const QStringList &schematic) -> QVector<Finding>;
+};
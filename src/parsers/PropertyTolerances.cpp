@@ -0,0 +1,146 @@
+#include "parsers/PropertyTolerances.hpp"
+
+#include <QFile>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+
+#include "diagnostics/Tracer.hpp"
+#include "parsers/SpiceNumber.hpp"
+
+namespace {
+// "0.1%" or a SPICE number; false if neither or negative.
+auto toleranceValue(QStringView text, double *value) -> bool {
+    double number = 0.0;
+    const bool percent = text.endsWith(QLatin1Char('%'));
+    if (!SpiceNumber::parse(percent ? text.chopped(1) : text, &number) ||
+        number < 0.0) {
+        return false;
+    }
+    *value = percent ? number / 100.0 : number;
+    return true;
+}
+} // namespace
+
+auto PropertyTolerances::load(const QString &path, QString *error) -> bool {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        parse(QString());
+        if (error != nullptr) {
+            *error = QStringLiteral("Failed to open file: %1").arg(path);
+        }
+        return false;
+    }
+    QString parseError;
+    if (!parse(QString::fromUtf8(file.readAll()), &parseError)) {
+        if (error != nullptr) {
+            *error = QStringLiteral("%1: %2").arg(path, parseError);
+        }
+        return false;
+    }
+    return true;
+}
+
+auto PropertyTolerances::parse(const QString &text, QString *error) -> bool {
+    OPENSVS_TRACE_SCOPE("PropertyTolerances::parse", "parse");
+    byName_.clear();
+    default_ = Tolerance();
+    hasDefault_ = false;
+    auto fail = [&](int line, const QString &message) {
+        byName_.clear();
+        default_ = Tolerance();
+        hasDefault_ = false;
+        if (error != nullptr) {
+            *error = QStringLiteral("line %1: %2").arg(line).arg(message);
+        }
+        return false;
+    };
+
+    const QStringList lines = text.split(QLatin1Char('\n'));
+    for (qsizetype i = 0; i < lines.size(); ++i) {
+        const int lineNumber = static_cast<int>(i) + 1;
+        QString line = lines.at(i);
+        const qsizetype hash = line.indexOf(QLatin1Char('#'));
+        if (hash >= 0) {
+            line.truncate(hash);
+        }
+        const QStringList tokens =
+            line.simplified().split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        if (tokens.isEmpty()) {
+            continue;
+        }
+        if (tokens.size() == 1) {
+            return fail(lineNumber,
+                        QStringLiteral("expected rel= or abs= after %1")
+                            .arg(tokens.first()));
+        }
+        Tolerance tolerance;
+        for (qsizetype k = 1; k < tokens.size(); ++k) {
+            const QString &token = tokens.at(k);
+            const qsizetype eq = token.indexOf(QLatin1Char('='));
+            const QString key = token.left(eq).toLower();
+            double *field = nullptr;
+            if (eq > 0 && key == QStringLiteral("rel")) {
+                field = &tolerance.relative;
+            } else if (eq > 0 && key == QStringLiteral("abs")) {
+                field = &tolerance.absolute;
+            }
+            if (field == nullptr) {
+                return fail(lineNumber,
+                            QStringLiteral("expected rel= or abs=, got %1")
+                                .arg(token));
+            }
+            if (!toleranceValue(QStringView(token).mid(eq + 1), field)) {
+                return fail(lineNumber,
+                            QStringLiteral("not a tolerance: %1").arg(token));
+            }
+        }
+        setTolerance(tokens.first(), tolerance);
+    }
+    return true;
+}
+
+void PropertyTolerances::setTolerance(const QString &parameter,
+                                      Tolerance tolerance) {
+    if (parameter == QStringLiteral("*")) {
+        default_ = tolerance;
+        hasDefault_ = true;
+        return;
+    }
+    byName_.insert(Name{parameter.toCaseFolded()}, tolerance);
+}
+
+auto PropertyTolerances::tolerance(const QString &parameter) const
+    -> Tolerance {
+    if (!byName_.isEmpty()) {
+        const auto it = byName_.constFind(Name{parameter});
+        if (it != byName_.cend()) {
+            return *it;
+        }
+    }
+    return default_;
+}
+
+auto PropertyTolerances::ruleCount() const -> qsizetype {
+    return byName_.size() + (hasDefault_ ? 1 : 0);
+}
+
+auto PropertyTolerances::matches(const QString &parameter, QStringView a,
+                                 QStringView b) const -> bool {
+    if (a == b) {
+        return true;
+    }
+    double x = 0.0;
+    double y = 0.0;
+    if (!SpiceNumber::parse(a, &x) || !SpiceNumber::parse(b, &y)) {
+        return false;
+    }
+    const double difference = std::abs(x - y);
+    if (difference == 0.0) {
+        return true;
+    }
+    const Tolerance allowed = tolerance(parameter);
+    return difference <= std::max(allowed.absolute,
+                                  allowed.relative *
+                                      std::max(std::abs(x), std::abs(y)));
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringView>
+
+// How far apart two property values may be and still match. A tolerance
+// file has one rule per line:
+//
+//   # drawn widths snap to the 5 nm grid
+//   w     abs=5n
+//   l     rel=0.1%
+//   *     rel=1e-6            # every other parameter
+//
+// The first token is the parameter name (case-insensitive) or * for the
+// default; rel is a fraction of the larger magnitude, or a percentage,
+// and abs a SPICE number. Values match when they are the same text, or
+// both parse as SPICE numbers and differ by at most max(abs, rel * |v|).
+// Without rules, numbers only need to be equal once parsed, so "1e-6"
+// and "1u" match.
+class PropertyTolerances {
+  public:
+    struct Tolerance {
+        double relative = 0.0;
+        double absolute = 0.0;
+    };
+
+    // Replace the rules; on error the set is left empty and error names
+    // the offending line.
+    auto load(const QString &path, QString *error = nullptr) -> bool;
+    auto parse(const QString &text, QString *error = nullptr) -> bool;
+
+    // "*" sets the default.
+    void setTolerance(const QString &parameter, Tolerance tolerance);
+    auto tolerance(const QString &parameter) const -> Tolerance;
+    auto ruleCount() const -> qsizetype;
+
+    auto matches(const QString &parameter, QStringView a,
+                 QStringView b) const -> bool;
+
+  private:
+    // Parameter name compared and hashed case-insensitively, so a lookup
+    // needs no folded copy of the name.
+    struct Name {
+        QString text;
+
+        auto operator==(const Name &other) const -> bool {
+            return text.compare(other.text, Qt::CaseInsensitive) == 0;
+        }
+        friend auto qHash(const Name &name, size_t seed) -> size_t {
+            size_t hash = seed;
+            for (const QChar c : name.text) {
+                hash = hash * 31 + QChar::toCaseFolded(char32_t{c.unicode()});
+            }
+            return hash;
+        }
+    };
+
+    QHash<Name, Tolerance> byName_; // case-folded names
+    Tolerance default_;
+    bool hasDefault_{false};
+};
@@ -0,0 +1,553 @@
+#include "parsers/SpiceIndex.hpp"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QVector>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "diagnostics/Tracer.hpp"
+#include "parsers/SpiceTokenizer.hpp"
+
+namespace {
+constexpr quint64 fnvBasis = 14695981039346656037ULL;
+constexpr quint64 fnvPrime = 1099511628211ULL;
+constexpr unsigned char separator = 0x1f;
+constexpr int linesPerCheckpoint = 256;
+constexpr int fileShift = 48;
+constexpr qint64 offsetMask = (qint64(1) << fileShift) - 1;
+constexpr size_t maxFiles = size_t(1) << 15;
+// Repeated nets are dropped whenever the list has doubled plus this many,
+// so a flattened netlist never holds every node reference at once.
+constexpr size_t netBatch = size_t(1) << 20;
+
+auto lower(char c) -> unsigned char {
+    const auto u = static_cast<unsigned char>(c);
+    return (u >= 'A' && u <= 'Z') ? static_cast<unsigned char>(u + 32) : u;
+}
+
+auto mix(quint64 hash, unsigned char c) -> quint64 {
+    return (hash ^ c) * fnvPrime;
+}
+
+// FNV-1a over the lower-cased name and a separator, so "ab"+"c" and
+// "a"+"bc" differ as scope and name.
+auto hashName(quint64 hash, const char *text, qsizetype size) -> quint64 {
+    for (qsizetype i = 0; i < size; ++i) {
+        hash = mix(hash, lower(text[i]));
+    }
+    return mix(hash, separator);
+}
+
+auto topScope() -> quint64 { return hashName(fnvBasis, nullptr, 0); }
+
+auto keyOf(quint64 scope, const char *text, qsizetype size,
+           SpiceIndex::Kind kind) -> quint64 {
+    return mix(hashName(scope, text, size),
+               static_cast<unsigned char>(static_cast<int>(kind) + 1));
+}
+
+// Nodes of a primitive element by its letter; subcircuit calls (x) list
+// a variable number and are handled apart.
+auto nodeCount(unsigned char letter) -> int {
+    switch (letter) {
+    case 'm':
+    case 'e':
+    case 'g':
+    case 's':
+    case 't':
+        return 4;
+    case 'q':
+    case 'j':
+        return 3;
+    case 'k':
+        return 0;
+    default:
+        return 2;
+    }
+}
+} // namespace
+
+struct SpiceIndex::File {
+    QString path;
+    std::unique_ptr<QFile> file; // owns the mapping
+    const char *data = nullptr;
+    qint64 size = 0;
+    QDateTime modified;
+    QVector<qint64> checkpoints; // offset of every 256th line
+    qint64 lines = 0;
+};
+
+class SpiceIndex::Scanner {
+  public:
+    explicit Scanner(SpiceIndex &index) : index_(index) {
+        scopes_.push_back(topScope());
+    }
+
+    auto scan(const QString &path, QString *error) -> bool;
+    void finish();
+
+  private:
+    using Token = SpiceTokenizer::Token;
+    enum class Statement : char { None, Subckt, Element, Include, Other };
+
+    auto statement(const SpiceTokenizer::Statement &parsed) -> bool;
+    void start(const Token &head);
+    void token(const Token &token);
+    void end();
+    void define(quint64 key, Kind kind);
+    void addNet(const char *text, qsizetype size, qint64 location);
+    void compactNets();
+
+    SpiceIndex &index_;
+    std::vector<Entry> nets_;
+    size_t compacted_ = 0; // nets_ size after the last compaction
+    QSet<QString> visited_;
+    qint64 file_ = 0; // index of the file being scanned, shifted
+    QString dir_;     // and its directory, for includes
+    QVector<quint64> scopes_;
+
+    Statement statement_ = Statement::None;
+    qint64 statementAt_ = 0;
+    unsigned char letter_ = 0;
+    bool named_ = false;  // .subckt name seen
+    bool params_ = false; // past "params:" or the first name=value
+    int nodesLeft_ = 0;
+    std::vector<Entry> pending_; // x nodes; the last is the subckt name
+};
+
+auto SpiceIndex::Scanner::scan(const QString &path, QString *error) -> bool {
+    const QFileInfo info(path);
+    const QString canonical = info.canonicalFilePath();
+    if (!canonical.isEmpty() && visited_.contains(canonical)) {
+        return true;
+    }
+    auto file = std::make_unique<QFile>(info.absoluteFilePath());
+    if (canonical.isEmpty() || !file->open(QIODevice::ReadOnly)) {
+        if (error != nullptr) {
+            *error = QStringLiteral("Failed to open file: %1").arg(path);
+        }
+        return false;
+    }
+    if (index_.files_.size() >= maxFiles) {
+        if (error != nullptr) {
+            *error = QStringLiteral("%1: too many included files").arg(path);
+        }
+        return false;
+    }
+    visited_.insert(canonical);
+
+    const qint64 size = file->size();
+    const char *data = nullptr;
+    if (size > 0) {
+        uchar *mapped = file->map(0, size);
+        if (mapped == nullptr) {
+            if (error != nullptr) {
+                *error = QStringLiteral("Failed to map file: %1").arg(path);
+            }
+            return false;
+        }
+        data = reinterpret_cast<const char *>(mapped);
+    }
+    const size_t fileIndex = index_.files_.size();
+    File mappedFile;
+    mappedFile.path = info.absoluteFilePath();
+    mappedFile.file = std::move(file);
+    mappedFile.data = data;
+    mappedFile.size = size;
+    mappedFile.modified = info.lastModified();
+    index_.files_.push_back(std::move(mappedFile));
+
+    const qint64 outerFile = file_;
+    const QString outerDir = dir_;
+    file_ = static_cast<qint64>(fileIndex) << fileShift;
+    dir_ = info.absolutePath();
+    SpiceTokenizer tokenizer(
+        [this](const SpiceTokenizer::Statement &s) { return statement(s); });
+    QVector<qint64> checkpoints;
+    for (qint64 at = 0; at < size;) {
+        if (tokenizer.lineCount() % linesPerCheckpoint == 0) {
+            checkpoints.append(at);
+        }
+        const auto *newline = static_cast<const char *>(
+            std::memchr(data + at, '\n', static_cast<size_t>(size - at)));
+        const qint64 stop = newline != nullptr ? newline - data : size;
+        tokenizer.line(data + at, data + stop, at);
+        at = stop + 1;
+    }
+    tokenizer.finish();
+    file_ = outerFile;
+    dir_ = outerDir;
+
+    File &done = index_.files_[fileIndex];
+    done.checkpoints = std::move(checkpoints);
+    done.lines = tokenizer.lineCount();
+    return true;
+}
+
+auto SpiceIndex::Scanner::statement(const SpiceTokenizer::Statement &parsed)
+    -> bool {
+    start(parsed.tokens.front());
+    for (size_t i = 1; i < parsed.tokens.size(); ++i) {
+        token(parsed.tokens[i]);
+    }
+    end();
+    return true;
+}
+
+void SpiceIndex::Scanner::start(const Token &head) {
+    statementAt_ = file_ | head.offset;
+    if (head.text[0] != '.') {
+        statement_ = Statement::Element;
+        letter_ = lower(head.text[0]);
+        nodesLeft_ = nodeCount(letter_);
+        define(keyOf(scopes_.back(), head.text, head.size, Kind::Instance),
+               Kind::Instance);
+    } else if (head.is(".subckt")) {
+        statement_ = Statement::Subckt;
+    } else if (head.is(".ends")) {
+        statement_ = Statement::Other;
+        if (scopes_.size() > 1) {
+            scopes_.pop_back();
+        }
+    } else if (SpiceTokenizer::isInclude(head)) {
+        statement_ = Statement::Include;
+    } else {
+        statement_ = Statement::Other; // .lib sections are not followed
+    }
+}
+
+void SpiceIndex::Scanner::token(const Token &token) {
+    const char *text = token.text;
+    const qsizetype size = token.size;
+    const qint64 location = file_ | token.offset;
+    switch (statement_) {
+    case Statement::Subckt:
+        if (!named_) {
+            named_ = true;
+            define(keyOf(topScope(), text, size, Kind::Subckt), Kind::Subckt);
+            scopes_.push_back(hashName(fnvBasis, text, size));
+        } else if (params_ || token.contains('=') || token.is("params:")) {
+            params_ = true;
+        } else {
+            addNet(text, size, location);
+        }
+        break;
+    case Statement::Element:
+        if (letter_ != 'x') {
+            if (nodesLeft_ > 0 && !token.contains('=')) {
+                addNet(text, size, location);
+                --nodesLeft_;
+            }
+        } else if (params_) {
+            break;
+        } else if (size == 1 && text[0] == '=') {
+            // "w = 1u": the name before is a parameter, not the subckt
+            if (!pending_.empty()) {
+                pending_.pop_back();
+            }
+            params_ = true;
+        } else if (token.contains('=') || token.is("params:")) {
+            params_ = true;
+        } else {
+            pending_.push_back(
+                {keyOf(scopes_.back(), text, size, Kind::Net), location});
+        }
+        break;
+    case Statement::Include: {
+        const QString path = SpiceTokenizer::includePath(dir_, token);
+        statement_ = Statement::Other;
+        if (!scan(path, nullptr)) {
+            index_.missing_.append(path);
+        }
+        break;
+    }
+    case Statement::None:
+    case Statement::Other:
+        break;
+    }
+}
+
+void SpiceIndex::Scanner::end() {
+    if (statement_ == Statement::Element && letter_ == 'x' &&
+        !pending_.empty()) {
+        pending_.pop_back();
+        for (const Entry &net : pending_) {
+            nets_.push_back(net);
+        }
+        if (nets_.size() >= 2 * compacted_ + netBatch) {
+            compactNets();
+        }
+    }
+    pending_.clear();
+    statement_ = Statement::None;
+    named_ = false;
+    params_ = false;
+}
+
+void SpiceIndex::Scanner::define(quint64 key, Kind kind) {
+    index_.entries_.push_back({key, statementAt_});
+    ++index_.counts_[static_cast<size_t>(kind)];
+}
+
+void SpiceIndex::Scanner::addNet(const char *text, qsizetype size,
+                                 qint64 location) {
+    nets_.push_back({keyOf(scopes_.back(), text, size, Kind::Net), location});
+    if (nets_.size() >= 2 * compacted_ + netBatch) {
+        compactNets();
+    }
+}
+
+void SpiceIndex::Scanner::compactNets() {
+    auto before = [](const Entry &a, const Entry &b) {
+        return a.key != b.key ? a.key < b.key : a.location < b.location;
+    };
+    std::sort(nets_.begin(), nets_.end(), before);
+    nets_.erase(std::unique(nets_.begin(), nets_.end(),
+                            [](const Entry &a, const Entry &b) {
+                                return a.key == b.key;
+                            }),
+                nets_.end());
+    compacted_ = nets_.size();
+}
+
+void SpiceIndex::Scanner::finish() {
+    compactNets();
+    index_.counts_[static_cast<size_t>(Kind::Net)] =
+        static_cast<qint64>(nets_.size());
+    index_.entries_.insert(index_.entries_.end(), nets_.begin(), nets_.end());
+    std::vector<Entry>().swap(nets_);
+    std::sort(index_.entries_.begin(), index_.entries_.end(),
+              [](const Entry &a, const Entry &b) {
+                  return a.key != b.key ? a.key < b.key
+                                        : a.location < b.location;
+              });
+    index_.entries_.shrink_to_fit();
+}
+
+SpiceIndex::SpiceIndex() = default;
+SpiceIndex::~SpiceIndex() = default;
+SpiceIndex::SpiceIndex(SpiceIndex &&other) noexcept = default;
+auto SpiceIndex::operator=(SpiceIndex &&other) noexcept
+    -> SpiceIndex & = default;
+
+auto SpiceIndex::build(const QString &path, QString *error) -> bool {
+    OPENSVS_TRACE_SCOPE("SpiceIndex::build", "parser");
+    files_.clear();
+    entries_.clear();
+    counts_ = {};
+    missing_.clear();
+    Scanner scanner(*this);
+    if (!scanner.scan(path, error)) {
+        files_.clear();
+        entries_.clear();
+        counts_ = {};
+        missing_.clear();
+        return false;
+    }
+    scanner.finish();
+    return true;
+}
+
+auto SpiceIndex::files() const -> QStringList {
+    QStringList paths;
+    paths.reserve(static_cast<qsizetype>(files_.size()));
+    for (const File &file : files_) {
+        paths.append(file.path);
+    }
+    return paths;
+}
+
+auto SpiceIndex::missingFiles() const -> QStringList { return missing_; }
+
+auto SpiceIndex::count(Kind kind) const -> qint64 {
+    return counts_[static_cast<size_t>(kind)];
+}
+
+auto SpiceIndex::lineCount() const -> qint64 {
+    qint64 lines = 0;
+    for (const File &file : files_) {
+        lines += file.lines;
+    }
+    return lines;
+}
+
+auto SpiceIndex::memoryBytes() const -> qint64 {
+    auto bytes = static_cast<qint64>(sizeof(SpiceIndex));
+    bytes += static_cast<qint64>(entries_.capacity() * sizeof(Entry));
+    for (const File &file : files_) {
+        bytes += static_cast<qint64>(sizeof(File) + sizeof(QFile));
+        bytes += file.checkpoints.capacity() *
+                 static_cast<qint64>(sizeof(qint64));
+        bytes += file.path.capacity() * static_cast<qint64>(sizeof(QChar));
+    }
+    return bytes;
+}
+
+auto SpiceIndex::isCurrent() const -> bool {
+    for (const File &file : files_) {
+        const QFileInfo info(file.path);
+        if (!info.exists() || info.size() != file.size ||
+            info.lastModified() != file.modified) {
+            return false;
+        }
+    }
+    return !files_.empty();
+}
+
+auto SpiceIndex::scopeOf(const QString &cell) const -> quint64 {
+    if (cell.isEmpty()) {
+        return topScope();
+    }
+    const QByteArray name = cell.toUtf8();
+    if (!lookup(keyOf(topScope(), name.constData(), name.size(),
+                      Kind::Subckt))
+             .isValid()) {
+        return topScope();
+    }
+    return hashName(fnvBasis, name.constData(), name.size());
+}
+
+auto SpiceIndex::lookup(quint64 key) const -> Location {
+    const auto it = std::lower_bound(
+        entries_.cbegin(), entries_.cend(), key,
+        [](const Entry &entry, quint64 k) { return entry.key < k; });
+    if (it == entries_.cend() || it->key != key) {
+        return {};
+    }
+    const File &file = files_[static_cast<size_t>(it->location >> fileShift)];
+    const qint64 offset = it->location & offsetMask;
+    return {file.path, offset, lineOf(file, offset)};
+}
+
+auto SpiceIndex::lineOf(const File &file, qint64 offset) const -> qint64 {
+    if (file.checkpoints.isEmpty()) {
+        return 1;
+    }
+    const auto it = std::upper_bound(file.checkpoints.cbegin(),
+                                     file.checkpoints.cend(), offset);
+    const qsizetype block = (it - file.checkpoints.cbegin()) - 1;
+    qint64 line = block * linesPerCheckpoint;
+    const char *p = file.data + file.checkpoints.at(block);
+    const char *target = file.data + offset;
+    while (p < target) {
+        const auto *newline = static_cast<const char *>(
+            std::memchr(p, '\n', static_cast<size_t>(target - p)));
+        if (newline == nullptr) {
+            break;
+        }
+        ++line;
+        p = newline + 1;
+    }
+    return line + 1;
+}
+
+auto SpiceIndex::find(Kind kind, const QString &cell,
+                      const QString &name) const -> Location {
+    if (name.isEmpty() || entries_.empty()) {
+        return {};
+    }
+    const quint64 scope = kind == Kind::Subckt ? topScope() : scopeOf(cell);
+    const QByteArray bytes = name.toUtf8();
+    return lookup(keyOf(scope, bytes.constData(), bytes.size(), kind));
+}
+
+auto SpiceIndex::locate(const NetgenJsonParser::DiffEntry &entry,
+                        const QString &cell) const -> Location {
+    using DiffType = NetgenJsonParser::DiffType;
+    // netgen drops the element letter: "nfet:1001" is M1001, "INVX1:3"
+    // is x3, and a bare class name stands for its subcircuit. In a path
+    // ("inverter:0/nfet:1001") the device is defined in its parent's
+    // class.
+    auto instance = [&](const QString &name) {
+        const QStringList path = name.split(QLatin1Char('/'));
+        const QString &last = path.last();
+        QString scope = cell;
+        if (path.size() > 1) {
+            const QString parent =
+                path.at(path.size() - 2).section(QLatin1Char(':'), 0, 0);
+            if (find(Kind::Subckt, QString(), parent).isValid()) {
+                scope = parent;
+            }
+        }
+        if (!last.contains(QLatin1Char(':'))) {
+            const Location at = find(Kind::Instance, scope, last);
+            return at.isValid() ? at : find(Kind::Subckt, QString(), last);
+        }
+        const QString number = last.section(QLatin1Char(':'), -1);
+        const QStringList candidates{number, QStringLiteral("x") + number,
+                                     QStringLiteral("m") + number};
+        for (const QString &candidate : candidates) {
+            const Location at = find(Kind::Instance, scope, candidate);
+            if (at.isValid()) {
+                return at;
+            }
+        }
+        // The other side names it differently; show the parent's class.
+        return scope != cell ? find(Kind::Subckt, QString(), scope)
+                             : Location();
+    };
+
+    Location at;
+    switch (entry.type) {
+    case DiffType::NetMismatch:
+    case DiffType::Short:
+    case DiffType::Open:
+    case DiffType::PinMismatch:
+        at = find(Kind::Net, cell, entry.name);
+        if (!at.isValid() && entry.name.contains(QLatin1Char('/'))) {
+            // a flattened net; its first segment is the instance
+            at = find(Kind::Instance, cell,
+                      entry.name.section(QLatin1Char('/'), 0, 0));
+        }
+        break;
+    case DiffType::InstanceMismatch:
+    case DiffType::PropertyMismatch:
+    case DiffType::DeviceMismatch:
+        at = instance(entry.name);
+        break;
+    case DiffType::Unknown:
+        break;
+    }
+    return at.isValid() ? at : find(Kind::Subckt, QString(), cell);
+}
+
+auto SpiceIndex::excerpt(const Location &at, int before, int after,
+                         qint64 *firstLine) const -> QString {
+    const auto file =
+        std::find_if(files_.cbegin(), files_.cend(),
+                     [&](const File &f) { return f.path == at.path; });
+    if (!at.isValid() || file == files_.cend() ||
+        file->checkpoints.isEmpty()) {
+        return {};
+    }
+    const qint64 first = std::max<qint64>(1, at.line - before);
+    const qint64 last = at.line + after;
+    const qsizetype block =
+        std::min<qsizetype>((first - 1) / linesPerCheckpoint,
+                            file->checkpoints.size() - 1);
+    const char *end = file->data + file->size;
+    const char *p = file->data + file->checkpoints.at(block);
+    for (qint64 line = block * linesPerCheckpoint + 1; line < first && p < end;
+         ++line) {
+        const auto *newline = static_cast<const char *>(
+            std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        p = newline != nullptr ? newline + 1 : end;
+    }
+    const char *stop = p;
+    for (qint64 line = first; line <= last && stop < end; ++line) {
+        const auto *newline = static_cast<const char *>(
+            std::memchr(stop, '\n', static_cast<size_t>(end - stop)));
+        stop = newline != nullptr ? newline + 1 : end;
+    }
+    if (stop > p && stop[-1] == '\n') {
+        --stop;
+    }
+    if (firstLine != nullptr) {
+        *firstLine = first;
+    }
+    return QString::fromUtf8(p, stop - p);
+}
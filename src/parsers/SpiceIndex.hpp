@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <array>
+#include <vector>
+
+#include "parsers/NetgenJsonParser.hpp"
+
+// Where the subcircuits, instances and nets of a SPICE netlist are
+// defined, for jumping from a diff to its source line. Files are
+// memory-mapped and scanned once with SpiceTokenizer, and `.include`
+// files are indexed where they appear (relative to the file that includes
+// them, each once). Names are case-insensitive, as in SPICE,
+// and kept only as 64-bit hashes next to the byte offset of their first
+// occurrence: a subcircuit or instance at its statement, a net at its
+// first mention in a `.subckt` port list or element node list. A sparse
+// line table (one offset per 256 lines) turns offsets into line numbers,
+// so a flattened netlist costs about 16 bytes per name; the text itself
+// stays in the page cache. MainWindow builds it on a worker thread and
+// only reads it once it is handed over.
+class SpiceIndex {
+  public:
+    enum class Kind : char { Subckt, Instance, Net };
+
+    struct Location {
+        QString path;
+        qint64 offset = -1;
+        qint64 line = 0; // 1-based
+        auto isValid() const -> bool { return offset >= 0; }
+    };
+
+    SpiceIndex();
+    ~SpiceIndex();
+    SpiceIndex(SpiceIndex &&other) noexcept;
+    auto operator=(SpiceIndex &&other) noexcept -> SpiceIndex &;
+
+    // Replaces the index; on error it is left empty. Includes that cannot
+    // be opened are skipped and listed by missingFiles().
+    auto build(const QString &path, QString *error = nullptr) -> bool;
+
+    auto files() const -> QStringList;
+    auto missingFiles() const -> QStringList;
+    auto count(Kind kind) const -> qint64;
+    auto lineCount() const -> qint64;
+    auto memoryBytes() const -> qint64;
+    // False once one of the files changed on disk.
+    auto isCurrent() const -> bool;
+
+    // Subcircuits are looked up at the top level. cell scopes instances
+    // and nets; an empty cell, or one that is not a subcircuit (netgen
+    // names the top level after the file), means the top level.
+    auto find(Kind kind, const QString &cell, const QString &name) const
+        -> Location;
+    // The line entry refers to in cell: its net, instance or device class
+    // under the names netgen gives them ("nfet:1001" is M1001), else the
+    // cell's .subckt line.
+    auto locate(const NetgenJsonParser::DiffEntry &entry,
+                const QString &cell) const -> Location;
+    // Lines at.line - before through at.line + after of at's file;
+    // firstLine receives the number of the first one.
+    auto excerpt(const Location &at, int before, int after,
+                 qint64 *firstLine = nullptr) const -> QString;
+
+  private:
+    struct File;
+    struct Entry {
+        quint64 key = 0;
+        qint64 location = 0; // file index << 48 | byte offset
+    };
+    class Scanner;
+
+    auto scopeOf(const QString &cell) const -> quint64;
+    auto lookup(quint64 key) const -> Location;
+    auto lineOf(const File &file, qint64 offset) const -> qint64;
+
+    std::vector<File> files_;
+    std::vector<Entry> entries_; // sorted by key, then location
+    std::array<qint64, 3> counts_{};
+    QStringList missing_;
+};
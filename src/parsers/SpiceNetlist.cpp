@@ -0,0 +1,286 @@
+#include "parsers/SpiceNetlist.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+#include <utility>
+
+#include "diagnostics/Tracer.hpp"
+#include "parsers/SpiceNumber.hpp"
+#include "parsers/SpiceTokenizer.hpp"
+
+namespace {
+constexpr int maxIncludeDepth = 64;
+
+auto isNumber(const QString &text) -> bool {
+    double value = 0.0;
+    return SpiceNumber::parse(text, &value);
+}
+
+// The statement's tokens, with "w = 1u", "w= 1u" and "w =1u" joined into
+// "w=1u".
+auto strings(const SpiceTokenizer::Statement &statement) -> QStringList {
+    QStringList tokens;
+    tokens.reserve(static_cast<qsizetype>(statement.tokens.size()));
+    for (const SpiceTokenizer::Token &token : statement.tokens) {
+        QString text = token.toString();
+        if (!tokens.isEmpty() && (text.startsWith(QLatin1Char('=')) ||
+                                  tokens.last().endsWith(QLatin1Char('=')))) {
+            tokens.last() += text;
+        } else {
+            tokens.append(std::move(text));
+        }
+    }
+    return tokens;
+}
+} // namespace
+
+class SpiceNetlist::Reader {
+  public:
+    explicit Reader(SpiceNetlist &netlist)
+        : netlist_(netlist), cell_(&netlist.top_) {}
+
+    auto readFile(const QString &path, int depth) -> bool;
+    auto readText(const QByteArray &text, const QString &name,
+                  const QString &dir, int depth) -> bool;
+    auto finish(const QString &name) -> bool;
+
+    QString error;
+
+  private:
+    auto statement(const SpiceTokenizer::Statement &parsed,
+                   const QString &dir, int depth) -> bool;
+    auto fail(const QString &message) -> bool;
+    void element(const QStringList &tokens);
+
+    SpiceNetlist &netlist_;
+    QSet<QString> visited_;
+    Cell *cell_;         // open .subckt, else the top cell
+    bool ended_ = false; // .end seen in the top file
+    QString file_;
+    int line_ = 0;
+};
+
+auto SpiceNetlist::Reader::fail(const QString &message) -> bool {
+    error = QStringLiteral("%1: line %2: %3").arg(file_).arg(line_).arg(
+        message);
+    return false;
+}
+
+auto SpiceNetlist::Reader::readFile(const QString &path, int depth) -> bool {
+    const QFileInfo info(path);
+    const QString canonical = info.canonicalFilePath();
+    if (!canonical.isEmpty() && visited_.contains(canonical)) {
+        return true;
+    }
+    QFile file(info.absoluteFilePath());
+    if (canonical.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+        error = QStringLiteral("Failed to open file: %1").arg(path);
+        return false;
+    }
+    visited_.insert(canonical);
+    return readText(file.readAll(), path, info.absolutePath(), depth);
+}
+
+auto SpiceNetlist::Reader::readText(const QByteArray &text,
+                                    const QString &name, const QString &dir,
+                                    int depth) -> bool {
+    if (depth > maxIncludeDepth) {
+        return fail(QStringLiteral("includes nested too deeply"));
+    }
+    const QString outerFile = file_;
+    const int outerLine = line_;
+    file_ = name;
+    SpiceTokenizer tokenizer(
+        [this, &dir, depth](const SpiceTokenizer::Statement &parsed) {
+            // Whatever follows .end in the top file is not read.
+            return ended_ || statement(parsed, dir, depth);
+        });
+    const bool ok = tokenizer.feed(text.constData(), text.size()) &&
+                    tokenizer.finish();
+    file_ = outerFile;
+    line_ = outerLine;
+    return ok;
+}
+
+auto SpiceNetlist::Reader::statement(const SpiceTokenizer::Statement &parsed,
+                                     const QString &dir, int depth) -> bool {
+    line_ = static_cast<int>(parsed.line);
+    const QStringList tokens = strings(parsed);
+    const QString head = tokens.first().toLower();
+    if (!head.startsWith(QLatin1Char('.'))) {
+        element(tokens);
+        return true;
+    }
+    if (head == QStringLiteral(".subckt")) {
+        if (cell_ != &netlist_.top_) {
+            return fail(QStringLiteral(".subckt inside .subckt %1")
+                            .arg(cell_->name));
+        }
+        if (tokens.size() < 2) {
+            return fail(QStringLiteral(".subckt without a name"));
+        }
+        Cell cell;
+        cell.name = tokens.at(1);
+        for (qsizetype i = 2; i < tokens.size(); ++i) {
+            const QString &port = tokens.at(i);
+            if (port.contains(QLatin1Char('=')) ||
+                port.compare(QStringLiteral("params:"),
+                             Qt::CaseInsensitive) == 0) {
+                break;
+            }
+            cell.ports.append(port);
+        }
+        // A repeated definition replaces the earlier one, as in SPICE.
+        const QString key = cell.name.toLower();
+        auto it = netlist_.byName_.constFind(key);
+        if (it == netlist_.byName_.cend()) {
+            it = netlist_.byName_.insert(key, netlist_.cells_.size());
+            netlist_.cells_.append(std::move(cell));
+        } else {
+            netlist_.cells_[*it] = std::move(cell);
+        }
+        cell_ = &netlist_.cells_[*it];
+    } else if (head == QStringLiteral(".ends")) {
+        if (cell_ == &netlist_.top_) {
+            return fail(QStringLiteral(".ends without .subckt"));
+        }
+        cell_ = &netlist_.top_;
+    } else if (SpiceTokenizer::isInclude(parsed.tokens.front())) {
+        if (tokens.size() < 2) {
+            return fail(QStringLiteral("%1 without a file").arg(head));
+        }
+        // Keep the open cell across the include: it may hold elements.
+        const qsizetype open = cell_ == &netlist_.top_
+                                   ? -1
+                                   : netlist_.byName_.value(
+                                         cell_->name.toLower(), -1);
+        const QString path =
+            SpiceTokenizer::includePath(dir, parsed.tokens.at(1));
+        if (!readFile(path, depth + 1)) {
+            return false;
+        }
+        cell_ = open >= 0 ? &netlist_.cells_[open] : &netlist_.top_;
+    } else if (head == QStringLiteral(".global")) {
+        for (qsizetype i = 1; i < tokens.size(); ++i) {
+            netlist_.globals_.insert(tokens.at(i).toLower());
+        }
+    } else if (head == QStringLiteral(".end") && depth == 0) {
+        ended_ = true;
+    }
+    return true;
+}
+
+void SpiceNetlist::Reader::element(const QStringList &tokens) {
+    Element element;
+    element.name = tokens.first();
+    element.kind = element.name.front().toLower();
+    QStringList positional;
+    bool params = false;
+    for (qsizetype i = 1; i < tokens.size(); ++i) {
+        const QString &token = tokens.at(i);
+        const qsizetype eq = token.indexOf(QLatin1Char('='));
+        if (eq > 0) {
+            element.parameters.append(
+                {token.left(eq).toLower(), token.mid(eq + 1)});
+            params = true;
+        } else if (token.compare(QStringLiteral("params:"),
+                                 Qt::CaseInsensitive) == 0) {
+            params = true;
+        } else if (!params) {
+            positional.append(token);
+        }
+    }
+
+    // Nodes by the element letter; the token after them names the model.
+    const char kind = element.kind.toLatin1();
+    qsizetype nodes = positional.size() - 1;
+    switch (kind) {
+    case 'm':
+        nodes = 4;
+        break;
+    case 'd':
+        nodes = 2;
+        break;
+    case 'q':
+        nodes = positional.size() >= 5 ? 4 : 3;
+        break;
+    case 'r':
+    case 'c':
+    case 'l':
+        nodes = 2;
+        // "R1 a b 10k" has a value where other elements have a model.
+        if (positional.size() > 2 && isNumber(positional.at(2))) {
+            element.parameters.prepend(
+                {QStringLiteral("value"), positional.at(2)});
+            positional.removeAt(2);
+        } else if (positional.size() > 3 && isNumber(positional.at(3))) {
+            element.parameters.prepend(
+                {QStringLiteral("value"), positional.at(3)});
+        }
+        break;
+    default:
+        break;
+    }
+    nodes = std::clamp(nodes, qsizetype(0), positional.size());
+    element.nodes = positional.mid(0, nodes);
+    element.deviceClass = nodes < positional.size()
+                              ? positional.at(nodes)
+                              : QString(element.kind);
+    cell_->elements.append(std::move(element));
+}
+
+auto SpiceNetlist::Reader::finish(const QString &name) -> bool {
+    if (cell_ != &netlist_.top_) {
+        error = QStringLiteral("%1: .subckt %2 has no .ends")
+                    .arg(name, cell_->name);
+        return false;
+    }
+    return true;
+}
+
+auto SpiceNetlist::load(const QString &path, QString *error) -> bool {
+    OPENSVS_TRACE_SCOPE("SpiceNetlist::load", "parser");
+    *this = SpiceNetlist();
+    top_.name = QFileInfo(path).fileName();
+    Reader reader(*this);
+    if (!reader.readFile(path, 0) || !reader.finish(path)) {
+        *this = SpiceNetlist();
+        if (error != nullptr) {
+            *error = reader.error;
+        }
+        return false;
+    }
+    return true;
+}
+
+auto SpiceNetlist::parse(const QString &text, const QString &name,
+                         QString *error) -> bool {
+    OPENSVS_TRACE_SCOPE("SpiceNetlist::parse", "parser");
+    *this = SpiceNetlist();
+    top_.name = name;
+    Reader reader(*this);
+    if (!reader.readText(text.toUtf8(), name, QDir::currentPath(), 0) ||
+        !reader.finish(name)) {
+        *this = SpiceNetlist();
+        if (error != nullptr) {
+            *error = reader.error;
+        }
+        return false;
+    }
+    return true;
+}
+
+auto SpiceNetlist::cell(const QString &name) const -> const Cell * {
+    const auto it = byName_.constFind(name.toLower());
+    return it == byName_.cend() ? nullptr : &cells_.at(*it);
+}
+
+auto SpiceNetlist::isGlobal(const QString &net) const -> bool {
+    return net == QStringLiteral("0") || globals_.contains(net.toLower());
+}
+
+auto SpiceNetlist::isDeclaredGlobal(const QString &net) const -> bool {
+    return globals_.contains(net.toLower());
+}
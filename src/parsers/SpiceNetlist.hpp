@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// A SPICE netlist read into cells for NetlistComparator: each `.subckt`
+// with its ports and elements, and the statements outside any `.subckt`
+// as the top cell, named after the file as netgen names it. Statements
+// are split as SpiceTokenizer splits them, and `.include` files are read
+// where they appear, relative to the including file, each once; `.lib`
+// sections are not followed.
+// Names are case-insensitive. Nets named by `.global`, and node 0, are
+// global; isDeclaredGlobal leaves out node 0.
+class SpiceNetlist {
+  public:
+    struct Element {
+        QString name;        // as written: M1000, X0
+        QChar kind;          // lower-case first letter
+        QString deviceClass; // model or subcircuit name
+        QStringList nodes;
+        // name=value pairs, names lower-case, in order
+        QVector<QPair<QString, QString>> parameters;
+    };
+
+    struct Cell {
+        QString name;
+        QStringList ports;
+        QVector<Element> elements;
+    };
+
+    // Replaces the netlist; on error it is left empty.
+    auto load(const QString &path, QString *error = nullptr) -> bool;
+    // Reads text as the contents of a file called name; includes are
+    // resolved against the current directory.
+    auto parse(const QString &text, const QString &name,
+               QString *error = nullptr) -> bool;
+
+    auto top() const -> const Cell & { return top_; }
+    // .subckt definitions in file order.
+    auto cells() const -> const QVector<Cell> & { return cells_; }
+    auto cell(const QString &name) const -> const Cell *;
+    auto isGlobal(const QString &net) const -> bool;
+    auto isDeclaredGlobal(const QString &net) const -> bool;
+
+  private:
+    class Reader;
+
+    Cell top_;
+    QVector<Cell> cells_;
+    QHash<QString, qsizetype> byName_; // lower-case name -> cells_ index
+    QSet<QString> globals_;            // lower-case
+};
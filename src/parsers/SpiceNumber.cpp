@@ -0,0 +1,168 @@
+#include "parsers/SpiceNumber.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+// Powers of ten a double holds exactly; dividing by one rounds once.
+constexpr std::array<double, 23> exactPowers{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+// Significant digits kept in the mantissa: more than a double holds, and
+// few enough that the mil scale (x254) cannot overflow 64 bits.
+constexpr int maxDigits = 16;
+
+auto lower(QChar c) -> char16_t {
+    const char16_t u = c.unicode();
+    return (u >= u'A' && u <= u'Z') ? static_cast<char16_t>(u + 32) : u;
+}
+
+auto isDigit(QChar c) -> bool {
+    return c.unicode() >= u'0' && c.unicode() <= u'9';
+}
+
+auto isLetter(QChar c) -> bool {
+    const char16_t u = lower(c);
+    return u >= u'a' && u <= u'z';
+}
+
+auto startsWith(QStringView text, qsizetype at, const char16_t *word)
+    -> bool {
+    for (qsizetype k = 0; word[k] != u'\0'; ++k) {
+        if (at + k >= text.size() || lower(text[at + k]) != word[k]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto scaled(std::uint64_t mantissa, int exponent) -> double {
+    const auto value = static_cast<double>(mantissa);
+    if (exponent >= 0 && exponent < static_cast<int>(exactPowers.size())) {
+        return value * exactPowers[exponent];
+    }
+    if (exponent < 0 && -exponent < static_cast<int>(exactPowers.size())) {
+        return value / exactPowers[-exponent];
+    }
+    return value * std::pow(10.0, exponent);
+}
+} // namespace
+
+auto SpiceNumber::parse(QStringView text, double *value) -> bool {
+    text = text.trimmed();
+    qsizetype at = 0;
+    bool negative = false;
+    if (at < text.size() && (text[at] == QLatin1Char('+') ||
+                             text[at] == QLatin1Char('-'))) {
+        negative = text[at] == QLatin1Char('-');
+        ++at;
+    }
+
+    std::uint64_t mantissa = 0;
+    int exponent = 0;
+    int digits = 0; // significant digits in mantissa
+    bool anyDigit = false;
+    for (; at < text.size() && isDigit(text[at]); ++at) {
+        anyDigit = true;
+        const int d = text[at].unicode() - u'0';
+        if (digits < maxDigits) {
+            mantissa = mantissa * 10 + d;
+            digits += mantissa != 0 ? 1 : 0;
+        } else {
+            ++exponent;
+        }
+    }
+    if (at < text.size() && text[at] == QLatin1Char('.')) {
+        for (++at; at < text.size() && isDigit(text[at]); ++at) {
+            anyDigit = true;
+            if (digits < maxDigits) {
+                mantissa = mantissa * 10 + (text[at].unicode() - u'0');
+                digits += mantissa != 0 ? 1 : 0;
+                --exponent;
+            }
+        }
+    }
+    if (!anyDigit) {
+        return false;
+    }
+
+    // An e followed by digits is an exponent; otherwise it is a unit.
+    if (at < text.size() && lower(text[at]) == u'e') {
+        qsizetype next = at + 1;
+        bool negativeExp = false;
+        if (next < text.size() && (text[next] == QLatin1Char('+') ||
+                                   text[next] == QLatin1Char('-'))) {
+            negativeExp = text[next] == QLatin1Char('-');
+            ++next;
+        }
+        if (next < text.size() && isDigit(text[next])) {
+            int written = 0;
+            for (; next < text.size() && isDigit(text[next]); ++next) {
+                written = std::min(written * 10 + (text[next].unicode() - u'0'),
+                                   10000);
+            }
+            exponent += negativeExp ? -written : written;
+            at = next;
+        }
+    }
+
+    if (at < text.size()) {
+        if (startsWith(text, at, u"meg")) {
+            exponent += 6;
+        } else if (startsWith(text, at, u"mil")) {
+            mantissa *= 254;
+            exponent -= 7;
+        } else {
+            switch (lower(text[at])) {
+            case u't':
+                exponent += 12;
+                break;
+            case u'g':
+                exponent += 9;
+                break;
+            case u'k':
+                exponent += 3;
+                break;
+            case u'm':
+                exponent -= 3;
+                break;
+            case u'u':
+                exponent -= 6;
+                break;
+            case u'n':
+                exponent -= 9;
+                break;
+            case u'p':
+                exponent -= 12;
+                break;
+            case u'f':
+                exponent -= 15;
+                break;
+            case u'a':
+                exponent -= 18;
+                break;
+            default:
+                break;
+            }
+        }
+        for (; at < text.size(); ++at) {
+            if (!isLetter(text[at])) {
+                return false;
+            }
+        }
+    }
+
+    if (mantissa == 0) {
+        *value = negative ? -0.0 : 0.0;
+        return true;
+    }
+    while (mantissa % 10 == 0) {
+        mantissa /= 10;
+        ++exponent;
+    }
+    const double magnitude = scaled(mantissa, exponent);
+    *value = negative ? -magnitude : magnitude;
+    return true;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QStringView>
+
+// SPICE numbers as netgen prints property values: an optional sign, a
+// decimal mantissa, an optional e exponent and an optional scale suffix,
+// case-insensitive (f p n u m k meg g t, also a and mil), then any unit
+// letters, which are ignored ("10kohm", "1uF"). The mantissa is read as a
+// 64-bit integer with trailing zeros dropped, so "1e-6", "1u", "0.001m"
+// and "1.000u" all give the same double. Nothing is allocated; a value
+// costs one pass over its characters.
+class SpiceNumber {
+  public:
+    // false, leaving value untouched, unless the whole text (surrounding
+    // blanks aside) is a number.
+    static auto parse(QStringView text, double *value) -> bool;
+};
@@ -0,0 +1,112 @@
+#include "parsers/SpiceTokenizer.hpp"
+
+#include <QDir>
+#include <cstring>
+#include <utility>
+
+namespace {
+auto isBlank(char c) -> bool {
+    return c == ' ' || c == '\t' || c == '\r' || c == ',' || c == '(' ||
+           c == ')';
+}
+
+auto lower(char c) -> unsigned char {
+    const auto u = static_cast<unsigned char>(c);
+    return (u >= 'A' && u <= 'Z') ? static_cast<unsigned char>(u + 32) : u;
+}
+} // namespace
+
+auto SpiceTokenizer::Token::toString() const -> QString {
+    return QString::fromUtf8(text, size);
+}
+
+auto SpiceTokenizer::Token::is(const char *word) const -> bool {
+    const auto length = static_cast<qsizetype>(std::strlen(word));
+    if (size != length) {
+        return false;
+    }
+    for (qsizetype i = 0; i < size; ++i) {
+        if (lower(text[i]) != static_cast<unsigned char>(word[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto SpiceTokenizer::Token::contains(char c) const -> bool {
+    return std::memchr(text, c, static_cast<size_t>(size)) != nullptr;
+}
+
+SpiceTokenizer::SpiceTokenizer(Sink sink) : sink_(std::move(sink)) {}
+
+auto SpiceTokenizer::line(const char *begin, const char *end, qint64 offset)
+    -> bool {
+    ++lines_;
+    const char *p = begin;
+    while (p < end && isBlank(*p)) {
+        ++p;
+    }
+    if (p == end || *p == '*') {
+        return true; // blank lines and comments do not end a statement
+    }
+    if (*p == '+') {
+        ++p;
+    } else if (!finish()) {
+        return false;
+    }
+    while (p < end) {
+        while (p < end && isBlank(*p)) {
+            ++p;
+        }
+        if (p == end || *p == ';' || *p == '$') {
+            break;
+        }
+        const char *text = p;
+        while (p < end && !isBlank(*p) && *p != ';') {
+            ++p;
+        }
+        if (statement_.tokens.empty()) {
+            statement_.line = lines_;
+        }
+        statement_.tokens.push_back({text, p - text, offset + (text - begin)});
+    }
+    return true;
+}
+
+auto SpiceTokenizer::feed(const char *data, qint64 size) -> bool {
+    for (qint64 at = 0; at < size;) {
+        const auto *newline = static_cast<const char *>(
+            std::memchr(data + at, '\n', static_cast<size_t>(size - at)));
+        const qint64 stop = newline != nullptr ? newline - data : size;
+        if (!line(data + at, data + stop, at)) {
+            return false;
+        }
+        at = stop + 1;
+    }
+    return true;
+}
+
+auto SpiceTokenizer::finish() -> bool {
+    if (statement_.tokens.empty()) {
+        return true;
+    }
+    const bool ok = sink_(statement_);
+    statement_.tokens.clear();
+    return ok;
+}
+
+auto SpiceTokenizer::isInclude(const Token &head) -> bool {
+    return head.is(".include") || head.is(".inc");
+}
+
+auto SpiceTokenizer::includePath(const QString &dir, const Token &name)
+    -> QString {
+    QString file = name.toString();
+    if (file.size() >= 2 &&
+        (file.startsWith(QLatin1Char('"')) ||
+         file.startsWith(QLatin1Char('\''))) &&
+        file.endsWith(file.front())) {
+        file = file.mid(1, file.size() - 2);
+    }
+    return QDir(dir).filePath(file);
+}
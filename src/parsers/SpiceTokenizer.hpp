@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QString>
+#include <functional>
+#include <vector>
+
+// The SPICE syntax SpiceIndex and SpiceNetlist share. A statement is a
+// line and the `+` lines after it; `*` lines are comments and do not end
+// a statement. `;` anywhere, or `$` at the start of a token, comments out
+// the rest of a line. Blanks, commas and parentheses separate tokens.
+// Lines are UTF-8 bytes the caller keeps alive; tokens point into them,
+// so nothing is copied.
+class SpiceTokenizer {
+  public:
+    struct Token {
+        const char *text = nullptr;
+        qsizetype size = 0;
+        qint64 offset = 0; // of text, counted as the caller counts lines
+
+        auto toString() const -> QString;
+        // Case-insensitive comparison with a lower-case ASCII word.
+        auto is(const char *word) const -> bool;
+        auto contains(char c) const -> bool;
+    };
+
+    struct Statement {
+        std::vector<Token> tokens; // never empty
+        qint64 line = 0;           // 1-based line of the first token
+    };
+
+    // Receives each statement; returning false stops the tokenizer.
+    using Sink = std::function<bool(const Statement &)>;
+
+    explicit SpiceTokenizer(Sink sink);
+
+    // Feeds the next line, newline excluded, which starts at offset. A
+    // line that starts a statement first hands the previous one over.
+    auto line(const char *begin, const char *end, qint64 offset) -> bool;
+    // line() for every line of data.
+    auto feed(const char *data, qint64 size) -> bool;
+    // Hands over the last statement; none continues into another file.
+    auto finish() -> bool;
+    auto lineCount() const -> qint64 { return lines_; }
+
+    // .include or .inc.
+    static auto isInclude(const Token &head) -> bool;
+    // The file an include names, quotes removed, relative to dir.
+    static auto includePath(const QString &dir, const Token &name)
+        -> QString;
+
+  private:
+    Sink sink_;
+    Statement statement_;
+    qint64 lines_ = 0;
+};
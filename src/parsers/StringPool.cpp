@@ -0,0 +1,157 @@
+#include "parsers/StringPool.hpp"
+
+#include <QMutexLocker>
+#include <algorithm>
+
+#include "diagnostics/Tracer.hpp"
+
+namespace {
+using DiffEntry = NetgenJsonParser::DiffEntry;
+
+auto sameDiff(const DiffEntry &a, const DiffEntry &b) -> bool {
+    return a.type == b.type && a.subtype == b.subtype &&
+           a.sourceIndex == b.sourceIndex &&
+           a.circuitIndex == b.circuitIndex && a.name == b.name &&
+           a.layoutCell == b.layoutCell &&
+           a.schematicCell == b.schematicCell && a.details == b.details &&
+           a.details.isNull() == b.details.isNull();
+}
+
+auto sameDiffs(const QVector<DiffEntry> &a, const QVector<DiffEntry> &b)
+    -> bool {
+    return a.size() == b.size() &&
+           std::equal(a.cbegin(), a.cend(), b.cbegin(), sameDiff);
+}
+
+// True when only the pool holds the container; empty ones cost nothing.
+template <typename T> auto unreferenced(const T &container) -> bool {
+    return container.isEmpty() || container.isDetached();
+}
+} // namespace
+
+auto StringPool::intern(const QString &value) -> QString {
+    const QMutexLocker lock(&mutex_);
+    return internLocked(value);
+}
+
+auto StringPool::internLocked(const QString &value) -> QString {
+    if (value.isEmpty()) {
+        return value;
+    }
+    const auto it = strings_.constFind(value);
+    if (it != strings_.cend()) {
+        return *it;
+    }
+    strings_.insert(value);
+    return value;
+}
+
+void StringPool::internLocked(QStringList &list) {
+    for (QString &value : list) {
+        value = internLocked(value);
+    }
+}
+
+void StringPool::intern(QVector<Circuit> &circuits) {
+    OPENSVS_TRACE_SCOPE("StringPool::intern", "parser");
+    const QMutexLocker lock(&mutex_);
+    for (Circuit &cir : circuits) {
+        cir.layoutCell = internLocked(cir.layoutCell);
+        cir.schematicCell = internLocked(cir.schematicCell);
+        const QString key = cir.layoutCell + QLatin1Char('\n') +
+                            cir.schematicCell;
+
+        bool shared = false;
+        for (auto it = cells_.constFind(key);
+             it != cells_.cend() && it.key() == key; ++it) {
+            if (sameDiffs(it->diffs, cir.diffs) &&
+                it->devicesA == cir.devicesA && it->devicesB == cir.devicesB) {
+                cir.diffs = it->diffs;
+                cir.devicesA = it->devicesA;
+                cir.devicesB = it->devicesB;
+                shared = true;
+                ++sharedCircuits_;
+                break;
+            }
+        }
+        if (!shared) {
+            for (DiffEntry &entry : cir.diffs) {
+                entry.name = internLocked(entry.name);
+                entry.layoutCell = internLocked(entry.layoutCell);
+                entry.schematicCell = internLocked(entry.schematicCell);
+                entry.details = internLocked(entry.details);
+            }
+            internLocked(cir.devicesA);
+            internLocked(cir.devicesB);
+            cells_.insert(key, Cell{cir.diffs, cir.devicesA, cir.devicesB});
+        }
+
+        internLocked(cir.pinsA);
+        internLocked(cir.pinsB);
+
+        // The hash must be rebuilt to swap its keys; the values stay.
+        if (!cir.subcircuits.isEmpty()) {
+            QHash<QString, Circuit *> links;
+            links.reserve(cir.subcircuits.size());
+            for (auto it = cir.subcircuits.cbegin();
+                 it != cir.subcircuits.cend(); ++it) {
+                links.insert(internLocked(it.key()), it.value());
+            }
+            cir.subcircuits = std::move(links);
+        }
+    }
+}
+
+auto StringPool::prune() -> qsizetype {
+    const QMutexLocker lock(&mutex_);
+    // Cells first: they hold the strings of their diffs.
+    for (auto it = cells_.begin(); it != cells_.end();) {
+        if (unreferenced(it->diffs) && unreferenced(it->devicesA) &&
+            unreferenced(it->devicesB)) {
+            it = cells_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    qsizetype dropped = 0;
+    for (auto it = strings_.begin(); it != strings_.end();) {
+        if (it->isDetached()) {
+            it = strings_.erase(it);
+            ++dropped;
+        } else {
+            ++it;
+        }
+    }
+    return dropped;
+}
+
+auto StringPool::size() const -> qsizetype {
+    const QMutexLocker lock(&mutex_);
+    return strings_.size();
+}
+
+auto StringPool::cellCount() const -> qsizetype {
+    const QMutexLocker lock(&mutex_);
+    return cells_.size();
+}
+
+auto StringPool::sharedCircuits() const -> qint64 {
+    const QMutexLocker lock(&mutex_);
+    return sharedCircuits_;
+}
+
+auto StringPool::memoryBytes() const -> qint64 {
+    const QMutexLocker lock(&mutex_);
+    // Qt 6 QHash: spans of 128 one-byte offsets plus one node per entry.
+    auto tableBytes = [](qsizetype capacity, qsizetype size,
+                         qsizetype nodeBytes) -> qint64 {
+        if (capacity == 0) {
+            return 0;
+        }
+        const qint64 spans = (static_cast<qint64>(capacity) + 127) / 128;
+        return spans * (128 + 16) + static_cast<qint64>(size) * nodeBytes;
+    };
+    return tableBytes(strings_.capacity(), strings_.size(), sizeof(QString)) +
+           tableBytes(cells_.capacity(), cells_.size(),
+                      sizeof(QString) + sizeof(Cell) + sizeof(void *));
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QMultiHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "parsers/NetgenJsonParser.hpp"
+
+// Interns the strings of parsed reports so that several reports of the same
+// design, open side by side, hold one copy of each net, device and cell
+// name and of each detail text. Circuits whose diffs and device lists equal
+// those of a circuit interned before (same cells, e.g. an unchanged block
+// across two corners) take over that circuit's arrays, so the per-cell data
+// is shared too. Everything stays implicitly shared: a report that is later
+// modified detaches as usual.
+class StringPool {
+  public:
+    using Circuit = NetgenJsonParser::Report::Circuit;
+
+    // The pooled copy of value, added if new. Null and empty strings are
+    // returned as they are.
+    auto intern(const QString &value) -> QString;
+    // Interns the circuits in place; subcircuit links stay valid.
+    void intern(QVector<Circuit> &circuits);
+
+    // Drops what no report references any more, e.g. after closing one.
+    // Returns the number of strings dropped.
+    auto prune() -> qsizetype;
+
+    auto size() const -> qsizetype; // strings
+    auto cellCount() const -> qsizetype;
+    // Circuits whose arrays were taken from an earlier one.
+    auto sharedCircuits() const -> qint64;
+    // Bytes of the pool's own tables; the pooled payloads are counted with
+    // the reports that share them.
+    auto memoryBytes() const -> qint64;
+
+  private:
+    struct Cell {
+        QVector<NetgenJsonParser::DiffEntry> diffs;
+        QStringList devicesA;
+        QStringList devicesB;
+    };
+
+    auto internLocked(const QString &value) -> QString;
+    void internLocked(QStringList &list);
+
+    mutable QMutex mutex_;
+    QSet<QString> strings_;
+    QMultiHash<QString, Cell> cells_; // by layout and schematic cell
+    qint64 sharedCircuits_{0};
+};
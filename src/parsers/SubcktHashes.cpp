@@ -0,0 +1,86 @@
+#include "parsers/SubcktHashes.hpp"
+
+#include <QCryptographicHash>
+#include <QSet>
+
+#include "diagnostics/Tracer.hpp"
+#include "parsers/SpiceNetlist.hpp"
+
+namespace {
+using Cell = SpiceNetlist::Cell;
+
+const auto hashFormat = QByteArrayLiteral("opensvs-subckt-v1");
+const auto hashAlgorithm = QCryptographicHash::Blake2b_256;
+constexpr int maxDepth = 64;
+
+class Hasher {
+  public:
+    Hasher(const SpiceNetlist &netlist, QHash<QString, QByteArray> &hashes)
+        : netlist_(netlist), hashes_(hashes) {}
+
+    auto of(const Cell &cell, const QString &key, int depth) -> QByteArray;
+
+  private:
+    void text(QCryptographicHash &hash, const QString &value) const {
+        hash.addData(value.toLower().toUtf8());
+        hash.addData(QByteArrayView("\0", 1));
+    }
+
+    const SpiceNetlist &netlist_;
+    QHash<QString, QByteArray> &hashes_;
+    QSet<QString> open_; // cells being hashed, to cut recursion
+};
+
+auto Hasher::of(const Cell &cell, const QString &key, int depth)
+    -> QByteArray {
+    const auto it = hashes_.constFind(key);
+    if (it != hashes_.cend()) {
+        return *it;
+    }
+    QCryptographicHash hash(hashAlgorithm);
+    hash.addData(hashFormat);
+    open_.insert(key);
+    text(hash, QString::number(cell.ports.size()));
+    for (const QString &port : cell.ports) {
+        text(hash, port);
+    }
+    for (const SpiceNetlist::Element &element : cell.elements) {
+        text(hash, element.name);
+        text(hash, QString::number(element.nodes.size()));
+        for (const QString &node : element.nodes) {
+            text(hash, netlist_.isGlobal(node) ? QStringLiteral("global:") +
+                                                     node
+                                               : node);
+        }
+        const QString child = element.deviceClass.toLower();
+        const Cell *sub = element.kind == QLatin1Char('x')
+                              ? netlist_.cell(child)
+                              : nullptr;
+        if (sub != nullptr && !open_.contains(child) && depth < maxDepth) {
+            hash.addData(of(*sub, child, depth + 1));
+        } else {
+            text(hash, element.deviceClass);
+        }
+        text(hash, QString::number(element.parameters.size()));
+        for (const auto &[name, value] : element.parameters) {
+            text(hash, name);
+            text(hash, value);
+        }
+    }
+    open_.remove(key);
+    return *hashes_.insert(key, hash.result());
+}
+} // namespace
+
+SubcktHashes::SubcktHashes(const SpiceNetlist &netlist) {
+    OPENSVS_TRACE_SCOPE("SubcktHashes", "parser");
+    Hasher hasher(netlist, hashes_);
+    for (const Cell &cell : netlist.cells()) {
+        hasher.of(cell, cell.name.toLower(), 0);
+    }
+    hasher.of(netlist.top(), netlist.top().name.toLower(), 0);
+}
+
+auto SubcktHashes::hash(const QString &cell) const -> QByteArray {
+    return hashes_.value(cell.toLower());
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+class SpiceNetlist;
+
+// Merkle digests of the cells of a SpiceNetlist for incremental
+// comparison: a cell's digest covers its ports and elements as read
+// (case-folded, so layout and continuation lines do not count) and, for
+// each subcircuit call, the digest of the called cell instead of its name.
+// A cell's digest therefore changes exactly when it or anything below it
+// changes, and an unchanged digest on both sides means an earlier result
+// for that cell still holds. Calls to undefined cells hash their name,
+// global nets are marked as such, and the top level is hashed under the
+// file name.
+class SubcktHashes {
+  public:
+    SubcktHashes() = default;
+    explicit SubcktHashes(const SpiceNetlist &netlist);
+
+    // Empty for an unknown cell; names are case-insensitive.
+    auto hash(const QString &cell) const -> QByteArray;
+    auto size() const -> qsizetype { return hashes_.size(); }
+
+  private:
+    QHash<QString, QByteArray> hashes_; // lower-case name -> digest
+};
@@ -0,0 +1,93 @@
+#include <QBuffer>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "SyntheticReport.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+
+class SyntheticReportTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void parses_with_expected_shape();
+    static void is_deterministic();
+    static void reaches_target_size();
+};
+
+namespace {
+auto generate(const SyntheticReport::Knobs &knobs) -> QByteArray {
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    SyntheticReport::write(buffer, knobs);
+    return buffer.data();
+}
+} // namespace
+
+void SyntheticReportTests::parses_with_expected_shape() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("synthetic.json"));
+    SyntheticReport::Knobs knobs;
+    knobs.circuits = 10;
+    knobs.depth = 3;
+    knobs.fanout = 4;
+    knobs.badnets = 8;
+    knobs.pinsPerNet = 3;
+    knobs.propertyMismatches = 2;
+    const auto stats = SyntheticReport::writeFile(path, knobs);
+    QCOMPARE(stats.bytes, QFileInfo(path).size());
+    // 10 leaves, 3 blocks above them and one top cell.
+    QCOMPARE(stats.circuits, 14LL);
+
+    const auto report = NetgenJsonParser::parseFile(path);
+    QVERIFY2(report.ok, qPrintable(report.error));
+    QCOMPARE(report.circuits.size(), 14);
+    long long diffs = 0;
+    int noMatchingNet = 0;
+    int properties = 0;
+    for (const auto &cir : report.circuits) {
+        diffs += cir.diffs.size();
+        for (const auto &entry : cir.diffs) {
+            noMatchingNet += static_cast<int>(
+                entry.subtype ==
+                NetgenJsonParser::DiffEntry::Subtype::NoMatchingNet);
+            properties += static_cast<int>(
+                entry.type == NetgenJsonParser::DiffType::PropertyMismatch);
+        }
+    }
+    QCOMPARE(diffs, stats.diffs);
+    QCOMPARE(noMatchingNet, 14 * 2);
+    QCOMPARE(properties, 14 * 2);
+    QCOMPARE(report.summary.netMismatches, 14 * 8);
+
+    const auto &top = report.circuits.last();
+    QVERIFY(top.isTopLevel);
+    QCOMPARE(top.subcircuits.size(), 3);
+    QCOMPARE(top.layoutCell.size(), knobs.nameLength);
+    for (const auto &cir : report.circuits) {
+        QCOMPARE(cir.isTopLevel, &cir == &top);
+    }
+}
+
+void SyntheticReportTests::is_deterministic() {
+    SyntheticReport::Knobs knobs;
+    const QByteArray first = generate(knobs);
+    QVERIFY(!first.isEmpty());
+    QCOMPARE(generate(knobs), first);
+    knobs.seed = 2;
+    QVERIFY(generate(knobs) != first);
+}
+
+void SyntheticReportTests::reaches_target_size() {
+    SyntheticReport::Knobs knobs;
+    knobs.targetBytes = 256 * 1024;
+    const QByteArray data = generate(knobs);
+    QVERIFY(data.size() >= knobs.targetBytes);
+    QVERIFY(data.size() < knobs.targetBytes * 11 / 10);
+    QVERIFY(QJsonDocument::fromJson(data).isArray());
+}
+
+QTEST_MAIN(SyntheticReportTests)
+#include "SyntheticReportTests.moc"
@@ -0,0 +1,457 @@
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "cli/Cli.hpp"
+
+class CliTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void detects_headless_arguments();
+    static void prints_text_summary();
+    static void lists_filtered_diffs_as_csv();
+    static void writes_json_document();
+    static void exits_clean_without_matching_diffs();
+    static void reports_errors();
+    static void writes_chrome_trace();
+    static void prints_memory_breakdown();
+    static void reads_details_on_demand();
+    static void compares_with_baseline();
+    static void applies_waivers();
+    static void groups_similar_diffs();
+    static void counts_unique_masters();
+    static void prints_device_classes();
+    static void applies_tolerances();
+    static void compares_netlists();
+    static void reuses_unchanged_netlist_cells();
+};
+
+namespace {
+struct Result {
+    int code = -1;
+    QString out;
+    QString err;
+};
+
+auto runCli(const QStringList &args) -> Result {
+    Result result;
+    QTextStream out(&result.out);
+    QTextStream err(&result.err);
+    result.code = Cli::run(QStringList{QStringLiteral("opensvs-cli")} + args,
+                           out, err);
+    out.flush();
+    err.flush();
+    return result;
+}
+} // namespace
+
+void CliTests::detects_headless_arguments() {
+    char prog[] = "opensvs";
+    char summary[] = "--summary";
+    char format[] = "--format=csv";
+    char file[] = "report.json";
+    char dashes[] = "--";
+
+    char *gui[] = {prog, file};
+    QVERIFY(!Cli::isHeadless(2, gui));
+    char *withSummary[] = {prog, summary, file};
+    QVERIFY(Cli::isHeadless(3, withSummary));
+    char *withFormat[] = {prog, file, format};
+    QVERIFY(Cli::isHeadless(3, withFormat));
+    char *afterDashes[] = {prog, dashes, summary};
+    QVERIFY(!Cli::isHeadless(3, afterDashes));
+    char netlists[] = "--netlists";
+    char *withNetlists[] = {prog, netlists, file, file};
+    QVERIFY(Cli::isHeadless(4, withNetlists));
+}
+
+void CliTests::prints_text_summary() {
+    const Result result =
+        runCli({QStringLiteral("--summary"), QStringLiteral(FIXTURE_PATH)});
+    QCOMPARE(result.code, static_cast<int>(Cli::ExitDiffs));
+    QVERIFY(result.err.isEmpty());
+    QVERIFY(result.out.contains(QStringLiteral("Layout cell: bufferA.spice")));
+    QVERIFY(result.out.contains(QStringLiteral("Total devices: 4")));
+    QVERIFY(result.out.contains(QStringLiteral("Diffs: 16")));
+}
+
+void CliTests::lists_filtered_diffs_as_csv() {
+    const Result result =
+        runCli({QStringLiteral("--format"), QStringLiteral("csv"),
+                QStringLiteral("--search"), QStringLiteral("inverter:0/"),
+                QStringLiteral(FIXTURE_PATH)});
+    QCOMPARE(result.code, static_cast<int>(Cli::ExitDiffs));
+    const QStringList lines = result.out.split(QLatin1Char('\n'),
+                                                 Qt::SkipEmptyParts);
+    QCOMPARE(lines.first(),
+             QStringLiteral(
+                 "type,subtype,object,layout_cell,schematic_cell,details"));
+    QCOMPARE(lines.size(), 1 + 8);
+    for (const QString &line : lines.mid(1)) {
+        QVERIFY(line.startsWith(QStringLiteral("property_mismatch,")));
+    }
+}
+
+void CliTests::writes_json_document() {
+    const Result result = runCli(
+        {QStringLiteral("--summary"), QStringLiteral("--list-diffs"),
+         QStringLiteral("--format=json"), QStringLiteral("--type"),
+         QStringLiteral("instance_mismatch"), QStringLiteral(TUT6_PATH)});
+    QJsonParseError error;
+    const QJsonDocument doc =
+        QJsonDocument::fromJson(result.out.toUtf8(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    const QJsonObject root = doc.object();
+    const QJsonArray diffs = root.value(QStringLiteral("diffs")).toArray();
+    QVERIFY(!diffs.isEmpty());
+    QCOMPARE(root.value(QStringLiteral("summary"))
+                 .toObject()
+                 .value(QStringLiteral("diffs"))
+                 .toInt(),
+             diffs.size());
+    for (const QJsonValueConstRef &row : diffs) {
+        QCOMPARE(row.toObject().value(QStringLiteral("type")).toString(),
+                 QStringLiteral("instance_mismatch"));
+    }
+}
+
+void CliTests::exits_clean_without_matching_diffs() {
+    const Result result =
+        runCli({QStringLiteral("--list-diffs"), QStringLiteral("--search"),
+                QStringLiteral("no_such_object_anywhere"),
+                QStringLiteral(FIXTURE_PATH)});
+    QCOMPARE(result.code, static_cast<int>(Cli::ExitClean));
+    QVERIFY(result.out.isEmpty());
+}
+
+void CliTests::reports_errors() {
+    Result result = runCli({QStringLiteral("--summary"),
+                            QStringLiteral("/nonexistent/report.json")});
+    QCOMPARE(result.code, static_cast<int>(Cli::ExitError));
+    QVERIFY(result.err.contains(QStringLiteral("Failed to open file")));
+
+    result = runCli({QStringLiteral("--format"), QStringLiteral("xml"),
+                     QStringLiteral(FIXTURE_PATH)});
+    QCOMPARE(result.code, static_cast<int>(Cli::ExitError));
+
+    result = runCli({QStringLiteral("--cell"), QStringLiteral("nope"),
+                     QStringLiteral(FIXTURE_PATH)});
+    QCOMPARE(result.code, static_cast<int>(Cli::ExitError));
+}
+
+void CliTests::writes_chrome_trace() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString tracePath = dir.filePath(QStringLiteral("trace.json"));
+    const Result result =
+        runCli({QStringLiteral("--summary"), QStringLiteral("--trace"),
+                tracePath, QStringLiteral(FIXTURE_PATH)});
+    QCOMPARE(result.code, static_cast<int>(Cli::ExitDiffs));
+
+    QFile file(tracePath);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QJsonArray events = QJsonDocument::fromJson(file.readAll())
+                                  .object()
+                                  .value(QStringLiteral("traceEvents"))
+                                  .toArray();
+    QStringList names;
+    for (const auto &event : events) {
+        names << event.toObject().value(QStringLiteral("name")).toString();
+    }
+    QVERIFY(names.contains(QStringLiteral("NetgenJsonParser::parseFile")));
+    QVERIFY(names.contains(QStringLiteral("filter diffs")));
+    QVERIFY(names.contains(QStringLiteral("write output")));
+}
+
+void CliTests::prints_memory_breakdown() {
+    const Result text =
+        runCli({QStringLiteral("--memory"), QStringLiteral(FIXTURE_PATH)});
+    QCOMPARE(text.code, static_cast<int>(Cli::ExitDiffs));
+    QVERIFY(text.out.contains(QStringLiteral("Diffs: 16")));
+    QVERIFY(text.out.contains(QStringLiteral("diff strings: details")));
+    QVERIFY(text.out.contains(QStringLiteral("total")));
+
+    const Result json =
+        runCli({QStringLiteral("--memory"), QStringLiteral("--format"),
+                QStringLiteral("json"), QStringLiteral("--summary"),
+                QStringLiteral(FIXTURE_PATH)});
+    const QJsonObject memory =
+        QJsonDocument::fromJson(json.out.toUtf8())
+            .object()
+            .value(QStringLiteral("memory"))
+            .toObject();
+    QVERIFY(memory.value(QStringLiteral("total_bytes")).toInteger() > 0);
+    QVERIFY(!memory.value(QStringLiteral("items")).toArray().isEmpty());
+}
+
+void CliTests::reads_details_on_demand() {
+    const QStringList args{QStringLiteral("--format"), QStringLiteral("tsv"),
+                           QStringLiteral("--search"),
+                           QStringLiteral("Layout circuit"),
+                           QStringLiteral(TUT6_PATH)};
+    const Result resident = runCli(args);
+    const Result onDemand =
+        runCli(QStringList{QStringLiteral("--details-on-demand")} + args);
+    QCOMPARE(onDemand.code, resident.code);
+    QVERIFY(onDemand.err.isEmpty());
+    QVERIFY(resident.out.count(QLatin1Char('\n')) > 1);
+    QCOMPARE(onDemand.out, resident.out);
+}
+
+void CliTests::compares_with_baseline() {
+    const QString tut1 = QStringLiteral(FIXTURE_PATH);
+    const QString tut6 = QStringLiteral(TUT6_PATH);
+    const Result same =
+        runCli({QStringLiteral("--baseline"), tut6, QStringLiteral("--delta"),
+                QStringLiteral("new"), tut6});
+    QCOMPARE(same.code, static_cast<int>(Cli::ExitClean));
+    QVERIFY(same.out.contains(QStringLiteral("Delta: 0 new, 0 fixed")));
+
+    const Result json =
+        runCli({QStringLiteral("--baseline"), tut1, QStringLiteral("--format"),
+                QStringLiteral("json"), QStringLiteral("--summary"), tut6});
+    QCOMPARE(json.code, static_cast<int>(Cli::ExitDiffs));
+    const QJsonObject delta = QJsonDocument::fromJson(json.out.toUtf8())
+                                  .object()
+                                  .value(QStringLiteral("delta"))
+                                  .toObject();
+    QCOMPARE(delta.value(QStringLiteral("fixed")).toInteger(), 16);
+    QVERIFY(delta.value(QStringLiteral("new")).toInteger() > 0);
+    QCOMPARE(delta.value(QStringLiteral("unchanged")).toInteger(), 0);
+
+    // Fixed rows come from the baseline: one line each plus the header.
+    const Result fixed =
+        runCli({QStringLiteral("--baseline"), tut1, QStringLiteral("--delta"),
+                QStringLiteral("fixed"), QStringLiteral("--format"),
+                QStringLiteral("csv"), tut6});
+    QCOMPARE(fixed.code, static_cast<int>(Cli::ExitDiffs));
+    QCOMPARE(fixed.out.count(QLatin1Char('\n')), qsizetype(17));
+
+    const Result orphan =
+        runCli({QStringLiteral("--delta"), QStringLiteral("new"), tut6});
+    QCOMPARE(orphan.code, static_cast<int>(Cli::ExitError));
+}
+
+void CliTests::applies_waivers() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("waivers.txt"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("object=*   # everything is known\n");
+    file.close();
+
+    const QString tut6 = QStringLiteral(TUT6_PATH);
+    const Result hidden =
+        runCli({QStringLiteral("--waivers"), path, QStringLiteral("--format"),
+                QStringLiteral("csv"), tut6});
+    QCOMPARE(hidden.code, static_cast<int>(Cli::ExitClean));
+    QCOMPARE(hidden.out.count(QLatin1Char('\n')), qsizetype(1));
+
+    const Result shown = runCli({QStringLiteral("--waivers"), path,
+                                 QStringLiteral("--show-waived"),
+                                 QStringLiteral("--summary"), tut6});
+    QCOMPARE(shown.code, static_cast<int>(Cli::ExitDiffs));
+    QVERIFY(shown.out.contains(QStringLiteral("(1 rules)")));
+    QVERIFY(shown.out.contains(QStringLiteral("Waived: ")));
+
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("object=a\nshape=round\n");
+    file.close();
+    const Result bad = runCli({QStringLiteral("--waivers"), path, tut6});
+    QCOMPARE(bad.code, static_cast<int>(Cli::ExitError));
+    QVERIFY(bad.err.contains(QStringLiteral("line 2: unknown field shape")));
+}
+
+void CliTests::groups_similar_diffs() {
+    const QString tut6 = QStringLiteral(TUT6_PATH);
+    const Result rows =
+        runCli({QStringLiteral("--format"), QStringLiteral("csv"), tut6});
+    const Result groups =
+        runCli({QStringLiteral("--group"), QStringLiteral("--format"),
+                QStringLiteral("csv"), tut6});
+    QCOMPARE(groups.code, static_cast<int>(Cli::ExitDiffs));
+    QVERIFY(groups.out.startsWith(QStringLiteral("count,type,subtype,")));
+    const qsizetype groupCount = groups.out.count(QLatin1Char('\n')) - 1;
+    QVERIFY(groupCount > 0);
+    QVERIFY(groupCount <= rows.out.count(QLatin1Char('\n')) - 1);
+
+    const Result json =
+        runCli({QStringLiteral("--group"), QStringLiteral("--format"),
+                QStringLiteral("json"), tut6});
+    const QJsonObject root =
+        QJsonDocument::fromJson(json.out.toUtf8()).object();
+    QVERIFY(!root.contains(QStringLiteral("diffs")));
+    const QJsonArray array = root.value(QStringLiteral("groups")).toArray();
+    QCOMPARE(array.size(), groupCount);
+    qint64 total = 0;
+    for (const auto &value : array) {
+        total += value.toObject().value(QStringLiteral("count")).toInteger();
+    }
+    QCOMPARE(total, qint64(rows.out.count(QLatin1Char('\n')) - 1));
+}
+
+void CliTests::counts_unique_masters() {
+    const QString tut6 = QStringLiteral(TUT6_PATH);
+    const Result all =
+        runCli({QStringLiteral("--format"), QStringLiteral("json"), tut6});
+    const Result unique =
+        runCli({QStringLiteral("--unique-masters"), QStringLiteral("--summary"),
+                QStringLiteral("--list-diffs"), QStringLiteral("--format"),
+                QStringLiteral("json"), tut6});
+    QCOMPARE(unique.code, static_cast<int>(Cli::ExitDiffs));
+    const QJsonObject allRoot =
+        QJsonDocument::fromJson(all.out.toUtf8()).object();
+    const QJsonObject root =
+        QJsonDocument::fromJson(unique.out.toUtf8()).object();
+    const QJsonObject masters =
+        root.value(QStringLiteral("masters")).toObject();
+    QVERIFY(masters.value(QStringLiteral("masters")).toInteger() > 0);
+    const qsizetype listed =
+        root.value(QStringLiteral("diffs")).toArray().size();
+    QVERIFY(listed <=
+            allRoot.value(QStringLiteral("diffs")).toArray().size());
+    QVERIFY(masters.value(QStringLiteral("occurrences")).toInteger() >=
+            listed);
+
+    const Result text = runCli({QStringLiteral("--unique-masters"), tut6});
+    QVERIFY(text.out.contains(QStringLiteral("Masters: ")));
+    QVERIFY(text.out.contains(QStringLiteral("Diff occurrences: ")));
+}
+
+void CliTests::prints_device_classes() {
+    const QString tut3 = QStringLiteral(TUT3_PATH);
+    const Result text = runCli({QStringLiteral("--devices"), tut3});
+    QVERIFY(text.out.contains(
+        QStringLiteral("Devices with subcells: bufferA.spice vs "
+                       "bufferB.spice\n    pfet: 2 vs 3 **Mismatch**\n"
+                       "    nfet: 2 vs 2\n")));
+
+    const Result csv =
+        runCli({QStringLiteral("--summary"), QStringLiteral("--devices"),
+                QStringLiteral("--format"), QStringLiteral("csv"), tut3});
+    QVERIFY(csv.out.contains(QStringLiteral(
+        "layout_cell,schematic_cell,class,layout,schematic\n")));
+    QVERIFY(csv.out.contains(QStringLiteral("inverter,inverter,pfet,1,2\n")));
+
+    const Result json =
+        runCli({QStringLiteral("--devices"), QStringLiteral("--format"),
+                QStringLiteral("json"), tut3});
+    const QJsonArray devices = QJsonDocument::fromJson(json.out.toUtf8())
+                                   .object()
+                                   .value(QStringLiteral("devices"))
+                                   .toArray();
+    QCOMPARE(devices.size(), qsizetype(2));
+}
+
+void CliTests::applies_tolerances() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString report = dir.filePath(QStringLiteral("report.json"));
+    QFile json(report);
+    QVERIFY(json.open(QIODevice::WriteOnly | QIODevice::Text));
+    json.write(R"([{"name": ["top", "top"], "properties": [
+        [["M1", [["w", "1e-6"], ["ad", "1p"]]],
+         ["M1", [["w", "1u"], ["ad", "1.05p"]]]]]}])");
+    json.close();
+    const QString path = dir.filePath(QStringLiteral("tolerances.txt"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("ad  rel=10%   # extraction rounds areas\n");
+    file.close();
+
+    const Result exact =
+        runCli({QStringLiteral("--format"), QStringLiteral("csv"), report});
+    QCOMPARE(exact.code, static_cast<int>(Cli::ExitDiffs));
+    QCOMPARE(exact.out.count(QLatin1Char('\n')), qsizetype(2));
+    QVERIFY(exact.out.contains(QStringLiteral("ad: 1p vs 1.05p")));
+
+    const Result loose =
+        runCli({QStringLiteral("--tolerances"), path,
+                QStringLiteral("--format"), QStringLiteral("csv"), report});
+    QCOMPARE(loose.code, static_cast<int>(Cli::ExitClean));
+
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("ad within=10%\n");
+    file.close();
+    const Result bad =
+        runCli({QStringLiteral("--tolerances"), path, report});
+    QCOMPARE(bad.code, static_cast<int>(Cli::ExitError));
+    QVERIFY(bad.err.contains(QStringLiteral("line 1: expected rel= or abs=")));
+}
+
+void CliTests::compares_netlists() {
+    const QString tut1 = QFileInfo(QStringLiteral(FIXTURE_PATH)).path();
+    const QString layout = tut1 + QStringLiteral("/bufferA.spice");
+    const QString schematic = tut1 + QStringLiteral("/bufferB.spice");
+    // The same diffs as netgen's report of this setup.
+    Result result =
+        runCli({QStringLiteral("--netlists"), QStringLiteral("--flatten"),
+                QStringLiteral("inverter"), layout, schematic});
+    QCOMPARE(result.code, static_cast<int>(Cli::ExitDiffs));
+    QVERIFY(result.err.isEmpty());
+    QVERIFY(result.out.contains(QStringLiteral("Layout cell: bufferA.spice")));
+    QVERIFY(result.out.contains(QStringLiteral("Diffs: 16")));
+
+    // Unflattened, the inverter is compared once, as a circuit of its own.
+    result = runCli({QStringLiteral("--netlists"), layout, schematic});
+    QCOMPARE(result.code, static_cast<int>(Cli::ExitDiffs));
+    QVERIFY(result.out.contains(QStringLiteral("Circuits: 2")));
+    QVERIFY(result.out.contains(QStringLiteral("Diffs: 8")));
+
+    result = runCli({QStringLiteral("--netlists"), layout});
+    QCOMPARE(result.code, static_cast<int>(Cli::ExitError));
+    QVERIFY(result.err.contains(QStringLiteral("layout and a schematic")));
+    result = runCli({QStringLiteral("--flatten"), QStringLiteral("inverter"),
+                     QStringLiteral(FIXTURE_PATH)});
+    QCOMPARE(result.code, static_cast<int>(Cli::ExitError));
+    result = runCli({QStringLiteral("--netlists"), layout,
+                     QStringLiteral("/nonexistent/b.spice")});
+    QCOMPARE(result.code, static_cast<int>(Cli::ExitError));
+    QVERIFY(result.err.contains(QStringLiteral("Failed to open file")));
+}
+
+void CliTests::reuses_unchanged_netlist_cells() {
+    const QString tut1 = QFileInfo(QStringLiteral(FIXTURE_PATH)).path();
+    const QString layout = tut1 + QStringLiteral("/bufferA.spice");
+    const QString schematic = tut1 + QStringLiteral("/bufferB.spice");
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString records = dir.filePath(QStringLiteral("records.json"));
+    const QStringList args = {QStringLiteral("--netlists"),
+                              QStringLiteral("--incremental"), records,
+                              layout, schematic};
+
+    const Result first = runCli(args);
+    QCOMPARE(first.code, static_cast<int>(Cli::ExitDiffs));
+    QVERIFY(first.err.contains(QStringLiteral("reused 0 of 2 cells")));
+    QVERIFY(QFileInfo::exists(records));
+    // Nothing changed, so the second run compares nothing and says the same.
+    const Result second = runCli(args);
+    QCOMPARE(second.code, static_cast<int>(Cli::ExitDiffs));
+    QVERIFY(second.err.contains(QStringLiteral("reused 2 of 2 cells")));
+    QCOMPARE(second.out, first.out);
+
+    // An unreadable file costs the reuse, not the run.
+    QFile file(records);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("{}");
+    file.close();
+    const Result corrupt = runCli(args);
+    QCOMPARE(corrupt.code, static_cast<int>(Cli::ExitDiffs));
+    QVERIFY(corrupt.err.contains(QStringLiteral("not a netlist record file")));
+    QCOMPARE(corrupt.out, first.out);
+
+    const Result report = runCli({QStringLiteral("--incremental"), records,
+                                  QStringLiteral(FIXTURE_PATH)});
+    QCOMPARE(report.code, static_cast<int>(Cli::ExitError));
+    QVERIFY(report.err.contains(QStringLiteral("--incremental needs")));
+}
+
+QTEST_GUILESS_MAIN(CliTests)
+#include "CliTests.moc"
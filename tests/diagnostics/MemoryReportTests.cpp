@@ -0,0 +1,149 @@
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "diagnostics/MemoryBudget.hpp"
+#include "diagnostics/MemoryReport.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+
+class MemoryReportTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void measures_parsed_report();
+    static void shared_strings_count_once();
+    static void static_strings_cost_nothing();
+    static void writes_json_and_delimited();
+    static void budget_defaults_and_overrides();
+    static void budget_learns_ratio_from_loads();
+};
+
+namespace {
+using Circuit = NetgenJsonParser::Report::Circuit;
+
+auto find(const MemoryReport &report, const QString &name)
+    -> MemoryReport::Item {
+    for (const auto &item : report.items()) {
+        if (item.name == name) {
+            return item;
+        }
+    }
+    return {};
+}
+} // namespace
+
+void MemoryReportTests::measures_parsed_report() {
+    const auto parsed = NetgenJsonParser::parseFile(
+        QStringLiteral(FIXTURE_PATH));
+    QVERIFY(parsed.ok);
+    const MemoryReport report = MemoryReport::measure(parsed.circuits);
+
+    qint64 diffs = 0;
+    for (const auto &cir : parsed.circuits) {
+        diffs += cir.diffs.size();
+    }
+    QCOMPARE(find(report, QStringLiteral("circuits")).count,
+             qint64(parsed.circuits.size()));
+    QCOMPARE(find(report, QStringLiteral("diff rows (DiffEntry)")).count,
+             diffs);
+    QVERIFY(find(report, QStringLiteral("diff strings: details")).bytes > 0);
+
+    qint64 sum = 0;
+    for (const auto &item : report.items()) {
+        QVERIFY(item.bytes >= 0);
+        sum += item.bytes;
+    }
+    QCOMPARE(report.total(), sum);
+    QVERIFY(report.total() > 0);
+}
+
+void MemoryReportTests::shared_strings_count_once() {
+    QVector<Circuit> circuits(1);
+    const QString shared = QString(64, QLatin1Char('n'));
+    for (int i = 0; i < 3; ++i) {
+        NetgenJsonParser::DiffEntry entry;
+        entry.name = shared;
+        entry.details = QString(16 + i, QLatin1Char('d'));
+        circuits[0].diffs.push_back(entry);
+    }
+    const MemoryReport report = MemoryReport::measure(circuits);
+
+    const auto name = find(report, QStringLiteral("diff strings: name"));
+    QCOMPARE(name.count, qint64(1));
+    QCOMPARE(name.bytes, MemoryReport::stringBytes(shared));
+    QCOMPARE(find(report, QStringLiteral("diff strings: details")).count,
+             qint64(3));
+}
+
+void MemoryReportTests::static_strings_cost_nothing() {
+    QCOMPARE(MemoryReport::stringBytes(QString()), qint64(0));
+    QCOMPARE(MemoryReport::stringBytes(QStringLiteral("literal")),
+             qint64(0));
+    const QString heap(100, QLatin1Char('x'));
+    QVERIFY(MemoryReport::stringBytes(heap) >=
+            static_cast<qint64>(100 * sizeof(QChar)));
+    QVERIFY(MemoryReport::listBytes({heap, heap}) >
+            2 * MemoryReport::stringBytes(heap));
+}
+
+void MemoryReportTests::writes_json_and_delimited() {
+    MemoryReport report;
+    report.add(QStringLiteral("a"), 100, 2);
+    report.add(QStringLiteral("b"), 50, 1);
+
+    const QJsonObject json = report.toJson();
+    QCOMPARE(json.value(QStringLiteral("total_bytes")).toInteger(),
+             qint64(150));
+    QCOMPARE(json.value(QStringLiteral("items")).toArray().size(),
+             qsizetype(2));
+
+    QString csv;
+    QTextStream out(&csv);
+    report.writeDelimited(out, QLatin1Char(','));
+    out.flush();
+    QCOMPARE(csv, QStringLiteral("item,bytes,count\na,100,2\nb,50,1\n"));
+}
+
+void MemoryReportTests::budget_defaults_and_overrides() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    MemoryBudget budget(dir.filePath(QStringLiteral("opensvs.ini")));
+
+    QCOMPARE(budget.configuredBudgetBytes(), qint64(0));
+    QCOMPARE(budget.budgetBytes(), MemoryBudget::autoBudgetBytes());
+    QCOMPARE(budget.bytesPerFileByte(), MemoryBudget::defaultRatio);
+    QCOMPARE(budget.project(1000), qint64(8000));
+
+    budget.setBudgetBytes(4000);
+    QCOMPARE(budget.budgetBytes(), qint64(4000));
+    QVERIFY(!budget.exceeds(500));
+    QVERIFY(budget.exceeds(501));
+
+    budget.setBudgetBytes(0);
+    QCOMPARE(budget.configuredBudgetBytes(), qint64(0));
+}
+
+void MemoryReportTests::budget_learns_ratio_from_loads() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("opensvs.ini"));
+    MemoryBudget budget(path);
+
+    budget.recordLoad(1000, 12000);
+    QCOMPARE(budget.loadsSeen(), 1);
+    QCOMPARE(budget.bytesPerFileByte(), 12.0);
+
+    budget.recordLoad(1000, 2000);
+    QCOMPARE(budget.loadsSeen(), 2);
+    QVERIFY(budget.bytesPerFileByte() < 12.0);
+    QVERIFY(budget.bytesPerFileByte() > 2.0);
+
+    // Persisted for the next process.
+    QCOMPARE(MemoryBudget(path).bytesPerFileByte(), budget.bytesPerFileByte());
+    budget.recordLoad(0, 5000);
+    QCOMPARE(budget.loadsSeen(), 2);
+}
+
+QTEST_GUILESS_MAIN(MemoryReportTests)
+#include "MemoryReportTests.moc"
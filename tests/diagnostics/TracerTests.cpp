@@ -0,0 +1,126 @@
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QtTest>
+
+#include "diagnostics/Tracer.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+
+class TracerTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void init();
+    static void cleanup();
+    static void disabled_records_nothing();
+    static void nested_spans_are_contained();
+    static void spans_carry_thread_ids();
+    static void parse_file_is_instrumented();
+    static void writes_chrome_trace();
+};
+
+namespace {
+auto names(const QVector<Tracer::Event> &events) -> QStringList {
+    QStringList list;
+    for (const auto &event : events) {
+        list << QString::fromUtf8(event.name);
+    }
+    return list;
+}
+} // namespace
+
+void TracerTests::init() {
+    Tracer::clear();
+    Tracer::setEnabled(true);
+}
+
+void TracerTests::cleanup() { Tracer::setEnabled(false); }
+
+void TracerTests::disabled_records_nothing() {
+    Tracer::setEnabled(false);
+    {
+        OPENSVS_TRACE_SCOPE("ignored");
+        Tracer::Span span("also ignored");
+        QVERIFY(!span.isActive());
+        span.setDetail(QStringLiteral("x"));
+    }
+    QCOMPARE(Tracer::eventCount(), 0);
+}
+
+void TracerTests::nested_spans_are_contained() {
+    {
+        Tracer::Span outer("outer", "test");
+        outer.setDetail(QStringLiteral("detail"));
+        { OPENSVS_TRACE_SCOPE("inner", "test"); }
+    }
+    const auto events = Tracer::events();
+    QCOMPARE(names(events), QStringList({QStringLiteral("inner"),
+                                         QStringLiteral("outer")}));
+    const auto &inner = events.at(0);
+    const auto &outer = events.at(1);
+    QCOMPARE(QString::fromUtf8(outer.category), QStringLiteral("test"));
+    QCOMPARE(outer.detail, QStringLiteral("detail"));
+    QVERIFY(inner.startNs >= outer.startNs);
+    QVERIFY(inner.startNs + inner.durationNs <=
+            outer.startNs + outer.durationNs);
+    QCOMPARE(Tracer::events(1).size(), 1);
+}
+
+void TracerTests::spans_carry_thread_ids() {
+    { OPENSVS_TRACE_SCOPE("main"); }
+    QThread *worker =
+        QThread::create([] { OPENSVS_TRACE_SCOPE("worker"); });
+    worker->start();
+    QVERIFY(worker->wait(5000));
+    delete worker;
+    const auto events = Tracer::events();
+    QCOMPARE(events.size(), 2);
+    QVERIFY(events.at(0).threadId != events.at(1).threadId);
+}
+
+void TracerTests::parse_file_is_instrumented() {
+    const auto report =
+        NetgenJsonParser::parseFile(QStringLiteral(FIXTURE_PATH));
+    QVERIFY(report.ok);
+    const QStringList recorded = names(Tracer::events());
+    for (const char *name :
+         {"read file", "QJsonDocument::fromJson", "extract diffs",
+          "NetgenJsonParser::linkHierarchy", "NetgenJsonParser::parseFile"}) {
+        QVERIFY2(recorded.contains(QString::fromUtf8(name)), name);
+    }
+    QCOMPARE(Tracer::events().constLast().detail,
+             QStringLiteral(FIXTURE_PATH));
+}
+
+void TracerTests::writes_chrome_trace() {
+    {
+        Tracer::Span span("export", "test");
+        span.setDetail(QStringLiteral("a \"quoted\" detail"));
+    }
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    Tracer::writeChromeTrace(buffer);
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(buffer.data(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    const QJsonArray events =
+        doc.object().value(QStringLiteral("traceEvents")).toArray();
+    QCOMPARE(events.size(), 2); // process name metadata + one span
+    const QJsonObject span = events.at(1).toObject();
+    QCOMPARE(span.value(QStringLiteral("ph")).toString(), QStringLiteral("X"));
+    QCOMPARE(span.value(QStringLiteral("name")).toString(),
+             QStringLiteral("export"));
+    QCOMPARE(span.value(QStringLiteral("cat")).toString(),
+             QStringLiteral("test"));
+    QVERIFY(span.value(QStringLiteral("dur")).toDouble() >= 0);
+    QCOMPARE(span.value(QStringLiteral("args"))
+                 .toObject()
+                 .value(QStringLiteral("detail"))
+                 .toString(),
+             QStringLiteral("a \"quoted\" detail"));
+}
+
+QTEST_MAIN(TracerTests)
+#include "TracerTests.moc"
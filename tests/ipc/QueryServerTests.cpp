@@ -0,0 +1,286 @@
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QUuid>
+#include <QtTest>
+
+#include "ipc/QueryServer.hpp"
+#include "parsers/DiffDetailCache.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+
+class QueryServerTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void answers_without_report();
+    static void pages_diffs();
+    static void reports_net_mismatch_per_cell();
+    static void reports_shorts_and_pins_on_a_net();
+    static void walks_hierarchy();
+    static void snapshot_outlives_window_circuits();
+    static void searches_on_demand_details();
+    static void serves_queries_over_socket();
+};
+
+namespace {
+using DiffType = NetgenJsonParser::DiffType;
+const QString tut1 = QStringLiteral(FIXTURE_PATH);
+const QString tut6 = QStringLiteral(TUT6_PATH);
+
+auto snapshotOf(const NetgenJsonParser::Report &report,
+                std::shared_ptr<const DiffDetailCache> details = nullptr)
+    -> std::shared_ptr<const QuerySnapshot> {
+    return QuerySnapshot::make(QStringLiteral("comp.json"), report.summary,
+                               report.circuits, std::move(details));
+}
+
+auto diffCount(const NetgenJsonParser::Report &report) -> qint64 {
+    qint64 count = 0;
+    for (const auto &cir : report.circuits) {
+        count += cir.diffs.size();
+    }
+    return count;
+}
+} // namespace
+
+void QueryServerTests::answers_without_report() {
+    const QJsonObject ping = QueryServer::answer(
+        QJsonObject{{QStringLiteral("cmd"), QStringLiteral("ping")},
+                    {QStringLiteral("id"), 7}},
+        nullptr);
+    QVERIFY(ping.value(QStringLiteral("ok")).toBool());
+    QVERIFY(!ping.value(QStringLiteral("loaded")).toBool());
+    QCOMPARE(ping.value(QStringLiteral("id")).toInt(), 7);
+
+    const QJsonObject summary = QueryServer::answer(
+        QJsonObject{{QStringLiteral("cmd"), QStringLiteral("summary")}},
+        nullptr);
+    QVERIFY(!summary.value(QStringLiteral("ok")).toBool());
+    QCOMPARE(summary.value(QStringLiteral("error")).toString(),
+             QStringLiteral("no report loaded"));
+
+    const auto report = NetgenJsonParser::parseFile(tut1);
+    const auto snapshot = snapshotOf(report);
+    const QJsonObject unknown = QueryServer::answer(
+        QJsonObject{{QStringLiteral("cmd"), QStringLiteral("frobnicate")}},
+        snapshot.get());
+    QVERIFY(!unknown.value(QStringLiteral("ok")).toBool());
+    QCOMPARE(unknown.value(QStringLiteral("error")).toString(),
+             QStringLiteral("unknown command: frobnicate"));
+}
+
+void QueryServerTests::pages_diffs() {
+    const auto report = NetgenJsonParser::parseFile(tut6);
+    QVERIFY(report.ok);
+    const auto snapshot = snapshotOf(report);
+    const qint64 total = diffCount(report);
+    QVERIFY(total > 3);
+
+    const QJsonObject reply = QueryServer::answer(
+        QJsonObject{{QStringLiteral("cmd"), QStringLiteral("diffs")},
+                    {QStringLiteral("offset"), 1},
+                    {QStringLiteral("limit"), 2}},
+        snapshot.get());
+    QVERIFY(reply.value(QStringLiteral("ok")).toBool());
+    QCOMPARE(reply.value(QStringLiteral("total")).toInteger(), total);
+    const QJsonArray rows = reply.value(QStringLiteral("diffs")).toArray();
+    QCOMPARE(rows.size(), qsizetype(2));
+
+    const auto &second = report.circuits.first().diffs.size() > 1
+                             ? report.circuits.first().diffs.at(1)
+                             : report.circuits.at(1).diffs.first();
+    const QJsonObject row = rows.first().toObject();
+    QCOMPARE(row.value(QStringLiteral("object")).toString(), second.name);
+    QCOMPARE(row.value(QStringLiteral("details")).toString(), second.details);
+    QCOMPARE(row.value(QStringLiteral("circuit")).toInteger(),
+             second.circuitIndex);
+
+    const QJsonObject summary = QueryServer::answer(
+        QJsonObject{{QStringLiteral("cmd"), QStringLiteral("summary")}},
+        snapshot.get());
+    QCOMPARE(summary.value(QStringLiteral("summary"))
+                 .toObject()
+                 .value(QStringLiteral("diffs"))
+                 .toInteger(),
+             total);
+}
+
+void QueryServerTests::reports_net_mismatch_per_cell() {
+    const auto report = NetgenJsonParser::parseFile(tut6);
+    const auto snapshot = snapshotOf(report);
+    const NetgenJsonParser::DiffEntry *net = nullptr;
+    for (const auto &cir : report.circuits) {
+        for (const auto &entry : cir.diffs) {
+            if (net == nullptr && entry.type == DiffType::NetMismatch) {
+                net = &entry;
+            }
+        }
+    }
+    QVERIFY(net != nullptr);
+
+    const QJsonObject hit = QueryServer::answer(
+        QJsonObject{{QStringLiteral("cmd"), QStringLiteral("net")},
+                    {QStringLiteral("net"), net->name},
+                    {QStringLiteral("cell"), net->layoutCell}},
+        snapshot.get());
+    QVERIFY(hit.value(QStringLiteral("ok")).toBool());
+    QVERIFY(hit.value(QStringLiteral("cell_found")).toBool());
+    QVERIFY(hit.value(QStringLiteral("mismatched")).toBool());
+
+    const QJsonObject clean = QueryServer::answer(
+        QJsonObject{{QStringLiteral("cmd"), QStringLiteral("net")},
+                    {QStringLiteral("net"), QStringLiteral("no_such_net")},
+                    {QStringLiteral("cell"), net->layoutCell}},
+        snapshot.get());
+    QVERIFY(clean.value(QStringLiteral("cell_found")).toBool());
+    QVERIFY(!clean.value(QStringLiteral("mismatched")).toBool());
+
+    const QJsonObject missing = QueryServer::answer(
+        QJsonObject{{QStringLiteral("cmd"), QStringLiteral("net")}},
+        snapshot.get());
+    QVERIFY(!missing.value(QStringLiteral("ok")).toBool());
+}
+
+void QueryServerTests::reports_shorts_and_pins_on_a_net() {
+    NetgenJsonParser::Report report;
+    NetgenJsonParser::Report::Circuit top;
+    top.layoutCell = QStringLiteral("top");
+    top.schematicCell = QStringLiteral("top");
+    top.index = 0;
+    auto add = [&top](DiffType type, const QString &name) {
+        NetgenJsonParser::DiffEntry entry;
+        entry.type = type;
+        entry.name = name;
+        entry.layoutCell = top.layoutCell;
+        entry.schematicCell = top.schematicCell;
+        entry.circuitIndex = top.index;
+        top.diffs.push_back(entry);
+    };
+    add(DiffType::Short, QStringLiteral("vdd"));
+    add(DiffType::PinMismatch, QStringLiteral("vdd"));
+    add(DiffType::DeviceMismatch, QStringLiteral("vdd"));
+    report.circuits.push_back(top);
+    const auto snapshot = snapshotOf(report);
+
+    const QJsonObject hit = QueryServer::answer(
+        QJsonObject{{QStringLiteral("cmd"), QStringLiteral("net")},
+                    {QStringLiteral("net"), QStringLiteral("VDD")},
+                    {QStringLiteral("cell"), QStringLiteral("top")}},
+        snapshot.get());
+    QVERIFY(hit.value(QStringLiteral("mismatched")).toBool());
+    // The device that happens to share the name is not a net diff.
+    QCOMPARE(hit.value(QStringLiteral("diffs")).toArray().size(),
+             qsizetype(2));
+}
+
+void QueryServerTests::walks_hierarchy() {
+    const auto report = NetgenJsonParser::parseFile(tut6);
+    const auto snapshot = snapshotOf(report);
+    qsizetype topLevel = 0;
+    for (const auto &cir : report.circuits) {
+        topLevel += cir.isTopLevel ? 1 : 0;
+    }
+
+    const QJsonObject all = QueryServer::answer(
+        QJsonObject{{QStringLiteral("cmd"), QStringLiteral("hierarchy")}},
+        snapshot.get());
+    QVERIFY(all.value(QStringLiteral("ok")).toBool());
+    QCOMPARE(all.value(QStringLiteral("roots")).toArray().size(), topLevel);
+    QCOMPARE(all.value(QStringLiteral("circuits")).toArray().size(),
+             report.circuits.size());
+
+    const QString cell = report.circuits.first().layoutCell;
+    const QJsonObject one = QueryServer::answer(
+        QJsonObject{{QStringLiteral("cmd"), QStringLiteral("hierarchy")},
+                    {QStringLiteral("cell"), cell}},
+        snapshot.get());
+    QVERIFY(one.value(QStringLiteral("ok")).toBool());
+    QVERIFY(!one.value(QStringLiteral("roots")).toArray().isEmpty());
+
+    const QJsonObject none = QueryServer::answer(
+        QJsonObject{{QStringLiteral("cmd"), QStringLiteral("hierarchy")},
+                    {QStringLiteral("cell"), QStringLiteral("no_such_cell")}},
+        snapshot.get());
+    QVERIFY(!none.value(QStringLiteral("ok")).toBool());
+}
+
+void QueryServerTests::snapshot_outlives_window_circuits() {
+    auto report = NetgenJsonParser::parseFile(tut6);
+    const auto snapshot = snapshotOf(report);
+    report = NetgenJsonParser::Report{};
+
+    const auto &circuits = snapshot->report.circuits;
+    QVERIFY(!circuits.isEmpty());
+    for (const auto &cir : circuits) {
+        for (const auto *child : cir.subcircuits) {
+            QVERIFY(child >= circuits.constData());
+            QVERIFY(child < circuits.constData() + circuits.size());
+        }
+    }
+}
+
+void QueryServerTests::searches_on_demand_details() {
+    const auto compact =
+        NetgenJsonParser::parseFile(tut6, NetgenJsonParser::Details::OnDemand);
+    QVERIFY(compact.ok);
+    QVERIFY(compact.detailCache);
+    const auto snapshot = snapshotOf(compact, compact.detailCache);
+    QVERIFY(snapshot->report.detailsOnDemand);
+
+    const auto resident = NetgenJsonParser::parseFile(tut6);
+    const QJsonObject request{
+        {QStringLiteral("cmd"), QStringLiteral("diffs")},
+        {QStringLiteral("search"), QStringLiteral("Layout circuit")},
+        {QStringLiteral("limit"), 0}};
+    const QJsonObject expected =
+        QueryServer::answer(request, snapshotOf(resident).get());
+    const QJsonObject actual = QueryServer::answer(request, snapshot.get());
+    QVERIFY(expected.value(QStringLiteral("total")).toInteger() > 0);
+    QCOMPARE(actual, expected);
+}
+
+void QueryServerTests::serves_queries_over_socket() {
+    const QString name = QStringLiteral("opensvs-query-test-") +
+                         QUuid::createUuid().toString(QUuid::Id128).left(12);
+    QueryServer server;
+    QVERIFY(server.start(name));
+    QVERIFY(server.isRunning());
+    server.setSnapshot(snapshotOf(NetgenJsonParser::parseFile(tut1)));
+
+    // The server answers on its own thread, so blocking waits are fine here.
+    QLocalSocket client;
+    client.connectToServer(server.fullServerName());
+    QVERIFY(client.waitForConnected(5000));
+    client.write("{\"cmd\":\"ping\",\"id\":1}\n"
+                 "not json\n"
+                 "{\"cmd\":\"summary\",\"id\":2}\n");
+    QVERIFY(client.waitForBytesWritten(5000));
+
+    QList<QJsonObject> replies;
+    while (replies.size() < 3) {
+        if (!client.canReadLine()) {
+            QVERIFY(client.waitForReadyRead(5000));
+            continue;
+        }
+        replies.append(QJsonDocument::fromJson(client.readLine()).object());
+    }
+    QCOMPARE(replies.at(0).value(QStringLiteral("id")).toInt(), 1);
+    QVERIFY(replies.at(0).value(QStringLiteral("loaded")).toBool());
+    QVERIFY(!replies.at(1).value(QStringLiteral("ok")).toBool());
+    QCOMPARE(replies.at(2).value(QStringLiteral("id")).toInt(), 2);
+    QCOMPARE(replies.at(2)
+                 .value(QStringLiteral("summary"))
+                 .toObject()
+                 .value(QStringLiteral("report"))
+                 .toString(),
+             QStringLiteral("comp.json"));
+
+    client.disconnectFromServer();
+    server.stop();
+    QVERIFY(!server.isRunning());
+    QVERIFY(server.fullServerName().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(QueryServerTests)
+#include "QueryServerTests.moc"
@@ -0,0 +1,72 @@
+#include <QSignalSpy>
+#include <QUuid>
+#include <QtTest>
+#include <atomic>
+#include <thread>
+
+#include "ipc/SingleInstance.hpp"
+
+class SingleInstanceTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void hands_paths_to_listener();
+    static void hand_off_fails_without_listener();
+    static void second_listener_is_refused();
+    static void server_name_is_stable();
+};
+
+namespace {
+auto uniqueName() -> QString {
+    return QStringLiteral("opensvs-test-") +
+           QUuid::createUuid().toString(QUuid::Id128).left(12);
+}
+} // namespace
+
+void SingleInstanceTests::hands_paths_to_listener() {
+    SingleInstance instance(uniqueName());
+    QVERIFY(instance.listen());
+    QSignalSpy spy(&instance, &SingleInstance::filesReceived);
+
+    // handOff blocks, so it runs where the listener's event loop is not.
+    std::atomic<int> accepted{-1};
+    std::thread client([&] {
+        accepted = SingleInstance::handOff(instance.serverName(),
+                                           {QStringLiteral("/tmp/a.json")},
+                                           5000)
+                       ? 1
+                       : 0;
+    });
+    QTRY_COMPARE(spy.count(), 1);
+    QTRY_COMPARE(accepted.load(), 1);
+    client.join();
+    QCOMPARE(spy.first().first().toStringList(),
+             QStringList{QStringLiteral("/tmp/a.json")});
+}
+
+void SingleInstanceTests::hand_off_fails_without_listener() {
+    QVERIFY(!SingleInstance::handOff(uniqueName(),
+                                     {QStringLiteral("/tmp/a.json")}, 200));
+}
+
+void SingleInstanceTests::second_listener_is_refused() {
+    const QString name = uniqueName();
+    SingleInstance first(name);
+    QVERIFY(first.listen());
+
+    // The probe connects through the socket backlog; no event loop needed.
+    SingleInstance second(name);
+    QVERIFY(!second.listen());
+    QVERIFY(!second.isListening());
+    QVERIFY(first.isListening());
+}
+
+void SingleInstanceTests::server_name_is_stable() {
+    QCOMPARE(SingleInstance::defaultServerName(),
+             SingleInstance::defaultServerName());
+    QVERIFY(SingleInstance::defaultServerName().startsWith(
+        QStringLiteral("opensvs-")));
+}
+
+QTEST_GUILESS_MAIN(SingleInstanceTests)
+#include "SingleInstanceTests.moc"
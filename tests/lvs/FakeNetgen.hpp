@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QDir>
+#include <QFile>
+#include <QString>
+
+// Stand-in `netgen` for LVS tests. Prepending its directory to PATH makes
+// LvsRunner pick it up; FAKE_NETGEN_MODE selects the behaviour:
+//   ok   - prints a short log, copies the fixture's .out log to <out> and
+//          writes FIXTURE_PATH to <out>.json (which may be a FIFO)
+//   nap  - like ok, after sleeping one second
+//   slow - sleeps until terminated
+//   fail - writes to stderr and exits with code 3
+namespace FakeNetgen {
+
+inline auto install(const QString &dirPath) -> bool {
+    const QDir dir(dirPath);
+    QFile file(dir.filePath(QStringLiteral("netgen")));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    file.write("#!/bin/sh\n"
+               "echo \"Reading netlist file $3\"\n"
+               "echo \"Subcircuit summary:\"\n"
+               "case \"$FAKE_NETGEN_MODE\" in\n"
+               "  nap) sleep 1 ;;\n"
+               "  slow) exec sleep 30 ;;\n"
+               "  fail) echo \"rules file broken\" 1>&2; exit 3 ;;\n"
+               "esac\n"
+               "out=\"$6\"\n"
+               "fixture=\"" FIXTURE_PATH "\"\n"
+               "cat \"${fixture%.json}.out\" >\"$out\"\n"
+               "cat \"$fixture\" >\"${out%.out}.json\"\n"
+               "echo \"Final result: Circuits match uniquely.\"\n");
+    file.close();
+    file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner |
+                        QFileDevice::ExeOwner);
+
+    for (const char *name : {"layout.spice", "schematic.spice", "setup.tcl"}) {
+        QFile input(dir.filePath(QString::fromLatin1(name)));
+        if (!input.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+    }
+
+    const QByteArray path = qgetenv("PATH");
+    qputenv("PATH", QFile::encodeName(dirPath) + ':' + path);
+    return true;
+}
+
+} // namespace FakeNetgen
@@ -0,0 +1,110 @@
+#include <QFile>
+#include <QSet>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <algorithm>
+
+#include "FakeNetgen.hpp"
+#include "lvs/LvsJobQueue.hpp"
+
+class LvsJobQueueTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void runs_jobs_with_bounded_concurrency();
+    void cancels_queued_job();
+    void unique_out_paths_do_not_collide();
+
+  private:
+    auto makeRequest() const -> LvsRunner::Request;
+
+    QTemporaryDir dir_;
+};
+
+void LvsJobQueueTests::initTestCase() {
+    QVERIFY(dir_.isValid());
+    QVERIFY(FakeNetgen::install(dir_.path()));
+}
+
+auto LvsJobQueueTests::makeRequest() const -> LvsRunner::Request {
+    LvsRunner::Request request;
+    request.layout = dir_.filePath(QStringLiteral("layout.spice"));
+    request.schematic = dir_.filePath(QStringLiteral("schematic.spice"));
+    request.rules = dir_.filePath(QStringLiteral("setup.tcl"));
+    request.outPath = LvsJobQueue::uniqueOutPath(QDir(dir_.path()));
+    return request;
+}
+
+void LvsJobQueueTests::runs_jobs_with_bounded_concurrency() {
+    qputenv("FAKE_NETGEN_MODE", "nap");
+    LvsJobQueue queue;
+    queue.setMaxConcurrent(2);
+    int peak = 0;
+    connect(&queue, &LvsJobQueue::jobChanged, this,
+            [&]() { peak = std::max(peak, queue.runningCount()); });
+    QSignalSpy finishedSpy(&queue, &LvsJobQueue::jobFinished);
+
+    const int jobCount = 4;
+    for (int i = 0; i < jobCount; ++i) {
+        queue.enqueue(makeRequest());
+    }
+    QCOMPARE(queue.runningCount(), 2);
+    QCOMPARE(queue.pendingCount(), jobCount);
+
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), jobCount, 20000);
+    QCOMPARE(peak, 2);
+    QCOMPARE(queue.pendingCount(), 0);
+    for (const auto &job : queue.jobs()) {
+        QCOMPARE(job.status, LvsJobQueue::Status::Succeeded);
+        QVERIFY(QFile::exists(job.jsonPath));
+        QCOMPARE(job.result, QStringLiteral("Circuits match uniquely."));
+        QVERIFY(job.durationMs > 0);
+    }
+}
+
+void LvsJobQueueTests::cancels_queued_job() {
+    qputenv("FAKE_NETGEN_MODE", "slow");
+    LvsJobQueue queue;
+    queue.setMaxConcurrent(1);
+    QSignalSpy finishedSpy(&queue, &LvsJobQueue::jobFinished);
+    // Models see the old rows in the AboutTo signals.
+    QVector<qsizetype> sizesBefore;
+    connect(&queue, &LvsJobQueue::jobAboutToBeAdded, this,
+            [&]() { sizesBefore.append(queue.jobs().size()); });
+    connect(&queue, &LvsJobQueue::jobsAboutToBeReset, this,
+            [&]() { sizesBefore.append(queue.jobs().size()); });
+
+    const int running = queue.enqueue(makeRequest());
+    const int waiting = queue.enqueue(makeRequest());
+    QCOMPARE(queue.jobs().at(waiting).status, LvsJobQueue::Status::Queued);
+
+    queue.cancel(waiting);
+    QCOMPARE(queue.jobs().at(waiting).status, LvsJobQueue::Status::Canceled);
+    QCOMPARE(queue.jobs().at(running).status, LvsJobQueue::Status::Running);
+
+    queue.cancel(running);
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 2, 10000);
+    QCOMPARE(queue.jobs().at(running).status, LvsJobQueue::Status::Canceled);
+    QCOMPARE(queue.runningCount(), 0);
+
+    queue.clearFinished();
+    QVERIFY(queue.jobs().isEmpty());
+    QCOMPARE(sizesBefore, QVector<qsizetype>({0, 1, 2}));
+}
+
+void LvsJobQueueTests::unique_out_paths_do_not_collide() {
+    const QDir dir(dir_.path());
+    QSet<QString> seen;
+    const int samples = 1000;
+    for (int i = 0; i < samples; ++i) {
+        const QString path = LvsJobQueue::uniqueOutPath(dir);
+        QVERIFY(path.endsWith(QStringLiteral(".out")));
+        QVERIFY(!seen.contains(path));
+        seen.insert(path);
+    }
+}
+
+QTEST_GUILESS_MAIN(LvsJobQueueTests)
+#include "LvsJobQueueTests.moc"
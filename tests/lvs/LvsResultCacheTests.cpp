@@ -0,0 +1,188 @@
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <memory>
+#include <thread>
+
+#include "FakeNetgen.hpp"
+#include "lvs/LvsJobQueue.hpp"
+#include "lvs/LvsResultCache.hpp"
+
+class LvsResultCacheTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void key_tracks_content_and_includes();
+    void resolves_include_directives();
+    void queue_serves_second_run_from_cache();
+    void concurrent_stores_of_one_key();
+
+  private:
+    auto makeRequest() const -> LvsRunner::Request;
+    void writeFile(const QString &name, const QByteArray &content) const;
+
+    QTemporaryDir dir_;
+    QTemporaryDir cacheDir_;
+};
+
+void LvsResultCacheTests::initTestCase() {
+    QVERIFY(dir_.isValid());
+    QVERIFY(cacheDir_.isValid());
+    QVERIFY(FakeNetgen::install(dir_.path()));
+    writeFile(QStringLiteral("layout.spice"),
+              ".include \"cells.sp\"\nX1 a b inv\n.end\n");
+    writeFile(QStringLiteral("cells.sp"), ".subckt inv a b\n.ends\n");
+}
+
+auto LvsResultCacheTests::makeRequest() const -> LvsRunner::Request {
+    LvsRunner::Request request;
+    request.layout = dir_.filePath(QStringLiteral("layout.spice"));
+    request.schematic = dir_.filePath(QStringLiteral("schematic.spice"));
+    request.rules = dir_.filePath(QStringLiteral("setup.tcl"));
+    request.outPath = LvsJobQueue::uniqueOutPath(QDir(dir_.path()));
+    return request;
+}
+
+void LvsResultCacheTests::writeFile(const QString &name,
+                                    const QByteArray &content) const {
+    QFile file(dir_.filePath(name));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(content);
+}
+
+void LvsResultCacheTests::key_tracks_content_and_includes() {
+    LvsResultCache cache(cacheDir_.filePath(QStringLiteral("keys")));
+    const QString first = cache.computeKey(makeRequest());
+    QVERIFY(!first.isEmpty());
+    QCOMPARE(cache.computeKey(makeRequest()), first);
+
+    // A fresh instance reads the persisted digests and agrees.
+    LvsResultCache reloaded(cacheDir_.filePath(QStringLiteral("keys")));
+    QCOMPARE(reloaded.computeKey(makeRequest()), first);
+
+    // Editing only the included file must change the key.
+    writeFile(QStringLiteral("cells.sp"), ".subckt inv a b c\n.ends\n");
+    const QString second = reloaded.computeKey(makeRequest());
+    QVERIFY(!second.isEmpty());
+    QVERIFY(second != first);
+
+    // A same-size edit that keeps the mtime, as rsync -t or cp -p do.
+    const QString cells = dir_.filePath(QStringLiteral("cells.sp"));
+    const QDateTime mtime = QFileInfo(cells).lastModified();
+    QTest::qSleep(10);
+    writeFile(QStringLiteral("cells.sp"), ".subckt inv a b d\n.ends\n");
+    {
+        QFile file(cells);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(mtime, QFileDevice::FileModificationTime));
+    }
+    QCOMPARE(QFileInfo(cells).lastModified(), mtime);
+    QVERIFY(reloaded.computeKey(makeRequest()) != second);
+
+    LvsRunner::Request missing = makeRequest();
+    missing.rules = dir_.filePath(QStringLiteral("nope.tcl"));
+    QString error;
+    QVERIFY(cache.computeKey(missing, &error).isEmpty());
+    QVERIFY(!error.isEmpty());
+}
+
+void LvsResultCacheTests::resolves_include_directives() {
+    const QString base = dir_.path();
+    QCOMPARE(LvsResultCache::includeTarget(".include \"cells.sp\"", base),
+             dir_.filePath(QStringLiteral("cells.sp")));
+    QCOMPARE(LvsResultCache::includeTarget(".INC cells.sp", base),
+             dir_.filePath(QStringLiteral("cells.sp")));
+    QCOMPARE(LvsResultCache::includeTarget("source {setup.tcl}", base),
+             dir_.filePath(QStringLiteral("setup.tcl")));
+    QVERIFY(LvsResultCache::includeTarget("M1 a b c d nfet", base).isEmpty());
+    QVERIFY(LvsResultCache::includeTarget(".include", base).isEmpty());
+}
+
+void LvsResultCacheTests::queue_serves_second_run_from_cache() {
+    auto cache = std::make_shared<LvsResultCache>(
+        cacheDir_.filePath(QStringLiteral("queue")));
+    LvsJobQueue queue;
+    queue.setCache(cache);
+    QSignalSpy finishedSpy(&queue, &LvsJobQueue::jobFinished);
+
+    qputenv("FAKE_NETGEN_MODE", "ok");
+    const int first = queue.enqueue(makeRequest());
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 10000);
+    QCOMPARE(queue.jobs().at(first).status, LvsJobQueue::Status::Succeeded);
+    QVERIFY(!queue.jobs().at(first).cached);
+    const QString key = queue.jobs().at(first).cacheKey;
+    QVERIFY(!key.isEmpty());
+    QTRY_VERIFY_WITH_TIMEOUT(!cache->lookup(key).isEmpty(), 5000);
+    const QString cached = cache->lookup(key);
+    QVERIFY(!(QFile::permissions(cached) & QFileDevice::WriteOwner));
+    // The cache holds a copy: rewriting the job's output leaves it alone.
+    {
+        QFile output(queue.jobs().at(first).jsonPath);
+        QVERIFY(output.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        output.write("{}");
+    }
+    QFile cachedFile(cached);
+    QVERIFY(cachedFile.open(QIODevice::ReadOnly));
+    const QByteArray report = cachedFile.readAll();
+    cachedFile.close();
+    QVERIFY(report.size() > 2);
+
+    // netgen would fail now, so success proves it was never started.
+    qputenv("FAKE_NETGEN_MODE", "fail");
+    const int second = queue.enqueue(makeRequest());
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 2, 10000);
+    const auto &hit = queue.jobs().at(second);
+    QCOMPARE(hit.status, LvsJobQueue::Status::Succeeded);
+    QVERIFY(hit.cached);
+    QCOMPARE(hit.jsonPath, cache->lookup(key));
+
+    // Forcing a rerun bypasses the cache.
+    const int forced = queue.enqueue(makeRequest(), /*useCache=*/false);
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 3, 10000);
+    QCOMPARE(queue.jobs().at(forced).status, LvsJobQueue::Status::Failed);
+
+    // ...and a successful forced rerun replaces a stale entry.
+    QVERIFY(QFile::setPermissions(cached, QFileDevice::ReadOwner |
+                                              QFileDevice::WriteOwner));
+    QVERIFY(cachedFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    cachedFile.write("stale");
+    cachedFile.close();
+    qputenv("FAKE_NETGEN_MODE", "ok");
+    const int rerun = queue.enqueue(makeRequest(), /*useCache=*/false);
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 4, 10000);
+    QVERIFY(!queue.jobs().at(rerun).cached);
+    QCOMPARE(queue.jobs().at(rerun).cacheKey, key);
+    QTRY_VERIFY_WITH_TIMEOUT(cachedFile.size() == report.size(), 5000);
+}
+
+void LvsResultCacheTests::concurrent_stores_of_one_key() {
+    LvsResultCache cache(cacheDir_.filePath(QStringLiteral("race")));
+    writeFile(QStringLiteral("a.json"), QByteArray(4096, 'a'));
+    writeFile(QStringLiteral("b.json"), QByteArray(4096, 'b'));
+    const QString key = QStringLiteral("same");
+    auto storeMany = [&cache, &key](const QString &json) {
+        for (int i = 0; i < 50; ++i) {
+            cache.store(key, json, QString());
+        }
+    };
+    std::thread a(storeMany, dir_.filePath(QStringLiteral("a.json")));
+    std::thread b(storeMany, dir_.filePath(QStringLiteral("b.json")));
+    a.join();
+    b.join();
+
+    // One whole copy won, and no temporary file was left behind.
+    QFile cached(cache.lookup(key));
+    QVERIFY(cached.open(QIODevice::ReadOnly));
+    const QByteArray report = cached.readAll();
+    QVERIFY(report == QByteArray(4096, 'a') ||
+            report == QByteArray(4096, 'b'));
+    QCOMPARE(QDir(cache.directory())
+                 .entryList({QStringLiteral("*.tmp")}, QDir::Files)
+                 .size(),
+             0);
+}
+
+QTEST_GUILESS_MAIN(LvsResultCacheTests)
+#include "LvsResultCacheTests.moc"
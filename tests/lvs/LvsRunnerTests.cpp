@@ -0,0 +1,143 @@
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "FakeNetgen.hpp"
+#include "lvs/LvsRunner.hpp"
+#include "lvs/NetgenOutTail.hpp"
+
+class LvsRunnerTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void streams_output_and_reports_json();
+    void streams_json_through_fifo_data();
+    void streams_json_through_fifo();
+    void cancel_terminates_netgen();
+    void reports_nonzero_exit();
+
+  private:
+    auto makeRequest() const -> LvsRunner::Request;
+
+    QTemporaryDir dir_;
+};
+
+void LvsRunnerTests::initTestCase() {
+    QVERIFY(dir_.isValid());
+    QVERIFY(FakeNetgen::install(dir_.path()));
+}
+
+auto LvsRunnerTests::makeRequest() const -> LvsRunner::Request {
+    LvsRunner::Request request;
+    request.layout = dir_.filePath(QStringLiteral("layout.spice"));
+    request.schematic = dir_.filePath(QStringLiteral("schematic.spice"));
+    request.rules = dir_.filePath(QStringLiteral("setup.tcl"));
+    request.outPath = dir_.filePath(QStringLiteral("comp_test.out"));
+    return request;
+}
+
+void LvsRunnerTests::streams_output_and_reports_json() {
+    qputenv("FAKE_NETGEN_MODE", "ok");
+    LvsRunner runner;
+    QSignalSpy outputSpy(&runner, &LvsRunner::outputReceived);
+    QSignalSpy finishedSpy(&runner, &LvsRunner::finished);
+
+    QVERIFY(runner.start(makeRequest()));
+    QVERIFY(runner.isRunning());
+    QVERIFY(finishedSpy.wait(10000));
+
+    QCOMPARE(finishedSpy.count(), 1);
+    const auto args = finishedSpy.takeFirst();
+    QVERIFY2(args.at(0).toBool(), qPrintable(args.at(2).toString()));
+    QCOMPARE(args.at(1).toString(),
+             dir_.filePath(QStringLiteral("comp_test.json")));
+    QVERIFY(QFile::exists(args.at(1).toString()));
+    QCOMPARE(runner.phase(), LvsRunner::Phase::Finished);
+
+    QStringList streamed;
+    for (const auto &call : outputSpy) {
+        streamed += call.at(0).toStringList();
+    }
+    QVERIFY(streamed.contains(QStringLiteral("Subcircuit summary:")));
+    QVERIFY(streamed.last().startsWith(QStringLiteral("Final result")));
+    QCOMPARE(runner.outTail()->matchedCount(), 1);
+}
+
+void LvsRunnerTests::streams_json_through_fifo_data() {
+    QTest::addColumn<bool>("keepCopy");
+    QTest::newRow("keep copy") << true;
+    QTest::newRow("stream only") << false;
+}
+
+void LvsRunnerTests::streams_json_through_fifo() {
+    QFETCH(bool, keepCopy);
+    qputenv("FAKE_NETGEN_MODE", "ok");
+    QFile fixture(QStringLiteral(FIXTURE_PATH));
+    QVERIFY(fixture.open(QIODevice::ReadOnly));
+    const QByteArray expected = fixture.readAll();
+
+    LvsRunner runner;
+    QByteArray streamed;
+    connect(&runner, &LvsRunner::jsonChunk, this,
+            [&streamed](const QByteArray &chunk) { streamed += chunk; });
+    QSignalSpy finishedSpy(&runner, &LvsRunner::finished);
+
+    LvsRunner::Request request = makeRequest();
+    request.outPath = dir_.filePath(QStringLiteral("comp_fifo.out"));
+    request.streamJson = true;
+    request.keepJsonCopy = keepCopy;
+    QVERIFY(runner.start(request));
+    QVERIFY(runner.isStreaming());
+    QVERIFY(finishedSpy.wait(10000));
+
+    const auto args = finishedSpy.takeFirst();
+    QVERIFY2(args.at(0).toBool(), qPrintable(args.at(2).toString()));
+    QCOMPARE(streamed, expected);
+    QVERIFY(!runner.isStreaming());
+
+    const QString json = dir_.filePath(QStringLiteral("comp_fifo.json"));
+    QCOMPARE(args.at(1).toString(), keepCopy ? json : QString());
+    QCOMPARE(QFile::exists(json), keepCopy);
+    if (keepCopy) {
+        QFile copy(json);
+        QVERIFY(copy.open(QIODevice::ReadOnly));
+        QCOMPARE(copy.readAll(), expected);
+    }
+    QVERIFY(!QFile::exists(json + QStringLiteral(".part")));
+}
+
+void LvsRunnerTests::cancel_terminates_netgen() {
+    qputenv("FAKE_NETGEN_MODE", "slow");
+    LvsRunner runner;
+    QSignalSpy finishedSpy(&runner, &LvsRunner::finished);
+    QSignalSpy startedSpy(&runner, &LvsRunner::started);
+
+    QVERIFY(runner.start(makeRequest()));
+    QVERIFY(startedSpy.wait(5000));
+    runner.cancel();
+    QVERIFY(finishedSpy.wait(5000));
+
+    QCOMPARE(finishedSpy.first().at(0).toBool(), false);
+    QCOMPARE(runner.phase(), LvsRunner::Phase::Canceled);
+    QVERIFY(!runner.isRunning());
+    QVERIFY(runner.elapsedMs() < 5000);
+}
+
+void LvsRunnerTests::reports_nonzero_exit() {
+    qputenv("FAKE_NETGEN_MODE", "fail");
+    LvsRunner runner;
+    QSignalSpy finishedSpy(&runner, &LvsRunner::finished);
+
+    QVERIFY(runner.start(makeRequest()));
+    QVERIFY(finishedSpy.wait(10000));
+
+    QCOMPARE(finishedSpy.first().at(0).toBool(), false);
+    QVERIFY(finishedSpy.first().at(2).toString().contains(
+        QStringLiteral("rules file broken")));
+    QCOMPARE(runner.phase(), LvsRunner::Phase::Failed);
+}
+
+QTEST_GUILESS_MAIN(LvsRunnerTests)
+#include "LvsRunnerTests.moc"
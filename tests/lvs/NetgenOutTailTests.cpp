@@ -0,0 +1,89 @@
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "lvs/NetgenOutTail.hpp"
+
+class NetgenOutTailTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void parses_matching_log();
+    static void parses_mismatching_log();
+    static void follows_a_growing_file();
+};
+
+namespace {
+auto readAll(const QString &path) -> QByteArray {
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+void feedAll(NetgenOutTail &tail, const QByteArray &data) {
+    for (const QByteArray &line : data.split('\n')) {
+        tail.feedLine(QString::fromLocal8Bit(line));
+    }
+}
+} // namespace
+
+void NetgenOutTailTests::parses_matching_log() {
+    NetgenOutTail tail;
+    feedAll(tail, readAll(QStringLiteral(TUT1_OUT_PATH)));
+
+    QCOMPARE(tail.cells().size(), 1);
+    const auto &cell = tail.cells().first();
+    QCOMPARE(cell.layoutCell, QStringLiteral("bufferA.spice"));
+    QCOMPARE(cell.schematicCell, QStringLiteral("bufferB.spice"));
+    QCOMPARE(cell.mismatchFlags, 0);
+    QCOMPARE(cell.verdict, NetgenOutTail::Verdict::Match);
+    QCOMPARE(tail.matchedCount(), 1);
+    QCOMPARE(tail.mismatchedCount(), 0);
+    QCOMPARE(tail.finalResult(), QStringLiteral("Circuits match uniquely."));
+}
+
+void NetgenOutTailTests::parses_mismatching_log() {
+    NetgenOutTail tail;
+    QSignalSpy finishedSpy(&tail, &NetgenOutTail::cellFinished);
+    feedAll(tail, readAll(QStringLiteral(TUT3_OUT_PATH)));
+
+    QCOMPARE(finishedSpy.count(), 2);
+    QCOMPARE(tail.cells().size(), 2);
+    QCOMPARE(tail.cells().at(0).layoutCell, QStringLiteral("inverter"));
+    QCOMPARE(tail.cells().at(0).mismatchFlags, 3);
+    QCOMPARE(tail.cells().at(0).verdict, NetgenOutTail::Verdict::Mismatch);
+    QCOMPARE(tail.cells().at(1).layoutCell, QStringLiteral("bufferA.spice"));
+    QCOMPARE(tail.cells().at(1).verdict, NetgenOutTail::Verdict::Mismatch);
+    QCOMPARE(tail.mismatchedCount(), 2);
+    QCOMPARE(tail.finalResult(), QStringLiteral("Netlists do not match."));
+}
+
+void NetgenOutTailTests::follows_a_growing_file() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("comp.out"));
+    const QByteArray data = readAll(QStringLiteral(TUT3_OUT_PATH));
+    const qsizetype split = data.indexOf("Subcircuit summary:", 1) + 5;
+
+    NetgenOutTail tail;
+    tail.start(path);
+    tail.poll(); // not created yet
+    QVERIFY(tail.cells().isEmpty());
+
+    QFile out(path);
+    QVERIFY(out.open(QIODevice::WriteOnly));
+    out.write(data.left(split));
+    out.flush();
+    tail.poll();
+    QCOMPARE(tail.cells().size(), 1);
+    QCOMPARE(tail.mismatchedCount(), 1);
+
+    out.write(data.mid(split));
+    out.close();
+    tail.stop();
+    QCOMPARE(tail.cells().size(), 2);
+    QCOMPARE(tail.mismatchedCount(), 2);
+}
+
+QTEST_GUILESS_MAIN(NetgenOutTailTests)
+#include "NetgenOutTailTests.moc"
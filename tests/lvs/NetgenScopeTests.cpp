@@ -0,0 +1,176 @@
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "lvs/LvsResultCache.hpp"
+#include "lvs/NetgenScope.hpp"
+
+class NetgenScopeTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();
+    void empties_black_boxed_cells();
+    void reuses_unchanged_clean_cells();
+
+  private:
+    auto makeRequest() const -> LvsRunner::Request;
+    void writeFile(const QString &name, const QByteArray &content) const;
+    auto readFile(const QString &path) const -> QByteArray;
+    // netgen's report for the inv, buf and top cells; diff makes buf
+    // mismatch.
+    void writeReport(const QString &path, bool diff) const;
+
+    QTemporaryDir dir_;
+};
+
+namespace {
+const QByteArray cells = ".subckt inv a y\n"
+                         "M1 y a 0 0 nfet\n"
+                         ".ends\n"
+                         ".subckt buf a y\n"
+                         "X1 a m inv ; first stage\n"
+                         "X2 m y inv\n"
+                         ".ends\n";
+
+auto circuit(const QString &cell, int nets) -> QJsonObject {
+    return QJsonDocument::fromJson(
+               QStringLiteral("{\"name\": [\"%1\", \"%1\"], "
+                              "\"devices\": [[[\"nfet\", 1]], "
+                              "[[\"nfet\", 1]]], \"nets\": [%2, %2]}")
+                   .arg(cell)
+                   .arg(nets)
+                   .toUtf8())
+        .object();
+}
+} // namespace
+
+void NetgenScopeTests::initTestCase() {
+    QVERIFY(dir_.isValid());
+    writeFile(QStringLiteral("cells.sp"), cells);
+    writeFile(QStringLiteral("layout.spice"),
+              ".include \"cells.sp\"\nX1 in out buf\n.end\n");
+    writeFile(QStringLiteral("schematic.spice"),
+              cells + "X1 in out buf\n.end\n");
+    writeFile(QStringLiteral("setup.tcl"), "permute default\n");
+}
+
+auto NetgenScopeTests::makeRequest() const -> LvsRunner::Request {
+    LvsRunner::Request request;
+    request.layout = dir_.filePath(QStringLiteral("layout.spice"));
+    request.schematic = dir_.filePath(QStringLiteral("schematic.spice"));
+    request.rules = dir_.filePath(QStringLiteral("setup.tcl"));
+    return request;
+}
+
+void NetgenScopeTests::writeFile(const QString &name,
+                                 const QByteArray &content) const {
+    QFile file(dir_.filePath(name));
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(content);
+}
+
+auto NetgenScopeTests::readFile(const QString &path) const -> QByteArray {
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+void NetgenScopeTests::writeReport(const QString &path, bool diff) const {
+    QJsonObject buf = circuit(QStringLiteral("buf"), 3);
+    if (diff) {
+        buf.insert(QStringLiteral("nets"), QJsonArray{3, 4});
+        buf.insert(QStringLiteral("badnets"),
+                   QJsonDocument::fromJson(
+                       "[[[[\"m\", [[\"inv\", \"a\", 1]]]], [[\"m\", "
+                       "[[\"inv\", \"y\", 1]]]]]]")
+                       .array());
+    }
+    const QJsonArray report{circuit(QStringLiteral("inv"), 3), buf,
+                            circuit(QStringLiteral("layout.spice"), 2)};
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(QJsonDocument(report).toJson());
+}
+
+void NetgenScopeTests::empties_black_boxed_cells() {
+    const QByteArray scoped = NetgenScope::blackBoxed(
+        dir_.filePath(QStringLiteral("layout.spice")),
+        {QStringLiteral("buf")});
+    // The include is read in place and only buf loses its body.
+    QVERIFY(!scoped.contains(".include"));
+    QVERIFY(scoped.contains(".subckt inv a y\nM1 y a 0 0 nfet\n.ends\n"));
+    QVERIFY(scoped.contains(".subckt buf a y\n"));
+    QVERIFY(!scoped.contains("X1 a m inv"));
+    QVERIFY(!scoped.contains("X2 m y inv"));
+    QVERIFY(scoped.contains("X1 in out buf\n.end\n"));
+
+    QVERIFY(NetgenScope::blackBoxed(dir_.filePath(QStringLiteral("none.sp")),
+                                    {})
+                .isEmpty());
+}
+
+void NetgenScopeTests::reuses_unchanged_clean_cells() {
+    LvsResultCache cache(dir_.filePath(QStringLiteral("cache")));
+    const QString scopeDir = dir_.filePath(QStringLiteral("scoped"));
+    const QString json = dir_.filePath(QStringLiteral("comp.json"));
+
+    // Nothing stored yet: netgen runs the netlists as given, and its
+    // clean cells are stored. buf mismatches and is not.
+    NetgenScope::Plan plan =
+        NetgenScope::plan(makeRequest(), cache, scopeDir, true);
+    QVERIFY(!plan.scopeKey.isEmpty());
+    QCOMPARE(plan.cellKeys.size(), 2);
+    QVERIFY(plan.reused.isEmpty());
+    QCOMPARE(plan.layout, makeRequest().layout);
+    writeReport(json, true);
+    NetgenScope::remember(json, plan, cache);
+    QCOMPARE(cache.cellResults(plan.scopeKey).size(), 1);
+
+    // inv is black-boxed now; buf is compared again.
+    plan = NetgenScope::plan(makeRequest(), cache, scopeDir, true);
+    QCOMPARE(plan.reused.keys(), QStringList{QStringLiteral("inv")});
+    QVERIFY(plan.layout.startsWith(scopeDir));
+    QVERIFY(plan.layout.endsWith(QStringLiteral("/layout.spice")));
+    QVERIFY(!readFile(plan.layout).contains("M1 y a 0 0 nfet"));
+    QVERIFY(readFile(plan.schematic).contains("X2 m y inv"));
+
+    // netgen reports the black box as an empty cell; merge() puts the
+    // stored comparison back in its place.
+    writeReport(json, false);
+    QJsonArray fresh =
+        QJsonDocument::fromJson(readFile(json)).array();
+    fresh.replace(0, QJsonDocument::fromJson(
+                         "{\"name\": [\"inv\", \"inv\"], \"nets\": [2, 2]}")
+                         .object());
+    {
+        QFile file(json);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(QJsonDocument(fresh).toJson());
+    }
+    QVERIFY(NetgenScope::merge(json, plan));
+    const QJsonArray merged = QJsonDocument::fromJson(readFile(json)).array();
+    QCOMPARE(merged.size(), 3);
+    QCOMPARE(merged.at(0).toObject(), circuit(QStringLiteral("inv"), 3));
+    QCOMPARE(merged.at(1).toObject(), circuit(QStringLiteral("buf"), 3));
+    NetgenScope::remember(json, plan, cache);
+    QCOMPARE(cache.cellResults(plan.scopeKey).size(), 2);
+
+    // Both are black-boxed next; forcing a rerun reuses nothing.
+    plan = NetgenScope::plan(makeRequest(), cache, scopeDir, true);
+    QCOMPARE(plan.reused.size(), 2);
+    QVERIFY(NetgenScope::plan(makeRequest(), cache, scopeDir, false)
+                .reused.isEmpty());
+
+    // Editing inv changes both digests, so neither is reused.
+    writeFile(QStringLiteral("cells.sp"),
+              QByteArray(cells).replace("nfet", "pfet"));
+    plan = NetgenScope::plan(makeRequest(), cache, scopeDir, true);
+    QVERIFY(plan.reused.isEmpty());
+    QCOMPARE(plan.layout, makeRequest().layout);
+    writeFile(QStringLiteral("cells.sp"), cells);
+}
+
+QTEST_GUILESS_MAIN(NetgenScopeTests)
+#include "NetgenScopeTests.moc"
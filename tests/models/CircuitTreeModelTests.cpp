@@ -9,6 +9,7 @@ class CircuitTreeModelTests : public QObject {
 
   private slots:
     static void builds_tree_and_filters();
+    static void appends_rows_without_reset();
 };
 
 void CircuitTreeModelTests::builds_tree_and_filters() {
@@ -17,6 +18,10 @@ void CircuitTreeModelTests::builds_tree_and_filters() {
     root.layoutCell = QStringLiteral("rootA");
     root.schematicCell = QStringLiteral("rootB");
     root.index = 0;
+    root.devicesA = QStringList{QStringLiteral("nfet")};
+    root.deviceCountsA = QVector<int>{1};
+    root.devicesB = QStringList{QStringLiteral("nfet")};
+    root.deviceCountsB = QVector<int>{2};
     NetgenJsonParser::Report::Circuit child;
     child.layoutCell = QStringLiteral("childA");
     child.schematicCell = QStringLiteral("childB");
@@ -41,6 +46,12 @@ void CircuitTreeModelTests::builds_tree_and_filters() {
     QVERIFY(childPtr);
     QCOMPARE(childPtr->layoutCell, QStringLiteral("childA"));
 
+    // Only circuits whose device classes differ carry a tooltip.
+    QVERIFY(treeModel.data(rootIdx, Qt::ToolTipRole)
+                .toString()
+                .contains(QStringLiteral("nfet: 1 vs 2")));
+    QVERIFY(!treeModel.data(childIdx, Qt::ToolTipRole).isValid());
+
     // Check proxy filtering by circuit index.
     DiffEntryModel diffModel;
     QVector<NetgenJsonParser::DiffEntry> diffs;
@@ -69,5 +80,52 @@ void CircuitTreeModelTests::builds_tree_and_filters() {
     QCOMPARE(proxy.rowCount(), 2);
 }
 
+void CircuitTreeModelTests::appends_rows_without_reset() {
+    QVector<NetgenJsonParser::Report::Circuit> circuits;
+    circuits.reserve(3);
+    NetgenJsonParser::Report::Circuit first;
+    first.layoutCell = QStringLiteral("a");
+    first.index = 0;
+    circuits.append(first);
+
+    CircuitTreeModel treeModel;
+    treeModel.setCircuits(&circuits);
+    DiffEntryModel diffModel;
+    DiffFilterProxyModel proxy;
+    proxy.setSourceModel(&diffModel);
+    proxy.setAllowedCircuits(QSet<int>({2}));
+    QSignalSpy treeResets(&treeModel, &QAbstractItemModel::modelReset);
+    QSignalSpy diffResets(&diffModel, &QAbstractItemModel::modelReset);
+
+    // A clean circuit stays out of the tree, as while streaming.
+    NetgenJsonParser::Report::Circuit clean;
+    clean.index = 1;
+    clean.isTopLevel = false;
+    NetgenJsonParser::Report::Circuit dirty;
+    dirty.layoutCell = QStringLiteral("c");
+    dirty.index = 2;
+    dirty.devicesA = QStringList{QStringLiteral("nfet")};
+    dirty.deviceCountsA = QVector<int>{1};
+    circuits << clean << dirty;
+    treeModel.appendCircuits();
+    QCOMPARE(treeModel.rowCount(), 2);
+    QCOMPARE(CircuitTreeModel::circuitForIndex(treeModel.index(1, 0))
+                 ->layoutCell,
+             QStringLiteral("c"));
+    QVERIFY(treeModel.data(treeModel.index(1, 0), Qt::ToolTipRole)
+                .toString()
+                .contains(QStringLiteral("nfet: 1 vs 0")));
+
+    NetgenJsonParser::DiffEntry entry;
+    entry.circuitIndex = 0;
+    diffModel.appendDiffs({entry});
+    entry.circuitIndex = 2;
+    diffModel.appendDiffs({entry, entry});
+    QCOMPARE(diffModel.rowCount(), 3);
+    QCOMPARE(proxy.rowCount(), 2); // the filter sees appended rows
+    QCOMPARE(treeResets.count(), 0);
+    QCOMPARE(diffResets.count(), 0);
+}
+
 QTEST_MAIN(CircuitTreeModelTests)
 #include "CircuitTreeModelTests.moc"
@@ -0,0 +1,140 @@
+#include <QtTest>
+
+#include "models/DiffClusters.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+
+class DiffClustersTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void masks_indices();
+    static void buckets_numbers();
+    static void groups_bit_slices();
+    static void keeps_distinct_issues_apart();
+    static void covers_every_row();
+};
+
+namespace {
+using DiffEntry = NetgenJsonParser::DiffEntry;
+using DiffType = NetgenJsonParser::DiffType;
+const QString tut6 = QStringLiteral(TUT6_PATH);
+
+auto entry(const QString &name, const QString &details,
+           DiffType type = DiffType::InstanceMismatch,
+           DiffEntry::Subtype subtype = DiffEntry::Subtype::NoMatchingInstance)
+    -> DiffEntry {
+    DiffEntry diff;
+    diff.type = type;
+    diff.subtype = subtype;
+    diff.name = name;
+    diff.layoutCell = QStringLiteral("sram_array");
+    diff.schematicCell = QStringLiteral("sram_array");
+    diff.details = details;
+    return diff;
+}
+
+auto listOf(const QVector<DiffEntry> &diffs) -> DiffClusters::DiffList {
+    DiffClusters::DiffList list;
+    for (const DiffEntry &diff : diffs) {
+        list.append(&diff);
+    }
+    return list;
+}
+} // namespace
+
+void DiffClustersTests::masks_indices() {
+    QCOMPARE(DiffClusters::maskedName(QStringLiteral("data[12]")),
+             QStringLiteral("data[#]"));
+    QCOMPARE(DiffClusters::maskedName(QStringLiteral("XI3/bit_07<4>")),
+             QStringLiteral("XI#/bit_#<#>"));
+    QCOMPARE(DiffClusters::maskedName(QStringLiteral("vdd")),
+             QStringLiteral("vdd"));
+}
+
+void DiffClustersTests::buckets_numbers() {
+    QCOMPARE(DiffClusters::maskedDetails(QStringLiteral("w: 1.5u vs 2u")),
+             QStringLiteral("w: ~1e-6 vs ~1e-6"));
+    QCOMPARE(DiffClusters::maskedDetails(QStringLiteral("l=1e-7 vs 0.15")),
+             QStringLiteral("l=~1e-7 vs ~1e-1"));
+    QCOMPARE(DiffClusters::maskedDetails(QStringLiteral("r=2meg, 0")),
+             QStringLiteral("r=~1e6, 0"));
+    QCOMPARE(DiffClusters::maskedDetails(QStringLiteral("c=2a vs 10mil")),
+             QStringLiteral("c=~1e-18 vs ~1e-4"));
+    // Digits inside a word are indices; letters after a number are its
+    // scale and unit, as SpiceNumber reads them.
+    QCOMPARE(DiffClusters::maskedDetails(
+                 QStringLiteral("(connected to m4/g, m2/d)")),
+             QStringLiteral("(connected to m#/d, m#/g)"));
+    QCOMPARE(DiffClusters::maskedDetails(QStringLiteral("3um")),
+             QStringLiteral("~1e-6"));
+    QCOMPARE(DiffClusters::maskedDetails(QStringLiteral("10kohm")),
+             QStringLiteral("~1e4"));
+}
+
+void DiffClustersTests::groups_bit_slices() {
+    QVector<DiffEntry> diffs;
+    for (int bit = 0; bit < 8; ++bit) {
+        diffs.append(entry(QStringLiteral("XBIT%1/XM1").arg(bit),
+                           QStringLiteral("No matching instance for XBIT%1")
+                               .arg(bit)));
+    }
+    diffs.append(entry(QStringLiteral("XDEC"),
+                       QStringLiteral("No matching instance for XDEC")));
+    // One finger group: same parameter, different but similar values.
+    for (int finger = 0; finger < 3; ++finger) {
+        diffs.append(entry(QStringLiteral("M%1").arg(finger),
+                           QStringLiteral("w: %1u vs 2u").arg(finger + 1),
+                           DiffType::PropertyMismatch,
+                           DiffEntry::Subtype::MissingParameter));
+    }
+
+    const auto clusters = DiffClusters::cluster(listOf(diffs));
+    QCOMPARE(clusters.size(), qsizetype(3));
+    QCOMPARE(clusters.at(0).rows.size(), qsizetype(8));
+    QCOMPARE(clusters.at(0).name, QStringLiteral("XBIT#/XM#"));
+    QCOMPARE(clusters.at(1).rows, (QVector<int>{9, 10, 11}));
+    QCOMPARE(clusters.at(1).details, QStringLiteral("w: ~1e-6 vs ~1e-6"));
+    QCOMPARE(clusters.at(2).rows, QVector<int>{8});
+}
+
+void DiffClustersTests::keeps_distinct_issues_apart() {
+    const QVector<DiffEntry> diffs{
+        entry(QStringLiteral("M1"), QStringLiteral("w: 1u vs 2u"),
+              DiffType::PropertyMismatch,
+              DiffEntry::Subtype::MissingParameter),
+        entry(QStringLiteral("M2"), QStringLiteral("w: 1u vs 20u"),
+              DiffType::PropertyMismatch,
+              DiffEntry::Subtype::MissingParameter),
+        entry(QStringLiteral("M3"), QStringLiteral("w: 1u vs 2u"),
+              DiffType::DeviceMismatch,
+              DiffEntry::Subtype::MissingParameter)};
+    QCOMPARE(DiffClusters::cluster(listOf(diffs)).size(), qsizetype(3));
+}
+
+void DiffClustersTests::covers_every_row() {
+    const auto report = NetgenJsonParser::parseFile(tut6);
+    QVERIFY(report.ok);
+    DiffClusters::DiffList list;
+    for (const auto &cir : report.circuits) {
+        for (const DiffEntry &diff : cir.diffs) {
+            list.append(&diff);
+        }
+    }
+    const auto clusters = DiffClusters::cluster(list);
+    QVERIFY(!clusters.isEmpty());
+    QVERIFY(clusters.size() <= list.size());
+    QVector<int> seen(list.size(), 0);
+    for (qsizetype i = 0; i < clusters.size(); ++i) {
+        if (i > 0) {
+            QVERIFY(clusters.at(i - 1).rows.size() >=
+                    clusters.at(i).rows.size());
+        }
+        for (const int row : clusters.at(i).rows) {
+            ++seen[row];
+        }
+    }
+    QCOMPARE(seen.count(1), list.size());
+}
+
+QTEST_GUILESS_MAIN(DiffClustersTests)
+#include "DiffClustersTests.moc"
@@ -0,0 +1,173 @@
+#include <QtTest>
+#include <algorithm>
+
+#include "models/DiffDelta.hpp"
+#include "parsers/DiffDetailCache.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+
+class DiffDeltaTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void classifies_new_fixed_unchanged();
+    static void matches_repeated_keys_one_to_one();
+    static void normalizes_pin_order();
+    static void places_fixed_in_current_circuit();
+    static void self_compare_is_unchanged();
+    static void reads_on_demand_details();
+};
+
+namespace {
+using Circuit = NetgenJsonParser::Report::Circuit;
+using DiffEntry = NetgenJsonParser::DiffEntry;
+using DiffType = NetgenJsonParser::DiffType;
+using Status = DiffDelta::Status;
+const QString tut6 = QStringLiteral(TUT6_PATH);
+
+auto circuit(const QString &cell, long long index,
+             const QStringList &names) -> Circuit {
+    Circuit cir;
+    cir.layoutCell = cell;
+    cir.schematicCell = cell;
+    cir.index = index;
+    cir.isTopLevel = index == 0;
+    for (const QString &name : names) {
+        DiffEntry entry;
+        entry.type = DiffType::NetMismatch;
+        entry.subtype = DiffEntry::Subtype::NoMatchingNet;
+        entry.name = name;
+        entry.layoutCell = cell;
+        entry.schematicCell = cell;
+        entry.details = QStringLiteral("No matching net for %1").arg(name);
+        entry.circuitIndex = index;
+        cir.diffs.append(entry);
+    }
+    return cir;
+}
+
+auto diffCount(const QVector<Circuit> &circuits) -> qsizetype {
+    qsizetype count = 0;
+    for (const auto &cir : circuits) {
+        count += cir.diffs.size();
+    }
+    return count;
+}
+} // namespace
+
+void DiffDeltaTests::classifies_new_fixed_unchanged() {
+    const QVector<Circuit> baseline{
+        circuit(QStringLiteral("top"), 0,
+                {QStringLiteral("a"), QStringLiteral("b")})};
+    const QVector<Circuit> current{
+        circuit(QStringLiteral("top"), 0,
+                {QStringLiteral("c"), QStringLiteral("a")})};
+
+    const auto delta = DiffDelta::compare(baseline, current);
+    QVERIFY(delta.current ==
+            (QVector<Status>{Status::New, Status::Unchanged}));
+    QCOMPARE(delta.newCount, qint64(1));
+    QCOMPARE(delta.unchangedCount, qint64(1));
+    QCOMPARE(delta.fixed.size(), qsizetype(1));
+    QCOMPARE(delta.fixed.first().name, QStringLiteral("b"));
+    QCOMPARE(delta.fixed.first().sourceIndex, -1);
+}
+
+void DiffDeltaTests::matches_repeated_keys_one_to_one() {
+    const QVector<Circuit> baseline{
+        circuit(QStringLiteral("top"), 0,
+                {QStringLiteral("a"), QStringLiteral("a"),
+                 QStringLiteral("a")})};
+    const QVector<Circuit> current{
+        circuit(QStringLiteral("top"), 0,
+                {QStringLiteral("a"), QStringLiteral("a")})};
+    auto delta = DiffDelta::compare(baseline, current);
+    QCOMPARE(delta.unchangedCount, qint64(2));
+    QCOMPARE(delta.fixed.size(), qsizetype(1));
+
+    delta = DiffDelta::compare(current, baseline);
+    QVERIFY(delta.current == (QVector<Status>{Status::Unchanged,
+                                              Status::Unchanged,
+                                              Status::New}));
+    QVERIFY(delta.fixed.isEmpty());
+}
+
+void DiffDeltaTests::normalizes_pin_order() {
+    QCOMPARE(
+        DiffDelta::normalizedDetails(QStringLiteral(
+            "The following pins are connected only in Layout circuit: "
+            "m2/d, m1/g | The following pins are connected only in "
+            "Schematics circuit: x/b,  x/a")),
+        QStringLiteral("The following pins are connected only in Layout "
+                       "circuit: m1/g, m2/d | The following pins are "
+                       "connected only in Schematics circuit: x/a, x/b"));
+    QCOMPARE(DiffDelta::normalizedDetails(QStringLiteral(
+                 "No matching net in Layout circuit for n1 (connected to "
+                 "r2/b, r1/a)")),
+             QStringLiteral("No matching net in Layout circuit for n1 "
+                            "(connected to r1/a, r2/b)"));
+    QCOMPARE(DiffDelta::normalizedDetails(QStringLiteral("w: 1 vs 2")),
+             QStringLiteral("w: 1 vs 2"));
+
+    QVector<Circuit> baseline{circuit(QStringLiteral("top"), 0,
+                                      {QStringLiteral("n1")})};
+    QVector<Circuit> current = baseline;
+    baseline.first().diffs.first().details =
+        QStringLiteral("Layout: p2, p1");
+    current.first().diffs.first().details = QStringLiteral("Layout: p1, p2");
+    QCOMPARE(DiffDelta::compare(baseline, current).unchangedCount,
+             qint64(1));
+}
+
+void DiffDeltaTests::places_fixed_in_current_circuit() {
+    const QVector<Circuit> baseline{
+        circuit(QStringLiteral("top"), 0, {}),
+        circuit(QStringLiteral("inv"), 1, {QStringLiteral("a")}),
+        circuit(QStringLiteral("gone"), 2, {QStringLiteral("b")})};
+    const QVector<Circuit> current{
+        circuit(QStringLiteral("top"), 0, {QStringLiteral("c")}),
+        circuit(QStringLiteral("nand"), 1, {}),
+        circuit(QStringLiteral("inv"), 2, {})};
+
+    const auto delta = DiffDelta::compare(baseline, current);
+    QCOMPARE(delta.fixed.size(), qsizetype(2));
+    QCOMPARE(delta.fixed.at(0).circuitIndex, 2LL);
+    // A cell the current report no longer lists falls back to the top.
+    QCOMPARE(delta.fixed.at(1).circuitIndex, 0LL);
+}
+
+void DiffDeltaTests::self_compare_is_unchanged() {
+    const auto first = NetgenJsonParser::parseFile(tut6);
+    const auto second = NetgenJsonParser::parseFile(tut6);
+    QVERIFY(first.ok && second.ok);
+    const auto delta = DiffDelta::compare(first.circuits, second.circuits);
+    QCOMPARE(delta.unchangedCount, qint64(diffCount(second.circuits)));
+    QCOMPARE(delta.newCount, qint64(0));
+    QVERIFY(delta.fixed.isEmpty());
+}
+
+void DiffDeltaTests::reads_on_demand_details() {
+    const auto compact =
+        NetgenJsonParser::parseFile(tut6, NetgenJsonParser::Details::OnDemand);
+    QVERIFY(compact.ok && compact.detailCache);
+    const DiffDetailCache &cache = *compact.detailCache;
+    auto resident = NetgenJsonParser::parseFile(tut6);
+
+    // Without the cache the dropped details would not match.
+    auto delta = DiffDelta::compare(compact.circuits, resident.circuits,
+                                    &cache);
+    QCOMPARE(delta.newCount, qint64(0));
+
+    // Fixed rows carry the baseline's details, read back from the spill.
+    auto withDiffs =
+        std::find_if(resident.circuits.begin(), resident.circuits.end(),
+                     [](const Circuit &cir) { return !cir.diffs.isEmpty(); });
+    QVERIFY(withDiffs != resident.circuits.end());
+    const DiffEntry removed = withDiffs->diffs.takeFirst();
+    delta = DiffDelta::compare(compact.circuits, resident.circuits, &cache);
+    QCOMPARE(delta.fixed.size(), qsizetype(1));
+    QCOMPARE(delta.fixed.first().name, removed.name);
+    QCOMPARE(delta.fixed.first().details, removed.details);
+}
+
+QTEST_GUILESS_MAIN(DiffDeltaTests)
+#include "DiffDeltaTests.moc"
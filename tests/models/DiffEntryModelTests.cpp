@@ -1,6 +1,8 @@
 #include <QtTest>
 
+#include "models/DiffEntryCommon.hpp"
 #include "models/DiffEntryModel.hpp"
+#include "parsers/DiffDetailCache.hpp"
 #include "parsers/NetgenJsonParser.hpp"
 
 class DiffEntryModelTests : public QObject {
@@ -8,6 +10,7 @@ class DiffEntryModelTests : public QObject {
 
   private slots:
     static void populates_rows_and_columns();
+    static void reads_details_off_the_gui_thread();
 };
 
 void DiffEntryModelTests::populates_rows_and_columns() {
@@ -48,5 +51,37 @@ void DiffEntryModelTests::populates_rows_and_columns() {
                 .contains(QStringLiteral("Extra connection")));
 }
 
+void DiffEntryModelTests::reads_details_off_the_gui_thread() {
+    const QString tut6 = QStringLiteral(TUT6_PATH);
+    const auto compact =
+        NetgenJsonParser::parseFile(tut6, NetgenJsonParser::Details::OnDemand);
+    const auto resident = NetgenJsonParser::parseFile(tut6);
+    QVERIFY(compact.ok && compact.detailCache && resident.ok);
+    QVector<NetgenJsonParser::DiffEntry> diffs;
+    QStringList expected;
+    for (qsizetype c = 0; c < compact.circuits.size(); ++c) {
+        diffs += compact.circuits.at(c).diffs;
+        for (const auto &entry : resident.circuits.at(c).diffs) {
+            expected << entry.details;
+        }
+    }
+    QVERIFY(diffs.size() > 1);
+
+    DiffEntryModel model;
+    model.setDetailSource(compact.detailCache);
+    model.setDiffs(diffs);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+    const QModelIndex first = model.index(0, DiffEntryColumns::DETAILS);
+    const QModelIndex second = model.index(1, DiffEntryColumns::DETAILS);
+    QCOMPARE(model.data(first).toString(),
+             DiffEntryModel::loadingDetails.toString());
+    QCOMPARE(model.data(second).toString(),
+             DiffEntryModel::loadingDetails.toString());
+    QVERIFY(changed.wait());
+    QCOMPARE(changed.count(), 1); // both rows came in one read
+    QCOMPARE(model.data(first).toString(), expected.at(0));
+    QCOMPARE(model.data(second).toString(), expected.at(1));
+}
+
 QTEST_MAIN(DiffEntryModelTests)
 #include "DiffEntryModelTests.moc"
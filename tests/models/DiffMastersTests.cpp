@@ -0,0 +1,109 @@
+#include <QtTest>
+
+#include "models/DiffMasters.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+
+class DiffMastersTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void multiplies_instances_down_the_hierarchy();
+    static void marks_repeated_entries();
+    static void expands_to_same_master();
+    static void survives_cycles();
+    static void covers_tut6();
+};
+
+namespace {
+using Circuit = DiffMasters::Circuit;
+const QString tut6 = QStringLiteral(TUT6_PATH);
+
+auto circuit(long long index, const QString &cell,
+             const QStringList &devices = {},
+             const QVector<int> &counts = {}, int diffs = 1) -> Circuit {
+    Circuit cir;
+    cir.index = index;
+    cir.layoutCell = cell;
+    cir.schematicCell = cell;
+    cir.devicesA = devices;
+    cir.deviceCountsA = counts;
+    for (int i = 0; i < diffs; ++i) {
+        NetgenJsonParser::DiffEntry diff;
+        diff.circuitIndex = index;
+        cir.diffs.append(diff);
+    }
+    return cir;
+}
+
+// chip holds 4 inv, 2 nand and plain devices; each nand holds 2 inv. inv
+// is reported twice.
+auto design() -> QVector<Circuit> {
+    return {circuit(0, QStringLiteral("inv"), {QStringLiteral("nch")}, {1},
+                    3),
+            circuit(1, QStringLiteral("nand"), {QStringLiteral("inv")}, {2}),
+            circuit(2, QStringLiteral("inv"), {QStringLiteral("nch")}, {1},
+                    3),
+            circuit(3, QStringLiteral("chip"),
+                    {QStringLiteral("inv"), QStringLiteral("nand"),
+                     QStringLiteral("nch")},
+                    {4, 2, 10})};
+}
+} // namespace
+
+void DiffMastersTests::multiplies_instances_down_the_hierarchy() {
+    const DiffMasters masters = DiffMasters::build(design());
+    QCOMPARE(masters.masters().size(), qsizetype(3));
+    QCOMPARE(masters.instances(3), qint64(1));
+    QCOMPARE(masters.instances(1), qint64(2));
+    QCOMPARE(masters.instances(0), qint64(8));
+    QCOMPARE(masters.instances(2), qint64(8));
+    QCOMPARE(masters.instances(42), qint64(1));
+    // 3 inv diffs x 8, 1 nand diff x 2 and the chip's own.
+    QCOMPARE(masters.uniqueDiffCount(), qint64(5));
+    QCOMPARE(masters.occurrenceCount(), qint64(27));
+}
+
+void DiffMastersTests::marks_repeated_entries() {
+    const DiffMasters masters = DiffMasters::build(design());
+    QCOMPARE(masters.masterOf(0), masters.masterOf(2));
+    QVERIFY(masters.masterOf(0) != masters.masterOf(1));
+    QCOMPARE(masters.duplicateCircuits(), QSet<int>{2});
+    QCOMPARE(masters.masters().at(masters.masterOf(0)).circuits,
+             (QVector<int>{0, 2}));
+}
+
+void DiffMastersTests::expands_to_same_master() {
+    const DiffMasters masters = DiffMasters::build(design());
+    QCOMPARE(masters.sameMaster({2}), (QSet<int>{0, 2}));
+    QCOMPARE(masters.sameMaster({1, 42}), (QSet<int>{1, 42}));
+    QCOMPARE(DiffMasters().sameMaster({7}), QSet<int>{7});
+}
+
+void DiffMastersTests::survives_cycles() {
+    const QVector<Circuit> circuits{
+        circuit(0, QStringLiteral("a"), {QStringLiteral("b")}, {2}),
+        circuit(1, QStringLiteral("b"), {QStringLiteral("a")}, {2})};
+    const DiffMasters masters = DiffMasters::build(circuits);
+    QCOMPARE(masters.instances(0), qint64(1));
+    QCOMPARE(masters.instances(1), qint64(1));
+}
+
+void DiffMastersTests::covers_tut6() {
+    const auto report = NetgenJsonParser::parseFile(tut6);
+    QVERIFY(report.ok);
+    const DiffMasters masters = DiffMasters::build(report.circuits);
+    qint64 diffs = 0;
+    for (const auto &cir : report.circuits) {
+        QVERIFY(masters.masterOf(cir.index) >= 0);
+        QVERIFY(masters.instances(cir.index) >= 1);
+        if (!masters.duplicateCircuits().contains(
+                static_cast<int>(cir.index))) {
+            diffs += cir.diffs.size();
+        }
+    }
+    QCOMPARE(masters.uniqueDiffCount(), diffs);
+    QVERIFY(masters.occurrenceCount() >= diffs);
+}
+
+QTEST_GUILESS_MAIN(DiffMastersTests)
+#include "DiffMastersTests.moc"
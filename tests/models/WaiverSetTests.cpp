@@ -0,0 +1,167 @@
+#include <QtTest>
+
+#include "models/WaiverSet.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+
+class WaiverSetTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void parses_rules_and_reasons();
+    static void rejects_bad_lines();
+    static void matches_object_globs_and_regexes();
+    static void keeps_backreferences_of_grouped_regexes();
+    static void matches_type_subtype_and_cell();
+    static void first_rule_wins();
+    static void apply_agrees_with_match();
+};
+
+namespace {
+using DiffEntry = NetgenJsonParser::DiffEntry;
+using DiffType = NetgenJsonParser::DiffType;
+const QString tut6 = QStringLiteral(TUT6_PATH);
+
+auto entry(const QString &name, const QString &cell = QStringLiteral("top"),
+           DiffType type = DiffType::NetMismatch,
+           DiffEntry::Subtype subtype = DiffEntry::Subtype::NoMatchingNet)
+    -> DiffEntry {
+    DiffEntry diff;
+    diff.type = type;
+    diff.subtype = subtype;
+    diff.name = name;
+    diff.layoutCell = cell;
+    diff.schematicCell = cell;
+    return diff;
+}
+
+auto waivers(const QString &text) -> WaiverSet {
+    WaiverSet set;
+    QString error;
+    const bool ok = set.parse(text, &error);
+    if (!ok) {
+        qWarning() << error;
+    }
+    return set;
+}
+} // namespace
+
+void WaiverSetTests::parses_rules_and_reasons() {
+    WaiverSet set;
+    QVERIFY(set.parse(QStringLiteral("# header comment\n"
+                                     "\n"
+                                     "object=vdd*   # tied off\n"
+                                     "type=net_mismatch cell=inv#2\n")));
+    QCOMPARE(set.rules().size(), qsizetype(2));
+    QCOMPARE(set.rules().at(0).object, QStringLiteral("vdd*"));
+    QCOMPARE(set.rules().at(0).reason, QStringLiteral("tied off"));
+    QCOMPARE(set.rules().at(0).line, 3);
+    // '#' inside a pattern is not a comment.
+    QCOMPARE(set.rules().at(1).cell, QStringLiteral("inv#2"));
+    QVERIFY(set.rules().at(1).reason.isEmpty());
+}
+
+void WaiverSetTests::rejects_bad_lines() {
+    WaiverSet set;
+    QString error;
+    QVERIFY(set.parse(QStringLiteral("object=a")));
+    QVERIFY(!set.parse(QStringLiteral("object=a\ncolour=red"), &error));
+    QCOMPARE(error, QStringLiteral("line 2: unknown field colour"));
+    QVERIFY(set.isEmpty());
+
+    QVERIFY(!set.parse(QStringLiteral("object=re:(open"), &error));
+    QVERIFY(error.startsWith(QStringLiteral("line 1: bad object pattern")));
+    QVERIFY(!set.parse(QStringLiteral("object"), &error));
+    QVERIFY(!set.parse(QStringLiteral("cell=a cell=b"), &error));
+    QCOMPARE(error, QStringLiteral("line 1: cell given twice"));
+
+    QVERIFY(!set.load(QStringLiteral("/nonexistent/waivers.txt"), &error));
+    QVERIFY(error.startsWith(QStringLiteral("Failed to open file")));
+}
+
+void WaiverSetTests::matches_object_globs_and_regexes() {
+    const WaiverSet set = waivers(QStringLiteral("object=VDD\n"
+                                                 "object=*_dummy_?\n"
+                                                 "object=re:^net\\d+$\n"));
+    QCOMPARE(set.match(entry(QStringLiteral("vdd"))), 0);
+    QCOMPARE(set.match(entry(QStringLiteral("vdda"))), -1);
+    QCOMPARE(set.match(entry(QStringLiteral("m1_DUMMY_3"))), 1);
+    QCOMPARE(set.match(entry(QStringLiteral("m1_dummy_33"))), -1);
+    QCOMPARE(set.match(entry(QStringLiteral("NET42"))), 2);
+    QCOMPARE(set.match(entry(QStringLiteral("net42a"))), -1);
+    QCOMPARE(WaiverSet().match(entry(QStringLiteral("vdd"))), -1);
+}
+
+void WaiverSetTests::keeps_backreferences_of_grouped_regexes() {
+    // Joined into one alternation, \1 of the second rule would name the
+    // first rule's group.
+    const WaiverSet set = waivers(QStringLiteral("object=re:^(x)y$\n"
+                                                 "object=re:^(ab)\\1$\n"
+                                                 "object=re:^z+$\n"));
+    QCOMPARE(set.rules().size(), qsizetype(3));
+    QCOMPARE(set.match(entry(QStringLiteral("xy"))), 0);
+    QCOMPARE(set.match(entry(QStringLiteral("ABab"))), 1);
+    QCOMPARE(set.match(entry(QStringLiteral("abx"))), -1);
+    QCOMPARE(set.match(entry(QStringLiteral("zz"))), 2);
+}
+
+void WaiverSetTests::matches_type_subtype_and_cell() {
+    const WaiverSet set =
+        waivers(QStringLiteral("type=property_mismatch cell=decap_*\n"
+                               "subtype=missing_instance\n"));
+    const DiffEntry property =
+        entry(QStringLiteral("c1"), QStringLiteral("decap_4"),
+              DiffType::PropertyMismatch,
+              DiffEntry::Subtype::MissingParameter);
+    QCOMPARE(set.match(property), 0);
+
+    // Either the layout or the schematic cell may match.
+    DiffEntry renamed = property;
+    renamed.layoutCell = QStringLiteral("top");
+    QCOMPARE(set.match(renamed), 0);
+    renamed.schematicCell = QStringLiteral("top");
+    QCOMPARE(set.match(renamed), -1);
+
+    DiffEntry device = property;
+    device.type = DiffType::DeviceMismatch;
+    QCOMPARE(set.match(device), -1);
+    device.subtype = DiffEntry::Subtype::MissingInstance;
+    QCOMPARE(set.match(device), 1);
+}
+
+void WaiverSetTests::first_rule_wins() {
+    const WaiverSet set = waivers(QStringLiteral("object=*         # any\n"
+                                                 "object=clk      # clock\n"));
+    QCOMPARE(set.match(entry(QStringLiteral("clk"))), 0);
+
+    const WaiverSet reversed =
+        waivers(QStringLiteral("object=clk\nobject=*\n"));
+    QCOMPARE(reversed.match(entry(QStringLiteral("clk"))), 0);
+    QCOMPARE(reversed.match(entry(QStringLiteral("rst"))), 1);
+}
+
+void WaiverSetTests::apply_agrees_with_match() {
+    const auto report = NetgenJsonParser::parseFile(tut6);
+    QVERIFY(report.ok);
+    const WaiverSet set = waivers(QStringLiteral(
+        "type=net_mismatch object=*a*\n"
+        "cell=*inv* object=re:^[a-m]\n"
+        "subtype=no_matching_instance\n"
+        "object=?\n"));
+    QVERIFY(!set.isEmpty());
+
+    const QVector<int> waived = set.apply(report.circuits);
+    qsizetype row = 0;
+    qsizetype hits = 0;
+    for (const auto &cir : report.circuits) {
+        for (const DiffEntry &diff : cir.diffs) {
+            const int rule = waived.at(row++);
+            QCOMPARE(rule, set.match(diff));
+            hits += rule >= 0 ? 1 : 0;
+        }
+    }
+    QCOMPARE(waived.size(), row);
+    QVERIFY(hits > 0);
+}
+
+QTEST_GUILESS_MAIN(WaiverSetTests)
+#include "WaiverSetTests.moc"
@@ -0,0 +1,110 @@
+#include <QtTest>
+
+#include "parsers/DeviceHistogram.hpp"
+
+class DeviceHistogramTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void joins_classes_by_name();
+    static void keeps_swapped_classes_with_equal_totals();
+    static void rolls_up_through_subcells();
+    static void survives_cycles();
+};
+
+namespace {
+using Circuit = DeviceHistogram::Circuit;
+using ClassCount = DeviceHistogram::ClassCount;
+
+auto circuit(const QString &cell, const QStringList &classesA,
+             const QVector<int> &countsA, const QStringList &classesB,
+             const QVector<int> &countsB) -> Circuit {
+    Circuit cir;
+    cir.layoutCell = cell;
+    cir.schematicCell = cell;
+    cir.devicesA = classesA;
+    cir.deviceCountsA = countsA;
+    cir.devicesB = classesB;
+    cir.deviceCountsB = countsB;
+    return cir;
+}
+
+auto find(const QVector<ClassCount> &rows, const QString &deviceClass)
+    -> ClassCount {
+    for (const ClassCount &row : rows) {
+        if (row.deviceClass == deviceClass) {
+            return row;
+        }
+    }
+    return {};
+}
+} // namespace
+
+void DeviceHistogramTests::joins_classes_by_name() {
+    // Order differs per side, and nfet is listed twice in the layout.
+    const auto rows = DeviceHistogram::compare(
+        {QStringLiteral("pfet"), QStringLiteral("nfet"),
+         QStringLiteral("nfet")},
+        {1, 2, 3}, {QStringLiteral("nfet"), QStringLiteral("res")}, {5, 1});
+    QCOMPARE(rows.size(), qsizetype(3));
+    QCOMPARE(rows.at(0).deviceClass, QStringLiteral("pfet"));
+    QCOMPARE(rows.at(0).schematic, qint64(0));
+    QCOMPARE(rows.at(1).layout, qint64(5));
+    QCOMPARE(rows.at(1).schematic, qint64(5));
+    QCOMPARE(rows.at(2).deviceClass, QStringLiteral("res"));
+    QCOMPARE(rows.at(2).layout, qint64(0));
+
+    const auto off = DeviceHistogram::mismatches(rows);
+    QCOMPARE(off.size(), qsizetype(2));
+    QCOMPARE(off.at(0).deviceClass, QStringLiteral("pfet"));
+    QCOMPARE(off.at(1).deviceClass, QStringLiteral("res"));
+}
+
+void DeviceHistogramTests::keeps_swapped_classes_with_equal_totals() {
+    const auto off = DeviceHistogram::mismatches(DeviceHistogram::of(
+        circuit(QStringLiteral("inv"),
+                {QStringLiteral("pfet"), QStringLiteral("nfet")}, {2, 1},
+                {QStringLiteral("pfet"), QStringLiteral("nfet")}, {1, 2})));
+    QCOMPARE(off.size(), qsizetype(2));
+}
+
+void DeviceHistogramTests::rolls_up_through_subcells() {
+    // chip has 3 inv in the layout and 4 in the schematic; inv itself has
+    // one pfet more in the schematic.
+    const QVector<Circuit> circuits{
+        circuit(QStringLiteral("chip"),
+                {QStringLiteral("inv"), QStringLiteral("nfet")}, {3, 2},
+                {QStringLiteral("inv"), QStringLiteral("nfet")}, {4, 2}),
+        circuit(QStringLiteral("inv"),
+                {QStringLiteral("pfet"), QStringLiteral("nfet")}, {1, 1},
+                {QStringLiteral("pfet"), QStringLiteral("nfet")}, {2, 1})};
+    const auto rolled = DeviceHistogram::rolledUp(circuits);
+    QCOMPARE(rolled.size(), qsizetype(2));
+    const ClassCount pfet = find(rolled.at(0), QStringLiteral("pfet"));
+    QCOMPARE(pfet.layout, qint64(3));
+    QCOMPARE(pfet.schematic, qint64(8));
+    const ClassCount nfet = find(rolled.at(0), QStringLiteral("nfet"));
+    QCOMPARE(nfet.layout, qint64(5));
+    QCOMPARE(nfet.schematic, qint64(6));
+    QVERIFY(find(rolled.at(0), QStringLiteral("inv")).deviceClass.isEmpty());
+    QCOMPARE(rolled.at(1).size(), qsizetype(2));
+}
+
+void DeviceHistogramTests::survives_cycles() {
+    const QVector<Circuit> circuits{
+        circuit(QStringLiteral("a"), {QStringLiteral("b")}, {2},
+                {QStringLiteral("b")}, {2}),
+        circuit(QStringLiteral("b"),
+                {QStringLiteral("a"), QStringLiteral("nfet")}, {1, 1},
+                {QStringLiteral("a"), QStringLiteral("nfet")}, {1, 2})};
+    const auto rolled = DeviceHistogram::rolledUp(circuits);
+    QCOMPARE(rolled.size(), qsizetype(2));
+    // b keeps a as a class; a expands b.
+    QCOMPARE(find(rolled.at(1), QStringLiteral("a")).layout, qint64(1));
+    const ClassCount nfet = find(rolled.at(0), QStringLiteral("nfet"));
+    QCOMPARE(nfet.layout, qint64(2));
+    QCOMPARE(nfet.schematic, qint64(4));
+}
+
+QTEST_GUILESS_MAIN(DeviceHistogramTests)
+#include "DeviceHistogramTests.moc"
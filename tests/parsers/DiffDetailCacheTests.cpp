@@ -0,0 +1,112 @@
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "parsers/DiffDetailCache.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+
+class DiffDetailCacheTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void on_demand_parse_drops_details();
+    static void resolves_details_like_resident_parse();
+    static void evicts_beyond_max_bytes();
+    static void outlives_the_source_file();
+};
+
+namespace {
+using Details = NetgenJsonParser::Details;
+const QString tut1 = QStringLiteral(FIXTURE_PATH);
+const QString tut6 = QStringLiteral(TUT6_PATH);
+} // namespace
+
+void DiffDetailCacheTests::on_demand_parse_drops_details() {
+    const auto resident = NetgenJsonParser::parseFile(tut6);
+    const auto compact =
+        NetgenJsonParser::parseFile(tut6, Details::OnDemand);
+    QVERIFY(resident.ok);
+    QVERIFY(compact.ok);
+    QVERIFY(!resident.detailsOnDemand);
+    QVERIFY(!resident.detailCache);
+    QVERIFY(compact.detailsOnDemand);
+    QVERIFY(compact.detailCache);
+    QVERIFY(compact.detailCache->spilledBytes() > 0);
+    QCOMPARE(compact.circuits.size(), resident.circuits.size());
+    QCOMPARE(compact.summary.netMismatches, resident.summary.netMismatches);
+    for (qsizetype c = 0; c < compact.circuits.size(); ++c) {
+        const auto &cir = compact.circuits.at(c);
+        QVERIFY(cir.sourceOffset >= 0);
+        QVERIFY(cir.sourceLength > 0);
+        QCOMPARE(cir.diffs.size(), resident.circuits.at(c).diffs.size());
+        for (const auto &entry : cir.diffs) {
+            QVERIFY(entry.details.isNull());
+            QVERIFY(entry.sourceIndex >= 0);
+        }
+    }
+}
+
+void DiffDetailCacheTests::resolves_details_like_resident_parse() {
+    const auto resident = NetgenJsonParser::parseFile(tut6);
+    const auto compact =
+        NetgenJsonParser::parseFile(tut6, Details::OnDemand);
+    const DiffDetailCache &cache = *compact.detailCache;
+
+    qint64 diffs = 0;
+    for (qsizetype c = 0; c < compact.circuits.size(); ++c) {
+        const auto &expected = resident.circuits.at(c).diffs;
+        const auto &actual = compact.circuits.at(c).diffs;
+        for (qsizetype d = 0; d < actual.size(); ++d) {
+            QString cached;
+            QVERIFY(!cache.cached(actual.at(d), &cached));
+            QCOMPARE(cache.details(actual.at(d)), expected.at(d).details);
+            QVERIFY(cache.cached(actual.at(d), &cached));
+            QCOMPARE(cached, expected.at(d).details);
+            ++diffs;
+        }
+    }
+    QVERIFY(diffs > 0);
+    // Each diff is read once, on its own, then served from the cache.
+    QCOMPARE(cache.misses(), diffs);
+    QCOMPARE(cache.hits(), diffs);
+    QCOMPARE(cache.cachedEntries(), diffs);
+    QVERIFY(cache.cachedBytes() > 0);
+
+    // Resident entries pass through untouched.
+    QCOMPARE(cache.details(resident.circuits.first().diffs.first()),
+             resident.circuits.first().diffs.first().details);
+}
+
+void DiffDetailCacheTests::evicts_beyond_max_bytes() {
+    auto resident = NetgenJsonParser::parseFile(tut1);
+    QVERIFY(resident.ok);
+    auto diffs = resident.circuits.first().diffs;
+    const QString expected = diffs.first().details;
+    QVERIFY(!expected.isEmpty());
+
+    DiffDetailCache cache(1);
+    QVERIFY(cache.spill(diffs));
+    QVERIFY(diffs.first().details.isNull());
+    QCOMPARE(cache.details(diffs.first()), expected);
+    QCOMPARE(cache.details(diffs.first()), expected);
+    QCOMPARE(cache.cachedBytes(), qint64(0));
+    QCOMPARE(cache.misses(), qint64(2));
+}
+
+void DiffDetailCacheTests::outlives_the_source_file() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("comp.json"));
+    QVERIFY(QFile::copy(tut1, path));
+    const auto compact = NetgenJsonParser::parseFile(path, Details::OnDemand);
+    QVERIFY(compact.ok);
+    QVERIFY(QFile::remove(path));
+
+    const auto resident = NetgenJsonParser::parseFile(tut1);
+    const auto &entry = compact.circuits.first().diffs.first();
+    QCOMPARE(compact.detailCache->details(entry),
+             resident.circuits.first().diffs.first().details);
+}
+
+QTEST_GUILESS_MAIN(DiffDetailCacheTests)
+#include "DiffDetailCacheTests.moc"
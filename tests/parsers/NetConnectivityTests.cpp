@@ -0,0 +1,295 @@
+#include <QtTest>
+
+#include "parsers/NetConnectivity.hpp"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+class NetConnectivityTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void finds_short();
+    static void finds_open();
+    static void ignores_matched_and_ambiguous_sets();
+    static void never_joins_one_side();
+    static void requires_balanced_counts();
+    static void finds_nothing_in_fixtures();
+    static void finds_open_in_split_supplies();
+    static void finds_short_in_merged_supplies();
+    static void finds_one_open_among_many_nets();
+    static void handles_many_nets();
+};
+
+namespace {
+using Net = NetConnectivity::Net;
+using Kind = NetConnectivity::Kind;
+
+struct Group {
+    QVector<Net> layout;
+    QVector<Net> schematic;
+};
+
+auto net(const QString &name, const QHash<QString, int> &pins) -> Net {
+    return Net{name, pins};
+}
+
+// One net per device pin, one device on each.
+auto net(const QString &name, const QStringList &pins) -> Net {
+    Net n{name, {}};
+    for (const QString &pin : pins) {
+        n.pins.insert(pin, 1);
+    }
+    return n;
+}
+
+// The nets of one side of a badnets group, read the way the parser does.
+auto netsOf(const QJsonArray &side) -> QVector<Net> {
+    QVector<Net> nets;
+    for (const QJsonValueConstRef &ref_net : side) {
+        const QJsonArray netArr = ref_net.toArray();
+        const QString name = netArr.at(0).toString();
+        if (name.contains(QStringLiteral("(no matching net)"))) {
+            continue;
+        }
+        Net n{name, {}};
+        for (const QJsonValueConstRef &ref_conn : netArr.at(1).toArray()) {
+            const QJsonArray conn = ref_conn.toArray();
+            n.pins[conn.at(0).toString() + QLatin1Char(':') +
+                   conn.at(1).toString()] += conn.at(2).toInt();
+        }
+        nets.append(n);
+    }
+    return nets;
+}
+
+// Every badnets group of a checked-in netgen report, in file order.
+auto fixtureGroups(const QString &path) -> QVector<Group> {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    QVector<Group> groups;
+    const QJsonArray circuits = QJsonDocument::fromJson(file.readAll()).array();
+    for (const QJsonValueConstRef &ref_circuit : circuits) {
+        const QJsonArray badnets =
+            ref_circuit.toObject().value(QStringLiteral("badnets")).toArray();
+        for (const QJsonValueConstRef &ref_group : badnets) {
+            QJsonArray pair = ref_group.toArray();
+            if (pair.size() == 1) {
+                pair = pair.at(0).toArray();
+            }
+            groups.append(Group{netsOf(pair.at(0).toArray()),
+                                netsOf(pair.at(1).toArray())});
+        }
+    }
+    return groups;
+}
+
+// One net carrying every device of the given nets.
+auto merged(const QString &name, const QVector<Net> &nets) -> Net {
+    Net n{name, {}};
+    for (const Net &part : nets) {
+        for (auto it = part.pins.cbegin(); it != part.pins.cend(); ++it) {
+            n.pins[it.key()] += it.value();
+        }
+    }
+    return n;
+}
+
+auto names(const QVector<Net> &nets) -> QStringList {
+    QStringList result;
+    for (const Net &n : nets) {
+        result.append(n.name);
+    }
+    return result;
+}
+} // namespace
+
+void NetConnectivityTests::finds_short() {
+    const auto findings = NetConnectivity::classify(
+        {net(QStringLiteral("vdd"), {QStringLiteral("inv:pos"),
+                                     QStringLiteral("nand:pos")})},
+        {net(QStringLiteral("vdd_a"), {QStringLiteral("inv:pos")}),
+         net(QStringLiteral("vdd_b"), {QStringLiteral("nand:pos")})});
+    QCOMPARE(findings.size(), qsizetype(1));
+    QVERIFY(findings.first().kind == Kind::Short);
+    QCOMPARE(findings.first().net, QStringLiteral("vdd"));
+    QCOMPARE(findings.first().nets,
+             (QStringList{QStringLiteral("vdd_a"), QStringLiteral("vdd_b")}));
+}
+
+void NetConnectivityTests::finds_open() {
+    const auto findings = NetConnectivity::classify(
+        {net(QStringLiteral("out_1"), {QStringLiteral("inv:out")}),
+         net(QStringLiteral("out_2"), {QStringLiteral("buf:in")})},
+        {net(QStringLiteral("out"), {QStringLiteral("inv:out"),
+                                     QStringLiteral("buf:in")})});
+    QCOMPARE(findings.size(), qsizetype(1));
+    QVERIFY(findings.first().kind == Kind::Open);
+    QCOMPARE(findings.first().net, QStringLiteral("out"));
+    QCOMPARE(findings.first().nets, (QStringList{QStringLiteral("out_1"),
+                                                 QStringLiteral("out_2")}));
+}
+
+void NetConnectivityTests::ignores_matched_and_ambiguous_sets() {
+    // One to one, a net without a counterpart, and two to two.
+    const auto findings = NetConnectivity::classify(
+        {net(QStringLiteral("a"), {QStringLiteral("inv:in")}),
+         net(QStringLiteral("b"), {QStringLiteral("pfet:bulk")}),
+         net(QStringLiteral("c"), {QStringLiteral("nand:a")}),
+         net(QStringLiteral("d"), {QStringLiteral("nand:b")})},
+        {net(QStringLiteral("a"), {QStringLiteral("inv:in")}),
+         net(QStringLiteral("e"), {QStringLiteral("nand:a"),
+                                   QStringLiteral("mux:s")}),
+         net(QStringLiteral("f"), {QStringLiteral("nand:b"),
+                                   QStringLiteral("mux:s")})});
+    QVERIFY(findings.isEmpty());
+}
+
+void NetConnectivityTests::never_joins_one_side() {
+    // y shares a pin with z but none with n, so n is not x, y and z; and
+    // p and q sharing a class pin does not make them one net.
+    auto findings = NetConnectivity::classify(
+        {net(QStringLiteral("n"),
+             {QStringLiteral("a:1"), QStringLiteral("c:1")})},
+        {net(QStringLiteral("x"), {QStringLiteral("a:1")}),
+         net(QStringLiteral("y"), {QStringLiteral("b:1")}),
+         net(QStringLiteral("z"),
+             {QStringLiteral("b:1"), QStringLiteral("c:1")})});
+    QVERIFY(findings.isEmpty());
+    findings = NetConnectivity::classify(
+        {net(QStringLiteral("p"), {{QStringLiteral("inv:out"), 1}}),
+         net(QStringLiteral("q"), {{QStringLiteral("inv:out"), 1}})},
+        {net(QStringLiteral("r"), {{QStringLiteral("inv:out"), 1}}),
+         net(QStringLiteral("s"), {{QStringLiteral("inv:out"), 1}})});
+    QVERIFY(findings.isEmpty());
+}
+
+void NetConnectivityTests::requires_balanced_counts() {
+    // Three inverters on the layout net, two on the schematic nets.
+    const QVector<Net> schematic{
+        net(QStringLiteral("vdd_a"), {{QStringLiteral("inv:pos"), 1}}),
+        net(QStringLiteral("vdd_b"), {{QStringLiteral("inv:pos"), 1}})};
+    QVERIFY(NetConnectivity::classify(
+                {net(QStringLiteral("vdd"), {{QStringLiteral("inv:pos"), 3}})},
+                schematic)
+                .isEmpty());
+    const auto findings = NetConnectivity::classify(
+        {net(QStringLiteral("vdd"), {{QStringLiteral("inv:pos"), 2}})},
+        schematic);
+    QCOMPARE(findings.size(), qsizetype(1));
+    QVERIFY(findings.first().kind == Kind::Short);
+}
+
+void NetConnectivityTests::finds_nothing_in_fixtures() {
+    // netgen pairs these nets up without a short or open; tut6 numbers
+    // its schematic pins, so no pin is shared across the sides at all.
+    const QVector<Group> tut2 = fixtureGroups(QStringLiteral(TUT2_PATH));
+    const QVector<Group> tut3 = fixtureGroups(QStringLiteral(TUT3_PATH));
+    const QVector<Group> tut6 = fixtureGroups(QStringLiteral(TUT6_PATH));
+    QCOMPARE(tut2.size(), qsizetype(1));
+    QCOMPARE(tut3.size(), qsizetype(2));
+    QCOMPARE(tut6.size(), qsizetype(12));
+    QCOMPARE(tut6.at(11).layout.size(), qsizetype(908));
+    for (const QVector<Group> &groups : {tut2, tut3, tut6}) {
+        for (const Group &group : groups) {
+            QVERIFY(NetConnectivity::classify(group.layout, group.schematic)
+                        .isEmpty());
+        }
+    }
+}
+
+void NetConnectivityTests::finds_open_in_split_supplies() {
+    // tut6's layout splits vdd in four and gnd in three; rejoined on the
+    // schematic side, each supply is an open over its own pieces.
+    const QVector<Net> layout =
+        fixtureGroups(QStringLiteral(TUT6_PATH)).value(0).layout;
+    QCOMPARE(layout.size(), qsizetype(7));
+    QVector<Net> vdd;
+    QVector<Net> gnd;
+    for (const Net &n : layout) {
+        (n.name.endsWith(QStringLiteral("/vdd")) ? vdd : gnd).append(n);
+    }
+    const auto findings = NetConnectivity::classify(
+        layout, {merged(QStringLiteral("vdd"), vdd),
+                 merged(QStringLiteral("gnd"), gnd)});
+    QCOMPARE(findings.size(), qsizetype(2));
+    QVERIFY(findings.at(0).kind == Kind::Open);
+    QCOMPARE(findings.at(0).net, QStringLiteral("vdd"));
+    QCOMPARE(findings.at(0).nets, names(vdd));
+    QVERIFY(findings.at(1).kind == Kind::Open);
+    QCOMPARE(findings.at(1).net, QStringLiteral("gnd"));
+    QCOMPARE(findings.at(1).nets, names(gnd));
+}
+
+void NetConnectivityTests::finds_short_in_merged_supplies() {
+    // tut6's schematic vdd and vss carry the same classes on different
+    // pins; one layout net with both is a short between them.
+    const QVector<Net> schematic =
+        fixtureGroups(QStringLiteral(TUT6_PATH)).value(0).schematic;
+    QCOMPARE(names(schematic),
+             (QStringList{QStringLiteral("vdd"), QStringLiteral("vss")}));
+    const auto findings = NetConnectivity::classify(
+        {merged(QStringLiteral("supply"), schematic)}, schematic);
+    QCOMPARE(findings.size(), qsizetype(1));
+    QVERIFY(findings.first().kind == Kind::Short);
+    QCOMPARE(findings.first().net, QStringLiteral("supply"));
+    QCOMPARE(findings.first().nets, names(schematic));
+}
+
+void NetConnectivityTests::finds_one_open_among_many_nets() {
+    // tut6's group of 105 layout nets against itself with two nets joined
+    // on the schematic side: every other net pairs off, many of them
+    // through the same class pins, and only the joined pair is reported.
+    const QVector<Net> layout =
+        fixtureGroups(QStringLiteral(TUT6_PATH)).value(8).layout;
+    QCOMPARE(layout.size(), qsizetype(105));
+    const auto byName = [&](const QString &name) {
+        for (const Net &n : layout) {
+            if (n.name == name) {
+                return n;
+            }
+        }
+        return Net{};
+    };
+    const Net a = byName(QStringLiteral("NOR2X1_5/Y"));
+    const Net b = byName(QStringLiteral("N<5>"));
+    QVERIFY(!a.pins.isEmpty() && !b.pins.isEmpty());
+    QVector<Net> schematic;
+    for (const Net &n : layout) {
+        if (n.name != a.name && n.name != b.name) {
+            schematic.append(n);
+        }
+    }
+    schematic.append(merged(QStringLiteral("joined"), {a, b}));
+    const auto findings = NetConnectivity::classify(layout, schematic);
+    QCOMPARE(findings.size(), qsizetype(1));
+    QVERIFY(findings.first().kind == Kind::Open);
+    QCOMPARE(findings.first().net, QStringLiteral("joined"));
+    QCOMPARE(findings.first().nets, (QStringList{a.name, b.name}));
+}
+
+void NetConnectivityTests::handles_many_nets() {
+    // Independent opens, each schematic net over two layout nets.
+    const int count = 100000;
+    QVector<Net> layout;
+    QVector<Net> schematic;
+    layout.reserve(2 * count);
+    schematic.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const QString a = QStringLiteral("x%1:a").arg(i);
+        const QString b = QStringLiteral("x%1:b").arg(i);
+        layout.append(net(QStringLiteral("l%1a").arg(i), QStringList{a}));
+        layout.append(net(QStringLiteral("l%1b").arg(i), QStringList{b}));
+        schematic.append(net(QStringLiteral("s%1").arg(i), {a, b}));
+    }
+    const auto findings = NetConnectivity::classify(layout, schematic);
+    QCOMPARE(findings.size(), qsizetype(count));
+    QCOMPARE(findings.last().net, QStringLiteral("s%1").arg(count - 1));
+}
+
+QTEST_GUILESS_MAIN(NetConnectivityTests)
+#include "NetConnectivityTests.moc"
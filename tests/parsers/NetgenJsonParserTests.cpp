@@ -12,6 +12,9 @@ class NetgenJsonParserTests : public QObject {
     static void parses_tut2_fixture();
     static void parses_tut3_fixture();
     static void parses_tut6_fixture_instance_mismatches();
+    static void detects_shorts_and_opens();
+    static void diffs_pins();
+    static void compares_properties_numerically();
     static void fails_on_invalid_json();
 };
 
@@ -41,6 +44,7 @@ void NetgenJsonParserTests::parses_sample_fixture() {
     QCOMPARE(sub.layoutCell, QStringLiteral("bufferA.spice"));
     QCOMPARE(sub.schematicCell, QStringLiteral("bufferB.spice"));
     QCOMPARE(sub.devicesA, QStringList({"pfet", "nfet"}));
+    QCOMPARE(sub.deviceCountsA, QVector<int>({2, 2}));
     QCOMPARE(sub.devicesB, QStringList({"pfet", "nfet"}));
     QCOMPARE(sub.subcircuits.size(), 0);
 
@@ -67,6 +71,9 @@ void NetgenJsonParserTests::parses_tut2_fixture() {
 
     QCOMPARE(report.circuits.size(), 2);
     const auto &sub = report.circuits[1];
+    // Its Gnd and Vdd pieces do not sum to any schematic net.
+    QCOMPARE(report.summary.shorts, 0);
+    QCOMPARE(report.summary.opens, 0);
 
     QCOMPARE(sub.summary.totalDevices, 2);
     QCOMPARE(sub.summary.totalNets, 5);
@@ -125,6 +132,8 @@ void NetgenJsonParserTests::parses_tut3_fixture() {
 
     QCOMPARE(report.circuits.size(), 2);
     const auto &sub = report.circuits[0];
+    QCOMPARE(report.summary.shorts, 0);
+    QCOMPARE(report.summary.opens, 0);
 
     QCOMPARE(sub.summary.totalDevices, 2);
     QCOMPARE(sub.summary.totalNets, 6);
@@ -132,7 +141,7 @@ void NetgenJsonParserTests::parses_tut3_fixture() {
     QCOMPARE(sub.schematicCell, QStringLiteral("inverter"));
     QCOMPARE(sub.subcircuits.size(), 0);
 
-    QCOMPARE(sub.diffs.size(), 2);
+    QCOMPARE(sub.diffs.size(), 3);
     QCOMPARE(sub.diffs[0].type, NetgenJsonParser::DiffType::NetMismatch);
     QCOMPARE(sub.diffs[0].subtype,
              NetgenJsonParser::DiffEntry::Subtype::UnmatchedConnections);
@@ -149,6 +158,14 @@ void NetgenJsonParserTests::parses_tut3_fixture() {
     QCOMPARE(sub.diffs[1].name, QStringLiteral("pfet:XU3"));
     QVERIFY(sub.diffs[1].details.contains(
         QStringLiteral("The instance is present only in Schematics circuit")));
+    QCOMPARE(sub.diffs[2].type, NetgenJsonParser::DiffType::DeviceMismatch);
+    QCOMPARE(sub.diffs[2].subtype,
+             NetgenJsonParser::DiffEntry::Subtype::DeviceCount);
+    QCOMPARE(sub.diffs[2].name, QStringLiteral("pfet"));
+    QCOMPARE(sub.diffs[2].details,
+             QStringLiteral("Class pfet: 1 in Layout circuit, 2 in Schematics "
+                            "circuit"));
+    QCOMPARE(sub.deviceCountsB, QVector<int>({2, 1}));
 }
 
 void NetgenJsonParserTests::parses_tut6_fixture_instance_mismatches() {
@@ -162,8 +179,13 @@ void NetgenJsonParserTests::parses_tut6_fixture_instance_mismatches() {
     QVERIFY(!report.circuits.isEmpty());
 
     const auto &sub = report.circuits.first();
+    // Badnets groups of up to 908 nets, none a short or an open.
+    QCOMPARE(report.summary.shorts, 0);
+    QCOMPARE(report.summary.opens, 0);
 
-    QCOMPARE(sub.diffs.size(), 1609);
+    // 1609 device and net diffs, then the 22 schematic pins netgen could
+    // not pair.
+    QCOMPARE(sub.diffs.size(), 1631);
     const auto diff = sub.diffs[1261];
     QCOMPARE(diff.type, NetgenJsonParser::DiffType::InstanceMismatch);
     QCOMPARE(diff.subtype,
@@ -174,6 +196,107 @@ void NetgenJsonParserTests::parses_tut6_fixture_instance_mismatches() {
                        "matching instance")));
 }
 
+void NetgenJsonParserTests::detects_shorts_and_opens() {
+    // Layout vdd joins the schematic's vdd_a and vdd_b; schematic out is
+    // split over layout out_1 and out_2.
+    QTemporaryFile tmpFile;
+    QVERIFY(tmpFile.open());
+    tmpFile.write(R"([{"name": ["top", "top"], "nets": [4, 3],
+        "badnets": [
+          [[["vdd", [["inv", "pos", 1], ["nand", "pos", 1]]]],
+           [["vdd_a", [["inv", "pos", 1]]], ["vdd_b", [["nand", "pos", 1]]]]],
+          [[["out_1", [["inv", "out", 1]]], ["out_2", [["buf", "in", 1]]]],
+           [["out", [["inv", "out", 1], ["buf", "in", 1]]]]]]}])");
+    tmpFile.flush();
+
+    const auto report = NetgenJsonParser::parseFile(tmpFile.fileName());
+    QVERIFY(report.ok);
+    QCOMPARE(report.summary.shorts, 1);
+    QCOMPARE(report.summary.opens, 1);
+    QList<NetgenJsonParser::DiffEntry> found;
+    for (const auto &diff : report.circuits.first().diffs) {
+        if (diff.type == NetgenJsonParser::DiffType::Short ||
+            diff.type == NetgenJsonParser::DiffType::Open) {
+            found.append(diff);
+        }
+    }
+    QCOMPARE(found.size(), 2);
+    QCOMPARE(found.at(0).type, NetgenJsonParser::DiffType::Short);
+    QCOMPARE(found.at(0).name, QStringLiteral("vdd"));
+    QCOMPARE(found.at(0).details,
+             QStringLiteral(
+                 "Layout net vdd joins schematic nets vdd_a, vdd_b"));
+    QCOMPARE(found.at(1).type, NetgenJsonParser::DiffType::Open);
+    QCOMPARE(found.at(1).name, QStringLiteral("out"));
+    QCOMPARE(NetgenJsonParser::toTypeString(found.at(1).type),
+             QStringLiteral("open"));
+}
+
+void NetgenJsonParserTests::compares_properties_numerically() {
+    QTemporaryFile tmpFile;
+    QVERIFY(tmpFile.open());
+    tmpFile.write(R"([{"name": ["top", "top"], "properties": [
+        [["M1", [["w", "1e-6"], ["l", "0.35"], ["nf", "2"], ["ad", "1p"]]],
+         ["M1", [["w", "1u"], ["l", "0.350000"], ["nf", "3"],
+                 ["ad", "1.05p"]]]]]}])");
+    tmpFile.flush();
+
+    auto details = [](const NetgenJsonParser::Report &report) {
+        QStringList list;
+        for (const auto &diff : report.circuits.first().diffs) {
+            list << diff.details;
+        }
+        return list;
+    };
+    const auto exact = NetgenJsonParser::parseFile(tmpFile.fileName());
+    QVERIFY(exact.ok);
+    QCOMPARE(details(exact), (QStringList{QStringLiteral("nf: 2 vs 3"),
+                                          QStringLiteral("ad: 1p vs 1.05p")}));
+
+    PropertyTolerances tolerances;
+    QVERIFY(tolerances.parse(QStringLiteral("ad rel=10%")));
+    const auto loose = NetgenJsonParser::parseFile(
+        tmpFile.fileName(), NetgenJsonParser::Details::Resident, tolerances);
+    QVERIFY(loose.ok);
+    QCOMPARE(details(loose), QStringList{QStringLiteral("nf: 2 vs 3")});
+    QCOMPARE(loose.tolerances.ruleCount(), qsizetype(1));
+}
+
+void NetgenJsonParserTests::diffs_pins() {
+    const auto tut2 = NetgenJsonParser::parseFile(QStringLiteral(TUT2_PATH));
+    QVERIFY(tut2.ok);
+    const auto &inverter = tut2.circuits[0];
+    QCOMPARE(inverter.layoutCell, QStringLiteral("inverter"));
+    QCOMPARE(inverter.pinsA.size(), 6);
+    QStringList missing;
+    for (const auto &diff : inverter.diffs) {
+        if (diff.type == NetgenJsonParser::DiffType::PinMismatch) {
+            QCOMPARE(diff.subtype,
+                     NetgenJsonParser::DiffEntry::Subtype::MissingPin);
+            QCOMPARE(diff.details,
+                     QStringLiteral("The pin is present only in Layout "
+                                    "circuit"));
+            missing << diff.name;
+        }
+    }
+    QCOMPARE(missing, (QStringList{QStringLiteral("Vdd"),
+                                   QStringLiteral("Gnd")}));
+
+    // Matched circuits keep no pin table.
+    const auto tut6 = NetgenJsonParser::parseFile(QStringLiteral(TUT6_PATH));
+    QVERIFY(tut6.ok);
+    const auto &top = tut6.circuits.first();
+    QCOMPARE(top.pinsB.size(), 22);
+    QCOMPARE(top.diffs.last().name, QStringLiteral("dp<6>"));
+    QCOMPARE(NetgenJsonParser::toTypeString(top.diffs.last().type),
+             QStringLiteral("pin_mismatch"));
+    for (const auto &cir : tut2.circuits) {
+        if (&cir != &inverter) {
+            QVERIFY(cir.pinsA.isEmpty() && cir.pinsB.isEmpty());
+        }
+    }
+}
+
 void NetgenJsonParserTests::fails_on_invalid_json() {
     NetgenJsonParser parser;
 
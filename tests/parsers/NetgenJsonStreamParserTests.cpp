@@ -0,0 +1,133 @@
+#include <QFile>
+#include <QRandomGenerator>
+#include <QtTest>
+
+#include "parsers/NetgenJsonParser.hpp"
+#include "parsers/NetgenJsonStreamParser.hpp"
+
+class NetgenJsonStreamParserTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void matches_parse_file_data();
+    static void matches_parse_file();
+    static void emits_circuits_before_the_end();
+    static void fails_on_truncated_stream();
+    static void fails_on_invalid_element();
+};
+
+namespace {
+auto readAll(const QString &path) -> QByteArray {
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+auto diffKeys(const NetgenJsonParser::Report &report) -> QStringList {
+    QStringList keys;
+    for (const auto &cir : report.circuits) {
+        for (const auto &entry : cir.diffs) {
+            keys << QStringLiteral("%1|%2|%3|%4")
+                        .arg(cir.layoutCell, entry.name, entry.details)
+                        .arg(entry.circuitIndex);
+        }
+    }
+    return keys;
+}
+} // namespace
+
+void NetgenJsonStreamParserTests::matches_parse_file_data() {
+    QTest::addColumn<QString>("path");
+    QTest::newRow("tut1") << QStringLiteral(FIXTURE_PATH);
+    QTest::newRow("tut2") << QStringLiteral(TUT2_PATH);
+    QTest::newRow("tut3") << QStringLiteral(TUT3_PATH);
+    QTest::newRow("tut6") << QStringLiteral(TUT6_PATH);
+}
+
+void NetgenJsonStreamParserTests::matches_parse_file() {
+    QFETCH(QString, path);
+    const auto expected = NetgenJsonParser::parseFile(path);
+    QVERIFY(expected.ok);
+    const QByteArray data = readAll(path);
+
+    // Chunk boundaries land inside strings, escapes and nested arrays.
+    QRandomGenerator rng(7);
+    NetgenJsonStreamParser stream;
+    for (qsizetype pos = 0; pos < data.size();) {
+        const qsizetype len = 1 + rng.bounded(64);
+        stream.feed(data.mid(pos, len));
+        pos += len;
+    }
+    const auto report = stream.finish();
+    QVERIFY2(report.ok, qPrintable(report.error));
+
+    QCOMPARE(report.circuits.size(), expected.circuits.size());
+    QCOMPARE(report.summary.deviceMismatches,
+             expected.summary.deviceMismatches);
+    QCOMPARE(report.summary.netMismatches, expected.summary.netMismatches);
+    QCOMPARE(report.summary.totalDevices, expected.summary.totalDevices);
+    QCOMPARE(report.summary.totalNets, expected.summary.totalNets);
+    for (qsizetype i = 0; i < report.circuits.size(); ++i) {
+        QCOMPARE(report.circuits.at(i).isTopLevel,
+                 expected.circuits.at(i).isTopLevel);
+        QCOMPARE(report.circuits.at(i).subcircuits.size(),
+                 expected.circuits.at(i).subcircuits.size());
+    }
+    QCOMPARE(diffKeys(report), diffKeys(expected));
+}
+
+void NetgenJsonStreamParserTests::emits_circuits_before_the_end() {
+    const QByteArray data = readAll(QStringLiteral(TUT2_PATH));
+    QVERIFY(!data.isEmpty());
+    const qsizetype lastElement =
+        data.lastIndexOf('{', data.lastIndexOf("\"name\""));
+    QVERIFY(lastElement > 0);
+
+    NetgenJsonStreamParser stream;
+    stream.feed(data.left(lastElement));
+    auto taken = stream.takeCircuits();
+    QCOMPARE(taken.size(), 1);
+    QVERIFY(stream.takeCircuits().isEmpty());
+
+    stream.feed(data.mid(lastElement));
+    const auto late = stream.takeCircuits();
+    QCOMPARE(late.size(), 1);
+    QCOMPARE(late.first().index, 1);
+    QCOMPARE(stream.circuitCount(), 2);
+    taken += late;
+
+    // Taken circuits are not kept; finish() assembles them with the rest.
+    const auto expected =
+        NetgenJsonParser::parseFile(QStringLiteral(TUT2_PATH));
+    const auto report = stream.finish(std::move(taken));
+    QVERIFY(report.ok);
+    QCOMPARE(report.circuits.size(), expected.circuits.size());
+    QCOMPARE(diffKeys(report), diffKeys(expected));
+}
+
+void NetgenJsonStreamParserTests::fails_on_truncated_stream() {
+    const QByteArray data = readAll(QStringLiteral(FIXTURE_PATH));
+    NetgenJsonStreamParser stream;
+    stream.feed(data.left(data.size() / 2));
+    QVERIFY(!stream.hasError());
+    const auto report = stream.finish();
+    QVERIFY(!report.ok);
+    QVERIFY(report.circuits.isEmpty());
+    QVERIFY(report.error.contains(QStringLiteral("unexpected end")));
+}
+
+void NetgenJsonStreamParserTests::fails_on_invalid_element() {
+    NetgenJsonStreamParser stream;
+    stream.feed(QByteArrayLiteral("[{\"name\": [\"a\", \"b\"] oops}]"));
+    QVERIFY(stream.hasError());
+    QVERIFY(!stream.finish().ok);
+
+    stream.feed(QByteArrayLiteral("{}"));
+    QVERIFY(stream.hasError());
+
+    NetgenJsonStreamParser empty;
+    empty.feed(QByteArrayLiteral("[ ]"));
+    QVERIFY(!empty.finish().ok);
+}
+
+QTEST_APPLESS_MAIN(NetgenJsonStreamParserTests)
+#include "NetgenJsonStreamParserTests.moc"
@@ -0,0 +1,376 @@
+#include <QtTest>
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <algorithm>
+
+#include "parsers/NetgenJsonParser.hpp"
+#include "parsers/NetlistComparator.hpp"
+#include "parsers/SpiceNetlist.hpp"
+
+class NetlistComparatorTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void matches_netgen_on_tutorials();
+    static void keeps_matched_subcircuits_whole();
+    static void merges_parallel_devices();
+    static void compares_parallel_sums();
+    static void finds_swapped_connection();
+    static void compares_parameters();
+    static void reports_missing_cell();
+    static void compares_large_netlist();
+    static void reuses_unchanged_cells();
+};
+
+namespace {
+using Report = NetgenJsonParser::Report;
+using DiffType = NetgenJsonParser::DiffType;
+
+const QString tutorial = QStringLiteral(TUTORIAL_PATH);
+
+// Diffs as "type|subtype|name|parameter", sorted: netgen spells property
+// values in its own notation, so only the parameter name is compared.
+auto keys(const Report &report) -> QStringList {
+    QStringList keys;
+    for (const auto &circuit : report.circuits) {
+        for (const auto &entry : circuit.diffs) {
+            keys.append(
+                QStringLiteral("%1|%2|%3|%4")
+                    .arg(NetgenJsonParser::toTypeString(entry.type))
+                    .arg(static_cast<int>(entry.subtype))
+                    .arg(entry.name, entry.details.section(QLatin1Char(':'),
+                                                           0, 0)));
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+auto compareFiles(const QString &layout, const QString &schematic,
+                  const QStringList &flatten = {}) -> Report {
+    NetlistComparator::Options options;
+    options.flatten = flatten;
+    QString error;
+    const QJsonArray circuits = NetlistComparator::compareFiles(
+        tutorial + layout, tutorial + schematic, options, &error);
+    if (circuits.isEmpty()) {
+        Report report;
+        report.error = error;
+        return report;
+    }
+    return NetgenJsonParser::parseCircuits(circuits);
+}
+
+auto compareText(const QString &layout, const QString &schematic,
+                 const PropertyTolerances &tolerances = {}) -> Report {
+    SpiceNetlist a;
+    SpiceNetlist b;
+    if (!a.parse(layout, QStringLiteral("a.sp")) ||
+        !b.parse(schematic, QStringLiteral("b.sp"))) {
+        return {};
+    }
+    return NetgenJsonParser::parseCircuits(NetlistComparator::compare(a, b),
+                                           tolerances);
+}
+
+auto count(const Report &report, DiffType type) -> qsizetype {
+    qsizetype n = 0;
+    for (const auto &circuit : report.circuits) {
+        n += std::count_if(circuit.diffs.cbegin(), circuit.diffs.cend(),
+                           [type](const auto &e) { return e.type == type; });
+    }
+    return n;
+}
+
+auto inverters(int count, bool reversed) -> QString {
+    QString text = QStringLiteral(".global vdd\n");
+    for (int k = 0; k < count; ++k) {
+        const int i = reversed ? count - 1 - k : k;
+        text += QStringLiteral("MP%1 out%1 in%1 vdd vdd pfet w=2u\n"
+                               "MN%1 out%1 in%1 0 0 nfet w=1u\n")
+                    .arg(i);
+    }
+    return text;
+}
+} // namespace
+
+void NetlistComparatorTests::matches_netgen_on_tutorials() {
+    // tut2 uses Vdd and 0 in bufferBx.spice's inverter without .global,
+    // which gets proxy pins for them; tut8 wires the interchangeable
+    // inverters of triinvert apart; tut6 leaves the library cells
+    // undefined in map9v3_nolib.spice, so they are black boxes.
+    struct Case {
+        QString layout;
+        QString schematic;
+        QString report;
+        QStringList flatten;
+    };
+    const auto fileName = [](const QString &cell) {
+        return QFileInfo(cell).fileName();
+    };
+    for (const Case &c :
+         {Case{QStringLiteral("/tut1/bufferA.spice"),
+               QStringLiteral("/tut1/bufferB.spice"),
+               QStringLiteral("/tut1/comp.json"),
+               {QStringLiteral("inverter")}},
+          Case{QStringLiteral("/tut3/bufferA.spice"),
+               QStringLiteral("/tut3/bufferB.spice"),
+               QStringLiteral("/tut3/comp.json"),
+               {}},
+          Case{QStringLiteral("/tut2/bufferA.spice"),
+               QStringLiteral("/tut2/bufferBx.spice"),
+               QStringLiteral("/tut2/badnets.json"),
+               {}},
+          Case{QStringLiteral("/tut8/morph2.spice"),
+               QStringLiteral("/tut8/morph1.spice"),
+               QStringLiteral("/tut8/comp_8a.json"),
+               {}},
+          Case{QStringLiteral("/tut6/map9v3.spice"),
+               QStringLiteral("/tut6/map9v3_nolib.spice"),
+               QStringLiteral("/tut6/comp_6c.json"),
+               {}}}) {
+        const Report ours = compareFiles(c.layout, c.schematic, c.flatten);
+        QVERIFY2(ours.ok, qPrintable(ours.error));
+        const Report netgen = NetgenJsonParser::parseFile(tutorial + c.report);
+        QVERIFY(netgen.ok);
+        QCOMPARE(ours.circuits.size(), netgen.circuits.size());
+        for (qsizetype i = 0; i < ours.circuits.size(); ++i) {
+            QCOMPARE(fileName(ours.circuits.at(i).layoutCell),
+                     fileName(netgen.circuits.at(i).layoutCell));
+            QCOMPARE(ours.circuits.at(i).summary.totalNets,
+                     netgen.circuits.at(i).summary.totalNets);
+        }
+        QCOMPARE(keys(ours), keys(netgen));
+        QVERIFY(!keys(ours).isEmpty());
+    }
+}
+
+void NetlistComparatorTests::keeps_matched_subcircuits_whole() {
+    const Report report =
+        compareFiles(QStringLiteral("/tut8/morph2.spice"),
+                     QStringLiteral("/tut8/morph1.spice"));
+    QVERIFY2(report.ok, qPrintable(report.error));
+    QCOMPARE(report.circuits.size(), qsizetype(2));
+    const auto &cell = report.circuits.first();
+    QCOMPARE(cell.layoutCell, QStringLiteral("triinvert"));
+    QVERIFY(cell.diffs.isEmpty());
+    QVERIFY(!cell.isTopLevel);
+
+    // The pins are wired differently, so neither the instance's nets nor
+    // the instance itself match.
+    const auto &top = report.circuits.last();
+    QCOMPARE(top.layoutCell, QStringLiteral("morph2.spice"));
+    QCOMPARE(top.devicesA, QStringList{QStringLiteral("triinvert")});
+    QCOMPARE(count(report, DiffType::NetMismatch), qsizetype(4));
+    QCOMPARE(count(report, DiffType::InstanceMismatch), qsizetype(2));
+    QCOMPARE(top.diffs.size(), qsizetype(6));
+}
+
+void NetlistComparatorTests::merges_parallel_devices() {
+    const Report report =
+        compareText(QStringLiteral(".global vdd\n"
+                                   "M1 y a 0 0 nfet w=1u\n"
+                                   "M2 y a 0 0 nfet w=1u\n"
+                                   "M3 y a vdd vdd pfet w=2u\n"
+                                   "R1 y out 10k\n"),
+                    QStringLiteral(".global vdd\n"
+                                   "MN y a 0 0 nfet w=2u\n"
+                                   "MP vdd a y vdd pfet w=2u\n"
+                                   "R1 out y 10k\n"));
+    QVERIFY2(report.ok, qPrintable(report.error));
+    QCOMPARE(report.circuits.size(), qsizetype(1));
+    QVERIFY(report.circuits.first().diffs.isEmpty());
+    QCOMPARE(report.circuits.first().deviceCountsA, QVector<int>({1, 1, 1}));
+}
+
+void NetlistComparatorTests::compares_parallel_sums() {
+    const QString layout = QStringLiteral("M1 y a 0 0 nfet w=1u l=0.18u\n"
+                                          "M2 y a 0 0 nfet w=1u l=0.18u\n"
+                                          "R1 y out 20k\n"
+                                          "R2 y out 20k\n");
+    // Two 1u widths are one 2u, or 1u twice; two 20k are one 10k.
+    QCOMPARE(keys(compareText(
+                 layout, QStringLiteral("M1 y a 0 0 nfet w=2u l=0.18u\n"
+                                        "R1 y out 10k\n"))),
+             QStringList());
+    QCOMPARE(keys(compareText(
+                 layout, QStringLiteral("M1 y a 0 0 nfet w=1u l=0.18u m=2\n"
+                                        "R1 out y 10k\n"))),
+             QStringList());
+
+    // A sum that falls short is reported, not hidden by the fold.
+    const Report narrow = compareText(
+        layout, QStringLiteral("M1 y a 0 0 nfet w=1.5u l=0.18u\n"
+                               "R1 y out 20k\n"));
+    QVERIFY2(narrow.ok, qPrintable(narrow.error));
+    QCOMPARE(keys(narrow),
+             QStringList({QStringLiteral("property_mismatch|1|nfet:1|w"),
+                          QStringLiteral("property_mismatch|1|r:1|value")}));
+
+    // Lengths differ, so these are two devices, not one twice as wide.
+    const Report apart = compareText(
+        QStringLiteral("M1 y a 0 0 nfet w=1u l=0.18u\n"
+                       "M2 y a 0 0 nfet w=1u l=0.2u\n"),
+        QStringLiteral("M1 y a 0 0 nfet w=2u l=0.18u\n"));
+    QVERIFY2(apart.ok, qPrintable(apart.error));
+    QCOMPARE(apart.circuits.first().deviceCountsA, QVector<int>{2});
+    QVERIFY(!apart.circuits.first().diffs.isEmpty());
+}
+
+void NetlistComparatorTests::finds_swapped_connection() {
+    const Report report =
+        compareText(QStringLiteral(".global vdd\n"
+                                   "M1 y a 0 0 nfet\n"
+                                   "M2 vdd a y vdd pfet\n"
+                                   "R1 out y 10k\n"),
+                    QStringLiteral(".global vdd\n"
+                                   "M1 y a 0 0 nfet\n"
+                                   "M2 vdd y a vdd pfet\n"
+                                   "R1 out y 10k\n"));
+    QVERIFY2(report.ok, qPrintable(report.error));
+    QStringList nets;
+    for (const auto &entry : report.circuits.first().diffs) {
+        QCOMPARE(entry.type, DiffType::NetMismatch);
+        nets.append(entry.name);
+    }
+    nets.removeDuplicates();
+    nets.sort();
+    QCOMPARE(nets, QStringList({QStringLiteral("a"), QStringLiteral("y")}));
+}
+
+void NetlistComparatorTests::compares_parameters() {
+    const QString layout = QStringLiteral("M1 y a 0 0 nfet w=1u l=0.18u\n"
+                                          "M2 vdd a y vdd pfet w=2u\n");
+    const QString schematic =
+        QStringLiteral("M1 y a 0 0 nfet w=1e-6 l=0.18u\n"
+                       "M2 vdd a y vdd pfet w=2.1u ad=1p\n");
+    const Report strict = compareText(layout, schematic);
+    QVERIFY2(strict.ok, qPrintable(strict.error));
+    // w=1u and w=1e-6 are the same number.
+    QCOMPARE(keys(strict),
+             QStringList({QStringLiteral("property_mismatch|1|pfet:2|ad"),
+                          QStringLiteral("property_mismatch|1|pfet:2|w")}));
+
+    PropertyTolerances tolerances;
+    QVERIFY(tolerances.parse(QStringLiteral("w rel=5%\n")));
+    const Report loose = compareText(layout, schematic, tolerances);
+    QCOMPARE(keys(loose),
+             QStringList{QStringLiteral("property_mismatch|1|pfet:2|ad")});
+}
+
+void NetlistComparatorTests::reports_missing_cell() {
+    SpiceNetlist a;
+    QVERIFY(a.load(tutorial + QStringLiteral("/tut3/bufferA.spice")));
+    NetlistComparator::Options options;
+    options.layoutCell = QStringLiteral("inverter");
+    options.schematicCell = QStringLiteral("nand");
+    QString error;
+    QVERIFY(NetlistComparator::compare(a, a, options, &error).isEmpty());
+    QCOMPARE(error, QStringLiteral("bufferA.spice: no cell nand"));
+
+    QVERIFY(NetlistComparator::compareFiles(
+                tutorial + QStringLiteral("/tut3/bufferA.spice"),
+                QStringLiteral("/nonexistent/b.sp"), {}, &error)
+                .isEmpty());
+    QVERIFY(error.startsWith(QStringLiteral("Failed to open file")));
+
+    // The cell a netlist is named after is its top level.
+    options.schematicCell = QStringLiteral("bufferA.spice");
+    const QJsonArray top = NetlistComparator::compare(a, a, options);
+    QCOMPARE(top.last().toObject().value(QStringLiteral("name")).toArray(),
+             QJsonArray({QStringLiteral("inverter"),
+                         QStringLiteral("bufferA.spice")}));
+}
+
+void NetlistComparatorTests::compares_large_netlist() {
+    // 20000 devices a side, enough for the rehash to run in chunks.
+    const Report clean = compareText(inverters(10000, false),
+                                     inverters(10000, true));
+    QVERIFY2(clean.ok, qPrintable(clean.error));
+    QCOMPARE(clean.circuits.size(), qsizetype(1));
+    QVERIFY(clean.circuits.first().diffs.isEmpty());
+    QCOMPARE(clean.circuits.first().summary.totalNets, 20002);
+
+    QString swapped = inverters(10000, true);
+    swapped.replace(QStringLiteral("MN77 out77 in77 0"),
+                    QStringLiteral("MN77 in77 out77 0"));
+    const Report dirty = compareText(inverters(10000, false), swapped);
+    QVERIFY(count(dirty, DiffType::NetMismatch) > 0);
+}
+
+void NetlistComparatorTests::reuses_unchanged_cells() {
+    const QString before = QStringLiteral(".global vdd\n"
+                                          ".subckt inv a y\n"
+                                          "M1 y a vdd vdd pfet w=2u\n"
+                                          "M2 y a 0 0 nfet w=1u\n"
+                                          ".ends\n"
+                                          ".subckt left a y\n"
+                                          "X1 a m inv\n"
+                                          "X2 m y inv\n"
+                                          ".ends\n"
+                                          ".subckt right a y\n"
+                                          "X1 a m inv\n"
+                                          "X2 m y inv\n"
+                                          "R1 m 0 10k\n"
+                                          ".ends\n"
+                                          "X1 in mid left\n"
+                                          "X2 mid out right\n");
+    QString after = before;
+    after.replace(QStringLiteral("R1 m 0 10k"), QStringLiteral("R1 y 0 10k"));
+    SpiceNetlist a;
+    SpiceNetlist b;
+    SpiceNetlist changed;
+    QVERIFY(a.parse(before, QStringLiteral("top.sp")));
+    QVERIFY(b.parse(before, QStringLiteral("top.sp")));
+    QVERIFY(changed.parse(after, QStringLiteral("top.sp")));
+
+    NetlistComparator::Records first;
+    NetlistComparator::Options options;
+    options.records = &first;
+    QVERIFY(!NetlistComparator::compare(a, b, options).isEmpty());
+    QCOMPARE(first.cells.size(), qsizetype(4));
+    QCOMPARE(first.reusedCount(), qsizetype(0));
+
+    // Only "right" changed: it and the top are compared again.
+    NetlistComparator::Records second;
+    options.previous = &first;
+    options.records = &second;
+    const QJsonArray incremental =
+        NetlistComparator::compare(changed, b, options);
+    QCOMPARE(incremental, NetlistComparator::compare(changed, b));
+    QCOMPARE(second.reusedCount(), qsizetype(2));
+    QVERIFY(second.cells.value(QStringLiteral("inv")).reused);
+    QVERIFY(second.cells.value(QStringLiteral("left")).reused);
+    QVERIFY(!second.cells.value(QStringLiteral("right")).reused);
+    QVERIFY(!second.cells.value(QStringLiteral("right")).clean);
+    QVERIFY(!second.cells.value(QStringLiteral("top.sp")).reused);
+
+    // Saved and loaded, the records still cover every cell.
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("records.json"));
+    QString error;
+    QVERIFY2(second.save(path, &error), qPrintable(error));
+    NetlistComparator::Records loaded;
+    QVERIFY2(loaded.load(path, &error), qPrintable(error));
+    QCOMPARE(loaded.cells.size(), qsizetype(4));
+    NetlistComparator::Records third;
+    options.previous = &loaded;
+    options.records = &third;
+    QCOMPARE(NetlistComparator::compare(changed, b, options), incremental);
+    QCOMPARE(third.reusedCount(), qsizetype(4));
+
+    // Results from another flatten list do not apply.
+    options.flatten = {QStringLiteral("inv")};
+    NetlistComparator::compare(changed, b, options);
+    QCOMPARE(third.reusedCount(), qsizetype(0));
+
+    QVERIFY(!loaded.load(dir.filePath(QStringLiteral("none.json")), &error));
+    QVERIFY(error.startsWith(QStringLiteral("Failed to open file")));
+    QVERIFY(loaded.cells.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(NetlistComparatorTests)
+#include "NetlistComparatorTests.moc"
@@ -0,0 +1,73 @@
+#include <QtTest>
+
+#include "parsers/PinMatcher.hpp"
+
+class PinMatcherTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void skips_placeholders_and_matches();
+    static void finds_missing_pins();
+    static void finds_renamed_pins();
+    static void finds_reordered_pins();
+};
+
+namespace {
+using Kind = PinMatcher::Kind;
+const QString noMatch = QStringLiteral("(no matching pin)");
+} // namespace
+
+void PinMatcherTests::skips_placeholders_and_matches() {
+    QVERIFY(PinMatcher::allMatch({QString()}, {QString()}));
+    const QStringList pins{QStringLiteral("Vdd"), QStringLiteral("Gnd"),
+                           QStringLiteral("out")};
+    QVERIFY(PinMatcher::allMatch(pins, pins));
+    QVERIFY(PinMatcher::compare(pins, {QStringLiteral("vdd"),
+                                       QStringLiteral("GND"),
+                                       QStringLiteral("OUT")})
+                .isEmpty());
+    QVERIFY(!PinMatcher::allMatch(pins, {}));
+}
+
+void PinMatcherTests::finds_missing_pins() {
+    const auto findings =
+        PinMatcher::compare({QStringLiteral("pos"), QStringLiteral("Vdd"),
+                             noMatch},
+                            {QStringLiteral("pos"), noMatch,
+                             QStringLiteral("en")});
+    QCOMPARE(findings.size(), qsizetype(2));
+    QVERIFY(findings.at(0).kind == Kind::Missing);
+    QCOMPARE(findings.at(0).pin, QStringLiteral("Vdd"));
+    QCOMPARE(findings.at(0).layoutPos, 1);
+    QCOMPARE(findings.at(0).schematicPos, -1);
+    QVERIFY(findings.at(1).kind == Kind::Missing);
+    QCOMPARE(findings.at(1).pin, QStringLiteral("en"));
+    QCOMPARE(findings.at(1).layoutPos, -1);
+    QCOMPARE(findings.at(1).schematicPos, 2);
+}
+
+void PinMatcherTests::finds_renamed_pins() {
+    const auto findings = PinMatcher::compare(
+        {QStringLiteral("in"), QStringLiteral("out")},
+        {QStringLiteral("in"), QStringLiteral("y")});
+    QCOMPARE(findings.size(), qsizetype(1));
+    QVERIFY(findings.first().kind == Kind::Renamed);
+    QCOMPARE(findings.first().pin, QStringLiteral("out"));
+    QCOMPARE(findings.first().other, QStringLiteral("y"));
+}
+
+void PinMatcherTests::finds_reordered_pins() {
+    // a and b swapped; each is reported once, from the layout side.
+    const auto findings = PinMatcher::compare(
+        {QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("c")},
+        {QStringLiteral("b"), QStringLiteral("a"), QStringLiteral("c")});
+    QCOMPARE(findings.size(), qsizetype(2));
+    QVERIFY(findings.at(0).kind == Kind::Reordered);
+    QCOMPARE(findings.at(0).pin, QStringLiteral("a"));
+    QCOMPARE(findings.at(0).layoutPos, 0);
+    QCOMPARE(findings.at(0).schematicPos, 1);
+    QCOMPARE(findings.at(1).pin, QStringLiteral("b"));
+}
+
+QTEST_GUILESS_MAIN(PinMatcherTests)
+#include "PinMatcherTests.moc"
@@ -0,0 +1,56 @@
+#include <QtTest>
+
+#include "parsers/PropertyTolerances.hpp"
+
+class PropertyTolerancesTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void matches_numbers_by_value();
+    static void applies_rules_per_parameter();
+    static void reports_bad_lines();
+};
+
+void PropertyTolerancesTests::matches_numbers_by_value() {
+    const PropertyTolerances none;
+    const QString w = QStringLiteral("w");
+    QVERIFY(none.matches(w, u"1e-6", u"1u"));
+    QVERIFY(none.matches(w, u"(no value)", u"(no value)"));
+    QVERIFY(!none.matches(w, u"1u", u"1.01u"));
+    QVERIFY(!none.matches(w, u"1u", u"(no value)"));
+    QVERIFY(!none.matches(w, u"fast", u"slow"));
+}
+
+void PropertyTolerancesTests::applies_rules_per_parameter() {
+    PropertyTolerances tolerances;
+    QVERIFY(tolerances.parse(QStringLiteral(
+        "# snapped to the grid\n"
+        "W   abs=5n\n"
+        "l   rel=0.1%   # drawn vs extracted\n"
+        "*   rel=1e-3\n")));
+    QCOMPARE(tolerances.ruleCount(), qsizetype(3));
+    QVERIFY(tolerances.matches(QStringLiteral("w"), u"1u", u"1.004u"));
+    QVERIFY(!tolerances.matches(QStringLiteral("w"), u"1u", u"1.006u"));
+    QVERIFY(tolerances.matches(QStringLiteral("L"), u"150n", u"150.1n"));
+    QVERIFY(!tolerances.matches(QStringLiteral("l"), u"150n", u"151n"));
+    QVERIFY(tolerances.matches(QStringLiteral("ad"), u"1p", u"1.0005p"));
+    QVERIFY(!tolerances.matches(QStringLiteral("ad"), u"1p", u"1.01p"));
+    QCOMPARE(tolerances.tolerance(QStringLiteral("W")).absolute, 5e-9);
+}
+
+void PropertyTolerancesTests::reports_bad_lines() {
+    PropertyTolerances tolerances;
+    QString error;
+    QVERIFY(!tolerances.parse(QStringLiteral("w abs=5n\nl tol=1%\n"),
+                              &error));
+    QVERIFY(error.startsWith(QStringLiteral("line 2:")));
+    QCOMPARE(tolerances.ruleCount(), qsizetype(0));
+    QVERIFY(!tolerances.parse(QStringLiteral("w rel=-1"), &error));
+    QVERIFY(!tolerances.parse(QStringLiteral("w"), &error));
+    QVERIFY(!tolerances.load(QStringLiteral("/nonexistent/tolerances"),
+                             &error));
+    QVERIFY(error.contains(QStringLiteral("Failed to open file")));
+}
+
+QTEST_GUILESS_MAIN(PropertyTolerancesTests)
+#include "PropertyTolerancesTests.moc"
@@ -0,0 +1,181 @@
+#include <QtTest>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "parsers/SpiceIndex.hpp"
+
+class SpiceIndexTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void indexes_fixture_with_include();
+    static void joins_continuation_lines();
+    static void locates_diffs();
+    static void notices_changed_files();
+    static void reports_missing_file();
+};
+
+namespace {
+using Kind = SpiceIndex::Kind;
+
+auto write(const QString &path, const QByteArray &text) -> bool {
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) &&
+           file.write(text) == text.size();
+}
+
+// top.sp includes cells/inv.sp, which includes top.sp back and a file
+// that does not exist.
+auto writeNetlists(const QTemporaryDir &dir) -> bool {
+    return QDir(dir.path()).mkpath(QStringLiteral("cells")) &&
+           write(dir.filePath(QStringLiteral("top.sp")),
+                 "* top\n"
+                 ".include \"cells/inv.sp\"\n"
+                 ".subckt buf a y vdd gnd\n"
+                 "xinv1 a\n"
+                 "+ mid vdd gnd inv w=1u\n"
+                 "Xinv2 mid y vdd gnd inv\n"
+                 ".ends\n") &&
+           write(dir.filePath(QStringLiteral("cells/inv.sp")),
+                 ".subckt inv a y vdd gnd\n"
+                 "M1 y a vdd vdd pfet w=2u ; pull-up\n"
+                 "M2 y a gnd gnd nfet\n"
+                 ".ends\n"
+                 ".include \"../top.sp\"\n"
+                 ".include missing.sp\n");
+}
+} // namespace
+
+void SpiceIndexTests::indexes_fixture_with_include() {
+    SpiceIndex index;
+    QString error;
+    QVERIFY2(index.build(QStringLiteral(TUT6_SPICE_PATH), &error),
+             qPrintable(error));
+    QCOMPARE(index.files().size(), qsizetype(2));
+    QCOMPARE(index.lineCount(), qint64(182 + 803));
+    QVERIFY(index.isCurrent());
+
+    QCOMPARE(index.find(Kind::Subckt, QString(), QStringLiteral("map9v3"))
+                 .line,
+             qint64(5));
+    const auto invx1 =
+        index.find(Kind::Subckt, QString(), QStringLiteral("invx1"));
+    QVERIFY(invx1.path.endsWith(QStringLiteral("osu035_stdcells.sp")));
+    QCOMPARE(invx1.line, qint64(496));
+
+    const QString top = QStringLiteral("map9v3");
+    QCOMPARE(index.find(Kind::Instance, top, QStringLiteral("X1")).line,
+             qint64(6));
+    QCOMPARE(index.find(Kind::Net, top, QStringLiteral("1465")).line,
+             qint64(6));
+    QCOMPARE(index.find(Kind::Net, top, QStringLiteral("vdd")).line,
+             qint64(5));
+    QVERIFY(!index.find(Kind::Net, top, QStringLiteral("INVX1")).isValid());
+    QCOMPARE(index.find(Kind::Instance, QStringLiteral("INVX1"),
+                        QStringLiteral("m1"))
+                 .line,
+             qint64(499));
+    QVERIFY(index.memoryBytes() > 0);
+}
+
+void SpiceIndexTests::joins_continuation_lines() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeNetlists(dir));
+    SpiceIndex index;
+    QVERIFY(index.build(dir.filePath(QStringLiteral("top.sp"))));
+    QCOMPARE(index.files().size(), qsizetype(2));
+    QCOMPARE(index.missingFiles().size(), qsizetype(1));
+    QVERIFY(index.missingFiles().first().endsWith(
+        QStringLiteral("missing.sp")));
+    QCOMPARE(index.count(Kind::Subckt), qint64(2));
+    QCOMPARE(index.count(Kind::Instance), qint64(4));
+
+    const QString buf = QStringLiteral("buf");
+    const auto mid = index.find(Kind::Net, buf, QStringLiteral("mid"));
+    QCOMPARE(mid.line, qint64(5));
+    QVERIFY(!index.find(Kind::Net, buf, QStringLiteral("inv")).isValid());
+    QVERIFY(!index.find(Kind::Net, buf, QStringLiteral("w")).isValid());
+    QVERIFY(!index.find(Kind::Net, QString(), QStringLiteral("mid"))
+                 .isValid());
+    // Inline comments are not nets.
+    QVERIFY(!index.find(Kind::Net, QStringLiteral("inv"),
+                        QStringLiteral("pull-up"))
+                 .isValid());
+    QCOMPARE(index.find(Kind::Instance, buf, QStringLiteral("XINV2")).line,
+             qint64(6));
+
+    qint64 first = 0;
+    const auto xinv1 =
+        index.find(Kind::Instance, buf, QStringLiteral("xinv1"));
+    QCOMPARE(xinv1.line, qint64(4));
+    QCOMPARE(index.excerpt(xinv1, 1, 1, &first),
+             QStringLiteral(".subckt buf a y vdd gnd\nxinv1 a\n"
+                            "+ mid vdd gnd inv w=1u"));
+    QCOMPARE(first, qint64(3));
+}
+
+void SpiceIndexTests::locates_diffs() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeNetlists(dir));
+    SpiceIndex index;
+    QVERIFY(index.build(dir.filePath(QStringLiteral("top.sp"))));
+    const QString buf = QStringLiteral("buf");
+
+    NetgenJsonParser::DiffEntry entry;
+    entry.type = NetgenJsonParser::DiffType::InstanceMismatch;
+    entry.name = QStringLiteral("inv:inv2");
+    QCOMPARE(index.locate(entry, buf).line, qint64(6));
+
+    entry.type = NetgenJsonParser::DiffType::PropertyMismatch;
+    entry.name = QStringLiteral("pfet:1");
+    QCOMPARE(index.locate(entry, QStringLiteral("inv")).line, qint64(2));
+    // A flattened path is looked up in the parent's class.
+    entry.name = QStringLiteral("inv:inv1/nfet:2");
+    QCOMPARE(index.locate(entry, buf).line, qint64(3));
+    entry.name = QStringLiteral("inv:inv1/nfet:XU2");
+    QCOMPARE(index.locate(entry, buf).line, qint64(1));
+
+    entry.type = NetgenJsonParser::DiffType::NetMismatch;
+    entry.name = QStringLiteral("mid");
+    QCOMPARE(index.locate(entry, buf).line, qint64(5));
+
+    entry.type = NetgenJsonParser::DiffType::DeviceMismatch;
+    entry.name = QStringLiteral("inv");
+    const auto inv = index.locate(entry, buf);
+    QVERIFY(inv.path.endsWith(QStringLiteral("inv.sp")));
+    QCOMPARE(inv.line, qint64(1));
+
+    // Unknown names fall back to the cell.
+    entry.type = NetgenJsonParser::DiffType::NetMismatch;
+    entry.name = QStringLiteral("nowhere");
+    QCOMPARE(index.locate(entry, buf).line, qint64(3));
+}
+
+void SpiceIndexTests::notices_changed_files() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeNetlists(dir));
+    SpiceIndex index;
+    QVERIFY(index.build(dir.filePath(QStringLiteral("top.sp"))));
+    QVERIFY(index.isCurrent());
+    QVERIFY(write(dir.filePath(QStringLiteral("cells/inv.sp")),
+                  ".subckt inv a y\n.ends\n"));
+    QVERIFY(!index.isCurrent());
+}
+
+void SpiceIndexTests::reports_missing_file() {
+    SpiceIndex index;
+    QString error;
+    QVERIFY(!index.build(QStringLiteral("/nonexistent/top.sp"), &error));
+    QVERIFY(error.startsWith(QStringLiteral("Failed to open file")));
+    QVERIFY(index.files().isEmpty());
+    QVERIFY(!index.find(Kind::Subckt, QString(), QStringLiteral("inv"))
+                 .isValid());
+}
+
+QTEST_GUILESS_MAIN(SpiceIndexTests)
+#include "SpiceIndexTests.moc"
@@ -0,0 +1,171 @@
+#include <QtTest>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "parsers/SpiceNetlist.hpp"
+
+class SpiceNetlistTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void reads_fixture();
+    static void reads_element_kinds();
+    static void follows_includes_once();
+    static void reports_errors();
+};
+
+namespace {
+auto write(const QString &path, const QByteArray &text) -> bool {
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) &&
+           file.write(text) == text.size();
+}
+
+auto parameter(const SpiceNetlist::Element &element, const QString &name)
+    -> QString {
+    for (const auto &param : element.parameters) {
+        if (param.first == name) {
+            return param.second;
+        }
+    }
+    return {};
+}
+} // namespace
+
+void SpiceNetlistTests::reads_fixture() {
+    SpiceNetlist netlist;
+    QString error;
+    QVERIFY2(netlist.load(QStringLiteral(TUTORIAL_PATH "/tut1/bufferA.spice"),
+                          &error),
+             qPrintable(error));
+    QCOMPARE(netlist.top().name, QStringLiteral("bufferA.spice"));
+    QCOMPARE(netlist.top().elements.size(), qsizetype(2));
+    QCOMPARE(netlist.cells().size(), qsizetype(1));
+
+    const SpiceNetlist::Cell *inverter =
+        netlist.cell(QStringLiteral("INVERTER"));
+    QVERIFY(inverter != nullptr);
+    QCOMPARE(inverter->ports,
+             QStringList({QStringLiteral("neg"), QStringLiteral("in"),
+                          QStringLiteral("out"), QStringLiteral("pos")}));
+    QCOMPARE(inverter->elements.size(), qsizetype(2));
+    const SpiceNetlist::Element &pfet = inverter->elements.first();
+    QCOMPARE(pfet.name, QStringLiteral("M1000"));
+    QCOMPARE(pfet.kind, QLatin1Char('m'));
+    QCOMPARE(pfet.deviceClass, QStringLiteral("pfet"));
+    QCOMPARE(pfet.nodes.size(), qsizetype(4));
+    // Continuation lines add to the statement above them.
+    QCOMPARE(pfet.parameters.size(), qsizetype(6));
+    QCOMPARE(parameter(pfet, QStringLiteral("ps")), QStringLiteral("7.2u"));
+
+    const SpiceNetlist::Element &x0 = netlist.top().elements.first();
+    QCOMPARE(x0.kind, QLatin1Char('x'));
+    QCOMPARE(x0.deviceClass, QStringLiteral("inverter"));
+    QCOMPARE(x0.nodes.at(1), QStringLiteral("inverter_1/in"));
+    QVERIFY(netlist.isGlobal(QStringLiteral("vdd")));
+    QVERIFY(netlist.isGlobal(QStringLiteral("0")));
+    QVERIFY(!netlist.isGlobal(QStringLiteral("out")));
+    QVERIFY(netlist.isDeclaredGlobal(QStringLiteral("Vdd")));
+    QVERIFY(!netlist.isDeclaredGlobal(QStringLiteral("0")));
+}
+
+void SpiceNetlistTests::reads_element_kinds() {
+    SpiceNetlist netlist;
+    QString error;
+    QVERIFY2(netlist.parse(QStringLiteral(
+                               ".subckt cell a b vdd params: w=1u\n"
+                               "R1 a b 10k\n"
+                               "R2 a b rpoly 2k ; trimmed\n"
+                               "C1 a 0 c=(1f)\n"
+                               "D1 a b dio area=2\n"
+                               "Q1 a b vdd npn\n"
+                               "Q2 a b vdd 0 pnp\n"
+                               "M1 a b vdd vdd pch W = 2u L= 1u\n"
+                               "X1 a b sub PARAMS: m=2\n"
+                               ".ends cell\n"),
+                           QStringLiteral("kinds.sp"), &error),
+             qPrintable(error));
+    const SpiceNetlist::Cell *cell = netlist.cell(QStringLiteral("cell"));
+    QVERIFY(cell != nullptr);
+    QCOMPARE(cell->ports.size(), qsizetype(3));
+    const auto &elements = cell->elements;
+    QCOMPARE(elements.size(), qsizetype(8));
+
+    QCOMPARE(elements.at(0).deviceClass, QStringLiteral("r"));
+    QCOMPARE(parameter(elements.at(0), QStringLiteral("value")),
+             QStringLiteral("10k"));
+    QCOMPARE(elements.at(1).deviceClass, QStringLiteral("rpoly"));
+    QCOMPARE(parameter(elements.at(1), QStringLiteral("value")),
+             QStringLiteral("2k"));
+    QCOMPARE(elements.at(2).nodes,
+             QStringList({QStringLiteral("a"), QStringLiteral("0")}));
+    QCOMPARE(parameter(elements.at(2), QStringLiteral("c")),
+             QStringLiteral("1f"));
+    QCOMPARE(elements.at(3).deviceClass, QStringLiteral("dio"));
+    QCOMPARE(elements.at(4).nodes.size(), qsizetype(3));
+    QCOMPARE(elements.at(4).deviceClass, QStringLiteral("npn"));
+    QCOMPARE(elements.at(5).nodes.size(), qsizetype(4));
+    QCOMPARE(elements.at(5).deviceClass, QStringLiteral("pnp"));
+    QCOMPARE(parameter(elements.at(6), QStringLiteral("w")),
+             QStringLiteral("2u"));
+    QCOMPARE(parameter(elements.at(6), QStringLiteral("l")),
+             QStringLiteral("1u"));
+    QCOMPARE(elements.at(7).nodes.size(), qsizetype(2));
+    QCOMPARE(elements.at(7).deviceClass, QStringLiteral("sub"));
+    QCOMPARE(parameter(elements.at(7), QStringLiteral("m")),
+             QStringLiteral("2"));
+}
+
+void SpiceNetlistTests::follows_includes_once() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkpath(QStringLiteral("cells")));
+    QVERIFY(write(dir.filePath(QStringLiteral("top.sp")),
+                  ".subckt buf a y\n"
+                  ".include \"cells/inv.sp\"\n"
+                  "X1 a m inv\n"
+                  "X2 m y inv\n"
+                  ".ends\n"
+                  ".include cells/inv.sp\n"
+                  ".end\n"
+                  "X3 a y buf\n"));
+    QVERIFY(write(dir.filePath(QStringLiteral("cells/inv.sp")),
+                  "M1 y a 0 0 nfet\n"
+                  ".include \"../top.sp\"\n"
+                  ".end\n"));
+    SpiceNetlist netlist;
+    QString error;
+    QVERIFY2(netlist.load(dir.filePath(QStringLiteral("top.sp")), &error),
+             qPrintable(error));
+    // The include lands in the open .subckt; .end stops only the top file.
+    const SpiceNetlist::Cell *buf = netlist.cell(QStringLiteral("buf"));
+    QVERIFY(buf != nullptr);
+    QCOMPARE(buf->elements.size(), qsizetype(3));
+    QCOMPARE(buf->elements.first().name, QStringLiteral("M1"));
+    QVERIFY(netlist.top().elements.isEmpty());
+}
+
+void SpiceNetlistTests::reports_errors() {
+    SpiceNetlist netlist;
+    QString error;
+    QVERIFY(!netlist.load(QStringLiteral("/nonexistent/top.sp"), &error));
+    QVERIFY(error.startsWith(QStringLiteral("Failed to open file")));
+
+    QVERIFY(!netlist.parse(QStringLiteral(".subckt a x\n.subckt b y\n"),
+                           QStringLiteral("nested.sp"), &error));
+    QCOMPARE(error,
+             QStringLiteral("nested.sp: line 2: .subckt inside .subckt a"));
+    QVERIFY(!netlist.parse(QStringLiteral("* c\n.ends\n"),
+                           QStringLiteral("ends.sp"), &error));
+    QCOMPARE(error, QStringLiteral("ends.sp: line 2: .ends without .subckt"));
+    QVERIFY(!netlist.parse(QStringLiteral(".subckt a x\nR1 x 0 1k\n"),
+                           QStringLiteral("open.sp"), &error));
+    QCOMPARE(error, QStringLiteral("open.sp: .subckt a has no .ends"));
+    QVERIFY(netlist.cells().isEmpty());
+    QVERIFY(netlist.top().elements.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(SpiceNetlistTests)
+#include "SpiceNetlistTests.moc"
@@ -0,0 +1,74 @@
+#include <QtTest>
+
+#include "parsers/SpiceNumber.hpp"
+
+class SpiceNumberTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void parses_values_data();
+    static void parses_values();
+    static void spellings_compare_equal();
+    static void rejects_non_numbers();
+};
+
+void SpiceNumberTests::parses_values_data() {
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<double>("expected");
+    QTest::newRow("plain") << QStringLiteral("42") << 42.0;
+    QTest::newRow("exponent") << QStringLiteral("7.2e-6") << 7.2e-6;
+    QTest::newRow("fraction") << QStringLiteral(".5") << 0.5;
+    QTest::newRow("sign") << QStringLiteral("-2.5n") << -2.5e-9;
+    QTest::newRow("blanks") << QStringLiteral(" 3.5E-1 ") << 0.35;
+    QTest::newRow("femto") << QStringLiteral("3f") << 3e-15;
+    QTest::newRow("pico") << QStringLiteral("3.24p") << 3.24e-12;
+    QTest::newRow("micro") << QStringLiteral("1U") << 1e-6;
+    QTest::newRow("milli") << QStringLiteral("1M") << 1e-3;
+    QTest::newRow("kilo") << QStringLiteral("10kohm") << 1e4;
+    QTest::newRow("mega") << QStringLiteral("1Meg") << 1e6;
+    QTest::newRow("giga") << QStringLiteral("2g") << 2e9;
+    QTest::newRow("mil") << QStringLiteral("1mil") << 25.4e-6;
+    QTest::newRow("unit") << QStringLiteral("1uF") << 1e-6;
+}
+
+void SpiceNumberTests::parses_values() {
+    QFETCH(QString, text);
+    QFETCH(double, expected);
+    double value = 0.0;
+    QVERIFY(SpiceNumber::parse(text, &value));
+    QCOMPARE(value, expected);
+}
+
+void SpiceNumberTests::spellings_compare_equal() {
+    // Trailing zeros are dropped before scaling, so equal values written
+    // differently give the same double, not merely close ones.
+    const QStringList same{QStringLiteral("1e-6"), QStringLiteral("1u"),
+                           QStringLiteral("0.001m"), QStringLiteral("1.000u"),
+                           QStringLiteral("1000n")};
+    double first = 0.0;
+    QVERIFY(SpiceNumber::parse(same.first(), &first));
+    for (const QString &text : same) {
+        double value = 0.0;
+        QVERIFY(SpiceNumber::parse(text, &value));
+        QVERIFY2(value == first, qPrintable(text));
+    }
+    double a = 0.0;
+    double b = 0.0;
+    QVERIFY(SpiceNumber::parse(QStringLiteral("0.35"), &a));
+    QVERIFY(SpiceNumber::parse(QStringLiteral("0.350000"), &b));
+    QVERIFY(a == b);
+}
+
+void SpiceNumberTests::rejects_non_numbers() {
+    double value = 7.0;
+    for (const QString &text :
+         {QString(), QStringLiteral("(no value)"), QStringLiteral("abc"),
+          QStringLiteral("-"), QStringLiteral("1u2"),
+          QStringLiteral("1 u")}) {
+        QVERIFY2(!SpiceNumber::parse(text, &value), qPrintable(text));
+    }
+    QCOMPARE(value, 7.0);
+}
+
+QTEST_GUILESS_MAIN(SpiceNumberTests)
+#include "SpiceNumberTests.moc"
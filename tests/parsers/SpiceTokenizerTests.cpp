@@ -0,0 +1,94 @@
+#include <QtTest>
+
+#include "parsers/SpiceTokenizer.hpp"
+
+class SpiceTokenizerTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void splits_statements();
+    static void keeps_offsets_and_lines();
+    static void stops_when_the_sink_fails();
+    static void resolves_includes();
+};
+
+namespace {
+// Each statement as its tokens joined by '|', with its line.
+auto statements(const QByteArray &text) -> QStringList {
+    QStringList out;
+    SpiceTokenizer tokenizer([&out](const SpiceTokenizer::Statement &s) {
+        QStringList tokens;
+        for (const SpiceTokenizer::Token &token : s.tokens) {
+            tokens.append(token.toString());
+        }
+        out.append(QStringLiteral("%1:%2").arg(s.line).arg(
+            tokens.join(QLatin1Char('|'))));
+        return true;
+    });
+    if (!tokenizer.feed(text.constData(), text.size()) ||
+        !tokenizer.finish()) {
+        return {};
+    }
+    return out;
+}
+} // namespace
+
+void SpiceTokenizerTests::splits_statements() {
+    QCOMPARE(statements("* title\n"
+                        "M1 d g s b nfet\r\n"
+                        "+ w=1u ; drawn\n"
+                        "\n"
+                        "* a comment does not end the statement\n"
+                        "+l=(2u),m=1 $ note\n"
+                        "R1 net$1 0 10k;value\n"
+                        "  .ENDS\n"),
+             QStringList({QStringLiteral("2:M1|d|g|s|b|nfet|w=1u|l=|2u|m=1"),
+                          QStringLiteral("7:R1|net$1|0|10k"),
+                          QStringLiteral("8:.ENDS")}));
+    QVERIFY(statements("* only comments\n\n").isEmpty());
+}
+
+void SpiceTokenizerTests::keeps_offsets_and_lines() {
+    const QByteArray text("X1 a\n+ b inv\n");
+    QVector<qint64> offsets;
+    SpiceTokenizer tokenizer([&offsets](const SpiceTokenizer::Statement &s) {
+        for (const SpiceTokenizer::Token &token : s.tokens) {
+            offsets.append(token.offset);
+        }
+        return true;
+    });
+    QVERIFY(tokenizer.feed(text.constData(), text.size()));
+    QVERIFY(tokenizer.finish());
+    QCOMPARE(tokenizer.lineCount(), qint64(2));
+    QCOMPARE(offsets, QVector<qint64>({0, 3, 7, 9}));
+
+    const SpiceTokenizer::Token head{text.constData(), 2, 0};
+    QVERIFY(head.is("x1"));
+    QVERIFY(!head.is("x"));
+    QVERIFY(!head.contains('='));
+}
+
+void SpiceTokenizerTests::stops_when_the_sink_fails() {
+    int seen = 0;
+    SpiceTokenizer tokenizer([&seen](const SpiceTokenizer::Statement &) {
+        return ++seen < 2;
+    });
+    const QByteArray text("R1 a b 1k\nR2 a b 1k\nR3 a b 1k\nR4 a b 1k\n");
+    QVERIFY(!tokenizer.feed(text.constData(), text.size()));
+    QCOMPARE(seen, 2);
+}
+
+void SpiceTokenizerTests::resolves_includes() {
+    const QByteArray text(".INC \"cells/inv.sp\"");
+    const SpiceTokenizer::Token head{text.constData(), 4, 0};
+    const SpiceTokenizer::Token name{text.constData() + 5, 14, 5};
+    QVERIFY(SpiceTokenizer::isInclude(head));
+    QCOMPARE(SpiceTokenizer::includePath(QStringLiteral("/work"), name),
+             QStringLiteral("/work/cells/inv.sp"));
+    const SpiceTokenizer::Token bare{text.constData() + 6, 12, 6};
+    QCOMPARE(SpiceTokenizer::includePath(QStringLiteral("/work"), bare),
+             QStringLiteral("/work/cells/inv.sp"));
+}
+
+QTEST_GUILESS_MAIN(SpiceTokenizerTests)
+#include "SpiceTokenizerTests.moc"
@@ -0,0 +1,116 @@
+#include <QtTest>
+
+#include "diagnostics/MemoryReport.hpp"
+#include "parsers/NetgenJsonParser.hpp"
+#include "parsers/StringPool.hpp"
+
+class StringPoolTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void interns_equal_strings();
+    static void shares_identical_circuits();
+    static void changed_circuit_keeps_own_diffs();
+    static void measures_shared_reports_once();
+    static void prune_drops_released_reports();
+};
+
+namespace {
+const QString tut1 = QStringLiteral(FIXTURE_PATH);
+const QString tut6 = QStringLiteral(TUT6_PATH);
+} // namespace
+
+void StringPoolTests::interns_equal_strings() {
+    StringPool pool;
+    const QString a = QStringLiteral("net_%1").arg(42);
+    const QString b = QStringLiteral("net_%1").arg(42);
+    QVERIFY(a.constData() != b.constData());
+    QCOMPARE(pool.intern(a).constData(), a.constData());
+    QCOMPARE(pool.intern(b).constData(), a.constData());
+    QCOMPARE(pool.size(), qsizetype(1));
+    QVERIFY(pool.intern(QString()).isNull());
+    QCOMPARE(pool.size(), qsizetype(1));
+}
+
+void StringPoolTests::shares_identical_circuits() {
+    StringPool pool;
+    auto first = NetgenJsonParser::parseFile(tut6);
+    auto second = NetgenJsonParser::parseFile(tut6);
+    QVERIFY(first.ok && second.ok);
+    pool.intern(first.circuits);
+    pool.intern(second.circuits);
+
+    QCOMPARE(pool.sharedCircuits(), qint64(second.circuits.size()));
+    for (qsizetype c = 0; c < second.circuits.size(); ++c) {
+        const auto &a = first.circuits.at(c);
+        const auto &b = second.circuits.at(c);
+        QCOMPARE(b.layoutCell.constData(), a.layoutCell.constData());
+        if (!b.diffs.isEmpty()) {
+            QCOMPARE(b.diffs.constData(), a.diffs.constData());
+        }
+        // Links still point into their own report.
+        for (auto it = b.subcircuits.cbegin(); it != b.subcircuits.cend();
+             ++it) {
+            QVERIFY(it.value() >= second.circuits.constData());
+            QVERIFY(it.value() <
+                    second.circuits.constData() + second.circuits.size());
+        }
+    }
+}
+
+void StringPoolTests::changed_circuit_keeps_own_diffs() {
+    StringPool pool;
+    auto first = NetgenJsonParser::parseFile(tut1);
+    auto second = NetgenJsonParser::parseFile(tut1);
+    QVERIFY(!second.circuits.isEmpty());
+    QVERIFY(!second.circuits.first().diffs.isEmpty());
+    second.circuits.first().diffs.first().details = QStringLiteral("changed");
+    pool.intern(first.circuits);
+    pool.intern(second.circuits);
+
+    const auto &a = first.circuits.first().diffs;
+    const auto &b = second.circuits.first().diffs;
+    QVERIFY(a.constData() != b.constData());
+    QCOMPARE(b.first().details, QStringLiteral("changed"));
+    QCOMPARE(a.first().details, NetgenJsonParser::parseFile(tut1)
+                                    .circuits.first()
+                                    .diffs.first()
+                                    .details);
+    // Rows that did not change still share their strings.
+    QCOMPARE(b.first().name.constData(), a.first().name.constData());
+}
+
+void StringPoolTests::measures_shared_reports_once() {
+    auto first = NetgenJsonParser::parseFile(tut6);
+    auto second = NetgenJsonParser::parseFile(tut6);
+    const qint64 separate = MemoryReport::measure(first.circuits).total() +
+                            MemoryReport::measure(second.circuits).total();
+
+    StringPool pool;
+    pool.intern(first.circuits);
+    pool.intern(second.circuits);
+    const qint64 one = MemoryReport::measure(first.circuits).total();
+    const qint64 both =
+        MemoryReport::measure({&first.circuits, &second.circuits}).total();
+    QVERIFY(both > one);
+    QVERIFY(both < separate);
+    // Only the circuit arrays and subcircuit tables are per report.
+    QVERIFY(both - one < one / 2);
+}
+
+void StringPoolTests::prune_drops_released_reports() {
+    StringPool pool;
+    {
+        auto report = NetgenJsonParser::parseFile(tut6);
+        pool.intern(report.circuits);
+        QVERIFY(pool.size() > 0);
+        QVERIFY(pool.cellCount() > 0);
+        QCOMPARE(pool.prune(), qsizetype(0));
+    }
+    QVERIFY(pool.prune() > 0);
+    QCOMPARE(pool.size(), qsizetype(0));
+    QCOMPARE(pool.cellCount(), qsizetype(0));
+}
+
+QTEST_GUILESS_MAIN(StringPoolTests)
+#include "StringPoolTests.moc"
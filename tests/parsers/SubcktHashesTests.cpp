@@ -0,0 +1,121 @@
+#include <QtTest>
+
+#include "parsers/SpiceNetlist.hpp"
+#include "parsers/SubcktHashes.hpp"
+
+class SubcktHashesTests : public QObject {
+    Q_OBJECT
+
+  private slots:
+    static void ignores_formatting();
+    static void follows_changes_upwards();
+    static void covers_parameters_and_globals();
+    static void hashes_fixture();
+};
+
+namespace {
+const QString hierarchy = QStringLiteral(".global vdd\n"
+                                         ".subckt inv a y\n"
+                                         "M1 y a vdd vdd pfet w=2u\n"
+                                         "M2 y a 0 0 nfet w=1u\n"
+                                         ".ends\n"
+                                         ".subckt nand a b y\n"
+                                         "M1 y a vdd vdd pfet\n"
+                                         "M2 y b vdd vdd pfet\n"
+                                         "M3 y a m 0 nfet\n"
+                                         "M4 m b 0 0 nfet\n"
+                                         ".ends\n"
+                                         ".subckt buf a y\n"
+                                         "X1 a m inv\n"
+                                         "X2 m y inv\n"
+                                         ".ends\n"
+                                         "X1 in mid buf\n"
+                                         "X2 mid in out nand\n");
+
+auto hashes(const QString &text) -> SubcktHashes {
+    SpiceNetlist netlist;
+    if (!netlist.parse(text, QStringLiteral("top.sp"))) {
+        return {};
+    }
+    return SubcktHashes(netlist);
+}
+} // namespace
+
+void SubcktHashesTests::ignores_formatting() {
+    const SubcktHashes plain = hashes(hierarchy);
+    QCOMPARE(plain.size(), qsizetype(4));
+    for (const QString &cell : {QStringLiteral("inv"), QStringLiteral("nand"),
+                                QStringLiteral("buf"),
+                                QStringLiteral("top.sp")}) {
+        QVERIFY(!plain.hash(cell).isEmpty());
+    }
+    QCOMPARE(plain.hash(QStringLiteral("INV")),
+             plain.hash(QStringLiteral("inv")));
+    QVERIFY(plain.hash(QStringLiteral("nor")).isEmpty());
+
+    QString reformatted = hierarchy;
+    reformatted.replace(QStringLiteral("M1 y a vdd vdd pfet w=2u\n"),
+                        QStringLiteral("* pull-up\nm1  Y A Vdd vdd\n"
+                                       "+ PFET W = 2u\n"));
+    reformatted.replace(QStringLiteral(".subckt buf"),
+                        QStringLiteral(".SUBCKT BUF"));
+    const SubcktHashes other = hashes(reformatted);
+    for (const QString &cell : {QStringLiteral("inv"), QStringLiteral("buf"),
+                                QStringLiteral("top.sp")}) {
+        QCOMPARE(other.hash(cell), plain.hash(cell));
+    }
+}
+
+void SubcktHashesTests::follows_changes_upwards() {
+    const SubcktHashes before = hashes(hierarchy);
+    QString changed = hierarchy;
+    changed.replace(QStringLiteral("M2 y a 0 0 nfet w=1u"),
+                    QStringLiteral("M2 a y 0 0 nfet w=1u"));
+    const SubcktHashes after = hashes(changed);
+    // inv changed, so did everything that calls it; nand did not.
+    QVERIFY(after.hash(QStringLiteral("inv")) !=
+            before.hash(QStringLiteral("inv")));
+    QVERIFY(after.hash(QStringLiteral("buf")) !=
+            before.hash(QStringLiteral("buf")));
+    QVERIFY(after.hash(QStringLiteral("top.sp")) !=
+            before.hash(QStringLiteral("top.sp")));
+    QCOMPARE(after.hash(QStringLiteral("nand")),
+             before.hash(QStringLiteral("nand")));
+}
+
+void SubcktHashesTests::covers_parameters_and_globals() {
+    const SubcktHashes before = hashes(hierarchy);
+    QString resized = hierarchy;
+    resized.replace(QStringLiteral("w=1u"), QStringLiteral("w=1.5u"));
+    QVERIFY(hashes(resized).hash(QStringLiteral("inv")) !=
+            before.hash(QStringLiteral("inv")));
+
+    // The same text with vdd local is a different circuit.
+    QString local = hierarchy;
+    local.remove(QStringLiteral(".global vdd\n"));
+    QVERIFY(hashes(local).hash(QStringLiteral("inv")) !=
+            before.hash(QStringLiteral("inv")));
+
+    // A call to a cell the file does not define hashes the name only.
+    const SubcktHashes open = hashes(QStringLiteral("X1 a b cell\n"));
+    const SubcktHashes renamed = hashes(QStringLiteral("X1 a b other\n"));
+    QVERIFY(!open.hash(QStringLiteral("top.sp")).isEmpty());
+    QVERIFY(open.hash(QStringLiteral("top.sp")) !=
+            renamed.hash(QStringLiteral("top.sp")));
+}
+
+void SubcktHashesTests::hashes_fixture() {
+    SpiceNetlist a;
+    SpiceNetlist b;
+    QVERIFY(a.load(QStringLiteral(TUTORIAL_PATH "/tut1/bufferA.spice")));
+    QVERIFY(b.load(QStringLiteral(TUTORIAL_PATH "/tut1/bufferB.spice")));
+    const SubcktHashes layout(a);
+    const SubcktHashes schematic(b);
+    QCOMPARE(layout.size(), qsizetype(2));
+    QVERIFY(!layout.hash(QStringLiteral("bufferA.spice")).isEmpty());
+    QVERIFY(layout.hash(QStringLiteral("inverter")) !=
+            schematic.hash(QStringLiteral("inverter")));
+}
+
+QTEST_GUILESS_MAIN(SubcktHashesTests)
+#include "SubcktHashesTests.moc"
@@ -1,19 +1,34 @@
 #include <QtTest>
 
+#include <QCheckBox>
 #include <QComboBox>
+#include <QDockWidget>
 #include <QLabel>
 #include <QLineEdit>
+#include <QPlainTextEdit>
 #include <QPushButton>
 #include <QStackedWidget>
+#include <QTabBar>
 #include <QTableView>
+#include <QTemporaryDir>
+#include <QTreeView>
 
 #include "MainWindow.hpp"
+#include "models/DiffEntryCommon.hpp"
+#include "diagnostics/Tracer.hpp"
 
 class MainWindowSmokeTests : public QObject {
     Q_OBJECT
 
   private slots:
     static void welcome_and_load();
+    static void traces_report_load();
+    static void opens_reports_in_tabs();
+    static void compares_with_baseline();
+    static void hides_waived_diffs();
+    static void groups_similar_diffs();
+    static void shows_unique_masters();
+    static void shows_diff_source();
 };
 
 void MainWindowSmokeTests::welcome_and_load() {
@@ -65,5 +80,260 @@ void MainWindowSmokeTests::welcome_and_load() {
     QCOMPARE(table->model()->rowCount(), 0);
 }
 
+void MainWindowSmokeTests::traces_report_load() {
+    MainWindow window;
+    QVERIFY(window.findChild<QDockWidget *>(QStringLiteral("perfDock")));
+    Tracer::clear();
+    Tracer::setEnabled(true);
+    QVERIFY(window.loadFile(QStringLiteral(FIXTURE_PATH), false));
+    Tracer::setEnabled(false);
+
+    QStringList names;
+    for (const auto &event : Tracer::events()) {
+        names << QString::fromUtf8(event.name);
+    }
+    for (const char *name :
+         {"MainWindow::loadFile", "NetgenJsonParser::parseFile",
+          "MainWindow::showReport", "CircuitTreeModel::setCircuits",
+          "DiffEntryModel::setDiffs",
+          "DiffFilterProxyModel::setAllowedCircuits"}) {
+        QVERIFY2(names.contains(QString::fromUtf8(name)), name);
+    }
+}
+
+void MainWindowSmokeTests::opens_reports_in_tabs() {
+    MainWindow window;
+    auto *tabs = window.findChild<QTabBar *>(QStringLiteral("reportTabs"));
+    auto *table =
+        window.findChild<QTableView *>(QStringLiteral("diffTableView"));
+    auto *typeFilter =
+        window.findChild<QComboBox *>(QStringLiteral("typeFilter"));
+    auto *totalDevices =
+        window.findChild<QLabel *>(QStringLiteral("summary_total_devices"));
+    QVERIFY(tabs && table && typeFilter && totalDevices);
+    QCOMPARE(tabs->count(), 1);
+
+    QVERIFY(window.loadFile(QStringLiteral(FIXTURE_PATH), false));
+    QCOMPARE(tabs->count(), 1); // the empty tab is reused
+    typeFilter->setCurrentText(QStringLiteral("device_mismatch"));
+    QCOMPARE(table->model()->rowCount(), 0);
+
+    QVERIFY(window.loadFile(QStringLiteral(TUT6_PATH), false));
+    QCOMPARE(tabs->count(), 2);
+    QCOMPARE(tabs->currentIndex(), 1);
+    QCOMPARE(typeFilter->currentText(), QStringLiteral("All"));
+    QVERIFY(table->model()->rowCount() > 0);
+    QVERIFY(totalDevices->text() != QStringLiteral("4"));
+
+    // Switching back restores the first report with its filter.
+    tabs->setCurrentIndex(0);
+    QCOMPARE(totalDevices->text(), QStringLiteral("4"));
+    QCOMPARE(typeFilter->currentText(), QStringLiteral("device_mismatch"));
+    QCOMPARE(table->model()->rowCount(), 0);
+    typeFilter->setCurrentText(QStringLiteral("All"));
+    QCOMPARE(table->model()->rowCount(), 16);
+
+    // Loading an open report reloads its tab.
+    QVERIFY(window.loadFile(QStringLiteral(TUT6_PATH), false));
+    QCOMPARE(tabs->count(), 2);
+    QCOMPARE(tabs->currentIndex(), 1);
+
+    emit tabs->tabCloseRequested(1);
+    QCOMPARE(tabs->count(), 1);
+    QCOMPARE(totalDevices->text(), QStringLiteral("4"));
+    QCOMPARE(table->model()->rowCount(), 16);
+}
+
+void MainWindowSmokeTests::compares_with_baseline() {
+    MainWindow window;
+    auto *tabs = window.findChild<QTabBar *>(QStringLiteral("reportTabs"));
+    auto *table =
+        window.findChild<QTableView *>(QStringLiteral("diffTableView"));
+    auto *delta = window.findChild<QComboBox *>(QStringLiteral("deltaFilter"));
+    QVERIFY(tabs && table && delta);
+    QVERIFY(!window.compareWith(QStringLiteral(FIXTURE_PATH)));
+
+    QVERIFY(window.loadFile(QStringLiteral(TUT6_PATH), false));
+    QVERIFY(!delta->isEnabled());
+    const int rows = table->model()->rowCount();
+    QVERIFY(rows > 0);
+
+    // The baseline opens in its own tab; the compared report stays current.
+    QVERIFY(window.compareWith(QStringLiteral(FIXTURE_PATH)));
+    QCOMPARE(tabs->count(), 2);
+    QCOMPARE(tabs->currentIndex(), 0);
+    QVERIFY(delta->isEnabled());
+    QVERIFY(table->model()->rowCount() > rows); // plus the fixed diffs
+    delta->setCurrentText(QStringLiteral("new"));
+    QCOMPARE(table->model()->rowCount(), rows);
+    delta->setCurrentText(QStringLiteral("unchanged"));
+    QCOMPARE(table->model()->rowCount(), 0);
+
+    tabs->setCurrentIndex(1);
+    QVERIFY(!delta->isEnabled());
+    QCOMPARE(delta->currentText(), QStringLiteral("All"));
+    tabs->setCurrentIndex(0);
+    QCOMPARE(delta->currentText(), QStringLiteral("unchanged"));
+
+    // Reloading drops the comparison.
+    QVERIFY(window.loadFile(QStringLiteral(TUT6_PATH), false));
+    QVERIFY(!delta->isEnabled());
+    QCOMPARE(delta->currentText(), QStringLiteral("All"));
+    QCOMPARE(table->model()->rowCount(), rows);
+}
+
+void MainWindowSmokeTests::hides_waived_diffs() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("waivers.txt"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("object=*\n");
+    file.close();
+
+    MainWindow window;
+    auto *table =
+        window.findChild<QTableView *>(QStringLiteral("diffTableView"));
+    auto *hide = window.findChild<QCheckBox *>(QStringLiteral("hideWaived"));
+    QVERIFY(table && hide);
+    QVERIFY(!hide->isEnabled());
+    QVERIFY(!window.loadWaivers(dir.filePath(QStringLiteral("missing"))));
+
+    QVERIFY(window.loadFile(QStringLiteral(TUT6_PATH), false));
+    const int rows = table->model()->rowCount();
+    QVERIFY(rows > 0);
+    QVERIFY(window.loadWaivers(path));
+    QVERIFY(hide->isEnabled());
+    QCOMPARE(table->model()->rowCount(), 0);
+    hide->setChecked(false);
+    QCOMPARE(table->model()->rowCount(), rows);
+
+    // Tabs opened later pick up the loaded rules.
+    hide->setChecked(true);
+    QVERIFY(window.loadFile(QStringLiteral(FIXTURE_PATH), false));
+    QCOMPARE(table->model()->rowCount(), 0);
+}
+
+void MainWindowSmokeTests::groups_similar_diffs() {
+    MainWindow window;
+    QVERIFY(window.loadFile(QStringLiteral(TUT6_PATH), false));
+    auto *table =
+        window.findChild<QTableView *>(QStringLiteral("diffTableView"));
+    auto *group = window.findChild<QCheckBox *>(QStringLiteral("groupSimilar"));
+    auto *clusters =
+        window.findChild<QTreeView *>(QStringLiteral("clusterView"));
+    auto *search = window.findChild<QLineEdit *>(QStringLiteral("searchField"));
+    QVERIFY(table && group && clusters && search);
+    const int rows = table->model()->rowCount();
+
+    group->setChecked(true);
+    QVERIFY(clusters->isVisibleTo(&window));
+    QVERIFY(!table->isVisibleTo(&window));
+    QAbstractItemModel *model = clusters->model();
+    const int groups = model->rowCount();
+    QVERIFY(groups > 0 && groups <= rows);
+    int members = 0;
+    for (int i = 0; i < groups; ++i) {
+        members += model->rowCount(model->index(i, 0));
+    }
+    QCOMPARE(members, rows);
+
+    // Groups follow the filter.
+    search->setText(QStringLiteral("no_such_object"));
+    QTRY_COMPARE(model->rowCount(), 0);
+
+    // Activating a member goes back to the table, on that row.
+    search->clear();
+    QTRY_COMPARE(model->rowCount(), groups);
+    const QModelIndex member = model->index(0, 0, model->index(0, 0));
+    const QString name =
+        member.siblingAtColumn(DiffEntryColumns::OBJECT).data().toString();
+    emit clusters->activated(member);
+    QVERIFY(!group->isChecked());
+    QVERIFY(table->isVisibleTo(&window));
+    QCOMPARE(table->currentIndex()
+                 .siblingAtColumn(DiffEntryColumns::OBJECT)
+                 .data()
+                 .toString(),
+             name);
+}
+
+void MainWindowSmokeTests::shows_unique_masters() {
+    MainWindow window;
+    QVERIFY(window.loadFile(QStringLiteral(TUT6_PATH), false));
+    auto *table =
+        window.findChild<QTableView *>(QStringLiteral("diffTableView"));
+    auto *unique =
+        window.findChild<QCheckBox *>(QStringLiteral("uniqueMasters"));
+    QVERIFY(table && unique);
+    QVERIFY(!unique->isChecked());
+    QAbstractItemModel *model = table->model();
+    const int rows = model->rowCount();
+    for (int row = 0; row < rows; ++row) {
+        const qint64 count =
+            model->index(row, 0)
+                .data(DiffEntryModel::InstancesRole)
+                .toLongLong();
+        QVERIFY(count >= 1);
+        QCOMPARE(model->headerData(row, Qt::Vertical).isValid(), count > 1);
+    }
+
+    // Only the filter changes; nothing is reparsed.
+    unique->setChecked(true);
+    QVERIFY(model->rowCount() <= rows);
+    unique->setChecked(false);
+    QCOMPARE(model->rowCount(), rows);
+}
+
+void MainWindowSmokeTests::shows_diff_source() {
+    MainWindow window;
+    const QString fixturePath = QStringLiteral(FIXTURE_PATH);
+    const QDir tut1 = QFileInfo(fixturePath).dir();
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString layoutPath = dir.filePath(QStringLiteral("bufferA.spice"));
+    QVERIFY(QFile::copy(tut1.filePath(QStringLiteral("bufferA.spice")),
+                        layoutPath));
+    QVERIFY(window.loadFile(fixturePath, false));
+    window.setSourceNetlists(layoutPath,
+                             tut1.filePath(QStringLiteral("bufferB.spice")));
+    window.show();
+    auto *dock = window.findChild<QDockWidget *>(QStringLiteral("sourceDock"));
+    auto *table =
+        window.findChild<QTableView *>(QStringLiteral("diffTableView"));
+    auto *layoutLabel =
+        window.findChild<QLabel *>(QStringLiteral("sourceLayoutLabel"));
+    auto *schematicLabel =
+        window.findChild<QLabel *>(QStringLiteral("sourceSchematicLabel"));
+    auto *layoutView = window.findChild<QPlainTextEdit *>(
+        QStringLiteral("sourceLayoutView"));
+    QVERIFY(dock && table && layoutLabel && schematicLabel && layoutView);
+    QVERIFY(dock->isHidden());
+
+    // Property diffs of tut1 name devices inside the inverter subcircuit.
+    dock->show();
+    table->setCurrentIndex(table->model()->index(0, 0));
+    QTRY_VERIFY(layoutLabel->text().contains(QStringLiteral("bufferA.spice:")));
+    QTRY_VERIFY(
+        schematicLabel->text().contains(QStringLiteral("bufferB.spice:")));
+    QVERIFY(layoutView->toPlainText().contains(QStringLiteral(".subckt")));
+
+    // Rewritten in place three lines shorter: the old mapping is dropped
+    // and the line comes from a fresh index.
+    const QString shown = layoutLabel->text();
+    const qint64 line = shown.section(QLatin1Char(':'), -1).toLongLong();
+    QFile layout(layoutPath);
+    QVERIFY(layout.open(QIODevice::ReadOnly));
+    const QByteArray text = layout.readAll();
+    layout.close();
+    QVERIFY(layout.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    layout.write(text.mid(text.indexOf(".subckt")));
+    layout.close();
+    QTRY_COMPARE(layoutLabel->text(),
+                 QStringLiteral("%1:%2")
+                     .arg(QDir::toNativeSeparators(layoutPath))
+                     .arg(line - 3));
+}
+
 QTEST_MAIN(MainWindowSmokeTests)
 #include "MainWindowSmokeTests.moc"